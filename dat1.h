@@ -73,6 +73,7 @@
 */
 
 #include <pthread.h>
+#include <sys/types.h>
 #include "hdf5.h"
 #include "hds1.h"
 #include "hds_types.h"
@@ -102,6 +103,9 @@ typedef enum {
   HDSTYPE_STRUCTURE
 } hdstype_t;
 
+/* True if the hdstype_t is one of the numeric types. */
+#define HDSTYPE_ISNUMERIC(t) ((t) >= HDSTYPE_BYTE && (t) <= HDSTYPE_DOUBLE)
+
 /* Which shell should be used when expanding environment
    variables. Not all HDS supported shells are supported
    by this library.
@@ -133,77 +137,192 @@ typedef enum {
     chance from the user side. */
 #define DAT__CELLNAME "ARRAY_OF_STRUCTURES_CELL"
 
+/* Name of the link to the catalogue dataset in the root group (see
+   dat1Catalogue.c). Component names are always converted to upper case,
+   so this can never be the name of a component. */
+#define DAT__CATNAME ".hds_catalogue"
+
 /* Names of attributes */
 #define HDS__ATTR_STRUCT_TYPE "CLASS"
 #define HDS__ATTR_STRUCT_DIMS "HDS_STRUCTURE_DIMS"
 #define HDS__ATTR_ROOT_NAME "HDS_ROOT_NAME"
 #define HDS__ATTR_ROOT_PRIMITIVE "HDS_ROOT_IS_PRIMITIVE"
+#define HDS__ATTR_GENERATION "HDS_GENERATION"
+#define HDS__ATTR_UNDEFINED "HDS_UNDEFINED"
+
+/* Number of read-lock holders that are recorded in each Handle in a
+   form that can be checked without locking a mutex (see
+   dat1HandleLock.c). */
+#define HDS__NFASTREAD 4
+
+/* Identifiers for the pools of objects managed by dat1PoolAlloc and
+   dat1PoolFree, and the number of read lock words in the arrays held in
+   the HDS__POOL_LOCKERS pool. */
+#define HDS__POOL_LOC     0
+#define HDS__POOL_HANDLE  1
+#define HDS__POOL_LOCKERS 2
+#define HDS__NPOOL        3
+#define HDS__POOLLOCKERS 10
+
+/* Maximum number of names remembered as not existing in a structure */
+#define HDS__MXABSENT 8
+
+/* Largest number of bytes of data that may be stored in a compact
+   dataset. HDF5 limits an object header message to 64kB. */
+#define HDS__MXCOMPACT 60000
+
+/* Largest number of threads that may be used to compress or decompress
+   the chunks of a dataset. */
+#define HDS__MXTHREADS 64
+
+/* Largest number of bytes in the chunk cache given to a primitive whose
+   chunks do not fit in the default cache (see the RAWCACHE tuning
+   parameter). */
+#define HDS__MXRAWCACHE 268435456
+
+/* Number of bytes in the blocks in which the HDS Classic NBLOCKS and
+   INAL tuning parameters are given. */
+#define HDS__BLOCKSIZE 512
+
+/* Flags identifying the items of object metadata that can be cached in
+   a Handle (see dat1MetaCache.c). */
+#define HDS__META_TYPE    1   /* hdstype_t returned by dat1Type */
+#define HDS__META_TYPESTR 2   /* Type string returned by datType */
+#define HDS__META_SDIMS   4   /* Structure dimensions from dat1GetStructureDims */
+#define HDS__META_NAME    8   /* Component name returned by datName */
+#define HDS__META_STRUC  16   /* Whether the object is a structure */
+#define HDS__META_ORDER  32   /* Index type from dat1IndexType */
+#define HDS__META_DEFINED 64  /* Primitive known to have a value (dat1IsDefined) */
+#define HDS__META_ALL   127
 
 /* This structure  contains information about an HDF5 object (group or
    dataset) that is common to all the locators that refer to the object. */
 typedef struct Handle {
    pthread_mutex_t mutex;   /* Guards access to the values in the handle */
-
-   int nwrite_lock;         /* Number of current write locks (0 or 1) */
-   pthread_t write_locker;  /* ID for thread holding write lock */
+   char mutexinit;          /* Non-zero if "mutex" has been initialised.
+                               This and "mutex" are preserved when the
+                               Handle is returned to its pool */
+   pthread_mutex_t lockmutex;/* Guards the lock information in all the
+                               Handles for a file. Only used in the
+                               top-level Handle (see dat1HandleLock).
+                               Preserved and initialised with "mutex" */
+
+   size_t write_owner;      /* Lock word for thread holding write lock, or
+                               zero. Read without the mutex (see
+                               dat1HandleLock) */
    int nread_lock;          /* Number of current read locks (0 or more) */
-   pthread_t *read_lockers; /* Array of IDs for thread holding read locks */
+   size_t *read_lockers;    /* Array of lock words for threads holding read
+                               locks */
    int maxreaders;          /* Current size of "read_lockers" array */
+   size_t read_owners[HDS__NFASTREAD]; /* Copies of up to HDS__NFASTREAD
+                               elements of "read_lockers", or zero */
+   int nsublock;            /* Number of locks held on descendant Handles */
 
    struct Handle *parent;   /* Pointer to Handle describing the parent object */
    struct Handle **children;/* Pointer to array holding pointers to Handles
                                 for any known child objects */
    int nchild;              /* The length of the "children" array */
+   int maxchild;            /* The allocated size of the "children" array */
+   int *freechild;          /* Indices of unused elements in "children" */
+   int nfree;               /* The number of indices in "freechild" */
+   int ichild;              /* Index of this Handle in parent->children */
+   struct Handle *childhash;/* Hash table of known child objects, keyed
+                               by name */
+   UT_hash_handle hh;       /* Mandatory for UTHASH (see "childhash") */
    char *name;              /* Name (cleaned) of the HDF object within its parent */
    char docheck;            /* If non-zero, check any lock is appropriate
                                before using the locator */
    struct Handle *check;    /* Used to test validity of the Handle */
    hdsbool_t erase;         /* Erase file after it is closed? */
+
+   int metaflags;           /* HDS__META_ flags for the cached items below */
+   hdstype_t metatype;      /* Cached type of the object */
+   char metatypestr[DAT__SZTYP+1]; /* Cached HDS type string */
+   char metaname[DAT__SZNAM+1];    /* Cached HDS name of the object */
+   hdsbool_t metastruc;     /* Cached flag indicating a structure */
+   hdsbool_t metaorder;     /* Cached flag indicating creation order index */
+   int metansdim;           /* Cached number of structure dimensions */
+   hdsdim metasdims[DAT__MXDIM];   /* Cached structure dimensions */
+   char (*absent)[DAT__SZNAM+1];   /* Names known not to exist in a structure */
+   int nabsent;             /* Number of names in "absent" */
+   int nextabsent;          /* Index of the "absent" entry to replace next */
 } Handle;
 
+/* Details of the memory mapping of a primitive, stored only by locators
+   that are currently mapped [datMap only]. */
+typedef struct HdsLocMap {
+  void *pntr;        /* Pointer to memory mapped data array */
+  void *regpntr;     /* Pointer that was registered with CNF */
+  size_t bytesmapped;/* Number of bytes mapped into memory */
+  hdsmode_t accmode; /* Access mode for memory mapped data */
+  int ndims;         /* Number of dimensions in mapdims */
+  hdsdim mapdims[DAT__MXDIM]; /* Dimensionality of mapped dims */
+  hdsbool_t uses_true_mmap;  /* Indicates that we have true mmap */
+  int fdmap;  /* File descriptor for mapped data (can free if >0) */
+  char maptype[DAT__SZTYP+1]; /* HDS type string used for memory mapping */
+} HdsLocMap;
+
 /* Preliminary definition of (currently undefined) structures used in the
    following HDSLoc structure. */
 struct HdsFile;
+struct HdsScope;
 struct LOC;
 
 /* Private definition of the HDS locator struct */
 typedef struct LOC {
   int hds_version;   /* Implementation version number. Always 5 at the moment.
                         Note, this MUST be the first field in the structure. */
-  struct LOC *prev;  /* Previous locator in linked list (see hdstrack2.c) */
-  struct LOC *next;  /* Next locator in linked list (see hdstrack2.c) */
-  struct HdsFile *hdsFile;  /* Holds heads of prim/sec locator lists for each file (see hdstrack2.c) */
   Handle *handle;    /* Structure holding fixed info for the HDF object */
-  void *pntr;        /* Pointer to memory mapped data array [datMap only] */
-  void *regpntr;     /* Pointer that was registered with CNF */
-  size_t bytesmapped;/* Number of bytes mapped into memory [datMap only] */
-  size_t vectorized; /* Non-zero if vectorized */
   hid_t file_id;     /* Set if this locator is associated with a root file */
   hid_t dataset_id;  /* Set if this is a dataset "primitive type" */
   hid_t dataspace_id;/* Set if this is a primitive with dimensions */
   hid_t group_id;    /* Set if this locator is associated with a group */
   hid_t dtype;       /* Set if a special data type was created for this locator */
-  hdsmode_t accmode; /* Access mode for memory mapped data [datMap only] */
-  int ndims;         /* Number of dimensions in mapdims [datMap only] */
-  hdsdim mapdims[DAT__MXDIM]; /* Dimensionality of mapped dims [datMap only] */
+  hid_t defer_id;    /* Parent group, if the object has not yet been opened (see dat1Deferred.c) */
+  hdsbool_t deferstruc; /* Is the unopened object a structure? */
+  size_t vectorized; /* Non-zero if vectorized */
   hdsbool_t iscell;  /* Is this a single cell? */
+  hdsbool_t isemptycell; /* Structure cell not yet created (group_id is the array, see dat1OpenCell.c) */
   hdsbool_t isslice; /* Is this a slice? */
   hdsbool_t isprimary;/* Is this a primary locator (and so owns its own file_id) */
   hdsbool_t isdiscont;/* Is this a discontiguous slice? */
-  hdsbool_t uses_true_mmap;  /* Indicates that we have true mmap [datMap only] */
-  int fdmap;  /* File descriptor for mapped data (can free if >0) [datMap only] */
-  char maptype[DAT__SZTYP+1]; /* HDS type string used for memory mapping [datMap only] */
-  char grpname[DAT__SZGRP+1]; /* Name of group associated with locator */
+  struct LOC *prev;  /* Previous locator in linked list (see hdstrack2.c) */
+  struct LOC *next;  /* Next locator in linked list (see hdstrack2.c) */
+  struct HdsFile *hdsFile;  /* Holds heads of prim/sec locator lists for each file (see hdstrack2.c) */
+  HdsLocMap *map;    /* Details of current memory mapping, or NULL [datMap only] */
+  char *grpname;     /* Name of group associated with locator, or NULL (see hdsgroups.c) */
+  struct HdsScope *scope; /* hdsBegin scope that owns the locator, or NULL (see dat1Scope.c) */
+  int iscope;        /* Index of the locator within the scope */
 } HDSLoc;
 
-/* A structure that lists all the locators associated with a file path,
-   separating the locators into primary and secondary. */
+/* A scope started by hdsBegin. It holds a list of the locators created
+   within the scope that have not yet been freed (see dat1Scope.c). */
+typedef struct HdsScope {
+   struct HdsScope *parent; /* Enclosing scope, or NULL */
+   pthread_mutex_t mutex;   /* Guards the following fields */
+   HDSLoc **locs;           /* The locators owned by the scope */
+   int nloc;                /* Number of locators in "locs" */
+   int maxloc;              /* Allocated length of "locs" */
+} HdsScope;
+
+/* Identifies a container file independently of the path used to reach
+   it. */
+typedef struct HdsFileKey {
+   dev_t dev;          /* Device containing the file */
+   ino_t ino;          /* Inode number of the file */
+} HdsFileKey;
+
+/* A structure that lists all the locators associated with a container
+   file, separating the locators into primary and secondary. */
 typedef struct HdsFile {
-   char *path;         /* The full absolute path to the file (used as the hash key) */
+   HdsFileKey key;     /* Device and inode of the file (used as the hash key) */
+   char *path;         /* The full absolute path to the file (for display) */
    HDSLoc *primhead;   /* Pointer to the locator at the head of a double-linked
                           list of primary locators. */
    HDSLoc *sechead;    /* Pointer to the locator at the head of a double-linked
                           list of secondary locators. */
+   pthread_mutex_t mutex; /* Guards access to the above lists and flags */
+   hdsbool_t catstale; /* Has the file been modified since it was opened? */
    UT_hash_handle hh;  /* Mandatory for UTHASH */
 } HdsFile;
 
@@ -282,13 +401,24 @@ void dat1H5EtoEMS( int *status );
 
 HDSLoc *
 dat1New( const HDSLoc *locator, hdsbool_t isprimary, const char *name_str, const char *type_str,
-        int ndim, const hdsdim dims[], int *status);
+        int ndim, const hdsdim dims[], const HDSCreateProps *props, int *status);
 
 void
 dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type,
-             const char * name_str, hid_t * dataset_id, hid_t *dataspace_id, int *status );
+             const HDSCreateProps *props, const char * name_str,
+             hid_t * dataset_id, hid_t *dataspace_id, int *status );
 
 hid_t dat1Reopen( hid_t file_id, unsigned int flags, hid_t fapl, int *status );
+hid_t dat1FileAccessPlist( unsigned int flags, int *status );
+hid_t dat1GroupCreatePlist( hdsbool_t isfile, int *status );
+hid_t dat1DatasetCreatePlist( int ndim, const hsize_t h5dims[], hid_t h5type,
+                              const HDSCreateProps *props, H5D_layout_t *layout,
+                              int *status );
+hid_t dat1DatasetAccessPlist( hid_t dcpl, hid_t dataspace_id, hid_t h5type,
+                              int *status );
+void dat1DatasetProps( hid_t dataset_id, HDSCreateProps *props,
+                       hdsdim chunk[], int *status );
+H5_index_t dat1IndexType( hid_t group_id, Handle *handle, int *status );
 hid_t dat1RetrieveContainer( const HDSLoc *locator, int * status );
 hid_t dat1RetrieveIdentifier( const HDSLoc * locator, int * status );
 
@@ -333,6 +463,10 @@ dat1Index2Coords ( size_t idx, int ndim, const hdsdim arraydims[DAT__MXDIM],
 hdstype_t
 dau1HdsType( hid_t h5type, int * status );
 
+void
+dat1TypeString( hdstype_t hdstyp, size_t nchar, char type_str[DAT__SZTYP+1],
+                int *status );
+
 HdsTypeInfo *
 dat1TypeInfo( void );
 
@@ -346,6 +480,16 @@ dat1CvtLogical( size_t nval, hdstype_t intype, size_t nbin,
              hdstype_t outtype, size_t nbout, const void * imp, void * exp,
              size_t *nbad, int * status );
 
+int
+dat1CvtNumeric( size_t nval, hdstype_t intype, size_t nbin,
+                hdstype_t outtype, size_t nbout, const void * imp,
+                void * exp, size_t *nbad, int * status );
+
+int
+dat1TransferNumeric( const HDSLoc *locator, hdsbool_t towrite,
+                     hdstype_t usertype, size_t nbuser, void *values,
+                     int *status );
+
 int
 dat1GetBounds( const HDSLoc * locator, hdsdim lower[DAT__MXDIM],
                hdsdim upper[DAT__MXDIM], hdsbool_t * issubset,
@@ -395,8 +539,15 @@ hds1CountLocators( size_t ncomp, char **comps, hdsbool_t skip_scratch_root, int
 void
 hds1GetLocators( hid_t file_id, int *nloc, HDSLoc ***loclist, hid_t **file_ids, int *status );
 
+char **
+hds1GetPaths( int *npath, int *status );
+
 Handle *
-hds1FindHandle( hid_t file_id, int *status );
+hds1FindHandle( HdsFile *hdsFile, int *status );
+
+hid_t
+hds1FindFileId( const char *path, unsigned int flags, HdsFile **hdsFile,
+                int *status );
 
 Handle *
 dat1TopHandle( Handle *handle, int *status );
@@ -449,13 +600,30 @@ dat1GetAttrString( hid_t objid, const char * attrname, hdsbool_t usedef,
 void dat1Getenv( const char *varname, int def, int *val );
 
 hdsbool_t hds1GetUseMmap();
+hdsbool_t hds1GetMapUpdate();
 hdsbool_t hds1GetLockCheck();
+hdsbool_t hds1GetCatalogue();
+int hds1GetCompact();
+int hds1GetDeflate();
+hdsbool_t hds1GetShuffle();
+hdsbool_t hds1GetFletcher32();
+int hds1GetScaleOffset();
+int hds1GetChunkSize();
+int hds1GetNThreads();
+int hds1GetRawCache();
+int hds1GetRawSlots();
+int hds1GetSieve();
+int hds1GetMetaBlock();
+int hds1GetInal();
+int hds1GetNcomp();
 hds_shell_t hds1GetShell();
 
 int dat1Annul( HDSLoc *locator, int * status );
 
 hid_t dat1GetParentID( hid_t objid, hdsbool_t allow_root, int *status );
 
+hid_t dat1FileSpace( const HDSLoc *locator, int *status );
+
 int
 dat1GetStructureDims( const HDSLoc * locator, int maxdims, hdsdim dims[], int *status );
 
@@ -467,10 +635,51 @@ rdonly, int * status );
 Handle *dat1EraseHandle( Handle *parent, const char *name, int * status );
 Handle *dat1FreeHandle( Handle *handle, int *status );
 int dat1ValidateLocator( const char *func, int checklock, const HDSLoc *loc, int rdonly, int *status );
+int dat1ValidateQuery( const char *func, const HDSLoc *loc, int *status );
 Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly, int *result, int *status );
 void dat1HandleMsg( const char *token, const Handle *handle );
 int dat1ValidateHandle( const char *func, Handle *handle, int *status );
 int dat1IsTopLevel( const HDSLoc *loc, int *status );
+void dat1LinkHandle( Handle *parent, Handle *child, int *status );
+void dat1UnlinkHandle( Handle *child );
+
+hdsbool_t dat1PeekStruc( const HDSLoc *parent, const char *name, hdsbool_t *isstruc, int *status );
+void dat1DeferLocator( HDSLoc *locator, hid_t parent_id, hdsbool_t isstruc, int *status );
+void dat1OpenDeferred( const HDSLoc *locator, int *status );
+void dat1CloseDeferred( HDSLoc *locator );
+void dat1OpenCell( const HDSLoc *locator, hdsbool_t create, int *status );
+
+void dat1Walk( hid_t obj_id, const char *name, const HDSWalkNode *top, int flags,
+               int (*func)( const HDSWalkNode *node, void *data, int *status ),
+               void *data, int *status );
+
+void dat1CatalogueStale( const HDSLoc *locator, int *status );
+void dat1CatalogueWrite( hid_t file_id, HdsFile *hdsFile, int *status );
+hdsbool_t dat1CatalogueScan( const HDSLoc *locator,
+                             int (*func)( const HDSWalkNode *node, void *data, int *status ),
+                             void *data, int flags, int *status );
+int dat1CatalogueHidden( hid_t group_id, int *status );
+hsize_t dat1CatalogueIndex( hid_t group_id, H5_index_t idxtype, hsize_t idx,
+                            int *status );
+hdsbool_t dat1IsDefined( hid_t dataset_id, Handle *handle, int *status );
+void dat1MarkDefined( hid_t dataset_id, Handle *handle, int *status );
+hdsbool_t dat1WriteChunks( const HDSLoc *locator, hid_t memtype_id,
+                           const void *values, int *status );
+hdsbool_t dat1ReadChunks( const HDSLoc *locator, hid_t memtype_id,
+                          void *values, int *status );
+void dat1ScopeBegin( int *status );
+HDSLoc **dat1ScopeEnd( int *nloc, int *status );
+void dat1ScopeAdd( HDSLoc *locator, int *status );
+void dat1ScopeRemove( HDSLoc *locator );
+void *dat1PoolAlloc( int pool, int *status );
+void dat1PoolFree( int pool, void *obj );
+hdsbool_t dat1MetaCached( const Handle *handle, int item );
+void dat1MetaStore( Handle *handle, int item );
+void dat1MetaInvalidate( Handle *handle, int items, hdsbool_t recurse );
+void dat1MetaStats( size_t *hits, size_t *misses );
+hdsbool_t dat1MetaIsAbsent( Handle *handle, const char *name );
+void dat1MetaSetAbsent( Handle *handle, const char *name );
+void dat1MetaClearAbsent( Handle *handle );
 
 /* DAT1_H_INCLUDED */
 #endif
@@ -28,6 +28,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -36,6 +37,10 @@
 *  History:
 *     2014-08-26 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Get locators from a pool rather than allocating each one.
+*     2026-10-16 (AGENT):
+*        Add the new locator to the current hdsBegin scope, if any.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -94,14 +99,19 @@ dat1AllocLoc( int * status ) {
   HDSLoc * newloc;
   if (*status != SAI__OK) return NULL;
 
-  newloc = MEM_CALLOC( 1, sizeof(*newloc) );
+  newloc = dat1PoolAlloc( HDS__POOL_LOC, status );
 
   if (!newloc) {
-    *status = DAT__NOMEM;
+    if (*status == SAI__OK) *status = DAT__NOMEM;
     emsRep("dat1AllocLoc", "Could not allocate memory for HDS locator",
            status );
+  } else {
+    /* Force the implementation version into the struct */
+    newloc->hds_version = 5;
+
+    /* Add it to the current hdsBegin scope, if any. */
+    dat1ScopeAdd( newloc, status );
+    if (*status != SAI__OK) newloc = dat1FreeLoc( newloc, status );
   }
-  /* Force the implementation version into the struct */
-  newloc->hds_version = 5;
   return newloc;
 }
@@ -33,6 +33,7 @@
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -69,6 +70,15 @@
 *        When the last primary locator is annulled, close all HDF5 
 *        identifiers associated with the file, not just the file identifier 
 *        in the supplied locator.
+*     2026-10-16 (AGENT):
+*        Free any group name and mapping details held by the locator.
+*     2026-10-16 (AGENT):
+*        Retain the hdsBegin scope details when clearing an annulled locator.
+*     2026-10-16 (AGENT):
+*        Release the parent group reference held by a locator whose object was
+*        never opened.
+*     2026-10-16 (AGENT):
+*        Write a catalogue to the file before closing it, if required.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -176,6 +186,11 @@ int dat1Annul( HDSLoc *locator, int * status ) {
 /* If required, close all HDF5 identifiers associated with the file. */
    if( file_id ) {
 
+/* First write a new catalogue of the file's contents if the file has
+   been modified and needs one. There is no point doing this for a file
+   that is about to be erased. */
+      if( !erase ) dat1CatalogueWrite( file_id, hdsFile, status );
+
 /* Get the number of active HDF5 identifiers of any type associated with
    the file. */
       cnt = H5Fget_obj_count( file_id, H5F_OBJ_ALL );
@@ -266,7 +281,9 @@ int dat1Annul( HDSLoc *locator, int * status ) {
 static void dat1Anloc( HDSLoc *locator, int * status ) {
 
 /* Local Variables: */
+   HdsScope *scope;
    hdsbool_t ingrp = 0;
+   int iscope;
    int ver;
 
 /* Return if a null locator is supplied, but do not check the inherited
@@ -316,19 +333,34 @@ static void dat1Anloc( HDSLoc *locator, int * status ) {
       locator->group_id = 0;
    }
 
+/* Release the parent group held by a locator whose object was never
+   opened. */
+   dat1CloseDeferred( locator );
+
 /* Nullify the pointer to the structure holding lists of locators
    associated with the same container file. */
    locator->hdsFile = NULL;
 
+/* Free any group name and mapping details (the latter should already
+   have been freed by datUnmap). */
+   if( locator->grpname ) MEM_FREE( locator->grpname );
+   if( locator->map ) MEM_FREE( locator->map );
+
 /* End the error context and return the final status */
    emsEnd( status  );
 
 /* Clear the locator but retain the version number. This is required to
    ensure that the locator is sent to the correct HDS implementation when
-   it is finally freed */
+   it is finally freed. Also retain the details of any hdsBegin scope that
+   owns the locator, so that it can be removed from the scope when it is
+   freed (or freed by hdsEnd). */
    ver = locator->hds_version;
+   scope = locator->scope;
+   iscope = locator->iscope;
    memset( locator, 0, sizeof(*locator) );
    locator->hds_version = ver;
+   locator->scope = scope;
+   locator->iscope = iscope;
 }
 
 
@@ -0,0 +1,653 @@
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "star/one.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+/* The functions in this file maintain an optional catalogue of the HDS
+   hierarchy in a container file, so that the contents of the file can be
+   listed (see datCatalogue) with a single read instead of opening every
+   object in it.
+
+   The catalogue is an HDF5 dataset holding one CatRecord for each object,
+   in the order that datWalk visits them. Each record holds the level,
+   name, type, shape, state and data size of an object. The full path to
+   an object is not stored, but is reconstructed from the names of the
+   preceding records with lower levels. The cells of a structure array
+   are recorded in Fortran order immediately after the array (each
+   followed by its contents), and so their subscripts can also be
+   reconstructed.
+
+   The dataset is linked into the root group with the name DAT__CATNAME.
+   This name is in lower case and so can never be the name of a
+   component, and the routines that list the components of a structure
+   (datNcomp, datIndex, datIterate and datWalk) skip over it (see
+   dat1CatalogueHidden and dat1CatalogueIndex).
+
+   The catalogue is not updated by each change to the file, since that
+   would take time proportional to the size of the file. Instead, the
+   root group holds a generation number, which is incremented by the
+   first change made to the file after it is opened (see
+   dat1CatalogueStale), and the catalogue records the generation number
+   of the file when it was written. A catalogue is only used if the two
+   are equal. If the CATALOGUE tuning parameter is set, a new catalogue
+   is written when a modified file is closed (see dat1CatalogueWrite,
+   called from dat1Annul). Otherwise any existing catalogue is left in
+   the file, but is no longer used. So a catalogue is only used if it is
+   up to date, unless the file has been modified by software that does
+   not maintain the generation number. As a simple check for this, the
+   number of top-level components in the catalogue must match the number
+   of components in the root group. */
+
+/* Flags used in the "flags" component of a CatRecord. */
+#define CAT__STRUC 1    /* Object is a structure */
+#define CAT__CELL 2     /* Object is a cell of a structure array */
+#define CAT__STATE 4    /* Primitive has a defined value */
+
+/* The description of a single object in the catalogue. The name is
+   blank for a cell. */
+typedef struct CatRecord {
+  char name[DAT__SZNAM+1];
+  char type[DAT__SZTYP+1];
+  int level;
+  int ndim;
+  hsize_t dims[DAT__MXDIM];
+  unsigned char flags;
+  uint64_t nbytes;
+} CatRecord;
+
+/* A growing list of records, used while writing a catalogue. */
+typedef struct CatList {
+  CatRecord *recs;
+  size_t nrec;
+  size_t maxrec;
+} CatList;
+
+/* The state of each level of the hierarchy while reading a catalogue. */
+typedef struct CatLevel {
+  const CatRecord *rec;  /* The most recent object at this level */
+  size_t pathlen;        /* Length of the path to its parent */
+  size_t ncell;          /* Number of its cells read so far */
+  char name[DAT__SZNAM+128]; /* Its name, with subscripts for a cell */
+} CatLevel;
+
+static hid_t dat1CatalogueType( hdsbool_t packed, int *status );
+static int dat1CatalogueAdd( const HDSWalkNode *node, void *data, int *status );
+static void dat1CatalogueDelete( hid_t file_id, int *status );
+static CatRecord *dat1CatalogueRead( hid_t file_id, size_t *nrec,
+                                     int *generation, int *status );
+
+/* Note that the container file holding the supplied locator is about to
+   be modified, incrementing the generation number of the file so that
+   any catalogue held in it is no longer used. This is cheap once the
+   file has been noted as modified, and so can be called by every routine
+   that changes the file. Nothing is done for files opened read-only,
+   since any attempt to change them will fail. */
+
+void dat1CatalogueStale( const HDSLoc *locator, int *status ) {
+  HdsFile *hdsFile;
+  int generation;
+  unsigned intent = 0;
+
+  if (*status != SAI__OK || !locator || !locator->hdsFile) return;
+  hdsFile = locator->hdsFile;
+
+  /* Quick return if the file is already known to have been changed. */
+  if (__atomic_load_n( &(hdsFile->catstale), __ATOMIC_ACQUIRE )) return;
+
+  pthread_mutex_lock( &(hdsFile->mutex) );
+
+  if (!hdsFile->catstale) {
+    CALLHDFQ( H5Fget_intent( locator->file_id, &intent ) );
+
+    if (intent != H5F_ACC_RDONLY) {
+      generation = dat1GetAttrInt( locator->file_id, HDS__ATTR_GENERATION,
+                                   HDS_TRUE, 0, status );
+      dat1SetAttrInt( locator->file_id, HDS__ATTR_GENERATION,
+                      generation < INT_MAX ? generation + 1 : 0, status );
+      if (*status == SAI__OK) {
+        __atomic_store_n( &(hdsFile->catstale), HDS_TRUE, __ATOMIC_RELEASE );
+      }
+    }
+  }
+
+ CLEANUP:
+  pthread_mutex_unlock( &(hdsFile->mutex) );
+}
+
+/* Write a new catalogue to a container file that is being closed, if it
+   has been modified and the CATALOGUE tuning parameter is set. The
+   catalogue is an optimisation, so any error that occurs while writing
+   it is annulled and the file is left without a catalogue. */
+
+void dat1CatalogueWrite( hid_t file_id, HdsFile *hdsFile, int *status ) {
+  CatList list;
+  char rootname[DAT__SZNAM+1];
+  hdsbool_t needroot;
+  hid_t dataset_id = 0;
+  hid_t filetype_id = 0;
+  hid_t memtype_id = 0;
+  hid_t root_id = 0;
+  hid_t space_id = 0;
+  hsize_t nrec;
+  htri_t exists;
+  int generation;
+  unsigned intent = 0;
+
+  if (*status != SAI__OK || !hdsFile || !file_id) return;
+
+  if (!hdsFile->catstale) return;
+  if (!hds1GetCatalogue()) return;
+
+  memset( &list, 0, sizeof(list) );
+  emsMark();
+
+  CALLHDFQ( H5Fget_intent( file_id, &intent ) );
+  if (intent == H5F_ACC_RDONLY) goto CLEANUP;
+
+  /* No catalogue is written if the top-level object is a primitive. */
+  needroot = dat1NeedsRootName( file_id, HDS_FALSE, rootname,
+                                sizeof(rootname), status );
+  if (!needroot) goto CLEANUP;
+
+  /* Describe every object in the file. */
+  CALLHDFE( hid_t, root_id,
+            H5Gopen2( file_id, "/", H5P_DEFAULT ),
+            DAT__HDF5E,
+            emsRep( " ", "Error opening root group to write catalogue",
+                    status )
+            );
+  dat1Walk( root_id, rootname, NULL, HDS_WALK_STATE, dat1CatalogueAdd,
+            &list, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  /* Remove any existing catalogue. */
+  CALLHDFE( htri_t, exists,
+            H5Lexists( root_id, DAT__CATNAME, H5P_DEFAULT ),
+            DAT__HDF5E,
+            emsRep( " ", "Error checking for the catalogue of an HDS "
+                    "container file", status )
+            );
+  if (exists > 0) dat1CatalogueDelete( file_id, status );
+
+  /* Write them to a new dataset in the root group. */
+  memtype_id = dat1CatalogueType( HDS_FALSE, status );
+  filetype_id = dat1CatalogueType( HDS_TRUE, status );
+  nrec = list.nrec;
+  CALLHDFE( hid_t, space_id,
+            H5Screate_simple( 1, &nrec, NULL ),
+            DAT__HDF5E,
+            emsRep( " ", "Error creating dataspace for catalogue", status )
+            );
+  CALLHDFE( hid_t, dataset_id,
+            H5Dcreate2( root_id, DAT__CATNAME, filetype_id, space_id,
+                        H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ),
+            DAT__HDF5E,
+            emsRep( " ", "Error creating catalogue dataset", status )
+            );
+  CALLHDFQ( H5Dwrite( dataset_id, memtype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                      list.recs ) );
+
+  /* Record the generation number of the file. */
+  generation = dat1GetAttrInt( root_id, HDS__ATTR_GENERATION, HDS_TRUE, 0,
+                               status );
+  dat1SetAttrInt( dataset_id, HDS__ATTR_GENERATION, generation, status );
+
+  hdsFile->catstale = HDS_FALSE;
+
+ CLEANUP:
+  if (*status != SAI__OK) {
+    if (dataset_id > 0) {
+      H5Dclose( dataset_id );
+      dataset_id = 0;
+      H5Ldelete( root_id, DAT__CATNAME, H5P_DEFAULT );
+    }
+    H5Eclear2( H5E_DEFAULT );
+    emsAnnul( status );
+  }
+  if (dataset_id > 0) H5Dclose( dataset_id );
+  if (space_id > 0) H5Sclose( space_id );
+  if (filetype_id > 0) H5Tclose( filetype_id );
+  if (memtype_id > 0) H5Tclose( memtype_id );
+  if (root_id > 0) H5Gclose( root_id );
+  if (list.recs) MEM_FREE( list.recs );
+  emsRlse();
+}
+
+/* Call the supplied function for the object identified by the supplied
+   locator and everything within it, using the catalogue in the
+   container file. The arguments and the descriptions passed to "func"
+   are the same as for datWalk. HDS_FALSE is returned, without calling
+   "func", if the file has no usable catalogue, if the catalogue does not
+   contain the object, or if the locator is a slice, a vectorised
+   primitive or an untouched structure cell. */
+
+hdsbool_t dat1CatalogueScan( const HDSLoc *locator,
+                             int (*func)( const HDSWalkNode *node, void *data, int *status ),
+                             void *data, int flags, int *status ) {
+  CatLevel *levels = NULL;
+  CatRecord *recs = NULL;
+  HDSWalkNode node;
+  H5G_info_t info;
+  char *path = NULL;
+  char *newpath;
+  char basepath[1024];
+  char cellname[128];
+  char file[1024];
+  const CatRecord *rec;
+  const char *tail;
+  hdsbool_t found = HDS_FALSE;
+  hdsdim coords[DAT__MXDIM];
+  hdsdim dims[DAT__MXDIM];
+  hdsdim pdims[DAT__MXDIM];
+  hsize_t ntop = 0;
+  int catgen = 0;
+  size_t baseoff = 0;
+  size_t i;
+  size_t len;
+  size_t maxpath = 0;
+  size_t nrec = 0;
+  int baselevel = -1;
+  int j;
+  int level;
+  int limit = 0;
+  int maxlevel = 0;
+  int nlev;
+  int skiplevel = -1;
+
+  if (*status != SAI__OK) return HDS_FALSE;
+
+  if (locator->vectorized || locator->isslice || locator->isemptycell) {
+    return HDS_FALSE;
+  }
+  if (locator->hdsFile &&
+      __atomic_load_n( &(locator->hdsFile->catstale), __ATOMIC_ACQUIRE )) {
+    return HDS_FALSE;
+  }
+
+  emsMark();
+
+  /* Read the catalogue and check that it is consistent with the file.
+     It must have been written at the current generation of the file,
+     each level must be at most one more than the previous level, each
+     cell must be within a structure array, and the number of top-level
+     components must match the number of links in the root group (which
+     include the catalogue itself). */
+  recs = dat1CatalogueRead( locator->file_id, &nrec, &catgen, status );
+  if (!recs || nrec == 0 || recs[0].level != 0) goto CLEANUP;
+  if (catgen != dat1GetAttrInt( locator->file_id, HDS__ATTR_GENERATION,
+                                HDS_TRUE, 0, status )) goto CLEANUP;
+
+  for (i = 0; i < nrec; i++) {
+    level = recs[i].level;
+    if (level < 0 || level > limit || recs[i].ndim < 0 ||
+        recs[i].ndim > DAT__MXDIM) goto CLEANUP;
+    if (level == 0 && i > 0) goto CLEANUP;
+    if (level == 1) ntop++;
+    if (level > maxlevel) maxlevel = level;
+    limit = level + 1;
+  }
+
+  CALLHDFQ( H5Gget_info_by_name( locator->file_id, "/", &info, H5P_DEFAULT ) );
+  if (info.nlinks != ntop + 1) goto CLEANUP;
+
+  /* Get the path to the supplied object, in the same form as the paths
+     in the catalogue. The path to the object relative to itself starts
+     after the last "." (cell subscripts do not include any "."). */
+  hdsTrace( locator, &nlev, basepath, file, status, sizeof(basepath),
+            sizeof(file) );
+  if (*status != SAI__OK) goto CLEANUP;
+  tail = strrchr( basepath, '.' );
+  baseoff = tail ? tail - basepath + 1 : 0;
+
+  levels = MEM_CALLOC( maxlevel + 2, sizeof(*levels) );
+  if (!levels) {
+    *status = DAT__NOMEM;
+    emsRep( " ", "Could not allocate memory to read a catalogue", status );
+    goto CLEANUP;
+  }
+
+  for (i = 0; i < nrec && *status == SAI__OK; i++) {
+    rec = recs + i;
+    level = rec->level;
+
+    /* Form the name of the object. The subscripts of a cell are found
+       by counting the cells of the parent array. */
+    if (rec->flags & CAT__CELL) {
+      if (level == 0 || !levels[ level - 1 ].rec ||
+          levels[ level - 1 ].rec->ndim == 0) goto CLEANUP;
+      for (j = 0; j < levels[ level - 1 ].rec->ndim; j++) {
+        pdims[ j ] = levels[ level - 1 ].rec->dims[ j ];
+      }
+      dat1Index2Coords( ++(levels[ level - 1 ].ncell),
+                        levels[ level - 1 ].rec->ndim, pdims, coords, status );
+      dat1Coords2CellName( levels[ level - 1 ].rec->ndim, coords, cellname,
+                           sizeof(cellname), status );
+      one_snprintf( levels[ level ].name, sizeof(levels[ level ].name),
+                    "%s%s", status, levels[ level - 1 ].name,
+                    strchr( cellname, '(' ) );
+      tail = strchr( cellname, '(' );
+    } else {
+      one_strlcpy( levels[ level ].name, rec->name,
+                   sizeof(levels[ level ].name), status );
+      tail = rec->name;
+    }
+    if (*status != SAI__OK) break;
+
+    /* Form the path to the object. */
+    len = levels[ level ].pathlen + strlen( tail ) + 2;
+    if (len > maxpath) {
+      newpath = MEM_REALLOC( path, 2*len );
+      if (!newpath) {
+        *status = DAT__NOMEM;
+        emsRep( " ", "Could not allocate memory to read a catalogue",
+                status );
+        break;
+      }
+      path = newpath;
+      maxpath = 2*len;
+    }
+    path[ levels[ level ].pathlen ] = 0;
+    if (level > 0 && !(rec->flags & CAT__CELL)) strcat( path, "." );
+    strcat( path, tail );
+
+    levels[ level ].rec = rec;
+    levels[ level ].ncell = 0;
+    levels[ level + 1 ].pathlen = strlen( path );
+
+    /* Find the supplied object, and then report it and everything within
+       it. */
+    if (baselevel < 0) {
+      if (strcmp( path, basepath )) continue;
+      baselevel = level;
+      found = HDS_TRUE;
+    } else if (level <= baselevel) {
+      break;
+    } else if (skiplevel >= 0 && level > skiplevel) {
+      continue;
+    } else if ((flags & HDS_WALK_NOCELLS) && (rec->flags & CAT__CELL)) {
+      skiplevel = level;
+      continue;
+    }
+    skiplevel = -1;
+
+    memset( &node, 0, sizeof(node) );
+    for (j = 0; j < rec->ndim; j++) dims[ j ] = rec->dims[ j ];
+    node.name = levels[ level ].name;
+    node.path = path + baseoff;
+    node.type = rec->type;
+    node.level = level - baselevel;
+    node.ndim = rec->ndim;
+    node.dims = dims;
+    node.isstruc = ( rec->flags & CAT__STRUC ) ? HDS_TRUE : HDS_FALSE;
+    node.iscell = ( rec->flags & CAT__CELL ) ? HDS_TRUE : HDS_FALSE;
+    if (flags & HDS_WALK_STATE) {
+      node.state = ( rec->flags & CAT__STATE ) ? HDS_TRUE : HDS_FALSE;
+    }
+    node.nbytes = rec->nbytes;
+    if (func( &node, data, status )) break;
+  }
+
+ CLEANUP:
+  if (recs) MEM_FREE( recs );
+  if (levels) MEM_FREE( levels );
+  if (path) MEM_FREE( path );
+
+  /* Errors from reading the catalogue mean it cannot be used, but errors
+     reported by "func" are passed on. */
+  if (*status != SAI__OK && !found) {
+    H5Eclear2( H5E_DEFAULT );
+    emsAnnul( status );
+  }
+  emsRlse();
+
+  return found;
+}
+
+/* Return the number of links in the supplied group that are not
+   components of the structure it holds. This is one for the root group
+   of a file holding a catalogue, and zero for any other group. */
+
+int dat1CatalogueHidden( hid_t group_id, int *status ) {
+  htri_t exists;
+
+  if (*status != SAI__OK) return 0;
+
+  CALLHDFE( htri_t, exists,
+            H5Lexists( group_id, DAT__CATNAME, H5P_DEFAULT ),
+            DAT__HDF5E,
+            emsRep( " ", "Error checking for the catalogue of an HDS "
+                    "container file", status )
+            );
+
+ CLEANUP:
+  return ( *status == SAI__OK && exists > 0 ) ? 1 : 0;
+}
+
+/* Return the zero-based position, within the supplied index of the
+   links in a group, of the link for the component at the supplied
+   zero-based position in the structure held in the group. The two
+   differ by one if the group holds a catalogue that precedes the
+   component in the index. */
+
+hsize_t dat1CatalogueIndex( hid_t group_id, H5_index_t idxtype, hsize_t idx,
+                            int *status ) {
+  H5L_info_t catinfo;
+  H5L_info_t info;
+  char name[2*DAT__SZNAM+1];
+  hsize_t result = idx;
+  ssize_t lenstr;
+
+  if (*status != SAI__OK) return result;
+  if (!dat1CatalogueHidden( group_id, status )) return result;
+
+  /* The catalogue precedes the component if it precedes the link that
+     is currently at the requested position. */
+  if (idxtype == H5_INDEX_CRT_ORDER) {
+    CALLHDFQ( H5Lget_info( group_id, DAT__CATNAME, &catinfo, H5P_DEFAULT ) );
+    CALLHDFQ( H5Lget_info_by_idx( group_id, ".", idxtype, H5_ITER_INC, idx,
+                                  &info, H5P_DEFAULT ) );
+    if (catinfo.corder <= info.corder) result++;
+  } else {
+    CALLHDFE( ssize_t, lenstr,
+              H5Lget_name_by_idx( group_id, ".", idxtype, H5_ITER_INC, idx,
+                                  name, sizeof(name), H5P_DEFAULT ),
+              DAT__HDF5E,
+              emsRep( " ", "Error obtaining the name of a component", status )
+              );
+    if (strcmp( DAT__CATNAME, name ) <= 0) result++;
+  }
+
+ CLEANUP:
+  return result;
+}
+
+/* Return an HDF5 compound data type describing a CatRecord. If "packed"
+   is true, the type is packed to remove any padding, for use in the
+   file. */
+
+static hid_t dat1CatalogueType( hdsbool_t packed, int *status ) {
+  hid_t dims_id = 0;
+  hid_t name_id = 0;
+  hid_t type_id = 0;
+  hid_t result = 0;
+  hsize_t mxdim = DAT__MXDIM;
+
+  if (*status != SAI__OK) return 0;
+
+  CALLHDFE( hid_t, name_id,
+            H5Tcopy( H5T_C_S1 ),
+            DAT__HDF5E,
+            emsRep( " ", "Error creating catalogue data type", status )
+            );
+  CALLHDFQ( H5Tset_size( name_id, DAT__SZNAM+1 ) );
+  CALLHDFE( hid_t, type_id,
+            H5Tcopy( H5T_C_S1 ),
+            DAT__HDF5E,
+            emsRep( " ", "Error creating catalogue data type", status )
+            );
+  CALLHDFQ( H5Tset_size( type_id, DAT__SZTYP+1 ) );
+  CALLHDFE( hid_t, dims_id,
+            H5Tarray_create2( H5T_NATIVE_HSIZE, 1, &mxdim ),
+            DAT__HDF5E,
+            emsRep( " ", "Error creating catalogue data type", status )
+            );
+
+  CALLHDFE( hid_t, result,
+            H5Tcreate( H5T_COMPOUND, sizeof(CatRecord) ),
+            DAT__HDF5E,
+            emsRep( " ", "Error creating catalogue data type", status )
+            );
+  CALLHDFQ( H5Tinsert( result, "name", HOFFSET(CatRecord, name), name_id ) );
+  CALLHDFQ( H5Tinsert( result, "type", HOFFSET(CatRecord, type), type_id ) );
+  CALLHDFQ( H5Tinsert( result, "level", HOFFSET(CatRecord, level),
+                       H5T_NATIVE_INT ) );
+  CALLHDFQ( H5Tinsert( result, "ndim", HOFFSET(CatRecord, ndim),
+                       H5T_NATIVE_INT ) );
+  CALLHDFQ( H5Tinsert( result, "dims", HOFFSET(CatRecord, dims), dims_id ) );
+  CALLHDFQ( H5Tinsert( result, "flags", HOFFSET(CatRecord, flags),
+                       H5T_NATIVE_UCHAR ) );
+  CALLHDFQ( H5Tinsert( result, "nbytes", HOFFSET(CatRecord, nbytes),
+                       H5T_NATIVE_UINT64 ) );
+  if (packed) CALLHDFQ( H5Tpack( result ) );
+
+ CLEANUP:
+  if (name_id > 0) H5Tclose( name_id );
+  if (type_id > 0) H5Tclose( type_id );
+  if (dims_id > 0) H5Tclose( dims_id );
+  if (*status != SAI__OK && result > 0) {
+    H5Tclose( result );
+    result = 0;
+  }
+  return result;
+}
+
+/* Called by dat1Walk to append the description of an object to a list
+   of records. */
+
+static int dat1CatalogueAdd( const HDSWalkNode *node, void *data, int *status ) {
+  CatList *list = data;
+  CatRecord *rec;
+  int i;
+
+  if (*status != SAI__OK) return 1;
+
+  if (list->nrec == list->maxrec) {
+    rec = MEM_REALLOC( list->recs, (2*list->maxrec + 256)*sizeof(*rec) );
+    if (!rec) {
+      *status = DAT__NOMEM;
+      emsRep( " ", "Could not allocate memory for a catalogue", status );
+      return 1;
+    }
+    list->recs = rec;
+    list->maxrec = 2*list->maxrec + 256;
+  }
+
+  rec = list->recs + list->nrec++;
+  memset( rec, 0, sizeof(*rec) );
+  if (!node->iscell) one_strlcpy( rec->name, node->name, sizeof(rec->name),
+                                  status );
+  one_strlcpy( rec->type, node->type, sizeof(rec->type), status );
+  rec->level = node->level;
+  rec->ndim = node->ndim;
+  for (i = 0; i < node->ndim; i++) rec->dims[i] = node->dims[i];
+  if (node->isstruc) rec->flags |= CAT__STRUC;
+  if (node->iscell) rec->flags |= CAT__CELL;
+  if (node->state) rec->flags |= CAT__STATE;
+  rec->nbytes = node->nbytes;
+
+  return 0;
+}
+
+/* Delete the catalogue from a container file. */
+
+static void dat1CatalogueDelete( hid_t file_id, int *status ) {
+
+  if (*status != SAI__OK) return;
+
+  CALLHDFQ( H5Ldelete( file_id, "/" DAT__CATNAME, H5P_DEFAULT ) );
+
+ CLEANUP:
+  return;
+}
+
+/* Read the records from the catalogue in a container file, returning a
+   pointer to an array that should be freed using MEM_FREE, and the
+   generation number of the file when the catalogue was written. NULL is
+   returned if the file has no catalogue. */
+
+static CatRecord *dat1CatalogueRead( hid_t file_id, size_t *nrec,
+                                     int *generation, int *status ) {
+  CatRecord *result = NULL;
+  hid_t dataset_id = 0;
+  hid_t memtype_id = 0;
+  hid_t space_id = 0;
+  hssize_t npoints;
+  htri_t exists;
+
+  *nrec = 0;
+  *generation = -1;
+  if (*status != SAI__OK) return NULL;
+
+  CALLHDFE( htri_t, exists,
+            H5Lexists( file_id, "/" DAT__CATNAME, H5P_DEFAULT ),
+            DAT__HDF5E,
+            emsRep( " ", "Error checking for the catalogue of an HDS "
+                    "container file", status )
+            );
+  if (!exists) goto CLEANUP;
+
+  CALLHDFE( hid_t, dataset_id,
+            H5Dopen2( file_id, "/" DAT__CATNAME, H5P_DEFAULT ),
+            DAT__HDF5E,
+            emsRep( " ", "Error opening the catalogue of an HDS container "
+                    "file", status )
+            );
+
+  CALLHDFE( hid_t, space_id,
+            H5Dget_space( dataset_id ),
+            DAT__HDF5E,
+            emsRep( " ", "Error reading the catalogue of an HDS container "
+                    "file", status )
+            );
+  CALLHDFE( hssize_t, npoints,
+            H5Sget_simple_extent_npoints( space_id ),
+            DAT__HDF5E,
+            emsRep( " ", "Error reading the catalogue of an HDS container "
+                    "file", status )
+            );
+
+  result = MEM_MALLOC( (npoints > 0 ? npoints : 1)*sizeof(*result) );
+  if (!result) {
+    *status = DAT__NOMEM;
+    emsRep( " ", "Could not allocate memory to read a catalogue", status );
+    goto CLEANUP;
+  }
+
+  memtype_id = dat1CatalogueType( HDS_FALSE, status );
+  CALLHDFQ( H5Dread( dataset_id, memtype_id, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                     result ) );
+  *nrec = npoints;
+  *generation = dat1GetAttrInt( dataset_id, HDS__ATTR_GENERATION, HDS_TRUE,
+                                -1, status );
+
+ CLEANUP:
+  if (memtype_id > 0) H5Tclose( memtype_id );
+  if (space_id > 0) H5Sclose( space_id );
+  if (dataset_id > 0) H5Dclose( dataset_id );
+  if (*status != SAI__OK && result) {
+    MEM_FREE( result );
+    result = NULL;
+    *nrec = 0;
+  }
+  return result;
+}
@@ -0,0 +1,933 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "dat_err.h"
+
+/* When a chunked dataset uses filters, H5Dwrite and H5Dread apply them to
+   one chunk at a time in the calling thread, and hold the HDF5 library
+   lock while doing so. The functions in this file instead compress or
+   decompress the chunks on several threads (see the NTHREADS tuning
+   parameter), while the calling thread passes each chunk to or from
+   HDF5 using H5Dwrite_chunk or H5Dread_chunk. Only the calling thread
+   ever calls HDF5.
+
+   When writing, the data are divided into chunks which are compressed
+   by the worker threads and written, in order, as soon as they are
+   ready. When reading, the calling thread reads the raw bytes of each
+   chunk that holds any of the selected elements, and the worker threads
+   decompress them and copy the selected elements into the caller's
+   buffer.
+
+   This is only possible for the filters that HDS can apply itself -
+   deflate, shuffle and Fletcher32 - which are applied in the order
+   recorded in the dataset creation properties, in exactly the same way
+   as HDF5 applies them. Datasets that use any other filter (e.g.
+   scale-offset) are left to HDF5.
+
+   At most HDS__CHUNKWINDOW chunks per thread are held in memory waiting
+   to be written or decompressed, which limits the memory used. */
+
+/* Number of chunks per thread that may be waiting to be written or
+   decompressed. */
+#define HDS__CHUNKWINDOW 4
+
+/* Largest number of filters that can be applied by HDS */
+#define HDS__MXFILTER 4
+
+/* A chunk waiting to be written or decompressed */
+typedef struct {
+  void *data;           /* Filtered data, or NULL */
+  size_t nbytes;        /* Number of bytes in "data" */
+  unsigned int mask;    /* Filters that were not applied to the chunk */
+  hdsbool_t ready;      /* Is the chunk waiting to be used? */
+} ChunkSlot;
+
+/* Everything needed to move data between a buffer and the chunks of a
+   dataset */
+typedef struct {
+  const char *values;   /* Data for the whole dataset (writing) */
+  char *out;            /* Buffer for the selected elements (reading) */
+  int rank;             /* Number of HDF5 axes */
+  hsize_t dims[DAT__MXDIM];     /* Dataset dimensions (HDF5 order) */
+  hsize_t chunk[DAT__MXDIM];    /* Chunk dimensions (HDF5 order) */
+  hsize_t start[DAT__MXDIM];    /* First selected element on each axis */
+  hsize_t end[DAT__MXDIM];      /* Last selected element on each axis */
+  hsize_t first[DAT__MXDIM];    /* First chunk used on each axis */
+  hsize_t nchunks[DAT__MXDIM];  /* Number of chunks used on each axis */
+  size_t typsize;       /* Number of bytes per element */
+  size_t chunkbytes;    /* Number of bytes in an uncompressed chunk */
+  size_t nchunk;        /* Total number of chunks used */
+  char fill[64];        /* Fill value for padding and missing chunks */
+  int nfilter;          /* Number of filters */
+  H5Z_filter_t filter[HDS__MXFILTER]; /* Filters in pipeline order */
+  int level;            /* Deflate compression level */
+
+  pthread_mutex_t mutex; /* Protects the following fields */
+  pthread_cond_t cond;  /* Signalled when any of them change */
+  size_t claim;         /* Index of the next chunk to claim */
+  size_t next;          /* Index of the next chunk to write or read */
+  size_t ndone;         /* Number of chunks decompressed */
+  size_t window;        /* Number of slots */
+  ChunkSlot *slots;     /* Chunk "i" uses slot "i % window" */
+  int failed;           /* Non-zero if a thread failed */
+  hdsbool_t abort;      /* Should the threads stop? */
+} ChunkJob;
+
+static hdsbool_t dat1ChunkSetup( const HDSLoc *locator, hid_t memtype_id,
+                                 hid_t dcpl, ChunkJob *job, int *status );
+static hdsbool_t dat1ChunkFilters( hid_t dcpl, ChunkJob *job, int *status );
+static int dat1ChunkStart( ChunkJob *job, void *(*worker)( void * ),
+                           pthread_t threads[], int *status );
+static void dat1ChunkStop( ChunkJob *job, pthread_t threads[],
+                           int nworker );
+static void dat1ChunkOffset( const ChunkJob *job, size_t ichunk,
+                             hsize_t offset[] );
+static void dat1ChunkGather( const ChunkJob *job, const hsize_t offset[],
+                             char *buf );
+static void dat1ChunkScatter( const ChunkJob *job, const hsize_t offset[],
+                              const char *buf );
+static void *dat1ChunkEncode( const ChunkJob *job, char *buf, char *work,
+                              size_t *nbytes );
+static const char *dat1ChunkDecode( const ChunkJob *job,
+                                    const ChunkSlot *slot, char *buf,
+                                    char *work );
+static uint32_t dat1Fletcher32( const unsigned char *data, size_t len );
+static void *dat1ChunkWriter( void *data );
+static void *dat1ChunkReader( void *data );
+
+/* Write all the values of a chunked and filtered dataset using several
+   threads to compress the chunks. The supplied values must be of the
+   same type as the dataset, and the locator must refer to every element
+   of the dataset (in its natural order). Returns HDS_FALSE without
+   writing anything if any of these conditions is not met, if only one
+   thread is to be used, or if the dataset only has one chunk, in which
+   case the caller should write the values using H5Dwrite. */
+
+hdsbool_t dat1WriteChunks( const HDSLoc *locator, hid_t memtype_id,
+                           const void *values, int *status ) {
+  ChunkJob job;
+  ChunkSlot *slot;
+  hdsbool_t result = HDS_FALSE;
+  hid_t dcpl = 0;
+  hsize_t offset[DAT__MXDIM];
+  int i;
+  int nworker;
+  pthread_t threads[HDS__MXTHREADS];
+  size_t ichunk;
+
+  if (*status != SAI__OK) return result;
+
+  /* Direct chunk writes need HDF5 1.10.3 or later */
+#if !H5_VERSION_GE(1,10,3)
+  return result;
+#else
+
+  if (hds1GetNThreads() < 2) return result;
+
+  memset( &job, 0, sizeof(job) );
+  job.values = values;
+
+  CALLHDFE( hid_t, dcpl,
+            H5Dget_create_plist( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep( "dat1WriteChunks_1", "Error obtaining the creation "
+                    "properties of an HDF5 dataset", status )
+          );
+  if (!dat1ChunkSetup( locator, memtype_id, dcpl, &job, status )) {
+    goto CLEANUP;
+  }
+
+  /* Every element must be written */
+  for (i = 0; i < job.rank; i++) {
+    if (job.start[i] != 0 || job.end[i] + 1 != job.dims[i]) goto CLEANUP;
+  }
+
+  /* From here on the values are written by this function */
+  result = HDS_TRUE;
+  nworker = dat1ChunkStart( &job, dat1ChunkWriter, threads, status );
+
+  /* Write each chunk in turn as soon as it has been compressed. The lock
+     is not held while writing, so that the next chunk can be claimed. */
+  for (ichunk = 0; ichunk < job.nchunk && *status == SAI__OK; ichunk++) {
+    slot = job.slots + ( ichunk % job.window );
+
+    pthread_mutex_lock( &job.mutex );
+    while (!slot->ready && !job.failed) {
+      pthread_cond_wait( &job.cond, &job.mutex );
+    }
+    pthread_mutex_unlock( &job.mutex );
+
+    if (job.failed) {
+      *status = job.failed;
+      if (*status == DAT__NOMEM) {
+        emsRep( "dat1WriteChunks_2", "Unable to allocate memory for "
+                "compressed chunks", status );
+      } else {
+        emsRep( "dat1WriteChunks_3", "Error compressing a chunk of "
+                "an HDF5 dataset", status );
+      }
+      break;
+    }
+
+    dat1ChunkOffset( &job, ichunk, offset );
+    if (H5Dwrite_chunk( locator->dataset_id, H5P_DEFAULT, 0, offset,
+                        slot->nbytes, slot->data ) < 0) {
+      *status = DAT__HDF5E;
+      dat1H5EtoEMS( status );
+      emsRep( "dat1WriteChunks_4", "Error writing a chunk of an HDF5 "
+              "dataset", status );
+    }
+
+    pthread_mutex_lock( &job.mutex );
+    MEM_FREE( slot->data );
+    slot->data = NULL;
+    slot->ready = HDS_FALSE;
+    job.next = ichunk + 1;
+    pthread_cond_broadcast( &job.cond );
+    pthread_mutex_unlock( &job.mutex );
+  }
+
+  dat1ChunkStop( &job, threads, nworker );
+
+ CLEANUP:
+  if (dcpl > 0) H5Pclose( dcpl );
+  return result;
+#endif
+}
+
+/* Read the values selected by a locator from a chunked and filtered
+   dataset, using several threads to decompress the chunks. The values
+   are returned in the type of the dataset, which must be the same as the
+   supplied memory type. The selection may be the whole dataset or any
+   single hyperslab within it (e.g. from datSlice). Returns HDS_FALSE
+   without reading anything if any of these conditions is not met, if
+   only one thread is to be used, or if the selection lies within a
+   single chunk, in which case the caller should read the values using
+   H5Dread. */
+
+hdsbool_t dat1ReadChunks( const HDSLoc *locator, hid_t memtype_id,
+                          void *values, int *status ) {
+  ChunkJob job;
+  ChunkSlot *slot;
+  haddr_t addr;
+  hdsbool_t result = HDS_FALSE;
+  hid_t dcpl = 0;
+  hsize_t nbytes;
+  hsize_t offset[DAT__MXDIM];
+  int nworker;
+  pthread_t threads[HDS__MXTHREADS];
+  size_t ichunk;
+  unsigned int mask;
+
+  if (*status != SAI__OK) return result;
+
+  /* Chunk queries need HDF5 1.10.5 or later */
+#if !H5_VERSION_GE(1,10,5)
+  return result;
+#else
+
+  if (hds1GetNThreads() < 2) return result;
+
+  memset( &job, 0, sizeof(job) );
+  job.out = values;
+
+  CALLHDFE( hid_t, dcpl,
+            H5Dget_create_plist( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep( "dat1ReadChunks_1", "Error obtaining the creation "
+                    "properties of an HDF5 dataset", status )
+          );
+  if (!dat1ChunkSetup( locator, memtype_id, dcpl, &job, status )) {
+    goto CLEANUP;
+  }
+
+  /* From here on the values are read by this function */
+  result = HDS_TRUE;
+
+  /* Any chunks that HDF5 is holding in its cache must be in the file
+     before their raw bytes can be read. */
+  CALLHDFQ( H5Dflush( locator->dataset_id ) );
+
+  nworker = dat1ChunkStart( &job, dat1ChunkReader, threads, status );
+
+  /* Read the raw bytes of each chunk into a free slot. Chunks that have
+     not been written hold the fill value. The lock is not held while
+     reading, so that other chunks can be decompressed. */
+  for (ichunk = 0; ichunk < job.nchunk && *status == SAI__OK; ichunk++) {
+    slot = job.slots + ( ichunk % job.window );
+
+    pthread_mutex_lock( &job.mutex );
+    while (slot->ready && !job.failed) {
+      pthread_cond_wait( &job.cond, &job.mutex );
+    }
+    pthread_mutex_unlock( &job.mutex );
+    if (job.failed) break;
+
+    dat1ChunkOffset( &job, ichunk, offset );
+    mask = 0;
+    addr = HADDR_UNDEF;
+    nbytes = 0;
+    if (H5Dget_chunk_info_by_coord( locator->dataset_id, offset, &mask,
+                                    &addr, &nbytes ) < 0) {
+      *status = DAT__HDF5E;
+    } else if (addr != HADDR_UNDEF && nbytes > 0) {
+      slot->data = MEM_MALLOC( nbytes );
+      if (!slot->data) {
+        *status = DAT__NOMEM;
+        emsRep( "dat1ReadChunks_2", "Unable to allocate memory for "
+                "compressed chunks", status );
+      } else if (H5Dread_chunk( locator->dataset_id, H5P_DEFAULT, offset,
+                                &mask, slot->data ) < 0) {
+        *status = DAT__HDF5E;
+      }
+    }
+    if (*status == DAT__HDF5E) {
+      dat1H5EtoEMS( status );
+      emsRep( "dat1ReadChunks_3", "Error reading a chunk of an HDF5 "
+              "dataset", status );
+    }
+    if (*status != SAI__OK) break;
+
+    pthread_mutex_lock( &job.mutex );
+    slot->nbytes = nbytes;
+    slot->mask = mask;
+    slot->ready = HDS_TRUE;
+    job.next = ichunk + 1;
+    pthread_cond_broadcast( &job.cond );
+    pthread_mutex_unlock( &job.mutex );
+  }
+
+  /* Wait for the remaining chunks to be decompressed */
+  pthread_mutex_lock( &job.mutex );
+  while (*status == SAI__OK && job.ndone < job.nchunk && !job.failed) {
+    pthread_cond_wait( &job.cond, &job.mutex );
+  }
+  pthread_mutex_unlock( &job.mutex );
+
+  if (*status == SAI__OK && job.failed) {
+    *status = job.failed;
+    if (*status == DAT__NOMEM) {
+      emsRep( "dat1ReadChunks_4", "Unable to allocate memory for "
+              "decompressed chunks", status );
+    } else {
+      emsRep( "dat1ReadChunks_5", "Error decompressing a chunk of "
+              "an HDF5 dataset (the data may be corrupt)", status );
+    }
+  }
+
+  dat1ChunkStop( &job, threads, nworker );
+
+ CLEANUP:
+  if (dcpl > 0) H5Pclose( dcpl );
+  return result;
+#endif
+}
+
+/* Check that the chunks of a dataset can be filtered by HDS, and store
+   the chunk shape, filters, element size, fill value and the bounds of
+   the elements selected by the locator in the supplied structure.
+   Returns HDS_FALSE if the chunks can not be filtered by HDS, if the
+   values need type conversion, if the selection is not a single
+   hyperslab, or if it lies within a single chunk. */
+
+static hdsbool_t dat1ChunkSetup( const HDSLoc *locator, hid_t memtype_id,
+                                 hid_t dcpl, ChunkJob *job, int *status ) {
+  hdsbool_t result = HDS_FALSE;
+  hid_t filespace = 0;
+  hid_t filetype = 0;
+  hsize_t nbox;
+  hssize_t nsel;
+  int i;
+
+  if (*status != SAI__OK) return result;
+
+  if (H5Pget_layout( dcpl ) != H5D_CHUNKED) return result;
+  if (!dat1ChunkFilters( dcpl, job, status )) return result;
+
+  /* The values must not need converting */
+  CALLHDFE( hid_t, filetype,
+            H5Dget_type( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep( "dat1ChunkSetup_1", "Error obtaining the data type "
+                    "of an HDF5 dataset", status )
+          );
+  if (H5Tequal( filetype, memtype_id ) <= 0) goto CLEANUP;
+  job->typsize = H5Tget_size( filetype );
+  if (job->typsize == 0 || job->typsize > sizeof(job->fill)) goto CLEANUP;
+
+  /* Get the shape of the dataset and its chunks */
+  CALLHDFE( hid_t, filespace,
+            H5Dget_space( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep( "dat1ChunkSetup_2", "Error obtaining the data space "
+                    "of an HDF5 dataset", status )
+          );
+  job->rank = H5Sget_simple_extent_dims( filespace, job->dims, NULL );
+  if (job->rank < 1 || job->rank > DAT__MXDIM ||
+      H5Pget_chunk( dcpl, job->rank, job->chunk ) != job->rank) {
+    goto CLEANUP;
+  }
+
+  /* The elements selected by the locator must fill the box that bounds
+     them. The selection of a vectorized locator has rank 1, so it can
+     only be used if the dataset also has rank 1 or every element is
+     selected. */
+  nsel = H5Sget_select_npoints( locator->dataspace_id );
+  if (nsel <= 0) goto CLEANUP;
+  if (H5Sget_simple_extent_ndims( locator->dataspace_id ) == job->rank) {
+    if (H5Sget_select_bounds( locator->dataspace_id, job->start,
+                              job->end ) < 0) {
+      H5Eclear2( H5E_DEFAULT );
+      goto CLEANUP;
+    }
+  } else if (nsel == H5Sget_simple_extent_npoints( filespace )) {
+    for (i = 0; i < job->rank; i++) {
+      job->start[i] = 0;
+      job->end[i] = job->dims[i] - 1;
+    }
+  } else {
+    goto CLEANUP;
+  }
+  nbox = 1;
+  for (i = 0; i < job->rank; i++) nbox *= job->end[i] - job->start[i] + 1;
+  if ((hsize_t) nsel != nbox) goto CLEANUP;
+
+  /* Find the chunks that hold the selected elements */
+  job->nchunk = 1;
+  job->chunkbytes = job->typsize;
+  for (i = 0; i < job->rank; i++) {
+    job->first[i] = job->start[i] / job->chunk[i];
+    job->nchunks[i] = job->end[i] / job->chunk[i] - job->first[i] + 1;
+    job->nchunk *= job->nchunks[i];
+    job->chunkbytes *= job->chunk[i];
+  }
+  if (job->nchunk < 2) goto CLEANUP;
+
+  /* Edge chunks are padded with the fill value, as HDF5 would do */
+  CALLHDFQ( H5Pget_fill_value( dcpl, filetype, job->fill ) );
+
+  result = HDS_TRUE;
+
+ CLEANUP:
+  if (filespace > 0) H5Sclose( filespace );
+  if (filetype > 0) H5Tclose( filetype );
+  return ( *status == SAI__OK ) ? result : HDS_FALSE;
+}
+
+/* Store the filters used by a dataset in the supplied structure. Returns
+   HDS_FALSE if the dataset uses no filters, or uses a filter that can not
+   be applied by HDS. */
+
+static hdsbool_t dat1ChunkFilters( hid_t dcpl, ChunkJob *job, int *status ) {
+  H5Z_filter_t filter;
+  hdsbool_t deflate = HDS_FALSE;
+  hdsbool_t fletcher32 = HDS_FALSE;
+  int i;
+  int nfilter;
+  size_t nelmts;
+  unsigned int cd_values[8];
+  unsigned int flags;
+
+  if (*status != SAI__OK) return HDS_FALSE;
+
+  nfilter = H5Pget_nfilters( dcpl );
+  if (nfilter < 1 || nfilter > HDS__MXFILTER) return HDS_FALSE;
+
+  for (i = 0; i < nfilter; i++) {
+    nelmts = sizeof(cd_values)/sizeof(cd_values[0]);
+    filter = H5Pget_filter2( dcpl, i, &flags, &nelmts, cd_values, 0, NULL,
+                             NULL );
+    if (filter == H5Z_FILTER_DEFLATE && !deflate) {
+      job->level = ( nelmts > 0 ) ? (int) cd_values[0] : 6;
+      deflate = HDS_TRUE;
+
+    /* Each filter is applied in place, except deflate, so only one
+       deflate filter and no shuffle after it can be handled, and only
+       one checksum (for which each buffer has room) */
+    } else if (filter == H5Z_FILTER_SHUFFLE && !deflate && !fletcher32) {
+    } else if (filter == H5Z_FILTER_FLETCHER32 && !fletcher32) {
+      fletcher32 = HDS_TRUE;
+    } else {
+      if (filter < 0) H5Eclear2( H5E_DEFAULT );
+      return HDS_FALSE;
+    }
+    job->filter[i] = filter;
+  }
+  job->nfilter = nfilter;
+
+  return HDS_TRUE;
+}
+
+/* Allocate the slots and start the worker threads. Returns the number of
+   threads started. */
+
+static int dat1ChunkStart( ChunkJob *job, void *(*worker)( void * ),
+                           pthread_t threads[], int *status ) {
+  int i;
+  int nthread;
+  int nworker = 0;
+
+  nthread = hds1GetNThreads();
+  if (nthread > (int) job->nchunk) nthread = job->nchunk;
+  job->window = HDS__CHUNKWINDOW * nthread;
+
+  pthread_mutex_init( &job->mutex, NULL );
+  pthread_cond_init( &job->cond, NULL );
+
+  if (*status != SAI__OK) return nworker;
+
+  job->slots = MEM_CALLOC( job->window, sizeof(*job->slots) );
+  if (!job->slots) {
+    *status = DAT__NOMEM;
+    emsRep( "dat1ChunkStart_1", "Unable to allocate memory for "
+            "compressed chunks", status );
+    return nworker;
+  }
+
+  for (i = 0; i < nthread; i++) {
+    if (pthread_create( threads + nworker, NULL, worker, job ) == 0) {
+      nworker++;
+    }
+  }
+  if (nworker == 0) {
+    *status = DAT__FATAL;
+    emsRep( "dat1ChunkStart_2", "Unable to start any threads to "
+            "compress or decompress chunks", status );
+  }
+  return nworker;
+}
+
+/* Stop the threads (they will already have stopped if every chunk was
+   used) and free any chunks that were not used. */
+
+static void dat1ChunkStop( ChunkJob *job, pthread_t threads[],
+                           int nworker ) {
+  int i;
+  size_t islot;
+
+  pthread_mutex_lock( &job->mutex );
+  job->abort = HDS_TRUE;
+  pthread_cond_broadcast( &job->cond );
+  pthread_mutex_unlock( &job->mutex );
+  for (i = 0; i < nworker; i++) pthread_join( threads[i], NULL );
+
+  if (job->slots) {
+    for (islot = 0; islot < job->window; islot++) {
+      if (job->slots[islot].data) MEM_FREE( job->slots[islot].data );
+    }
+    MEM_FREE( job->slots );
+    job->slots = NULL;
+  }
+  pthread_cond_destroy( &job->cond );
+  pthread_mutex_destroy( &job->mutex );
+}
+
+/* Get the offset (HDF5 order) of the first element in a chunk, given the
+   index of the chunk within the chunks used (counting in C order). */
+
+static void dat1ChunkOffset( const ChunkJob *job, size_t ichunk,
+                             hsize_t offset[] ) {
+  int i;
+  for (i = job->rank - 1; i >= 0; i--) {
+    offset[i] = ( job->first[i] + ichunk % job->nchunks[i] ) *
+                job->chunk[i];
+    ichunk /= job->nchunks[i];
+  }
+}
+
+/* Copy the values in a chunk from the full array into a chunk buffer.
+   Any part of the chunk outside the dataset is set to the fill value. */
+
+static void dat1ChunkGather( const ChunkJob *job, const hsize_t offset[],
+                             char *buf ) {
+  hsize_t extent[DAT__MXDIM];
+  hsize_t idx[DAT__MXDIM];
+  hdsbool_t partial = HDS_FALSE;
+  int i;
+  int last = job->rank - 1;
+  size_t dst;
+  size_t n;
+  size_t rowbytes;
+  size_t src;
+
+  for (i = 0; i < job->rank; i++) {
+    extent[i] = job->dims[i] - offset[i];
+    if (extent[i] < job->chunk[i]) {
+      partial = HDS_TRUE;
+    } else {
+      extent[i] = job->chunk[i];
+    }
+    idx[i] = 0;
+  }
+
+  if (partial) {
+    for (n = 0; n < job->chunkbytes; n += job->typsize) {
+      memcpy( buf + n, job->fill, job->typsize );
+    }
+  }
+
+  /* Copy each row of the chunk along the last (fastest varying) axis */
+  rowbytes = extent[last] * job->typsize;
+  while (1) {
+    src = 0;
+    dst = 0;
+    for (i = 0; i < job->rank; i++) {
+      src = src * job->dims[i] + offset[i] + idx[i];
+      dst = dst * job->chunk[i] + idx[i];
+    }
+    memcpy( buf + dst * job->typsize, job->values + src * job->typsize,
+            rowbytes );
+
+    for (i = last - 1; i >= 0; i--) {
+      if (++idx[i] < extent[i]) break;
+      idx[i] = 0;
+    }
+    if (i < 0) break;
+  }
+}
+
+/* Copy the selected values in a decompressed chunk into the output
+   buffer, which holds the box of selected elements in C order. */
+
+static void dat1ChunkScatter( const ChunkJob *job, const hsize_t offset[],
+                              const char *buf ) {
+  hsize_t extent[DAT__MXDIM];
+  hsize_t hi;
+  hsize_t idx[DAT__MXDIM];
+  hsize_t lo[DAT__MXDIM];
+  int i;
+  int last = job->rank - 1;
+  size_t dst;
+  size_t rowbytes;
+  size_t src;
+
+  /* Find the part of the chunk that is selected */
+  for (i = 0; i < job->rank; i++) {
+    lo[i] = ( offset[i] > job->start[i] ) ? offset[i] : job->start[i];
+    hi = offset[i] + job->chunk[i] - 1;
+    if (hi > job->end[i]) hi = job->end[i];
+    extent[i] = hi - lo[i] + 1;
+    idx[i] = 0;
+  }
+
+  /* Copy each row along the last (fastest varying) axis */
+  rowbytes = extent[last] * job->typsize;
+  while (1) {
+    src = 0;
+    dst = 0;
+    for (i = 0; i < job->rank; i++) {
+      src = src * job->chunk[i] + lo[i] - offset[i] + idx[i];
+      dst = dst * ( job->end[i] - job->start[i] + 1 ) + lo[i] -
+            job->start[i] + idx[i];
+    }
+    memcpy( job->out + dst * job->typsize, buf + src * job->typsize,
+            rowbytes );
+
+    for (i = last - 1; i >= 0; i--) {
+      if (++idx[i] < extent[i]) break;
+      idx[i] = 0;
+    }
+    if (i < 0) break;
+  }
+}
+
+/* Apply the filters to a chunk held in "buf", using "work" as a second
+   buffer of the same size. Returns a newly allocated buffer holding the
+   filtered chunk, or NULL if an error occurs. */
+
+static void *dat1ChunkEncode( const ChunkJob *job, char *buf, char *work,
+                              size_t *nbytes ) {
+  char *in = buf;
+  char *out = work;
+  char *tmp;
+  int i;
+  size_t j;
+  size_t k;
+  size_t nel;
+  uLongf zbytes;
+  uint32_t sum;
+  void *result;
+
+  *nbytes = job->chunkbytes;
+  for (i = 0; i < job->nfilter; i++) {
+
+    /* Shuffle: store the first byte of every element, then the second
+       byte of every element, etc. */
+    if (job->filter[i] == H5Z_FILTER_SHUFFLE) {
+      nel = *nbytes / job->typsize;
+      if (job->typsize > 1 && nel > 1) {
+        for (j = 0; j < job->typsize; j++) {
+          for (k = 0; k < nel; k++) {
+            out[j*nel + k] = in[k*job->typsize + j];
+          }
+        }
+        memcpy( out + nel*job->typsize, in + nel*job->typsize,
+                *nbytes - nel*job->typsize );
+        tmp = in;
+        in = out;
+        out = tmp;
+      }
+
+    /* Deflate: compress into a new buffer large enough for the worst
+       case, which becomes the input for the next filter */
+    } else if (job->filter[i] == H5Z_FILTER_DEFLATE) {
+      zbytes = compressBound( *nbytes );
+      tmp = MEM_MALLOC( zbytes + 4 );
+      if (!tmp) return NULL;
+      if (compress2( (Bytef *) tmp, &zbytes, (const Bytef *) in, *nbytes,
+                     job->level ) != Z_OK) {
+        MEM_FREE( tmp );
+        return NULL;
+      }
+      if (in != buf && in != work) MEM_FREE( in );
+      in = tmp;
+      *nbytes = zbytes;
+
+    /* Fletcher32: append a checksum (always little-endian). Every
+       buffer has room for this. */
+    } else if (job->filter[i] == H5Z_FILTER_FLETCHER32) {
+      sum = dat1Fletcher32( (const unsigned char *) in, *nbytes );
+      in[*nbytes] = sum & 0xff;
+      in[*nbytes + 1] = ( sum >> 8 ) & 0xff;
+      in[*nbytes + 2] = ( sum >> 16 ) & 0xff;
+      in[*nbytes + 3] = ( sum >> 24 ) & 0xff;
+      *nbytes += 4;
+    }
+  }
+
+  /* Return the result in a buffer of its own */
+  if (in == buf || in == work) {
+    result = MEM_MALLOC( *nbytes );
+    if (result) memcpy( result, in, *nbytes );
+  } else {
+    result = in;
+  }
+  return result;
+}
+
+/* Remove the filters from a chunk read from the file, in the reverse of
+   the order in which they were applied, skipping any that were not
+   applied to this chunk. "buf" and "work" are buffers large enough for a
+   decompressed chunk. Returns a pointer to the decompressed chunk, or
+   NULL if the chunk is corrupt. */
+
+static const char *dat1ChunkDecode( const ChunkJob *job,
+                                    const ChunkSlot *slot, char *buf,
+                                    char *work ) {
+  char *in = slot->data;
+  char *out = buf;
+  int i;
+  size_t j;
+  size_t k;
+  size_t nbytes = slot->nbytes;
+  size_t nel;
+  uLongf zbytes;
+  uint32_t stored;
+  uint32_t sum;
+  unsigned char *p;
+
+  for (i = job->nfilter - 1; i >= 0; i--) {
+    if (slot->mask & ( 1u << i )) continue;
+
+    /* Fletcher32: check and remove the checksum. HDF5 also accepts the
+       checksums written by versions before 1.6.3, which have the two
+       bytes in each half swapped. */
+    if (job->filter[i] == H5Z_FILTER_FLETCHER32) {
+      if (nbytes < 4) return NULL;
+      nbytes -= 4;
+      p = (unsigned char *) in + nbytes;
+      stored = p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) |
+               ( (uint32_t) p[3] << 24 );
+      sum = dat1Fletcher32( (const unsigned char *) in, nbytes );
+      if (stored != sum && stored != ( ( ( sum & 0x00ff00ff ) << 8 ) |
+                                       ( ( sum >> 8 ) & 0x00ff00ff ) )) {
+        return NULL;
+      }
+
+    /* Deflate: decompress into whichever buffer is not in use */
+    } else if (job->filter[i] == H5Z_FILTER_DEFLATE) {
+      zbytes = job->chunkbytes;
+      if (uncompress( (Bytef *) out, &zbytes, (const Bytef *) in,
+                      nbytes ) != Z_OK) return NULL;
+      nbytes = zbytes;
+      in = out;
+      out = ( in == buf ) ? work : buf;
+
+    /* Shuffle: gather the bytes of each element back together */
+    } else if (job->filter[i] == H5Z_FILTER_SHUFFLE) {
+      nel = nbytes / job->typsize;
+      if (job->typsize > 1 && nel > 1) {
+        if (nbytes > job->chunkbytes) return NULL;
+        for (j = 0; j < job->typsize; j++) {
+          for (k = 0; k < nel; k++) {
+            out[k*job->typsize + j] = in[j*nel + k];
+          }
+        }
+        memcpy( out + nel*job->typsize, in + nel*job->typsize,
+                nbytes - nel*job->typsize );
+        in = out;
+        out = ( in == buf ) ? work : buf;
+      }
+    }
+  }
+
+  return ( nbytes == job->chunkbytes ) ? in : NULL;
+}
+
+/* The Fletcher32 checksum, calculated in the same way as HDF5. */
+
+static uint32_t dat1Fletcher32( const unsigned char *data, size_t len ) {
+  size_t n = len / 2;
+  size_t tlen;
+  uint32_t sum1 = 0;
+  uint32_t sum2 = 0;
+
+  while (n) {
+    tlen = ( n > 360 ) ? 360 : n;
+    n -= tlen;
+    do {
+      sum1 += (uint32_t) ( ( (uint16_t) data[0] ) << 8 ) |
+              ( (uint16_t) data[1] );
+      data += 2;
+      sum2 += sum1;
+    } while (--tlen);
+    sum1 = ( sum1 & 0xffff ) + ( sum1 >> 16 );
+    sum2 = ( sum2 & 0xffff ) + ( sum2 >> 16 );
+  }
+
+  if (len % 2) {
+    sum1 += (uint32_t) ( ( (uint16_t) *data ) << 8 );
+    sum2 += sum1;
+    sum1 = ( sum1 & 0xffff ) + ( sum1 >> 16 );
+    sum2 = ( sum2 & 0xffff ) + ( sum2 >> 16 );
+  }
+
+  sum1 = ( sum1 & 0xffff ) + ( sum1 >> 16 );
+  sum2 = ( sum2 & 0xffff ) + ( sum2 >> 16 );
+
+  return ( sum2 << 16 ) | sum1;
+}
+
+/* Thread function that claims and compresses chunks until there are
+   none left. A chunk is only claimed if there is a free slot for it. */
+
+static void *dat1ChunkWriter( void *data ) {
+  ChunkJob *job = (ChunkJob *) data;
+  ChunkSlot *slot;
+  char *buf;
+  char *work;
+  hsize_t offset[DAT__MXDIM];
+  size_t ichunk;
+  size_t nbytes = 0;
+  void *result;
+
+  /* Each buffer has room for a checksum after the chunk */
+  buf = MEM_MALLOC( job->chunkbytes + 4 );
+  work = MEM_MALLOC( job->chunkbytes + 4 );
+
+  pthread_mutex_lock( &job->mutex );
+  if (!buf || !work) {
+    job->failed = DAT__NOMEM;
+    pthread_cond_broadcast( &job->cond );
+  }
+
+  while (!job->failed && !job->abort && job->claim < job->nchunk) {
+    if (job->claim >= job->next + job->window) {
+      pthread_cond_wait( &job->cond, &job->mutex );
+      continue;
+    }
+    ichunk = job->claim++;
+    pthread_mutex_unlock( &job->mutex );
+
+    dat1ChunkOffset( job, ichunk, offset );
+    dat1ChunkGather( job, offset, buf );
+    result = dat1ChunkEncode( job, buf, work, &nbytes );
+
+    pthread_mutex_lock( &job->mutex );
+    if (result) {
+      slot = job->slots + ( ichunk % job->window );
+      slot->data = result;
+      slot->nbytes = nbytes;
+      slot->ready = HDS_TRUE;
+    } else if (!job->failed) {
+      job->failed = DAT__FILWR;
+    }
+    pthread_cond_broadcast( &job->cond );
+  }
+  pthread_mutex_unlock( &job->mutex );
+
+  if (buf) MEM_FREE( buf );
+  if (work) MEM_FREE( work );
+  return NULL;
+}
+
+/* Thread function that claims, decompresses and scatters chunks, in the
+   order in which they were read, until there are none left. Chunks that
+   are not in the file are filled with the fill value. */
+
+static void *dat1ChunkReader( void *data ) {
+  ChunkJob *job = (ChunkJob *) data;
+  ChunkSlot *slot;
+  char *buf;
+  char *work;
+  const char *chunk;
+  hsize_t offset[DAT__MXDIM];
+  size_t ichunk;
+  size_t n;
+
+  buf = MEM_MALLOC( job->chunkbytes );
+  work = MEM_MALLOC( job->chunkbytes );
+
+  pthread_mutex_lock( &job->mutex );
+  if (!buf || !work) {
+    job->failed = DAT__NOMEM;
+    pthread_cond_broadcast( &job->cond );
+  }
+
+  while (!job->failed && !job->abort && job->claim < job->nchunk) {
+    if (job->claim >= job->next) {
+      pthread_cond_wait( &job->cond, &job->mutex );
+      continue;
+    }
+    ichunk = job->claim++;
+    slot = job->slots + ( ichunk % job->window );
+    pthread_mutex_unlock( &job->mutex );
+
+    if (slot->data) {
+      chunk = dat1ChunkDecode( job, slot, buf, work );
+    } else {
+      for (n = 0; n < job->chunkbytes; n += job->typsize) {
+        memcpy( buf + n, job->fill, job->typsize );
+      }
+      chunk = buf;
+    }
+    if (chunk) {
+      dat1ChunkOffset( job, ichunk, offset );
+      dat1ChunkScatter( job, offset, chunk );
+    }
+
+    pthread_mutex_lock( &job->mutex );
+    if (slot->data) MEM_FREE( slot->data );
+    slot->data = NULL;
+    slot->ready = HDS_FALSE;
+    if (chunk) {
+      job->ndone++;
+    } else if (!job->failed) {
+      job->failed = DAT__FILRD;
+    }
+    pthread_cond_broadcast( &job->cond );
+  }
+  pthread_mutex_unlock( &job->mutex );
+
+  if (buf) MEM_FREE( buf );
+  if (work) MEM_FREE( work );
+  return NULL;
+}
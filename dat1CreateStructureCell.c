@@ -41,11 +41,14 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-10-29 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Create groups that index the creation order of their links.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -104,6 +107,7 @@ dat1CreateStructureCell( hid_t group_id, size_t index, const char * typestr, con
                          int ndim, const hdsdim dims[], int *status ) {
 
   hid_t cellgroup_id = 0;
+  hid_t gcpl = H5P_DEFAULT;
   char cellname[128];
   hdsdim coords[DAT__MXDIM];
 
@@ -113,8 +117,9 @@ dat1CreateStructureCell( hid_t group_id, size_t index, const char * typestr, con
   dat1Index2Coords(index, ndim, dims, coords, status );
   dat1Coords2CellName( ndim, coords, cellname, sizeof(cellname), status );
 
+  gcpl = dat1GroupCreatePlist( HDS_FALSE, status );
   CALLHDFE( hid_t, cellgroup_id,
-           H5Gcreate2(group_id, cellname, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+           H5Gcreate2(group_id, cellname, H5P_DEFAULT, gcpl, H5P_DEFAULT),
            DAT__HDF5E,
            emsRepf("dat1New_4", "Error creating structure/group '%s'", status, parentstr)
            );
@@ -124,6 +129,7 @@ dat1CreateStructureCell( hid_t group_id, size_t index, const char * typestr, con
   dat1SetAttrString( cellgroup_id, HDS__ATTR_STRUCT_TYPE, typestr, status );
 
  CLEANUP:
+  if (gcpl > 0 && gcpl != H5P_DEFAULT) H5Pclose(gcpl);
   if (*status != SAI__OK) {
     if (cellgroup_id > 0) {
       H5Gclose(cellgroup_id);
@@ -42,10 +42,11 @@
 *  Description:
 *     This routine 'translates' a contiguous sequence of data values from one
 *     location to another. It is only intended for conversions to and from
-*     character formats and is relatively inefficient.
+*     character formats.
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -55,10 +56,22 @@
 *     - During conversion, any data values that cannot be sensibly
 *       translated from the source type to the destination type are substituted
 *       by a specific 'bad' value, and the return status set accordingly.
+*     - Strings are parsed in place by dedicated routines that give the
+*       same results as sscanf. A blank string, or an integer that is
+*       too large for the output type, is converted to a bad value.
+*     - Numbers are formatted as "%d" or "%G" would format them, without
+*       calling snprintf except for values that need an exponent or that
+*       cannot be rounded unambiguously. Strings that are too long for
+*       the output element are truncated.
 
 *  History:
 *     2014-09-15 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Parse and format numbers directly instead of calling sscanf and
+*        snprintf for each element. Integer overflow and blank strings now
+*        give bad values, and long formatted values no longer overrun the
+*        output element.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -102,6 +115,10 @@
 *-
 */
 
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <limits.h>
@@ -118,6 +135,41 @@
 
 #include "dat_err.h"
 
+/* Length of a buffer large enough to hold any formatted numerical value. */
+#define NUMBUF_LEN 40
+
+static int dat1ParseInt( const char *str, size_t len, int64_t *value );
+static int dat1ScanNumber( const char *str, size_t len, uint64_t *mant,
+                           int *exp10, int *neg );
+static int dat1ParseDouble( const char *str, size_t len, char *buffer,
+                            double *value );
+static int dat1ParseFloat( const char *str, size_t len, char *buffer,
+                           float *value );
+static size_t dat1FormatInt( int64_t value, char *buf );
+static size_t dat1FormatG( double value, int prec, char *buf );
+
+/* Powers of ten that can be represented exactly. */
+static const double pow10d[] = {
+  1.0E0, 1.0E1, 1.0E2, 1.0E3, 1.0E4, 1.0E5, 1.0E6, 1.0E7, 1.0E8, 1.0E9,
+  1.0E10, 1.0E11, 1.0E12, 1.0E13, 1.0E14, 1.0E15, 1.0E16, 1.0E17, 1.0E18,
+  1.0E19, 1.0E20, 1.0E21, 1.0E22
+};
+static const float pow10f[] = {
+  1.0E0F, 1.0E1F, 1.0E2F, 1.0E3F, 1.0E4F, 1.0E5F, 1.0E6F, 1.0E7F, 1.0E8F,
+  1.0E9F, 1.0E10F
+};
+
+/* Parse an integer value into the supplied variable and check it is in
+   range. Otherwise set the variable bad and increment the bad count. */
+#define PARSE_INT(type,lo,hi,bad) \
+  if( dat1ParseInt( inbuf, nbin, &outint64 ) && outint64 >= (lo) && \
+      outint64 <= (hi) ) { \
+    ((type *)exp)[n] = (type) outint64; \
+  } else { \
+    (*nbad)++; \
+    ((type *)exp)[n] = (bad); \
+  }
+
 int
 dat1CvtChar( size_t nval, hdstype_t intype, size_t nbin,
              hdstype_t outtype, size_t nbout, const void * imp, void * exp,
@@ -161,106 +213,57 @@ dat1CvtChar( size_t nval, hdstype_t intype, size_t nbin,
   if (intype == HDSTYPE_CHAR) {
     const char * inbuf = NULL;
 
-    /* The input is in a _CHAR*nbin array and for sscanf to work
-       we need a nul-terminated string */
+    /* The strings are parsed in place. A nul-terminated copy is only
+       needed for the rare values that have to be handed on to strtod
+       or strtof, so allocate a buffer to hold one. */
     buffer = MEM_MALLOC( nbin + 1 );
-    buffer[nbin] = '\0';
     inbuf = imp;
 
-    for (n = 0; n < nval; n++) {
-      int nitem;
-      int outint;
-      float outreal;
-      double outdouble;
-      hdsbool_t outlogical;
-      short outword;
-      unsigned short outuword;
+    for (n = 0; n < nval; n++, inbuf += nbin) {
       int64_t outint64;
 
-      strncpy( buffer, inbuf, nbin );
-      inbuf += nbin; /* Go to next string */
-
       switch( outtype ) {
       case HDSTYPE_INTEGER:
-        nitem = sscanf(buffer, "%d", &outint );
-        if (nitem == 0) {
-          (*nbad)++;
-          outint = typeinfo->BADI;
-        }
-        ((int *)exp)[n] = outint;
+        PARSE_INT( int, INT_MIN, INT_MAX, typeinfo->BADI );
         break;
       case HDSTYPE_REAL:
-        nitem = sscanf(buffer, "%f", &outreal);
-        if (nitem == 0) {
+        if( !dat1ParseFloat( inbuf, nbin, buffer, ((float *)exp) + n ) ) {
           (*nbad)++;
-          outreal = typeinfo->BADR;
+          ((float *)exp)[n] = typeinfo->BADR;
         }
-        ((float *)exp)[n] = outreal;
         break;
       case HDSTYPE_DOUBLE:
-        nitem = sscanf(buffer, "%lf", &outdouble);
-        if (nitem == 0) {
+        if( !dat1ParseDouble( inbuf, nbin, buffer, ((double *)exp) + n ) ) {
           (*nbad)++;
-          outdouble = typeinfo->BADD;
+          ((double *)exp)[n] = typeinfo->BADD;
         }
-        ((double *)exp)[n] = outdouble;
         break;
       case HDSTYPE_INT64:
-        nitem = sscanf(buffer, "%ld", &outint64);
-        if (nitem == 0) {
-          (*nbad)++;
-          outint64 = typeinfo->BADK;
-        }
-        ((int64_t *)exp)[n] = outint64;
+        PARSE_INT( int64_t, INT64_MIN, INT64_MAX, typeinfo->BADK );
         break;
       case HDSTYPE_LOGICAL:
         /* could be a string TRUE/FALSE/YES/NO
            but oddly, not 1/0. HDS assumes that anything
            that is not true is always false and does not
            attempt to trap for bad values. */
-        if (buffer[0] == 'T' || buffer[0] == 't' ||
-            buffer[0] == 'Y' || buffer[0] == 'y' ) {
-          outlogical = HDS_TRUE;
+        if (nbin > 0 && (inbuf[0] == 'T' || inbuf[0] == 't' ||
+                         inbuf[0] == 'Y' || inbuf[0] == 'y') ) {
+          ((hdsbool_t *)exp)[n] = HDS_TRUE;
         } else {
-          outlogical = HDS_FALSE;
+          ((hdsbool_t *)exp)[n] = HDS_FALSE;
         }
-        ((hdsbool_t *)exp)[n] = outlogical;
         break;
       case HDSTYPE_BYTE:
-        nitem = sscanf(buffer, "%hd", &outword);
-        if ((nitem > 0) && (outword <= SCHAR_MAX) && (outword >= SCHAR_MIN)) {
-          /* can just use outword as is */
-        } else {
-          (*nbad)++;
-          outword = typeinfo->BADB;
-        }
-        ((char *)exp)[n] = outword;
+        PARSE_INT( char, SCHAR_MIN, SCHAR_MAX, typeinfo->BADB );
         break;
       case HDSTYPE_UBYTE:
-        nitem = sscanf(buffer, "%hd", &outword);
-        if ((nitem > 0) && (outword <= UCHAR_MAX) && (outword >= 0)) {
-          /* can just use outword as is */
-        } else {
-          (*nbad)++;
-          outword = typeinfo->BADUB;
-        }
-        ((unsigned char *)exp)[n] = outword;
+        PARSE_INT( unsigned char, 0, UCHAR_MAX, typeinfo->BADUB );
         break;
       case HDSTYPE_WORD:
-        nitem = sscanf(buffer, "%hd", &outword);
-        if (nitem == 0) {
-          (*nbad)++;
-          outword = typeinfo->BADW;
-        }
-        ((short *)exp)[n] = outword;
+        PARSE_INT( short, SHRT_MIN, SHRT_MAX, typeinfo->BADW );
         break;
       case HDSTYPE_UWORD:
-        nitem = sscanf(buffer, "%hu", &outuword);
-        if (nitem == 0) {
-          (*nbad)++;
-          outuword = typeinfo->BADUW;
-        }
-        ((unsigned short *)exp)[n] = outuword;
+        PARSE_INT( unsigned short, 0, USHRT_MAX, typeinfo->BADUW );
         break;
       case HDSTYPE_CHAR:
         /* handled previously and we should not be here */
@@ -283,56 +286,55 @@ dat1CvtChar( size_t nval, hdstype_t intype, size_t nbin,
     }
   } else if (outtype == HDSTYPE_CHAR) {
     char * outbuf = NULL;
+    char numbuf[NUMBUF_LEN];
     size_t i;
     /* each value is converted one element at a time.
-       We sprintf into a fixed size buffer and copy into
+       We format into a fixed size buffer and copy into
        the correct place in the output */
-    buffer = MEM_MALLOC( nbout + 1 );
-    buffer[nbout] = '\0';
     outbuf = exp;
 
     for (n = 0; n < nval; n++) {
       hdsbool_t inlogical;
+      const char *str = numbuf;
       size_t nchar = 0;
 
       switch( intype ) {
 
       case HDSTYPE_INTEGER:
-        nchar = snprintf( buffer, nbout+1, "%d", ((int *)imp)[n] );
+        nchar = dat1FormatInt( ((int *)imp)[n], numbuf );
         break;
       case HDSTYPE_REAL:
-        nchar = snprintf( buffer, nbout+1, "%G", ((float *)imp)[n] );
+        nchar = dat1FormatG( ((float *)imp)[n], 6, numbuf );
         break;
       case HDSTYPE_DOUBLE:
-        nchar = snprintf( buffer, nbout+1, "%.*G", DBL_DIG, ((double *)imp)[n] );
+        nchar = dat1FormatG( ((double *)imp)[n], DBL_DIG, numbuf );
         break;
       case HDSTYPE_INT64:
-        nchar = snprintf( buffer, nbout+1, "%ld", ((int64_t *)imp)[n] );
+        nchar = dat1FormatInt( ((int64_t *)imp)[n], numbuf );
         break;
       case HDSTYPE_LOGICAL:
         inlogical = ((hdsbool_t *)imp)[n];
         if ( inlogical == typeinfo->BADL ) {
-          buffer[0] = '*';
-          buffer[1] = '\0';
-          nchar = 1;
+          str = "*";
         } else if ( HDS_ISTRUE(inlogical) ) {
           /* HDS is happy to truncate FALSE to FAL if there isn't space */
-          nchar = snprintf( buffer, nbout+1, "%s", "TRUE" );
+          str = "TRUE";
         } else {
-          nchar = snprintf( buffer, nbout+1, "%s", "FALSE" );
+          str = "FALSE";
         }
+        nchar = strlen( str );
         break;
       case HDSTYPE_BYTE:
-        nchar = snprintf( buffer, nbout+1, "%d", ((char *)imp)[n] );
+        nchar = dat1FormatInt( ((char *)imp)[n], numbuf );
         break;
       case HDSTYPE_UBYTE:
-        nchar = snprintf( buffer, nbout+1, "%u", ((unsigned char *)imp)[n] );
+        nchar = dat1FormatInt( ((unsigned char *)imp)[n], numbuf );
         break;
       case HDSTYPE_WORD:
-        nchar = snprintf( buffer, nbout+1, "%d", ((short *)imp)[n] );
+        nchar = dat1FormatInt( ((short *)imp)[n], numbuf );
         break;
       case HDSTYPE_UWORD:
-        nchar = snprintf( buffer, nbout+1, "%u", ((unsigned short *)imp)[n] );
+        nchar = dat1FormatInt( ((unsigned short *)imp)[n], numbuf );
         break;
       case HDSTYPE_CHAR:
         /* handled previously and we should not be here */
@@ -353,9 +355,11 @@ dat1CvtChar( size_t nval, hdstype_t intype, size_t nbin,
         }
       }
 
-      /* Copy the buffer to the output buffer -- space padding as this is really
-         a Fortran string. */
-      strncpy( outbuf, buffer, nchar );
+      /* Copy the string to the output buffer, truncating it if there is
+         not enough room and space padding as this is really a Fortran
+         string. */
+      if (nchar > nbout) nchar = nbout;
+      memcpy( outbuf, str, nchar );
       for (i=nchar; i<nbout; i++) {
         outbuf[i] = ' ';
       }
@@ -383,3 +387,267 @@ dat1CvtChar( size_t nval, hdstype_t intype, size_t nbin,
   if (buffer) MEM_FREE( buffer );
   return *status;
 }
+
+/* Parse a decimal integer from the start of a string of "len" characters
+   that need not be nul-terminated, in the same way as sscanf "%ld" (i.e.
+   leading white space and trailing junk are ignored). Returns zero if
+   the string does not start with an integer or if the integer overflows
+   an int64_t. */
+static int dat1ParseInt( const char *str, size_t len, int64_t *value ) {
+  const char *p = str;
+  const char *end = str + len;
+  int ndig = 0;
+  int neg = 0;
+  uint64_t u = 0;
+
+  while( p < end && isspace( (unsigned char) *p ) ) p++;
+  if( p < end && ( *p == '+' || *p == '-' ) ) {
+    neg = ( *p == '-' );
+    p++;
+  }
+
+  while( p < end && *p >= '0' && *p <= '9' ) {
+    unsigned int d = *p - '0';
+    if( u > ( UINT64_MAX - d ) / 10 ) return 0;
+    u = 10*u + d;
+    ndig++;
+    p++;
+  }
+  if( ndig == 0 ) return 0;
+
+  if( neg ) {
+    if( u > (uint64_t) INT64_MAX + 1 ) return 0;
+    *value = ( u == (uint64_t) INT64_MAX + 1 ) ? INT64_MIN : -(int64_t) u;
+  } else {
+    if( u > (uint64_t) INT64_MAX ) return 0;
+    *value = (int64_t) u;
+  }
+  return 1;
+}
+
+/* Scan a decimal floating point value at the start of a string of "len"
+   characters, returning the decimal mantissa, exponent and sign. Returns
+   zero if the value cannot be represented this way (too many significant
+   digits, hexadecimal, infinity, NaN or no number at all), in which case
+   the caller should use strtod or strtof instead. */
+static int dat1ScanNumber( const char *str, size_t len, uint64_t *mant,
+                           int *exp10, int *neg ) {
+  const char *p = str;
+  const char *end = str + len;
+  int ndig = 0;
+  int nsig = 0;
+  uint64_t m = 0;
+  int e = 0;
+
+  *neg = 0;
+  while( p < end && isspace( (unsigned char) *p ) ) p++;
+  if( p < end && ( *p == '+' || *p == '-' ) ) {
+    *neg = ( *p == '-' );
+    p++;
+  }
+
+  /* Integer part. Leading zeros are not significant. */
+  for( ; p < end && *p >= '0' && *p <= '9'; p++, ndig++ ) {
+    if( m == 0 && *p == '0' ) continue;
+    if( nsig++ == 19 ) return 0;
+    m = 10*m + ( *p - '0' );
+  }
+
+  /* Fractional part. */
+  if( p < end && *p == '.' ) {
+    for( p++; p < end && *p >= '0' && *p <= '9'; p++, ndig++ ) {
+      e--;
+      if( m == 0 && *p == '0' ) continue;
+      if( nsig++ == 19 ) return 0;
+      m = 10*m + ( *p - '0' );
+    }
+  }
+  if( ndig == 0 ) return 0;
+  if( p < end && ( *p == 'x' || *p == 'X' ) ) return 0;
+
+  /* Exponent. It is ignored if there are no digits after the "E" (as
+     strtod does). */
+  if( p < end && ( *p == 'e' || *p == 'E' ) ) {
+    const char *q = p + 1;
+    int eneg = 0;
+    int ev = 0;
+    int nedig = 0;
+    if( q < end && ( *q == '+' || *q == '-' ) ) {
+      eneg = ( *q == '-' );
+      q++;
+    }
+    for( ; q < end && *q >= '0' && *q <= '9'; q++, nedig++ ) {
+      if( ev < 100000 ) ev = 10*ev + ( *q - '0' );
+    }
+    if( nedig > 0 ) e += eneg ? -ev : ev;
+  }
+
+  *mant = m;
+  *exp10 = e;
+  return 1;
+}
+
+/* Parse a double precision value at the start of a string of "len"
+   characters, giving the same result as sscanf "%lf". Values with up to
+   15 significant digits and a small exponent are converted directly
+   (the result is exact since both the mantissa and the power of ten are
+   exactly representable). Other values are copied to "buffer" (which
+   must have room for len+1 characters), nul-terminated and converted
+   using strtod. Returns zero if no value could be read. */
+static int dat1ParseDouble( const char *str, size_t len, char *buffer,
+                            double *value ) {
+  char *endp;
+  double d;
+  int e;
+  int neg;
+  uint64_t m;
+
+  if( dat1ScanNumber( str, len, &m, &e, &neg ) ) {
+    if( m == 0 ) {
+      *value = neg ? -0.0 : 0.0;
+      return 1;
+    } else if( m <= ( UINT64_C(1) << 53 ) && e >= -22 && e <= 22 ) {
+      d = (double) m;
+      d = ( e < 0 ) ? d / pow10d[ -e ] : d * pow10d[ e ];
+      *value = neg ? -d : d;
+      return 1;
+    }
+  }
+
+  memcpy( buffer, str, len );
+  buffer[ len ] = '\0';
+  *value = strtod( buffer, &endp );
+  return ( endp != buffer );
+}
+
+/* The single precision equivalent of dat1ParseDouble, giving the same
+   result as sscanf "%f". */
+static int dat1ParseFloat( const char *str, size_t len, char *buffer,
+                           float *value ) {
+  char *endp;
+  float f;
+  int e;
+  int neg;
+  uint64_t m;
+
+  if( dat1ScanNumber( str, len, &m, &e, &neg ) ) {
+    if( m == 0 ) {
+      *value = neg ? -0.0F : 0.0F;
+      return 1;
+    } else if( m <= ( UINT64_C(1) << 24 ) && e >= -10 && e <= 10 ) {
+      f = (float) m;
+      f = ( e < 0 ) ? f / pow10f[ -e ] : f * pow10f[ e ];
+      *value = neg ? -f : f;
+      return 1;
+    }
+  }
+
+  memcpy( buffer, str, len );
+  buffer[ len ] = '\0';
+  *value = strtof( buffer, &endp );
+  return ( endp != buffer );
+}
+
+/* Format an integer as "%d" would, returning the number of characters
+   written (the string is not nul-terminated). */
+static size_t dat1FormatInt( int64_t value, char *buf ) {
+  char tmp[24];
+  char *p = tmp + sizeof(tmp);
+  size_t nc;
+  uint64_t u = ( value < 0 ) ? -(uint64_t) value : (uint64_t) value;
+
+  do {
+    *(--p) = '0' + ( u % 10 );
+    u /= 10;
+  } while( u );
+  if( value < 0 ) *(--p) = '-';
+
+  nc = tmp + sizeof(tmp) - p;
+  memcpy( buf, p, nc );
+  return nc;
+}
+
+/* Format a value as "%.<prec>G" would, returning the number of
+   characters written (the string is not nul-terminated). Values that
+   would be written without an exponent are formatted directly if the
+   rounding to "prec" significant digits can be done unambiguously.
+   Everything else uses snprintf. The buffer must have room for
+   NUMBUF_LEN characters. */
+static size_t dat1FormatG( double value, int prec, char *buf ) {
+  char digits[24];
+  char *p;
+  double a;
+  double frac;
+  double s;
+  int i;
+  int iter;
+  int k;
+  int ndig;
+  int x;
+  uint64_t m = 0;
+
+  a = fabs( value );
+  if( a >= 1.0E-4 && a < pow10d[ prec ] ) {
+
+    /* Estimate the decimal exponent, then correct it if the rounded
+       mantissa does not have exactly "prec" digits. */
+    x = 0;
+    if( a >= 1.0 ) {
+      while( x + 1 < prec && a >= pow10d[ x + 1 ] ) x++;
+    } else {
+      x = -1;
+      while( x > -4 && a * pow10d[ -x ] < 1.0 ) x--;
+    }
+
+    for( iter = 0; iter < 3; iter++ ) {
+      k = prec - 1 - x;
+      if( x < -4 || x >= prec || k > 22 ) break;
+
+      /* Scale the value so that the digits to be kept are the integer
+         part. This involves a single rounding error of at most half a
+         unit in the last place. If the fractional part is within that
+         distance of one half we cannot be sure which way to round. */
+      s = a * pow10d[ k ];
+      frac = s - floor( s );
+      if( fabs( frac - 0.5 ) <= 0.5*( nextafter( s, HUGE_VAL ) - s ) ) break;
+      m = (uint64_t) floor( s ) + ( frac > 0.5 );
+
+      if( m < (uint64_t) pow10d[ prec - 1 ] ) {
+        x--;
+      } else if( m >= (uint64_t) pow10d[ prec ] ) {
+        x++;
+      } else {
+
+        /* Got the digits. Write them out, omitting trailing zeros in any
+           fractional part. */
+        for( i = prec - 1; i >= 0; i-- ) {
+          digits[ i ] = '0' + ( m % 10 );
+          m /= 10;
+        }
+        ndig = prec;
+        while( ndig > x + 1 && ndig > 1 && digits[ ndig - 1 ] == '0' ) ndig--;
+
+        p = buf;
+        if( value < 0.0 ) *(p++) = '-';
+        if( x >= 0 ) {
+          memcpy( p, digits, x + 1 );
+          p += x + 1;
+          if( ndig > x + 1 ) {
+            *(p++) = '.';
+            memcpy( p, digits + x + 1, ndig - x - 1 );
+            p += ndig - x - 1;
+          }
+        } else {
+          *(p++) = '0';
+          *(p++) = '.';
+          for( i = -1; i > x; i-- ) *(p++) = '0';
+          memcpy( p, digits, ndig );
+          p += ndig;
+        }
+        return p - buf;
+      }
+    }
+  }
+
+  return snprintf( buf, NUMBUF_LEN, "%.*G", prec, value );
+}
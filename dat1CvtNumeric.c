@@ -0,0 +1,729 @@
+/*
+*+
+*  Name:
+*     dat1CvtNumeric
+
+*  Purpose:
+*     Convert an array of values from one numeric HDS type to another
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1CvtNumeric( size_t nval, hdstype_t intype, size_t nbin,
+*                     hdstype_t outtype, size_t nbout, const void * imp,
+*                     void * exp, size_t *nbad, int * status );
+
+*  Arguments:
+*     nval = size_t (Given)
+*        Number of values to be converted.
+*     intype = hdstype_t (Given)
+*        Type of data in "imp" array.
+*     nbin = size_t (Given)
+*        Number of bytes per input element.
+*     outtype = hdstype_t (Given)
+*        Required type of output data array "exp".
+*     nbout = size_t (Given)
+*        Number of bytes per output element.
+*     imp = const void * (Given)
+*        Buffer with data to be converted. nval elements of type
+*        intype.
+*     exp = void * (Returned)
+*        Buffer to receive converted data. nval elements of type
+*        outtype. Must not overlap "imp".
+*     nbad = size_t * (Returned)
+*        Number of values that could not be converted and were replaced
+*        by the output bad value. Input bad values are not included.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     int = inherited status on exit. This is for compatibility with the
+*        original HDS API.
+
+*  Description:
+*     Converts a contiguous vector of values between any pair of the
+*     numeric HDS types (_BYTE, _UBYTE, _WORD, _UWORD, _INTEGER, _INT64,
+*     _REAL and _DOUBLE) in the way that HDS version 4 did. Input values
+*     that equal the input type's bad value become the output type's bad
+*     value. Values outside the range of the output type (and NaNs
+*     converted to an integer type) also become the output bad value and
+*     are counted in "nbad". Floating point values are rounded to the
+*     nearest integer when converted to an integer type.
+
+*  Notes:
+*     - Unlike dat1CvtChar and dat1CvtLogical, this routine does not set
+*       DAT__CONER if any conversion errors occur. The caller should check
+*       "nbad" once all the values it needs have been converted.
+*     - The bad values are obtained from dat1TypeInfo.
+*     - The most frequently used conversions (_REAL<->_DOUBLE,
+*       _REAL/_DOUBLE to _INTEGER, _INTEGER to _REAL/_DOUBLE and _WORD
+*       to _REAL) use SSE2 or AVX2 code on x86 processors. AVX2 is
+*       selected at run time if the processor supports it. All other
+*       conversions use simple loops that the compiler can vectorise.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <float.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "prm_par.h"
+#include "dat_err.h"
+
+/* Use explicit SSE2/AVX2 code for the commonest conversions if we can.
+   AVX2 is only used if the processor running the code supports it. */
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__SSE2__)
+#include <immintrin.h>
+#define CVT_X86 1
+#else
+#define CVT_X86 0
+#endif
+
+/* The type of a function that converts "n" values, returning the number
+   of values that could not be converted. */
+typedef size_t (*CvtFun)( size_t n, const void *imp, void *exp,
+                          const HdsTypeInfo *ti );
+
+/* The C type used to store each numeric HDS type. */
+typedef signed char TYPE_B;
+typedef unsigned char TYPE_UB;
+typedef short TYPE_W;
+typedef unsigned short TYPE_UW;
+typedef int TYPE_I;
+typedef int64_t TYPE_K;
+typedef float TYPE_R;
+typedef double TYPE_D;
+
+/* Macros that define a static conversion function for each class of
+   conversion. "IN" and "OUT" are the HDS type codes (B, UB, W, UW, I, K, R
+   or D). */
+
+/* Integer to integer. Values outside the range of the output type are
+   bad. */
+#define CVT_ITOI(IN,OUT) \
+static size_t cvt##IN##to##OUT( size_t n, const void *imp, void *exp, \
+                                const HdsTypeInfo *ti ) { \
+  const TYPE_##IN *in = imp; \
+  TYPE_##OUT *out = exp; \
+  const TYPE_##IN badin = (TYPE_##IN) ti->BAD##IN; \
+  const TYPE_##OUT badout = (TYPE_##OUT) ti->BAD##OUT; \
+  size_t nerr = 0; \
+  size_t i; \
+  for( i = 0; i < n; i++ ) { \
+    TYPE_##IN v = in[ i ]; \
+    int isbad = ( v == badin ); \
+    int iserr = !isbad && ( (int64_t) v < (int64_t) VAL__MIN##OUT || \
+                            (int64_t) v > (int64_t) VAL__MAX##OUT ); \
+    out[ i ] = ( isbad || iserr ) ? badout : (TYPE_##OUT) v; \
+    nerr += iserr; \
+  } \
+  return nerr; \
+}
+
+/* Floating point to integer. Values are rounded to the nearest integer
+   (halves are rounded away from zero). Values that would round to a
+   value outside the range of the output type, and NaNs, are bad. */
+#define CVT_FTOI(IN,OUT) \
+static size_t cvt##IN##to##OUT( size_t n, const void *imp, void *exp, \
+                                const HdsTypeInfo *ti ) { \
+  const TYPE_##IN *in = imp; \
+  TYPE_##OUT *out = exp; \
+  const TYPE_##IN badin = (TYPE_##IN) ti->BAD##IN; \
+  const TYPE_##OUT badout = (TYPE_##OUT) ti->BAD##OUT; \
+  const double lo = (double) VAL__MIN##OUT - 0.5; \
+  const double hi = (double) VAL__MAX##OUT + 0.5; \
+  size_t nerr = 0; \
+  size_t i; \
+  for( i = 0; i < n; i++ ) { \
+    double v = in[ i ]; \
+    int isbad = ( in[ i ] == badin ); \
+    int isok = ( v > lo && v < hi ); \
+    int iserr = !isbad && !isok; \
+    double vc = isok ? v : 0.0; \
+    TYPE_##OUT t = (TYPE_##OUT) vc; \
+    double r = vc - (double) t; \
+    t += ( r >= 0.5 ) - ( r <= -0.5 ); \
+    out[ i ] = ( isbad || iserr ) ? badout : t; \
+    nerr += iserr; \
+  } \
+  return nerr; \
+}
+
+/* Integer to floating point. Every value can be represented (possibly
+   with a loss of precision). */
+#define CVT_ITOF(IN,OUT) \
+static size_t cvt##IN##to##OUT( size_t n, const void *imp, void *exp, \
+                                const HdsTypeInfo *ti ) { \
+  const TYPE_##IN *in = imp; \
+  TYPE_##OUT *out = exp; \
+  const TYPE_##IN badin = (TYPE_##IN) ti->BAD##IN; \
+  const TYPE_##OUT badout = (TYPE_##OUT) ti->BAD##OUT; \
+  size_t i; \
+  for( i = 0; i < n; i++ ) { \
+    out[ i ] = ( in[ i ] == badin ) ? badout : (TYPE_##OUT) in[ i ]; \
+  } \
+  return 0; \
+}
+
+/* Floating point to floating point. Values outside the range of the
+   output type are bad. NaNs are passed on unchanged. */
+#define CVT_FTOF(IN,OUT,MAXOUT) \
+static size_t cvt##IN##to##OUT( size_t n, const void *imp, void *exp, \
+                                const HdsTypeInfo *ti ) { \
+  const TYPE_##IN *in = imp; \
+  TYPE_##OUT *out = exp; \
+  const TYPE_##IN badin = (TYPE_##IN) ti->BAD##IN; \
+  const TYPE_##OUT badout = (TYPE_##OUT) ti->BAD##OUT; \
+  size_t nerr = 0; \
+  size_t i; \
+  for( i = 0; i < n; i++ ) { \
+    TYPE_##IN v = in[ i ]; \
+    int isbad = ( v == badin ); \
+    int iserr = !isbad && ( v > MAXOUT || v < -MAXOUT ); \
+    out[ i ] = ( isbad || iserr ) ? badout : (TYPE_##OUT) v; \
+    nerr += iserr; \
+  } \
+  return nerr; \
+}
+
+CVT_ITOI(B,UB)
+CVT_ITOI(B,W)
+CVT_ITOI(B,UW)
+CVT_ITOI(B,I)
+CVT_ITOI(B,K)
+CVT_ITOF(B,R)
+CVT_ITOF(B,D)
+
+CVT_ITOI(UB,B)
+CVT_ITOI(UB,W)
+CVT_ITOI(UB,UW)
+CVT_ITOI(UB,I)
+CVT_ITOI(UB,K)
+CVT_ITOF(UB,R)
+CVT_ITOF(UB,D)
+
+CVT_ITOI(W,B)
+CVT_ITOI(W,UB)
+CVT_ITOI(W,UW)
+CVT_ITOI(W,I)
+CVT_ITOI(W,K)
+CVT_ITOF(W,R)
+CVT_ITOF(W,D)
+
+CVT_ITOI(UW,B)
+CVT_ITOI(UW,UB)
+CVT_ITOI(UW,W)
+CVT_ITOI(UW,I)
+CVT_ITOI(UW,K)
+CVT_ITOF(UW,R)
+CVT_ITOF(UW,D)
+
+CVT_ITOI(I,B)
+CVT_ITOI(I,UB)
+CVT_ITOI(I,W)
+CVT_ITOI(I,UW)
+CVT_ITOI(I,K)
+CVT_ITOF(I,R)
+CVT_ITOF(I,D)
+
+CVT_ITOI(K,B)
+CVT_ITOI(K,UB)
+CVT_ITOI(K,W)
+CVT_ITOI(K,UW)
+CVT_ITOI(K,I)
+CVT_ITOF(K,R)
+CVT_ITOF(K,D)
+
+CVT_FTOI(R,B)
+CVT_FTOI(R,UB)
+CVT_FTOI(R,W)
+CVT_FTOI(R,UW)
+CVT_FTOI(R,I)
+CVT_FTOI(R,K)
+CVT_FTOF(R,D,DBL_MAX)
+
+CVT_FTOI(D,B)
+CVT_FTOI(D,UB)
+CVT_FTOI(D,W)
+CVT_FTOI(D,UW)
+CVT_FTOI(D,I)
+CVT_FTOI(D,K)
+CVT_FTOF(D,R,FLT_MAX)
+
+#if CVT_X86
+
+/* SSE2 versions of the commonest conversions. SSE2 is always available
+   on x86-64. Each function converts as many values as it can using
+   vectors and then uses the scalar function above for the remainder.
+   Bad values are detected after conversion to double precision, which
+   is exact for all the input types used here. */
+#define SSE2_SELECT(m,a,b) _mm_or_pd( _mm_and_pd( m, a ), _mm_andnot_pd( m, b ) )
+
+static size_t cvtRtoD_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const float *in = imp;
+  double *out = exp;
+  const __m128d badin = _mm_set1_pd( (double) ti->BADR );
+  const __m128d badout = _mm_set1_pd( ti->BADD );
+  size_t i;
+
+  for( i = 0; i + 2 <= n; i += 2 ) {
+    __m128d v = _mm_cvtps_pd( _mm_castsi128_ps(
+                   _mm_loadl_epi64( (const __m128i *)( in + i ) ) ) );
+    __m128d m = _mm_cmpeq_pd( v, badin );
+    _mm_storeu_pd( out + i, SSE2_SELECT( m, badout, v ) );
+  }
+  return cvtRtoD( n - i, in + i, out + i, ti );
+}
+
+static size_t cvtDtoR_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const double *in = imp;
+  float *out = exp;
+  const __m128d badin = _mm_set1_pd( ti->BADD );
+  const __m128d badout = _mm_set1_pd( (double) ti->BADR );
+  const __m128d maxout = _mm_set1_pd( FLT_MAX );
+  const __m128d absmask = _mm_castsi128_pd( _mm_set1_epi64x( INT64_MAX ) );
+  size_t nerr = 0;
+  size_t i;
+
+  for( i = 0; i + 2 <= n; i += 2 ) {
+    __m128d v = _mm_loadu_pd( in + i );
+    __m128d mbad = _mm_cmpeq_pd( v, badin );
+    __m128d merr = _mm_andnot_pd( mbad, _mm_cmpgt_pd( _mm_and_pd( v, absmask ),
+                                                      maxout ) );
+    v = SSE2_SELECT( _mm_or_pd( mbad, merr ), badout, v );
+    _mm_storel_epi64( (__m128i *)( out + i ),
+                      _mm_castps_si128( _mm_cvtpd_ps( v ) ) );
+    nerr += __builtin_popcount( _mm_movemask_pd( merr ) );
+  }
+  return nerr + cvtDtoR( n - i, in + i, out + i, ti );
+}
+
+static size_t cvtItoR_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const int *in = imp;
+  float *out = exp;
+  const __m128i badin = _mm_set1_epi32( ti->BADI );
+  const __m128 badout = _mm_set1_ps( ti->BADR );
+  size_t i;
+
+  for( i = 0; i + 4 <= n; i += 4 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)( in + i ) );
+    __m128 m = _mm_castsi128_ps( _mm_cmpeq_epi32( v, badin ) );
+    __m128 f = _mm_cvtepi32_ps( v );
+    _mm_storeu_ps( out + i, _mm_or_ps( _mm_and_ps( m, badout ),
+                                       _mm_andnot_ps( m, f ) ) );
+  }
+  return cvtItoR( n - i, in + i, out + i, ti );
+}
+
+static size_t cvtItoD_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const int *in = imp;
+  double *out = exp;
+  const __m128d badin = _mm_set1_pd( (double) ti->BADI );
+  const __m128d badout = _mm_set1_pd( ti->BADD );
+  size_t i;
+
+  for( i = 0; i + 2 <= n; i += 2 ) {
+    __m128d v = _mm_cvtepi32_pd( _mm_loadl_epi64( (const __m128i *)( in + i ) ) );
+    __m128d m = _mm_cmpeq_pd( v, badin );
+    _mm_storeu_pd( out + i, SSE2_SELECT( m, badout, v ) );
+  }
+  return cvtItoD( n - i, in + i, out + i, ti );
+}
+
+static size_t cvtWtoR_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const short *in = imp;
+  float *out = exp;
+  const __m128i badin = _mm_set1_epi16( ti->BADW );
+  const __m128 badout = _mm_set1_ps( ti->BADR );
+  size_t i;
+
+  for( i = 0; i + 8 <= n; i += 8 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *)( in + i ) );
+    __m128i m = _mm_cmpeq_epi16( v, badin );
+    __m128i lo = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+    __m128i hi = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+    __m128 mlo = _mm_castsi128_ps( _mm_unpacklo_epi16( m, m ) );
+    __m128 mhi = _mm_castsi128_ps( _mm_unpackhi_epi16( m, m ) );
+    __m128 flo = _mm_cvtepi32_ps( lo );
+    __m128 fhi = _mm_cvtepi32_ps( hi );
+    _mm_storeu_ps( out + i, _mm_or_ps( _mm_and_ps( mlo, badout ),
+                                       _mm_andnot_ps( mlo, flo ) ) );
+    _mm_storeu_ps( out + i + 4, _mm_or_ps( _mm_and_ps( mhi, badout ),
+                                           _mm_andnot_ps( mhi, fhi ) ) );
+  }
+  return cvtWtoR( n - i, in + i, out + i, ti );
+}
+
+/* Round a vector of doubles to the nearest integer, rounding halves away
+   from zero, and convert to 32 bit integers. Bad input values, and values
+   outside the range of an _INTEGER, are converted to the bad value. The
+   mask of values outside the range is returned in "merr". */
+static __m128i cvtRoundI_sse2( __m128d v, __m128d badin, const HdsTypeInfo *ti,
+                               __m128d *merr ) {
+  const __m128d lo = _mm_set1_pd( (double) VAL__MINI - 0.5 );
+  const __m128d hi = _mm_set1_pd( (double) VAL__MAXI + 0.5 );
+  const __m128d half = _mm_set1_pd( 0.5 );
+  const __m128d mhalf = _mm_set1_pd( -0.5 );
+  const __m128d one = _mm_set1_pd( 1.0 );
+  __m128d mbad = _mm_cmpeq_pd( v, badin );
+  __m128d mok = _mm_and_pd( _mm_cmpgt_pd( v, lo ), _mm_cmplt_pd( v, hi ) );
+  __m128d vc = _mm_and_pd( mok, v );
+  __m128d t = _mm_cvtepi32_pd( _mm_cvttpd_epi32( vc ) );
+  __m128d r = _mm_sub_pd( vc, t );
+  t = _mm_add_pd( t, _mm_and_pd( _mm_cmpge_pd( r, half ), one ) );
+  t = _mm_sub_pd( t, _mm_and_pd( _mm_cmple_pd( r, mhalf ), one ) );
+  *merr = _mm_andnot_pd( _mm_or_pd( mbad, mok ),
+                         _mm_castsi128_pd( _mm_set1_epi32( -1 ) ) );
+  t = SSE2_SELECT( _mm_or_pd( mbad, *merr ),
+                   _mm_set1_pd( (double) ti->BADI ), t );
+  return _mm_cvttpd_epi32( t );
+}
+
+static size_t cvtDtoI_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const double *in = imp;
+  int *out = exp;
+  const __m128d badin = _mm_set1_pd( ti->BADD );
+  __m128d merr;
+  size_t nerr = 0;
+  size_t i;
+
+  for( i = 0; i + 2 <= n; i += 2 ) {
+    __m128i iv = cvtRoundI_sse2( _mm_loadu_pd( in + i ), badin, ti, &merr );
+    _mm_storel_epi64( (__m128i *)( out + i ), iv );
+    nerr += __builtin_popcount( _mm_movemask_pd( merr ) );
+  }
+  return nerr + cvtDtoI( n - i, in + i, out + i, ti );
+}
+
+static size_t cvtRtoI_sse2( size_t n, const void *imp, void *exp,
+                            const HdsTypeInfo *ti ) {
+  const float *in = imp;
+  int *out = exp;
+  const __m128d badin = _mm_set1_pd( (double) ti->BADR );
+  __m128d merr;
+  size_t nerr = 0;
+  size_t i;
+
+  for( i = 0; i + 2 <= n; i += 2 ) {
+    __m128d v = _mm_cvtps_pd( _mm_castsi128_ps(
+                   _mm_loadl_epi64( (const __m128i *)( in + i ) ) ) );
+    __m128i iv = cvtRoundI_sse2( v, badin, ti, &merr );
+    _mm_storel_epi64( (__m128i *)( out + i ), iv );
+    nerr += __builtin_popcount( _mm_movemask_pd( merr ) );
+  }
+  return nerr + cvtRtoI( n - i, in + i, out + i, ti );
+}
+
+/* AVX2 versions of the same conversions. These are compiled for AVX2
+   regardless of the compiler flags, and are only used if the processor
+   supports AVX2. */
+#define AVX2_FUN __attribute__((target("avx2")))
+
+AVX2_FUN static size_t cvtRtoD_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const float *in = imp;
+  double *out = exp;
+  const __m256d badin = _mm256_set1_pd( (double) ti->BADR );
+  const __m256d badout = _mm256_set1_pd( ti->BADD );
+  size_t i;
+
+  for( i = 0; i + 4 <= n; i += 4 ) {
+    __m256d v = _mm256_cvtps_pd( _mm_loadu_ps( in + i ) );
+    __m256d m = _mm256_cmp_pd( v, badin, _CMP_EQ_OQ );
+    _mm256_storeu_pd( out + i, _mm256_blendv_pd( v, badout, m ) );
+  }
+  return cvtRtoD( n - i, in + i, out + i, ti );
+}
+
+AVX2_FUN static size_t cvtDtoR_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const double *in = imp;
+  float *out = exp;
+  const __m256d badin = _mm256_set1_pd( ti->BADD );
+  const __m256d badout = _mm256_set1_pd( (double) ti->BADR );
+  const __m256d maxout = _mm256_set1_pd( FLT_MAX );
+  const __m256d absmask = _mm256_castsi256_pd( _mm256_set1_epi64x( INT64_MAX ) );
+  size_t nerr = 0;
+  size_t i;
+
+  for( i = 0; i + 4 <= n; i += 4 ) {
+    __m256d v = _mm256_loadu_pd( in + i );
+    __m256d mbad = _mm256_cmp_pd( v, badin, _CMP_EQ_OQ );
+    __m256d merr = _mm256_andnot_pd( mbad,
+                      _mm256_cmp_pd( _mm256_and_pd( v, absmask ), maxout,
+                                     _CMP_GT_OQ ) );
+    v = _mm256_blendv_pd( v, badout, _mm256_or_pd( mbad, merr ) );
+    _mm_storeu_ps( out + i, _mm256_cvtpd_ps( v ) );
+    nerr += __builtin_popcount( _mm256_movemask_pd( merr ) );
+  }
+  return nerr + cvtDtoR( n - i, in + i, out + i, ti );
+}
+
+AVX2_FUN static size_t cvtItoR_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const int *in = imp;
+  float *out = exp;
+  const __m256i badin = _mm256_set1_epi32( ti->BADI );
+  const __m256 badout = _mm256_set1_ps( ti->BADR );
+  size_t i;
+
+  for( i = 0; i + 8 <= n; i += 8 ) {
+    __m256i v = _mm256_loadu_si256( (const __m256i *)( in + i ) );
+    __m256 m = _mm256_castsi256_ps( _mm256_cmpeq_epi32( v, badin ) );
+    _mm256_storeu_ps( out + i, _mm256_blendv_ps( _mm256_cvtepi32_ps( v ),
+                                                 badout, m ) );
+  }
+  return cvtItoR( n - i, in + i, out + i, ti );
+}
+
+AVX2_FUN static size_t cvtItoD_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const int *in = imp;
+  double *out = exp;
+  const __m256d badin = _mm256_set1_pd( (double) ti->BADI );
+  const __m256d badout = _mm256_set1_pd( ti->BADD );
+  size_t i;
+
+  for( i = 0; i + 4 <= n; i += 4 ) {
+    __m256d v = _mm256_cvtepi32_pd( _mm_loadu_si128( (const __m128i *)( in + i ) ) );
+    __m256d m = _mm256_cmp_pd( v, badin, _CMP_EQ_OQ );
+    _mm256_storeu_pd( out + i, _mm256_blendv_pd( v, badout, m ) );
+  }
+  return cvtItoD( n - i, in + i, out + i, ti );
+}
+
+AVX2_FUN static size_t cvtWtoR_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const short *in = imp;
+  float *out = exp;
+  const __m256i badin = _mm256_set1_epi32( ti->BADW );
+  const __m256 badout = _mm256_set1_ps( ti->BADR );
+  size_t i;
+
+  for( i = 0; i + 8 <= n; i += 8 ) {
+    __m256i v = _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i *)( in + i ) ) );
+    __m256 m = _mm256_castsi256_ps( _mm256_cmpeq_epi32( v, badin ) );
+    _mm256_storeu_ps( out + i, _mm256_blendv_ps( _mm256_cvtepi32_ps( v ),
+                                                 badout, m ) );
+  }
+  return cvtWtoR( n - i, in + i, out + i, ti );
+}
+
+/* AVX2 equivalent of cvtRoundI_sse2. */
+AVX2_FUN static __m128i cvtRoundI_avx2( __m256d v, __m256d badin,
+                                        const HdsTypeInfo *ti, __m256d *merr ) {
+  const __m256d lo = _mm256_set1_pd( (double) VAL__MINI - 0.5 );
+  const __m256d hi = _mm256_set1_pd( (double) VAL__MAXI + 0.5 );
+  const __m256d half = _mm256_set1_pd( 0.5 );
+  const __m256d mhalf = _mm256_set1_pd( -0.5 );
+  const __m256d one = _mm256_set1_pd( 1.0 );
+  __m256d mbad = _mm256_cmp_pd( v, badin, _CMP_EQ_OQ );
+  __m256d mok = _mm256_and_pd( _mm256_cmp_pd( v, lo, _CMP_GT_OQ ),
+                               _mm256_cmp_pd( v, hi, _CMP_LT_OQ ) );
+  __m256d vc = _mm256_and_pd( mok, v );
+  __m256d t = _mm256_round_pd( vc, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC );
+  __m256d r = _mm256_sub_pd( vc, t );
+  t = _mm256_add_pd( t, _mm256_and_pd( _mm256_cmp_pd( r, half, _CMP_GE_OQ ),
+                                       one ) );
+  t = _mm256_sub_pd( t, _mm256_and_pd( _mm256_cmp_pd( r, mhalf, _CMP_LE_OQ ),
+                                       one ) );
+  *merr = _mm256_andnot_pd( _mm256_or_pd( mbad, mok ),
+                            _mm256_castsi256_pd( _mm256_set1_epi32( -1 ) ) );
+  t = _mm256_blendv_pd( t, _mm256_set1_pd( (double) ti->BADI ),
+                        _mm256_or_pd( mbad, *merr ) );
+  return _mm256_cvttpd_epi32( t );
+}
+
+AVX2_FUN static size_t cvtDtoI_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const double *in = imp;
+  int *out = exp;
+  const __m256d badin = _mm256_set1_pd( ti->BADD );
+  __m256d merr;
+  size_t nerr = 0;
+  size_t i;
+
+  for( i = 0; i + 4 <= n; i += 4 ) {
+    __m128i iv = cvtRoundI_avx2( _mm256_loadu_pd( in + i ), badin, ti, &merr );
+    _mm_storeu_si128( (__m128i *)( out + i ), iv );
+    nerr += __builtin_popcount( _mm256_movemask_pd( merr ) );
+  }
+  return nerr + cvtDtoI( n - i, in + i, out + i, ti );
+}
+
+AVX2_FUN static size_t cvtRtoI_avx2( size_t n, const void *imp, void *exp,
+                                     const HdsTypeInfo *ti ) {
+  const float *in = imp;
+  int *out = exp;
+  const __m256d badin = _mm256_set1_pd( (double) ti->BADR );
+  __m256d merr;
+  size_t nerr = 0;
+  size_t i;
+
+  for( i = 0; i + 4 <= n; i += 4 ) {
+    __m256d v = _mm256_cvtps_pd( _mm_loadu_ps( in + i ) );
+    __m128i iv = cvtRoundI_avx2( v, badin, ti, &merr );
+    _mm_storeu_si128( (__m128i *)( out + i ), iv );
+    nerr += __builtin_popcount( _mm256_movemask_pd( merr ) );
+  }
+  return nerr + cvtRtoI( n - i, in + i, out + i, ti );
+}
+
+#endif
+
+/* The conversion matrix, indexed by input and output hdstype_t. Entries
+   on the diagonal are NULL since no conversion is needed. */
+static CvtFun CvtTable[ HDSTYPE_DOUBLE + 1 ][ HDSTYPE_DOUBLE + 1 ];
+static pthread_once_t CvtTableOnce = PTHREAD_ONCE_INIT;
+
+/* Fill one row of the table. The diagonal entries are NULL (see the
+   defines below). */
+#define CVT_ROW(IN,INTYPE) \
+  CvtTable[ INTYPE ][ HDSTYPE_BYTE ] = cvt##IN##toB; \
+  CvtTable[ INTYPE ][ HDSTYPE_UBYTE ] = cvt##IN##toUB; \
+  CvtTable[ INTYPE ][ HDSTYPE_WORD ] = cvt##IN##toW; \
+  CvtTable[ INTYPE ][ HDSTYPE_UWORD ] = cvt##IN##toUW; \
+  CvtTable[ INTYPE ][ HDSTYPE_INTEGER ] = cvt##IN##toI; \
+  CvtTable[ INTYPE ][ HDSTYPE_INT64 ] = cvt##IN##toK; \
+  CvtTable[ INTYPE ][ HDSTYPE_REAL ] = cvt##IN##toR; \
+  CvtTable[ INTYPE ][ HDSTYPE_DOUBLE ] = cvt##IN##toD;
+
+#define cvtBtoB NULL
+#define cvtUBtoUB NULL
+#define cvtWtoW NULL
+#define cvtUWtoUW NULL
+#define cvtItoI NULL
+#define cvtKtoK NULL
+#define cvtRtoR NULL
+#define cvtDtoD NULL
+
+static void dat1InitCvtTable( void ) {
+  CVT_ROW(B,HDSTYPE_BYTE)
+  CVT_ROW(UB,HDSTYPE_UBYTE)
+  CVT_ROW(W,HDSTYPE_WORD)
+  CVT_ROW(UW,HDSTYPE_UWORD)
+  CVT_ROW(I,HDSTYPE_INTEGER)
+  CVT_ROW(K,HDSTYPE_INT64)
+  CVT_ROW(R,HDSTYPE_REAL)
+  CVT_ROW(D,HDSTYPE_DOUBLE)
+
+#if CVT_X86
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" ) ) {
+    CvtTable[ HDSTYPE_REAL ][ HDSTYPE_DOUBLE ] = cvtRtoD_avx2;
+    CvtTable[ HDSTYPE_DOUBLE ][ HDSTYPE_REAL ] = cvtDtoR_avx2;
+    CvtTable[ HDSTYPE_INTEGER ][ HDSTYPE_REAL ] = cvtItoR_avx2;
+    CvtTable[ HDSTYPE_INTEGER ][ HDSTYPE_DOUBLE ] = cvtItoD_avx2;
+    CvtTable[ HDSTYPE_WORD ][ HDSTYPE_REAL ] = cvtWtoR_avx2;
+    CvtTable[ HDSTYPE_DOUBLE ][ HDSTYPE_INTEGER ] = cvtDtoI_avx2;
+    CvtTable[ HDSTYPE_REAL ][ HDSTYPE_INTEGER ] = cvtRtoI_avx2;
+  } else {
+    CvtTable[ HDSTYPE_REAL ][ HDSTYPE_DOUBLE ] = cvtRtoD_sse2;
+    CvtTable[ HDSTYPE_DOUBLE ][ HDSTYPE_REAL ] = cvtDtoR_sse2;
+    CvtTable[ HDSTYPE_INTEGER ][ HDSTYPE_REAL ] = cvtItoR_sse2;
+    CvtTable[ HDSTYPE_INTEGER ][ HDSTYPE_DOUBLE ] = cvtItoD_sse2;
+    CvtTable[ HDSTYPE_WORD ][ HDSTYPE_REAL ] = cvtWtoR_sse2;
+    CvtTable[ HDSTYPE_DOUBLE ][ HDSTYPE_INTEGER ] = cvtDtoI_sse2;
+    CvtTable[ HDSTYPE_REAL ][ HDSTYPE_INTEGER ] = cvtRtoI_sse2;
+  }
+#endif
+}
+
+int
+dat1CvtNumeric( size_t nval, hdstype_t intype, size_t nbin,
+                hdstype_t outtype, size_t nbout, const void * imp,
+                void * exp, size_t *nbad, int * status ) {
+  CvtFun fun;
+
+  *nbad = 0;
+  if (*status != SAI__OK) return *status;
+
+  /* Sanity check */
+  if ( !HDSTYPE_ISNUMERIC(intype) || !HDSTYPE_ISNUMERIC(outtype) ) {
+    *status = DAT__TYPIN;
+    emsRepf("dat1CvtNumeric_1", "dat1CvtNumeric can only convert between "
+            "numeric types (%d and %d given). (Possible programming error)",
+            status, intype, outtype );
+    return *status;
+  }
+
+  /* If the types are the same just copy the values. */
+  if (intype == outtype) {
+    memmove( exp, imp, nval * nbin );
+    return *status;
+  }
+
+  pthread_once( &CvtTableOnce, dat1InitCvtTable );
+  fun = CvtTable[ intype ][ outtype ];
+  *nbad = fun( nval, imp, exp, dat1TypeInfo() );
+
+  return *status;
+}
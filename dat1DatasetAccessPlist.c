@@ -0,0 +1,186 @@
+/*
+*+
+*  Name:
+*     dat1DatasetAccessPlist
+
+*  Purpose:
+*     Create the HDF5 dataset access properties for a chunked primitive
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1DatasetAccessPlist( hid_t dcpl, hid_t dataspace_id,
+*                                   hid_t h5type, int *status );
+
+*  Arguments:
+*     dcpl = hid_t (Given)
+*        The creation properties of the dataset.
+*     dataspace_id = hid_t (Given)
+*        The dataspace of the dataset.
+*     h5type = hid_t (Given)
+*        HDF5 datatype of the dataset.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     A new HDF5 dataset access property list, or H5P_DEFAULT if the
+*     default properties for the file should be used (or an error occurs).
+*     Any property list that is returned should be closed using H5Pclose
+*     when no longer needed.
+
+*  Description:
+*     Decides if a chunked dataset needs a larger chunk cache than the
+*     default for the file (see the RAWCACHE tuning parameter), and if so
+*     creates a dataset access property list for use with H5Dcreate2 or
+*     H5Dopen2 that gives it one.
+
+*  Notes:
+*     - A dataset needs a larger cache if one layer of its chunks (all the
+*     chunks that share the same position on the slowest varying axis, e.g.
+*     those holding a single plane of a cube) is larger than the default
+*     cache. Otherwise reading the dataset one plane at a time would
+*     decompress every chunk once for each plane it holds. The cache is then
+*     made large enough to hold one layer, up to HDS__MXRAWCACHE bytes, with
+*     about ten hash table slots per chunk.
+*     - H5P_DEFAULT is returned for datasets that are not chunked.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+hid_t dat1DatasetAccessPlist( hid_t dcpl, hid_t dataspace_id,
+                              hid_t h5type, int *status ) {
+
+/* Local Variables; */
+   hid_t dapl = H5P_DEFAULT;
+   hsize_t chunk[ DAT__MXDIM ];
+   hsize_t dims[ DAT__MXDIM ];
+   int i;
+   int ndim;
+   size_t chunkbytes;
+   size_t layerbytes;
+   size_t nchunk;
+   size_t nslots;
+   size_t p;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return dapl;
+
+/* Only chunked datasets have a chunk cache. */
+   if( dcpl == H5P_DEFAULT || H5Pget_layout( dcpl ) != H5D_CHUNKED ) {
+      return dapl;
+   }
+
+   ndim = H5Sget_simple_extent_dims( dataspace_id, dims, NULL );
+   if( ndim < 1 || ndim > DAT__MXDIM ||
+       H5Pget_chunk( dcpl, ndim, chunk ) != ndim ) return dapl;
+
+/* Find the number of bytes in a layer of chunks. The first HDF5 axis is
+   the slowest varying. */
+   chunkbytes = H5Tget_size( h5type );
+   for( i = 0; i < ndim; i++ ) chunkbytes *= chunk[ i ];
+   nchunk = 1;
+   for( i = 1; i < ndim; i++ ) {
+      nchunk *= ( dims[ i ] + chunk[ i ] - 1 )/chunk[ i ];
+   }
+   layerbytes = chunkbytes*nchunk;
+
+/* The default cache will do if it can hold a layer. */
+   if( layerbytes <= (size_t) hds1GetRawCache() ) return dapl;
+   if( layerbytes > HDS__MXRAWCACHE ) {
+      layerbytes = HDS__MXRAWCACHE;
+      nchunk = ( chunkbytes < layerbytes ) ? layerbytes/chunkbytes : 1;
+   }
+
+/* HDF5 recommends a prime number of slots, many more than the number of
+   chunks in the cache. */
+   nslots = 10*nchunk + 1;
+   if( nslots < (size_t) hds1GetRawSlots() ) nslots = hds1GetRawSlots();
+   if( nslots % 2 == 0 ) nslots++;
+   p = 3;
+   while( p*p <= nslots ) {
+      if( nslots % p == 0 ) {
+         nslots += 2;
+         p = 3;
+      } else {
+         p += 2;
+      }
+   }
+
+   CALLHDFE( hid_t, dapl,
+             H5Pcreate( H5P_DATASET_ACCESS ),
+             DAT__HDF5E,
+             emsRep( "dat1DatasetAccessPlist_1", "Error creating HDF5 "
+                     "dataset access properties", status )
+           );
+   CALLHDFQ( H5Pset_chunk_cache( dapl, nslots, layerbytes,
+                                 H5D_CHUNK_CACHE_W0_DEFAULT ) );
+
+CLEANUP:
+   if( *status != SAI__OK ) {
+      if( dapl > 0 ) H5Pclose( dapl );
+      dapl = H5P_DEFAULT;
+   }
+   return dapl;
+}
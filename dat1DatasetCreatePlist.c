@@ -0,0 +1,274 @@
+/*
+*+
+*  Name:
+*     dat1DatasetCreatePlist
+
+*  Purpose:
+*     Create the HDF5 dataset creation properties for a new primitive
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1DatasetCreatePlist( int ndim, const hsize_t h5dims[],
+*                                   hid_t h5type, const HDSCreateProps *props,
+*                                   H5D_layout_t *layout, int *status );
+
+*  Arguments:
+*     ndim = int (Given)
+*        Number of dimensions of the dataset (0 means scalar).
+*     h5dims = const hsize_t [] (Given)
+*        Dimensions in HDF5 C order.
+*     h5type = hid_t (Given)
+*        HDF5 datatype of the dataset.
+*     props = const HDSCreateProps * (Given)
+*        The requested storage properties. Any field holding
+*        HDS_PROP_DEFAULT, and all fields if a NULL pointer is supplied,
+*        take their values from the corresponding tuning parameters.
+*     layout = H5D_layout_t * (Returned)
+*        The layout of the dataset: H5D_COMPACT, H5D_CONTIGUOUS or
+*        H5D_CHUNKED.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     A new HDF5 dataset creation property list, or H5P_DEFAULT if the
+*     default properties should be used (or an error occurs). Any property
+*     list that is returned should be closed using H5Pclose when no longer
+*     needed.
+
+*  Description:
+*     Decides how a new primitive should be stored, and creates the
+*     corresponding dataset creation property list for use with H5Dcreate2.
+
+*  Notes:
+*     - A dataset that holds no more than COMPACT bytes of data (see
+*     hdsTune) has a compact layout, and no filters are applied to it.
+*     COMPACT is zero by default, so compact layouts are only used if
+*     requested.
+*     - Otherwise, a non-scalar dataset is chunked if a chunk shape is
+*     given, or if any filter (deflate, shuffle, fletcher32 or
+*     scale-offset) is requested. Chunked datasets have unlimited maximum
+*     dimensions so that datAlter can resize them in place. If no chunk
+*     shape is given, the chunks span the fastest varying axes and are
+*     cut along the slowest varying axes until they hold no more than
+*     CHUNKSIZE bytes.
+*     - The scale-offset filter is lossless for integer types. Floating
+*     point values are rounded to the given number of decimal places, and
+*     the fill value of the dataset is set to the HDS bad value so that bad
+*     values are preserved. It is not used for _LOGICAL or _CHAR data.
+*     - All other datasets are contiguous, so that they can be memory
+*     mapped, unless HDS was built with HDS_USE_CHUNKED_DATASETS, in which
+*     case they are chunked with a single chunk.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+hid_t dat1DatasetCreatePlist( int ndim, const hsize_t h5dims[],
+                              hid_t h5type, const HDSCreateProps *props,
+                              H5D_layout_t *layout, int *status ) {
+
+/* Local Variables; */
+   HdsTypeInfo *typeinfo;
+   hdsbool_t fletcher32 = HDS_FALSE;
+   hdsbool_t shuffle = HDS_FALSE;
+   hdstype_t hdstype;
+   hid_t dcpl = H5P_DEFAULT;
+   hsize_t chunk[ DAT__MXDIM ];
+   int deflate = 0;
+   int i;
+   int scaleoffset = 0;
+   size_t nbytes;
+   size_t typsize;
+
+   *layout = H5D_CONTIGUOUS;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return dcpl;
+
+/* Get the number of bytes of data. */
+   typsize = H5Tget_size( h5type );
+   nbytes = typsize;
+   for( i = 0; i < ndim; i++ ) nbytes *= h5dims[ i ];
+
+/* Small datasets are stored in the object header. */
+   if( nbytes > 0 && nbytes <= (size_t) hds1GetCompact() ) {
+      *layout = H5D_COMPACT;
+
+/* Scalars can not be chunked. */
+   } else if( ndim > 0 ) {
+
+/* Get the requested filters. */
+      deflate = ( props && props->deflate >= 0 ) ? props->deflate
+                                                 : hds1GetDeflate();
+      shuffle = ( props && props->shuffle >= 0 ) ? ( props->shuffle != 0 )
+                                                 : hds1GetShuffle();
+      fletcher32 = ( props && props->fletcher32 >= 0 )
+                   ? ( props->fletcher32 != 0 ) : hds1GetFletcher32();
+      scaleoffset = ( props && props->scaleoffset >= 0 )
+                    ? props->scaleoffset : hds1GetScaleOffset();
+      if( deflate > 9 ) deflate = 9;
+
+      if( ( props && props->chunk ) || deflate > 0 || shuffle ||
+          fletcher32 || scaleoffset > 0 ) {
+         *layout = H5D_CHUNKED;
+
+/* An explicit chunk shape is given in HDS (Fortran) order, and is
+   limited to the dimensions of the dataset. */
+         if( props && props->chunk ) {
+            for( i = 0; i < ndim; i++ ) {
+               chunk[ ndim - 1 - i ] = ( props->chunk[ i ] > 0 ) ?
+                                       props->chunk[ i ] : 1;
+            }
+
+/* Otherwise, start with the whole dataset and halve the slowest varying
+   axis (the first HDF5 axis) until the chunk is small enough, moving on
+   to the next axis once an axis has been reduced to a single element. */
+         } else {
+            for( i = 0; i < ndim; i++ ) chunk[ i ] = h5dims[ i ];
+            nbytes = typsize;
+            for( i = 0; i < ndim; i++ ) {
+               if( chunk[ i ] == 0 ) chunk[ i ] = 1;
+               nbytes *= chunk[ i ];
+            }
+            i = 0;
+            while( nbytes > (size_t) hds1GetChunkSize() && i < ndim ) {
+               if( chunk[ i ] > 1 ) {
+                  nbytes /= chunk[ i ];
+                  chunk[ i ] = ( chunk[ i ] + 1 )/2;
+                  nbytes *= chunk[ i ];
+               } else {
+                  i++;
+               }
+            }
+         }
+         for( i = 0; i < ndim; i++ ) {
+            if( h5dims[ i ] > 0 && chunk[ i ] > h5dims[ i ] ) {
+               chunk[ i ] = h5dims[ i ];
+            }
+         }
+
+#if HDS_USE_CHUNKED_DATASETS
+      } else {
+         *layout = H5D_CHUNKED;
+         for( i = 0; i < ndim; i++ ) {
+            chunk[ i ] = ( h5dims[ i ] > 0 ) ? h5dims[ i ] : 1;
+         }
+#endif
+      }
+   }
+
+   if( *layout == H5D_CONTIGUOUS ) return dcpl;
+
+   CALLHDFE( hid_t, dcpl,
+             H5Pcreate( H5P_DATASET_CREATE ),
+             DAT__HDF5E,
+             emsRep( "dat1DatasetCreatePlist_1", "Error creating HDF5 "
+                     "dataset creation properties", status )
+           );
+
+   if( *layout == H5D_COMPACT ) {
+      CALLHDFQ( H5Pset_layout( dcpl, H5D_COMPACT ) );
+      goto CLEANUP;
+   }
+
+   CALLHDFQ( H5Pset_chunk( dcpl, ndim, chunk ) );
+
+/* Add the filters in the order in which they are applied when writing.
+   The checksum is calculated last so that it describes the data as
+   stored in the file. */
+   if( scaleoffset > 0 ) {
+      hdstype = dau1HdsType( h5type, status );
+      if( hdstype == HDSTYPE_REAL || hdstype == HDSTYPE_DOUBLE ) {
+         typeinfo = dat1TypeInfo();
+         if( hdstype == HDSTYPE_REAL ) {
+            CALLHDFQ( H5Pset_fill_value( dcpl, H5T_NATIVE_FLOAT,
+                                         &(typeinfo->BADR) ) );
+         } else {
+            CALLHDFQ( H5Pset_fill_value( dcpl, H5T_NATIVE_DOUBLE,
+                                         &(typeinfo->BADD) ) );
+         }
+         CALLHDFQ( H5Pset_scaleoffset( dcpl, H5Z_SO_FLOAT_DSCALE,
+                                       scaleoffset ) );
+      } else if( HDSTYPE_ISNUMERIC( hdstype ) ) {
+         CALLHDFQ( H5Pset_scaleoffset( dcpl, H5Z_SO_INT,
+                                       H5Z_SO_INT_MINBITS_DEFAULT ) );
+      }
+   }
+   if( shuffle ) {
+      CALLHDFQ( H5Pset_shuffle( dcpl ) );
+   }
+   if( deflate > 0 ) {
+      CALLHDFQ( H5Pset_deflate( dcpl, deflate ) );
+   }
+   if( fletcher32 ) {
+      CALLHDFQ( H5Pset_fletcher32( dcpl ) );
+   }
+
+CLEANUP:
+   if( *status != SAI__OK ) {
+      if( dcpl > 0 ) H5Pclose( dcpl );
+      dcpl = H5P_DEFAULT;
+   }
+   return dcpl;
+}
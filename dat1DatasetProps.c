@@ -0,0 +1,189 @@
+/*
+*+
+*  Name:
+*     dat1DatasetProps
+
+*  Purpose:
+*     Get the storage properties of an existing primitive
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1DatasetProps( hid_t dataset_id, HDSCreateProps *props,
+*                            hdsdim chunk[], int *status );
+
+*  Arguments:
+*     dataset_id = hid_t (Given)
+*        The HDF5 dataset.
+*     props = HDSCreateProps * (Returned)
+*        The storage properties of the dataset. Every field is set
+*        explicitly, so none of them refer to the tuning defaults, unless
+*        the dataset is compact (see below). The "chunk" field is set to
+*        point to the supplied "chunk" array if the dataset is chunked,
+*        and is NULL otherwise.
+*     chunk = hdsdim [] (Returned)
+*        An array with at least DAT__MXDIM elements, returned holding the
+*        chunk dimensions, in HDS (Fortran) order, if the dataset is
+*        chunked.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Returns the chunk shape and filters used by an existing dataset, in
+*     the form accepted by dat1NewPrim. This allows a dataset to be
+*     replaced by a new one that is stored in the same way.
+*
+*     A compact dataset records nothing about how it would be stored if
+*     it were larger, so the filters for a compact dataset are returned
+*     as HDS_PROP_DEFAULT. A compact dataset that grows beyond the COMPACT
+*     tuning parameter is therefore stored in the same way as a new
+*     dataset of the same size.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+void dat1DatasetProps( hid_t dataset_id, HDSCreateProps *props,
+                       hdsdim chunk[], int *status ) {
+
+/* Local Variables; */
+   H5D_layout_t layout;
+   H5Z_filter_t filter;
+   hid_t dcpl = 0;
+   hsize_t h5chunk[ DAT__MXDIM ];
+   int i;
+   int nfilter;
+   int rank;
+   size_t nelmts;
+   unsigned int cd_values[ 32 ];
+   unsigned int flags;
+
+   props->chunk = NULL;
+   props->deflate = 0;
+   props->shuffle = 0;
+   props->fletcher32 = 0;
+   props->scaleoffset = 0;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return;
+
+   CALLHDFE( hid_t, dcpl,
+             H5Dget_create_plist( dataset_id ),
+             DAT__HDF5E,
+             emsRep( "dat1DatasetProps_1", "Error obtaining the creation "
+                     "properties of an HDF5 dataset", status )
+           );
+
+   layout = H5Pget_layout( dcpl );
+   if( layout == H5D_COMPACT ) {
+      props->deflate = HDS_PROP_DEFAULT;
+      props->shuffle = HDS_PROP_DEFAULT;
+      props->fletcher32 = HDS_PROP_DEFAULT;
+      props->scaleoffset = HDS_PROP_DEFAULT;
+   }
+   if( layout != H5D_CHUNKED ) goto CLEANUP;
+
+/* Get the chunk shape in HDS order. */
+   CALLHDFE( int, rank,
+             H5Pget_chunk( dcpl, DAT__MXDIM, h5chunk ),
+             DAT__HDF5E,
+             emsRep( "dat1DatasetProps_2", "Error obtaining the chunk "
+                     "shape of an HDF5 dataset", status )
+           );
+   for( i = 0; i < rank; i++ ) chunk[ i ] = h5chunk[ rank - 1 - i ];
+   props->chunk = chunk;
+
+/* Get the filters. */
+   CALLHDFE( int, nfilter,
+             H5Pget_nfilters( dcpl ),
+             DAT__HDF5E,
+             emsRep( "dat1DatasetProps_3", "Error obtaining the filters "
+                     "used by an HDF5 dataset", status )
+           );
+   for( i = 0; i < nfilter; i++ ) {
+      nelmts = sizeof( cd_values )/sizeof( cd_values[ 0 ] );
+      CALLHDFE( H5Z_filter_t, filter,
+                H5Pget_filter2( dcpl, i, &flags, &nelmts, cd_values, 0, NULL,
+                                NULL ),
+                DAT__HDF5E,
+                emsRep( "dat1DatasetProps_4", "Error obtaining the filters "
+                        "used by an HDF5 dataset", status )
+              );
+      if( filter == H5Z_FILTER_DEFLATE ) {
+         props->deflate = ( nelmts > 0 ) ? (int) cd_values[ 0 ] : 6;
+      } else if( filter == H5Z_FILTER_SHUFFLE ) {
+         props->shuffle = 1;
+      } else if( filter == H5Z_FILTER_FLETCHER32 ) {
+         props->fletcher32 = 1;
+      } else if( filter == H5Z_FILTER_SCALEOFFSET ) {
+         if( nelmts > 1 && cd_values[ 0 ] == H5Z_SO_FLOAT_DSCALE ) {
+            props->scaleoffset = (int) cd_values[ 1 ];
+         } else {
+            props->scaleoffset = 1;
+         }
+      }
+   }
+
+CLEANUP:
+   if( dcpl > 0 ) H5Pclose( dcpl );
+}
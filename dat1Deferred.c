@@ -0,0 +1,238 @@
+#include <pthread.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "dat_err.h"
+
+/* Locators returned by datFind (and so datIndex) and by datCell for an
+   existing structure cell do not open the HDF5 object when they are
+   created. Instead they hold a reference to the identifier for the
+   parent group (in "defer_id") and a flag indicating if the object is a
+   structure. The name of the link within the parent group is the name
+   stored in the locator's Handle. The HDF5 object is opened the first
+   time the locator is used for anything other than a cheap query (see
+   dat1ValidateQuery), so code that only enquires the name, type or
+   structure-ness of each component (or the shape of a structure) - and
+   then annuls the locator - need not open it. The shape of a primitive
+   requires its dataspace, and so opens it.
+
+   A deferred locator has no group, dataset or dataspace identifier.
+   Any code that uses a locator validated with dat1ValidateQuery,
+   rather than dat1ValidateLocator, must therefore call dat1OpenDeferred
+   before using these identifiers.
+
+   The reference to the parent group is counted (H5Iinc_ref), so it
+   remains valid even if the parent locator is annulled first. It is
+   released when the object is opened or the locator is annulled.
+
+   Any thread with a lock on the object may open it, so "defer_id" is
+   only changed with the Handle mutex locked, and it is cleared with
+   release semantics once the identifiers for the opened object have
+   been stored. A thread that reads "defer_id" without the mutex must do
+   so with acquire semantics, and can then rely on the identifiers
+   being visible if it finds "defer_id" is zero. "deferstruc" is left
+   unchanged when "defer_id" is cleared. */
+
+/* Return HDS_TRUE if the named component exists within the structure
+   identified by "parent", and return a flag indicating if the component
+   is itself a structure. The flag is taken from the Handle for the
+   component if the Handle already exists and has the flag cached.
+   Otherwise HDF5 is asked for the basic object information, which is
+   cheaper than opening the object. An error is reported if the
+   component exists but is neither a group nor a dataset. The HDF5
+   error stack is cleared if the component does not exist, since the
+   caller is expected to decide if that is an error. */
+
+hdsbool_t dat1PeekStruc( const HDSLoc *parent, const char *name,
+                         hdsbool_t *isstruc, int *status ) {
+#if H5_VERSION_GE(1,12,0)
+  H5O_info2_t info;
+#else
+  H5O_info_t info;
+#endif
+  Handle *child = NULL;
+  herr_t herr;
+
+  *isstruc = HDS_FALSE;
+  if (*status != SAI__OK) return HDS_FALSE;
+
+  if (parent->handle) {
+    HASH_FIND_STR( parent->handle->childhash, name, child );
+    if (child && dat1MetaCached( child, HDS__META_STRUC )) {
+      *isstruc = child->metastruc;
+      return HDS_TRUE;
+    }
+  }
+
+#if H5_VERSION_GE(1,12,0)
+  herr = H5Oget_info_by_name3( parent->group_id, name, &info,
+                               H5O_INFO_BASIC, H5P_DEFAULT );
+#elif H5_VERSION_GE(1,10,3)
+  herr = H5Oget_info_by_name2( parent->group_id, name, &info,
+                               H5O_INFO_BASIC, H5P_DEFAULT );
+#else
+  herr = H5Oget_info_by_name( parent->group_id, name, &info, H5P_DEFAULT );
+#endif
+  if (herr < 0) {
+    H5Eclear2( H5E_DEFAULT );
+    return HDS_FALSE;
+  }
+
+  if (info.type == H5O_TYPE_GROUP) {
+    *isstruc = HDS_TRUE;
+  } else if (info.type != H5O_TYPE_DATASET) {
+    *status = DAT__OBJIN;
+    emsRepf( " ", "Component '%s' exists but is neither group nor dataset.",
+             status, name );
+  }
+
+  return HDS_TRUE;
+}
+
+/* Mark a new locator as referring to an object that has not yet been
+   opened. The parent group identifier is referenced rather than copied.
+   The locator's Handle should be stored before the object is opened
+   (it supplies the link name), and the structure flag is cached in it
+   if possible. */
+
+void dat1DeferLocator( HDSLoc *locator, hid_t parent_id, hdsbool_t isstruc,
+                       int *status ) {
+
+  if (*status != SAI__OK) return;
+
+  if (H5Iinc_ref( parent_id ) < 0) {
+    *status = DAT__HDF5E;
+    dat1H5EtoEMS( status );
+    emsRep( " ", "Error referencing the parent group of an HDS object.",
+            status );
+    return;
+  }
+
+  locator->deferstruc = isstruc;
+  locator->defer_id = parent_id;
+}
+
+/* Reopen a chunked primitive, opened from its parent group by
+   dat1OpenDeferred, if it needs a larger chunk cache than the default
+   for the file (see dat1DatasetAccessPlist). The cache is chosen when a
+   dataset is first opened, so the dataset is closed before reopening
+   it. If some other locator already has the dataset open, the new
+   cache is ignored by HDF5 and the existing cache is shared. Getting
+   the creation properties is slow compared to opening a small dataset,
+   so datasets no larger than a quarter of the default cache (i.e. most
+   of them) are not checked, since a layer of their chunks will fit. */
+
+static void dat1SizeChunkCache( HDSLoc *loc, int *status ) {
+  hid_t dcpl;
+  hid_t dapl = H5P_DEFAULT;
+  hid_t type_id;
+  hssize_t npoints;
+
+  if (*status != SAI__OK) return;
+
+  npoints = H5Sget_simple_extent_npoints( loc->dataspace_id );
+  if (npoints <= 0) return;
+
+  type_id = H5Dget_type( loc->dataset_id );
+  if (type_id < 0) return;
+  if (npoints*H5Tget_size( type_id ) <= (size_t) hds1GetRawCache()/4) {
+    H5Tclose( type_id );
+    return;
+  }
+
+  dcpl = H5Dget_create_plist( loc->dataset_id );
+  if (dcpl < 0) {
+    H5Tclose( type_id );
+    *status = DAT__HDF5E;
+    dat1H5EtoEMS( status );
+    emsRepf( " ", "Error retrieving the storage properties of primitive "
+             "named %s", status, loc->handle->name );
+    return;
+  }
+
+  dapl = dat1DatasetAccessPlist( dcpl, loc->dataspace_id, type_id, status );
+  H5Tclose( type_id );
+  H5Pclose( dcpl );
+
+  if (dapl != H5P_DEFAULT) {
+    H5Dclose( loc->dataset_id );
+    loc->dataset_id = H5Dopen2( loc->defer_id, loc->handle->name, dapl );
+    H5Pclose( dapl );
+    if (loc->dataset_id < 0) {
+      loc->dataset_id = 0;
+      H5Sclose( loc->dataspace_id );
+      loc->dataspace_id = 0;
+      *status = DAT__OBJIN;
+      dat1H5EtoEMS( status );
+      emsRepf( " ", "Error opening primitive named %s", status,
+               loc->handle->name );
+    }
+  }
+}
+
+/* Open the HDF5 object for a locator created by dat1DeferLocator, if it
+   has not already been opened. The identifiers in a locator are state
+   that is filled in on demand, so this is allowed for a const locator.
+   The Handle mutex prevents two threads that have read locks on the
+   object from opening it at the same time. */
+
+void dat1OpenDeferred( const HDSLoc *locator, int *status ) {
+  HDSLoc *loc = (HDSLoc *) locator;
+  hid_t objid;
+
+  if (*status != SAI__OK || !loc ||
+      !__atomic_load_n( &(loc->defer_id), __ATOMIC_ACQUIRE )) return;
+
+  pthread_mutex_lock( &(loc->handle->mutex) );
+
+  if (loc->defer_id) {
+    objid = H5Oopen( loc->defer_id, loc->handle->name, H5P_DEFAULT );
+    if (objid < 0) {
+      *status = DAT__OBJIN;
+      dat1H5EtoEMS( status );
+      emsRepf( " ", "Error opening component %s", status,
+               loc->handle->name );
+
+    } else if (loc->deferstruc) {
+      loc->group_id = objid;
+
+    } else {
+      loc->dataspace_id = H5Dget_space( objid );
+      if (loc->dataspace_id < 0) {
+        loc->dataspace_id = 0;
+        H5Oclose( objid );
+        *status = DAT__OBJIN;
+        dat1H5EtoEMS( status );
+        emsRepf( " ", "Error retrieving data space from primitive named %s",
+                 status, loc->handle->name );
+      } else {
+        loc->dataset_id = objid;
+        dat1SizeChunkCache( loc, status );
+      }
+    }
+
+    if (*status == SAI__OK) dat1CloseDeferred( loc );
+  }
+
+  pthread_mutex_unlock( &(loc->handle->mutex) );
+}
+
+/* Release the reference to the parent group held by a locator for an
+   object that has not been opened. Called with the Handle mutex locked,
+   unless no other thread can be using the locator (e.g. when it is
+   annulled). */
+
+void dat1CloseDeferred( HDSLoc *locator ) {
+  hid_t parent_id;
+  if (locator) {
+    parent_id = __atomic_load_n( &(locator->defer_id), __ATOMIC_RELAXED );
+    if (parent_id) {
+      __atomic_store_n( &(locator->defer_id), 0, __ATOMIC_RELEASE );
+      H5Idec_ref( parent_id );
+    }
+  }
+}
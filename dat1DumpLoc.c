@@ -99,11 +99,17 @@ void dat1DumpLoc( const char *text, const HDSLoc* locator, int * status ) {
   printf("- File: %d; Group %d; Dataspace: %d; Dataset: %d; Data Type: %d\n",
          locator->file_id, locator->group_id, locator->dataspace_id,
          locator->dataset_id, locator->dtype);
-  printf("- Vectorized: %zu; Bytes mapped: %zu, Array mapped: %p (%s)\n",
-         locator->vectorized, locator->bytesmapped, locator->regpntr,
-         (locator->uses_true_mmap ? "file" : "memory"));
+  if (locator->map) {
+    printf("- Vectorized: %zu; Bytes mapped: %zu, Array mapped: %p (%s)\n",
+           locator->vectorized, locator->map->bytesmapped,
+           locator->map->regpntr,
+           (locator->map->uses_true_mmap ? "file" : "memory"));
+  } else {
+    printf("- Vectorized: %zu; Not mapped\n", locator->vectorized);
+  }
   printf("- Is sliced: %d; Primary: %s; Group name: '%s'\n", locator->isslice,
-         (locator->isprimary ? "yes" : "no"), locator->grpname);
+         (locator->isprimary ? "yes" : "no"),
+         (locator->grpname ? locator->grpname : ""));
   printf("- Is a discontiguous slice: %s\n", (locator->isdiscont ? "yes" : "no") );
 
   if (locator->dataspace_id > 0) {
@@ -41,11 +41,14 @@
 
 *  Authors:
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     5-JUL-2017 (DSB):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Find the component using the parent's hash table of children.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -109,19 +112,10 @@ Handle *dat1EraseHandle( Handle *parent, const char *name, int * status ){
 /* Find the handle to be erased - either the named component in the
    parent, or the parent itself. */
    if( name ) {
-      for( ichild = 0; ichild < parent->nchild; ichild++ ) {
-         child = parent->children[ ichild ];
-         if( child && child->name && !strcmp( child->name, name ) ) {
-            comp = child;
-
-/* We will be erasing this handle ("child") below. The parent will therefore
-   no longer have this handle as a child. So remove it from the parent's list
-   of children by storing a NULL pointer. */
-            parent->children[ ichild ] = NULL;
-            break;
-         }
-      }
+      HASH_FIND_STR( parent->childhash, name, comp );
 
+/* Note, the handle is removed from the parent's list of children when it
+   is freed by dat1FreeHandle below. */
    } else {
       comp = parent;
    }
@@ -0,0 +1,153 @@
+/*
+*+
+*  Name:
+*     dat1FileAccessPlist
+
+*  Purpose:
+*     Create the HDF5 file access properties used when opening a file
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1FileAccessPlist( unsigned int flags, int *status );
+
+*  Arguments:
+*     flags = unsigned int (Given)
+*        The HDF5 access flags with which the file is to be opened or
+*        created (e.g. H5F_ACC_RDONLY, H5F_ACC_RDWR or H5F_ACC_TRUNC).
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     A new HDF5 file access property list. It should be closed using
+*     H5Pclose when no longer needed. H5P_DEFAULT is returned if an error
+*     occurs.
+
+*  Description:
+*     Creates the file access property list that should be used for all
+*     calls to H5Fopen and H5Fcreate made by HDS.
+
+*  Notes:
+*     - The size of the chunk cache, the number of slots in its hash
+*     table, the size of the sieve buffer and the size of the blocks used
+*     for metadata are given by the RAWCACHE, RAWSLOTS, SIEVE and
+*     METABLOCK tuning parameters (see hdsTune).
+*     - If files opened for writing are to be mapped directly (see the
+*     MAP and MAPUPDATE tuning parameters), such files have the HDF5 data
+*     sieve buffer disabled and the SIEVE tuning parameter is ignored.
+*     Data mapped directly from the file can then be modified without HDF5
+*     holding an out of date copy in the sieve buffer. datMap checks for
+*     this before mapping a file that is open for writing, and maps a copy
+*     of the data otherwise.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Set the chunk cache, sieve buffer and metadata block size from
+*        the tuning parameters.
+*     2026-10-16 (AGENT):
+*        Only disable the sieve buffer if MAPUPDATE is set.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+hid_t dat1FileAccessPlist( unsigned int flags, int *status ) {
+
+/* Local Variables; */
+   hid_t fapl = H5P_DEFAULT;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return fapl;
+
+   CALLHDFE( hid_t, fapl,
+             H5Pcreate( H5P_FILE_ACCESS ),
+             DAT__HDF5E,
+             emsRep( "dat1FileAccessPlist_1", "Error creating HDF5 file "
+                     "access properties", status )
+           );
+
+/* The default chunk cache for each dataset in the file. The number of
+   metadata cache elements is no longer used by HDF5, and the preemption
+   policy is left at the HDF5 default. */
+   CALLHDFQ( H5Pset_cache( fapl, 0, hds1GetRawSlots(), hds1GetRawCache(),
+                           0.75 ) );
+   CALLHDFQ( H5Pset_meta_block_size( fapl, hds1GetMetaBlock() ) );
+
+/* HDF5 keeps a copy of small pieces of raw data that have recently been
+   read or written in a "sieve buffer", and uses that copy in place of the
+   file when possible. If datMap modifies the file directly the sieve
+   buffer would then be out of date, so disable it for any file that may
+   be written to if such files are to be mapped. Otherwise keep it, and
+   datMap will map a copy of the data in files open for writing. */
+   if( flags != H5F_ACC_RDONLY && hds1GetUseMmap() && hds1GetMapUpdate() ) {
+      CALLHDFQ( H5Pset_sieve_buf_size( fapl, 0 ) );
+   } else {
+      CALLHDFQ( H5Pset_sieve_buf_size( fapl, hds1GetSieve() ) );
+   }
+
+CLEANUP:
+   if( *status != SAI__OK && fapl > 0 ) {
+      H5Pclose( fapl );
+      fapl = H5P_DEFAULT;
+   }
+   return fapl;
+}
@@ -0,0 +1,199 @@
+/*
+*+
+*  Name:
+*     dat1FileSpace
+
+*  Purpose:
+*     Get the dataspace describing the elements of a dataset used by a locator
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1FileSpace( const HDSLoc *locator, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator for a primitive.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     hid_t = The dataspace to use as the file dataspace when reading or
+*        writing the elements of the dataset referred to by the locator. This
+*        is the locator's own dataspace unless the locator is vectorized, in
+*        which case it is a new dataspace that should be closed using H5Sclose
+*        when no longer needed. Zero is returned if an error occurs.
+
+*  Description:
+*     The dataspace of a vectorized locator is one-dimensional even if the
+*     dataset has more dimensions, and selects a single range of elements in
+*     the order they are stored. HDF5 only accepts such a dataspace as the
+*     file dataspace for a contiguous dataset. For a chunked dataset it must
+*     have the same rank as the dataset. This function returns a dataspace
+*     with the shape of the dataset, selecting the same elements as the
+*     vectorized locator (as a union of hyperslabs).
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+hid_t dat1FileSpace( const HDSLoc *locator, int *status ) {
+
+/* Local Variables; */
+   H5S_sel_type seltype;
+   H5S_seloper_t op = H5S_SELECT_SET;
+   hid_t result = 0;
+   hsize_t block[ 2 ];
+   hsize_t count[ DAT__MXDIM ];
+   hsize_t dims[ DAT__MXDIM ];
+   hsize_t first;
+   hsize_t last;
+   hsize_t nel;
+   hsize_t rem;
+   hsize_t start[ DAT__MXDIM ];
+   hsize_t stride[ DAT__MXDIM ];
+   int i;
+   int j;
+   int rank;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return result;
+
+/* Nothing to do unless the locator is vectorized. */
+   if( !locator->vectorized ) return locator->dataspace_id;
+
+   CALLHDFE( hid_t, result,
+             H5Dget_space( locator->dataset_id ),
+             DAT__HDF5E,
+             emsRep( "dat1FileSpace_1", "Error obtaining the data space "
+                     "of an HDF5 dataset", status )
+           );
+   CALLHDFE( int, rank,
+             H5Sget_simple_extent_dims( result, dims, NULL ),
+             DAT__DIMIN,
+             emsRep( "dat1FileSpace_2", "Error obtaining the shape of an "
+                     "HDF5 dataset", status )
+           );
+
+/* A one-dimensional dataset can use the locator's own dataspace. */
+   if( rank <= 1 ) {
+      H5Sclose( result );
+      return locator->dataspace_id;
+   }
+
+/* Get the range of elements selected by the locator (a vectorized
+   locator selects either all elements or a single block). */
+   seltype = H5Sget_select_type( locator->dataspace_id );
+   if( seltype == H5S_SEL_ALL ) goto CLEANUP;
+   if( seltype == H5S_SEL_HYPERSLABS &&
+       H5Sget_select_hyper_nblocks( locator->dataspace_id ) == 1 ) {
+      CALLHDFQ( H5Sget_select_hyper_blocklist( locator->dataspace_id, 0, 1,
+                                               block ) );
+      first = block[ 0 ];
+      last = block[ 1 ];
+   } else {
+      *status = DAT__OBJIN;
+      emsRep( "dat1FileSpace_3", "Unexpected selection in a vectorized "
+              "locator (programming error)", status );
+      goto CLEANUP;
+   }
+
+/* Number of elements in a step along each axis. */
+   stride[ rank - 1 ] = 1;
+   for( i = rank - 2; i >= 0; i-- ) stride[ i ] = stride[ i + 1 ]*dims[ i + 1 ];
+
+/* Select the range as a series of hyperslabs. Each one is the largest
+   block of whole rows, planes, etc, that starts at the first remaining
+   element. */
+   while( first <= last ) {
+
+/* Find the slowest varying axis on which the first remaining element
+   is at the start of a step, such that the step fits in the range. */
+      for( j = 0; j < rank - 1; j++ ) {
+         if( first % stride[ j ] == 0 && first + stride[ j ] - 1 <= last ) break;
+      }
+
+/* Get the position of the first element, and the number of steps that
+   can be taken along axis "j" without leaving the range or the axis. */
+      rem = first;
+      for( i = 0; i < rank; i++ ) {
+         start[ i ] = rem / stride[ i ];
+         rem = rem % stride[ i ];
+         count[ i ] = ( i < j ) ? 1 : dims[ i ];
+      }
+      nel = ( last - first + 1 )/stride[ j ];
+      if( nel > dims[ j ] - start[ j ] ) nel = dims[ j ] - start[ j ];
+      count[ j ] = nel;
+
+      CALLHDFQ( H5Sselect_hyperslab( result, op, start, NULL, count, NULL ) );
+      op = H5S_SELECT_OR;
+      first += nel*stride[ j ];
+   }
+
+CLEANUP:
+   if( *status != SAI__OK ) {
+      if( result > 0 ) H5Sclose( result );
+      result = 0;
+   }
+   return result;
+}
@@ -25,7 +25,8 @@
 
 *  Description:
 *     The memory used by the supplied Handle is freed, and a NULL pointer
-*     returned.
+*     returned. If the Handle has a parent, it is first removed from the
+*     parent's list of children.
 
 *  Notes:
 *     - This function will attempt to execute even if an error has
@@ -33,11 +34,21 @@
 
 *  Authors:
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     5-JUL-2017 (DSB):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Remove the Handle from its parent's children and free the
+*        child hash table.
+*     2026-10-16 (AGENT):
+*        Use dat1UnlinkHandle.
+*     2026-10-16 (AGENT):
+*        Free the list of names known not to exist.
+*     2026-10-16 (AGENT):
+*        Return Handles and read lock arrays to their pools.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -94,20 +105,32 @@ Handle *dat1FreeHandle( Handle *handle, int *status ) {
 /* Return immediately if an invalid Handle was supplied. */
    if( dat1ValidateHandle( "dat1FreeHandle", handle, status ) ) {
 
+/* Remove the Handle from its parent's array of children and hash
+   table, and record the slot it occupied as free for re-use. */
+      dat1UnlinkHandle( handle );
+
 /* Free the memory used by components of the Handle structure. */
       if( handle->name ) MEM_FREE( handle->name );
+      HASH_CLEAR( hh, handle->childhash );
       if( handle->children ) MEM_FREE( handle->children );
-      if( handle->read_lockers ) MEM_FREE( handle->read_lockers );
-
-/* Destroy the mutex */
+      if( handle->freechild ) MEM_FREE( handle->freechild );
+      if( handle->absent ) MEM_FREE( handle->absent );
+      if( handle->maxreaders == HDS__POOLLOCKERS ) {
+         dat1PoolFree( HDS__POOL_LOCKERS, handle->read_lockers );
+      } else if( handle->read_lockers ) {
+         MEM_FREE( handle->read_lockers );
+      }
+
+/* The mutex is kept for use when the Handle is re-used, unless Handles
+   are not being pooled. */
+#if DEBUG_HDS
       pthread_mutex_destroy( &(handle->mutex) );
+      pthread_mutex_destroy( &(handle->lockmutex) );
+#endif
 
-/* Fill the handles with zeros in case any other points to the same
-   handle exist. */
-      memset( handle, 0, sizeof(*handle) );
-
-/* Free the memory used by the Handle structure itself. */
-      MEM_FREE( handle );
+/* Return the Handle to the pool. This fills it with zeros (except for
+   the mutex) in case any other pointers to the same handle exist. */
+      dat1PoolFree( HDS__POOL_HANDLE, handle );
    }
 
 /* End the error reporting context. */
@@ -32,6 +32,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -43,6 +44,12 @@
 *        Initial version
 *     2020-08-06 (DSB):
 *        Fill the memory with zeros before freeing it.
+*     2026-10-16 (AGENT):
+*        Get locators from a pool rather than allocating each one.
+*     2026-10-16 (AGENT):
+*        Free any group name and mapping details held by the locator.
+*     2026-10-16 (AGENT):
+*        Remove the locator from any hdsBegin scope that owns it.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -111,9 +118,16 @@ dat1FreeLoc( HDSLoc * locator, int * status ) {
         }
      }
 
-     /* Always attempt to free the memory even if status is bad */
-     memset( locator, 0, sizeof( *locator ));
-     MEM_FREE(locator);
+     /* Remove it from any hdsBegin scope that owns it. */
+     dat1ScopeRemove( locator );
+
+     /* Free any side structures that are still attached. */
+     if (locator->grpname) MEM_FREE( locator->grpname );
+     if (locator->map) MEM_FREE( locator->map );
+
+     /* Always attempt to free the memory even if status is bad. The
+        locator is filled with zeros before being returned to the pool. */
+     dat1PoolFree( HDS__POOL_LOC, locator );
   }
 
   return NULL;
@@ -38,6 +38,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -45,6 +46,11 @@
 *        Initial version
 *     2014-11-21 (TIMJ):
 *        Use dat1GetStructDims
+*     2026-10-16 (AGENT):
+*        Open the HDF5 object if it has not yet been opened.
+*     2026-10-16 (AGENT):
+*        Read the identifier of the parent of an unopened object
+*        atomically.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -113,6 +119,14 @@ dat1GetBounds( const HDSLoc * locator, hdsdim lower[DAT__MXDIM],
 
 
 
+   /* A primitive that has not yet been opened has no dataspace, so open
+      it now. Unopened structures are never vectorised or sliced. */
+  if( __atomic_load_n( &(locator->defer_id), __ATOMIC_ACQUIRE ) &&
+      !locator->deferstruc ) {
+    dat1OpenDeferred( locator, status );
+    if (*status != SAI__OK) return *status;
+  }
+
    /* If the supplied locator has a dataspace, then use the bounds of the
       data space. This is done even if the object is a structure, since
       vectorised structure arrays will have a dataspace describing their
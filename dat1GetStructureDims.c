@@ -37,6 +37,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -45,6 +46,12 @@
 *  History:
 *     2014-11-21 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
+*     2026-10-16 (AGENT):
+*        Cache the dimensions in the Handle.
+*     2026-10-16 (AGENT):
+*        Open the HDF5 object if it has not yet been opened.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -101,10 +108,31 @@ int
 dat1GetStructureDims( const HDSLoc * locator, int maxdims, hdsdim dims[], int *status ) {
 
   size_t actdims = 0;
+  Handle *handle = locator->handle;
+  int i;
+
   if (*status != SAI__OK) return actdims;
-  if (!H5Aexists(locator->group_id, HDS__ATTR_STRUCT_DIMS)) return actdims;
+  if (locator->isemptycell) return actdims;
+
+  /* Use the dimensions cached in the Handle if available */
+  if (dat1MetaCached( handle, HDS__META_SDIMS ) &&
+      handle->metansdim <= maxdims) {
+    for (i = 0; i < handle->metansdim; i++) dims[i] = handle->metasdims[i];
+    return handle->metansdim;
+  }
+
+  dat1OpenDeferred( locator, status );
+  if (*status != SAI__OK) return actdims;
+
+  if (H5Aexists(locator->group_id, HDS__ATTR_STRUCT_DIMS)) {
+    dat1GetAttrHdsdims( locator->group_id, HDS__ATTR_STRUCT_DIMS, HDS_FALSE,
+                        0, NULL, maxdims, dims, &actdims, status );
+  }
 
-  dat1GetAttrHdsdims( locator->group_id, HDS__ATTR_STRUCT_DIMS, HDS_FALSE,
-                      0, NULL, maxdims, dims, &actdims, status );
+  if (*status == SAI__OK && handle) {
+    handle->metansdim = actdims;
+    for (i = 0; i < (int)actdims; i++) handle->metasdims[i] = dims[i];
+    dat1MetaStore( handle, HDS__META_SDIMS );
+  }
   return actdims;
 }
@@ -0,0 +1,170 @@
+/*
+*+
+*  Name:
+*     dat1GroupCreatePlist
+
+*  Purpose:
+*     Create the HDF5 group creation properties used for new structures
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1GroupCreatePlist( hdsbool_t isfile, int *status );
+
+*  Arguments:
+*     isfile = hdsbool_t (Given)
+*        If true, return file creation properties for use with H5Fcreate,
+*        which control the root group of the new file. Otherwise, return
+*        group creation properties for use with H5Gcreate2.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     A new HDF5 group or file creation property list. It should be closed using
+*     H5Pclose when no longer needed. H5P_DEFAULT is returned if an error
+*     occurs.
+
+*  Description:
+*     Creates the group (or file) creation property list that should be
+*     used for all calls to H5Gcreate2 (or H5Fcreate) made by HDS to create
+*     a structure or a cell of a structure array.
+
+*  Notes:
+*     - The groups track and index the creation order of their links, so
+*     that datIndex and datIterate return components in the order in which
+*     they were created (as in HDS version 4), and so that datIndex can look
+*     up a component by position in a B-tree rather than sorting all the
+*     link names. Groups in files written by earlier versions of HDS-v5
+*     have no such index, and their components are returned in
+*     alphabetical order (see dat1IndexType).
+*     - If the INAL tuning parameter is non-zero, the file creation
+*     properties make HDF5 allocate space within the file in pages, with
+*     metadata and raw data in separate pages, and keep track of free
+*     space between sessions. Large datasets in a file that grows to
+*     many GB are then allocated in aligned, contiguous pieces, and
+*     space freed by erasing or altering components is reused.
+*     - If the NCOM tuning parameter is non-zero, space for NCOM links is
+*     reserved in the header of each new group, and groups holding up to
+*     NCOM links (or eight, if more) use compact rather than dense link
+*     storage. This avoids the header having to be extended in pieces
+*     scattered through the file as components are added.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Use the NCOM tuning parameter to size new groups, and the INAL
+*        tuning parameter to choose the file space strategy.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+hid_t dat1GroupCreatePlist( hdsbool_t isfile, int *status ) {
+
+/* Local Variables; */
+   hid_t gcpl = H5P_DEFAULT;
+   int ncomp;
+   unsigned est_name_len;
+   unsigned est_num;
+   unsigned max_compact;
+   unsigned min_dense;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return gcpl;
+
+   CALLHDFE( hid_t, gcpl,
+             H5Pcreate( isfile ? H5P_FILE_CREATE : H5P_GROUP_CREATE ),
+             DAT__HDF5E,
+             emsRep( "dat1GroupCreatePlist_1", "Error creating HDF5 "
+                     "creation properties", status )
+           );
+
+/* Record the order in which links are created, and index it. */
+   CALLHDFQ( H5Pset_link_creation_order( gcpl, H5P_CRT_ORDER_TRACKED |
+                                               H5P_CRT_ORDER_INDEXED ) );
+
+/* Allocate space within the file in pages if space is to be reserved
+   for the file. */
+   if( isfile && hds1GetInal() > 0 ) {
+      CALLHDFQ( H5Pset_file_space_strategy( gcpl, H5F_FSPACE_STRATEGY_PAGE,
+                                            1, 1 ) );
+   }
+
+/* Size the group for the expected number of components. The estimated
+   number of links must not exceed the number held in compact form, so
+   the compact limit is raised first if required. */
+   ncomp = hds1GetNcomp();
+   if( ncomp > 0 ) {
+      CALLHDFQ( H5Pget_link_phase_change( gcpl, &max_compact, &min_dense ) );
+      if( (unsigned) ncomp > max_compact ) {
+         CALLHDFQ( H5Pset_link_phase_change( gcpl, ncomp, ( 3*ncomp )/4 ) );
+      }
+      CALLHDFQ( H5Pget_est_link_info( gcpl, &est_num, &est_name_len ) );
+      CALLHDFQ( H5Pset_est_link_info( gcpl, ncomp, est_name_len ) );
+   }
+
+CLEANUP:
+   if( *status != SAI__OK ) {
+      if( gcpl > 0 ) H5Pclose( gcpl );
+      gcpl = H5P_DEFAULT;
+   }
+   return gcpl;
+}
@@ -57,11 +57,26 @@
 
 *  Authors:
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     5-JUL-2017 (DSB):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Find existing child Handles using a hash table rather than a
+*        linear search, and grow the children array geometrically.
+*     2026-10-16 (AGENT):
+*        Use dat1LinkHandle.
+*     2026-10-16 (AGENT):
+*        Initialise the lock owner tokens.
+*     2026-10-16 (AGENT):
+*        Initialise the count of descendant locks.
+*     2026-10-16 (AGENT):
+*        Get Handles from a pool, and only initialise the mutex the first
+*        time a pooled Handle is used.
+*     2026-10-16 (AGENT):
+*        Initialise the lock mutex.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -119,12 +134,10 @@ Handle *dat1Handle( const HDSLoc *parent_loc, const char *name, int rdonly,
 /* Local Variables; */
    char *ext;
    char *lname = NULL;
-   Handle *child;
+   Handle *child = NULL;
    Handle *parent;
    Handle *result = NULL;
-   int ichild;
    int lock_status;
-   int ichild_unused;
 
 /* Return immediately if an error has already occurred. */
    if( *status != SAI__OK ) return result;
@@ -147,84 +160,63 @@ Handle *dat1Handle( const HDSLoc *parent_loc, const char *name, int rdonly,
    parent = parent_loc ? parent_loc->handle : NULL;
    if( parent_loc ) dat1ValidateHandle( "dat1Handle", parent, status );
 
-/* If a parent Handle is available, search through the Handles for any
-   known child objects to see if the requested component within the parent
-   (identified by 'name') is already known and therefore already has an
-   associated Handle structure. If it does, return a pointer to the child
-   Handle structure. Note "nchild" is the size of the "children" array -
-   this is not necessarily the same as the actual number of active
-   children since this array may contain some NULL pointers. */
-   ichild_unused = -1;
+/* If a parent Handle is available, look up the requested component
+   within the parent (identified by 'name') in the parent's hash table of
+   known child objects. If it is already known and therefore already has
+   an associated Handle structure, return a pointer to the child Handle
+   structure. */
    if( parent && lname ) {
-      for( ichild = 0; ichild < parent->nchild; ichild++ ) {
-         child = parent->children[ichild];
-         if( !child ){
-            ichild_unused = ichild;
-         } else if( !dat1ValidateHandle( "dat1Handle", child, status ) ){
-            break;
-         } else if( !strcmp( child->name, lname ) ) {
-            result = child;
-            break;
-         }
+      HASH_FIND_STR( parent->childhash, lname, child );
+      if( child && dat1ValidateHandle( "dat1Handle", child, status ) ) {
+         result = child;
       }
    }
 
 /* If we need to create a new Handle... */
    if( !result && *status == SAI__OK ) {
 
-/* Allocate the memory, filling it with zeros (NULLs). Report an error
-   if the memory could not be allocated */
-      result = MEM_CALLOC( 1, sizeof(*result) );
+/* Get a Handle from the pool, filled with zeros (NULLs) except for the
+   mutex, which is retained from any previous use. Report an error if the
+   memory could not be allocated */
+      result = dat1PoolAlloc( HDS__POOL_HANDLE, status );
       if( !result ) {
-         *status = DAT__NOMEM;
+         if( *status == SAI__OK ) *status = DAT__NOMEM;
          emsRep("dat1Handle", "Could not allocate memory for HDS Handle",
                 status );
 
 /* If the memory for the new Handle was allocated succesfully... */
       } else {
 
-/* Create links between the new Handle and any supplied parent. */
-         result->parent = parent;
-         if( parent ) {
-
-/* If an used slot in the children array was found, we re-used it.
-   Otherwise we extend the children array. */
-            if( ichild_unused == - 1) {
-               ichild_unused = parent->nchild++;
-               parent->children = MEM_REALLOC( parent->children,
-                                               parent->nchild*sizeof(Handle *) );
-            }
-
-            if( !parent->children ) {
-               *status = DAT__NOMEM;
-               emsRep("dat1Handle", "Could not reallocate memory for "
-                      "child links in an HDS Handle", status );
-            } else {
-               parent->children[ ichild_unused ] = result;
-            }
-
-         }
-
 /* Store the component name. Nullify "lname" to indicate the memory is
    now part of the Handle structure and should not be freed below. */
          result->name = lname;
          lname = NULL;
 
-/* Initialise a mutex that is used to serialise access to the values
-   stored in the handle. */
-         if( *status == SAI__OK &&
-             pthread_mutex_init( &(result->mutex), NULL ) != 0 ) {
-            *status = DAT__MUTEX;
-            emsRep( " ", "Failed to initialise POSIX mutex for a new Handle.",
-                    status );
+/* Create links between the new Handle and any supplied parent. */
+         if( parent ) dat1LinkHandle( parent, result, status );
+
+/* Initialise the mutex that is used to serialise access to the values
+   stored in the handle, unless it was initialised when the Handle was
+   previously used. */
+         if( *status == SAI__OK && !result->mutexinit ) {
+            if( pthread_mutex_init( &(result->mutex), NULL ) != 0 ||
+                pthread_mutex_init( &(result->lockmutex), NULL ) != 0 ) {
+               *status = DAT__MUTEX;
+               emsRep( " ", "Failed to initialise POSIX mutex for a new Handle.",
+                       status );
+            } else {
+               result->mutexinit = 1;
+            }
          }
 
 /* Initialise the Handle to indicate it is currently unlocked. */
          result->docheck = 1;
-         result->nwrite_lock = 0;
+         result->write_owner = 0;
          result->nread_lock = 0;
          result->read_lockers = NULL;
          result->maxreaders = 0;
+         memset( result->read_owners, 0, sizeof(result->read_owners) );
+         result->nsublock = 0;
 
 /* The address of the Handle is stored in the "check" component. This is
    used later to check that the handle is still valid (i.e. has not been
@@ -33,7 +33,7 @@
 *            4: locked for reading by one or more other threads (the
 *               current thread does not have a read lock on the Handle);
 *
-*            If "recurs" is non-zero and there are child Handles the
+*            If "recurs" is non-zero and there are known child Handles the
 *            above values take on the following meanings:
 *
 *            0: The supplied Handle and all children are unlocked;
@@ -51,8 +51,7 @@
 *        2 - Lock the handle (and all descendants if "recurs" is non-zero)
 *            for read-write or read-only use by the current thread. The
 *            result is 0 if the request conflicts with any existing lock (in
-*            which case the request to lock the supplied Handle is ignored)
-*            and +1 otherwise.
+*            which case no locks are changed) and +1 otherwise.
 *        3 - Unlock the handle (and all descendants if "recurs" is
 *            non-zero). If the current thread has a lock - either read-write
 *            or read-only - on the Handle, it is removed and +1 is returned
@@ -60,11 +59,13 @@
 *            0 or -1 is returned - -1 is returned if the handle is currently
 *            locked for writing by a different thread, and zero is returned
 *            otherwise (in which case the current thread does not have a lock,
-*            but some other threads may have read locks). If "recurs" is
-*            non-zero, +1 is returned only if the supplied Handle and all
-*            child handles are locked by the current thread. Otherwise, the
-*            returned value relates to the first handle (either the supplied
-*            or a child handle) that was no locked by the current thread.
+*            but some other threads may have read locks).
+*        4 - Remove the locks held on the Handle and its descendants from
+*            the counts stored in its ancestors. Called by dat1UnlinkHandle
+*            before the Handle is detached from its parent.
+*        5 - Add the locks held on the Handle and its descendants to the
+*            counts stored in its ancestors. Called by dat1LinkHandle after
+*            the Handle has been attached to a parent.
 *
 *     recurs = int (Given)
 *        If "recurs" is zero, the supplied Handle is the only Handle to be
@@ -99,9 +100,23 @@
 *     access with zero or more other threads.
 *
 *     A request to check, lock or unlock a handle can be propagated
-*     recursively to all child handles by setting "recurs" non-zero. However,
-*     if the attempt to lock or unlock a child fails, no error will be reported
-*     and the child will be left unchanged.
+*     recursively to all child handles by setting "recurs" non-zero. This
+*     is done without visiting the children. Instead, the lock is stored
+*     in the supplied Handle as a "deep" lock, which is inherited by all
+*     descendants (including those for which no Handle yet exists) unless
+*     the same thread has since changed the lock on the descendant. The
+*     lock held by a thread on a Handle is thus the lock it holds on the
+*     Handle itself, if any, or else the deep lock it holds on the closest
+*     ancestor. Conflicts with deep locks held by other threads are found
+*     by checking the ancestors of the Handle. Conflicts with locks held by
+*     other threads on descendants are found using the count of such locks
+*     stored in each Handle, so only the parts of the tree that contain
+*     locks need to be searched.
+*
+*     If a thread changes the lock on a descendant of a Handle on which it
+*     holds a deep lock, the deep lock is first moved down the tree to the
+*     children of each Handle on the path to the descendant. This is the
+*     only case in which the cost depends on the number of children.
 
 *  Notes:
 *     - If a thread gets a read-write lock on the handle, and
@@ -111,13 +126,22 @@
 *     subsequently attempts to get a read-write lock, the existing
 *     read-only lock will be promoted to a read-write lock only if
 *     there are no other locks on the Handle.
-*     - "oper" values of -2 and -3 are used in place of 2 and 3 when
-*     calling this function recursively from within itself.
+*     - A non-recursive lock on a Handle with no known children is
+*     stored as a deep lock so that any children later created by any
+*     thread inherit it.
+*     - The lock information in all the Handles for a container file is
+*     protected by a single mutex, held in the top-level Handle for the
+*     file, since a single change may affect several Handles in the file.
+*     Locks in different files do not interact, so threads using
+*     different files do not contend for the mutex. A thread checking
+*     that it already holds a lock on a Handle does not need to lock the
+*     mutex.
 *     - A value of zero is returned if an error has already ocurred, or
 *     if this function fails for any reason.
 
 *  Authors:
 *     DSB: David S Berry (DSB)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -132,6 +156,19 @@
 *     3-JUL-2018 (DSB):
 *        Fix incrementation bugs in loops that loop round lists of
 *        read-lockers.
+*     2026-10-16 (AGENT):
+*        Record the tokens of the threads holding locks so that a thread can
+*        check it already holds a lock without locking the Handle mutex.
+*     2026-10-16 (AGENT):
+*        Recursive locks are now stored as deep locks in the supplied
+*        Handle and inherited lazily by descendants, rather than being
+*        applied to every known descendant. Use a single mutex for all
+*        Handles. Added opers 4 and 5.
+*     2026-10-16 (AGENT):
+*        Get the first array of read lock words for a Handle from a pool.
+*     2026-10-16 (AGENT):
+*        Use a separate mutex for each container file, held in its top-
+*        level Handle.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -177,29 +214,84 @@
 
 
 #include <pthread.h>
+#include <string.h>
 #include "sae_par.h"
 #include "dat1.h"
 #include "ems.h"
 #include "dat_err.h"
 
-/* The initial size for the array holding the identifiers for the threads
+/* The initial size for the array holding the lock words for the threads
    that have a read lock on a handle. It is also the incremement in size
    when the array needs to be extended. */
 #define NTHREAD 10
 
+/* Each thread is given a unique non-zero token the first time it uses
+   this function. A lock held by a thread on a Handle is recorded as a
+   "lock word" holding the thread's token shifted left by one bit, with
+   the lowest bit set if the lock is a deep lock (i.e. is inherited by
+   descendants). Unlike pthread_t values, tokens are never re-used. */
+#define DEEP 1
+#define LOCKWORD(token,deep) ( ((token)<<1) | ((deep)?DEEP:0) )
+#define LOCKTOKEN(word) ((word)>>1)
+
+/* Types of lock, as returned by dat1OwnLock and dat1EffectiveLock. The
+   values are the corresponding "result" values for oper 1. */
+#define WRITE 1
+#define READ 3
+
+/* Bits returned by dat1EffectiveLock describing the locks held by other
+   threads. */
+#define OTHER_WRITE 1
+#define OTHER_READ 2
+
+/* The lock word of the thread holding a write lock on a Handle, and the
+   lock words of up to HDS__NFASTREAD threads holding read locks, are
+   stored in components of the Handle that are read and written
+   atomically. This allows a thread to check that it already holds a lock
+   without locking the mutex. Only the thread that owns a token stores it
+   in a Handle or removes it, so finding its own token is reliable even
+   though other threads may be modifying the Handle at the same time. */
+static size_t NextToken = 0;
+static __thread size_t ThreadToken = 0;
+
+static size_t dat1ThreadToken( void );
+static pthread_mutex_t *dat1LockMutex( Handle *handle );
+static void dat1AddReadOwner( Handle *handle, size_t word );
+static void dat1RemoveReadOwner( Handle *handle, size_t word );
+static int dat1OwnLock( Handle *handle, size_t token, int *deep );
+static void dat1SetLock( Handle *handle, size_t token, int type, int deep,
+                         int *status );
+static void dat1CountLocks( Handle *handle, int delta );
+static int dat1EffectiveLock( Handle *handle, int incown, size_t token,
+                              int *deep, Handle **holder, int *others );
+static int dat1LockResult( int type, int others );
+static int dat1QueryLock( Handle *handle, size_t token, int recurs );
+static Handle *dat1LockConflict( Handle *handle, size_t token, int type );
+static void dat1RemoveBelow( Handle *handle, size_t token, int *status );
+static void dat1PushDown( Handle *handle, size_t token, int *status );
+static void dat1PullDown( Handle *holder, Handle *handle, size_t token,
+                          int *status );
+
+/* Handle has known children? */
+#define HAS_CHILDREN(handle) ((handle)->nchild > (handle)->nfree)
+
 Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly,
                         int *result, int *status ){
 
 /* Local Variables; */
-   Handle *child;
-   int ichild;
-   int top_level;
-   pthread_t *locker;
-   pthread_t *rlocker;
-   int i;
-   int j;
    Handle *error_handle = NULL;
-   int child_result;
+   Handle *holder;
+   Handle *parent;
+   int current;
+   int deep;
+   int i;
+   int nlock;
+   int others;
+   int own;
+   int type;
+   pthread_mutex_t *mutex;
+   size_t token;
+   size_t word;
 
 /* initialise */
    *result = 0;
@@ -210,283 +302,480 @@ Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly,
 /* Validate the supplied Handle */
    if( !dat1ValidateHandle( "dat1HandleLock", handle, status ) ) return error_handle;
 
-/* To avoid deadlocks, we only lock the Handle mutex for top level
-   entries to this function. If "oper" is negative, negate it and set a
-   flag indicating we do not need to lock the mutex. */
-   if( oper < 0 ) {
-      oper = -oper;
-      top_level = 0;
-   } else {
-      top_level = 1;
+/* Get the token for the current thread. */
+   token = dat1ThreadToken();
+
+/* If we are only checking the lock on the supplied Handle (the usual
+   case when validating a locator), first see if the current thread
+   already holds a lock on the Handle, or a deep lock on an ancestor. This
+   does not need the mutex. If not, we fall through to the full check
+   below. */
+   if( oper == 1 && !recurs ) {
+      own = 1;
+      for( parent = handle; parent; parent = parent->parent ) {
+         word = __atomic_load_n( &(parent->write_owner), __ATOMIC_ACQUIRE );
+         if( LOCKTOKEN( word ) == token && ( own || ( word & DEEP ) ) ) {
+            *result = 1;
+            return error_handle;
+         }
+         for( i = 0; i < HDS__NFASTREAD; i++ ) {
+            word = __atomic_load_n( parent->read_owners + i, __ATOMIC_ACQUIRE );
+            if( LOCKTOKEN( word ) == token && ( own || ( word & DEEP ) ) ) {
+               *result = 3;
+               return error_handle;
+            }
+         }
+         own = 0;
+      }
    }
 
-/* For top-level entries to this function, we need to ensure no other thread
-   is modifying the details in the handle, so attempt to lock the handle's
-   mutex. */
-   if( top_level ) pthread_mutex_lock( &(handle->mutex) );
+/* Ensure no other thread is modifying the lock information for the
+   file. */
+   mutex = dat1LockMutex( handle );
+   pthread_mutex_lock( mutex );
 
 /* Return information about the current lock on the supplied Handle.
    ------------------------------------------------------------------ */
    if( oper == 1 ) {
+      *result = dat1QueryLock( handle, token, recurs );
 
-/* Default: unlocked */
-
-      if( handle->nwrite_lock ) {
-         if( pthread_equal( handle->write_locker, pthread_self() )) {
+/* Lock the handle for use by the current thread.
+   ------------------------------------------------------------------ */
+   } else if( oper == 2 ) {
+      type = rdonly ? READ : WRITE;
+
+/* Get the lock currently held by this thread on the Handle, and the locks
+   held by other threads. */
+      current = dat1EffectiveLock( handle, 1, token, &deep, &holder, &others );
+
+/* A read-write lock conflicts with any lock held by another thread. A
+   read-only lock conflicts with a read-write lock held by another
+   thread. If we are locking the whole tree, also check for conflicting
+   locks held on descendants. */
+      if( ( type == WRITE && others ) ||
+          ( type == READ && ( others & OTHER_WRITE ) ) ) {
+         error_handle = handle;
+      } else if( recurs ) {
+         error_handle = dat1LockConflict( handle, token, type );
+      }
 
-/* Locked for writing by the current thread. */
-            *result = 1;
-         } else {
+      if( !error_handle ) {
+
+/* For a non-recursive lock, nothing needs to be done if the thread
+   already has the required type of lock. Otherwise, if the current lock
+   is a deep lock, move it down to the children so that they retain it,
+   and then store the new lock in the Handle. */
+         if( !recurs ) {
+            if( current != type ) {
+               if( deep ) {
+                  dat1PullDown( holder, handle, token, status );
+                  dat1PushDown( handle, token, status );
+               }
+               dat1SetLock( handle, token, type, !HAS_CHILDREN( handle ),
+                            status );
+            }
 
-/* Locked for writing by another thread. */
-            *result = 2;
+/* For a recursive lock, nothing needs to be done if the thread already
+   has the required type of lock inherited from an ancestor. Otherwise
+   any deep lock on an ancestor is moved down to the Handle, any locks
+   held by the thread on descendants are removed, and a deep lock is
+   stored in the Handle. */
+         } else if( !deep || holder == handle || current != type ) {
+            if( deep ) dat1PullDown( holder, handle, token, status );
+            dat1RemoveBelow( handle, token, status );
+            dat1SetLock( handle, token, type, 1, status );
          }
 
-      } else if( handle->nread_lock ){
+         if( *status == SAI__OK ) *result = 1;
+      }
 
-/* Locked for reading by one or more other threads (the current thread does
-   not have a read lock on the Handle). */
-         *result = 4;
+/* Unlock the handle.
+   ----------------- */
+   } else if( oper == 3 ) {
+      current = dat1EffectiveLock( handle, 1, token, &deep, &holder, &others );
 
-/* Now check to see if the current thread has a read lock, changing the
-   above result value if it does. */
-         locker = handle->read_lockers;
-         for( i = 0; i < handle->nread_lock;i++,locker++ ) {
-            if( pthread_equal( *locker, pthread_self() )) {
+/* If the current thread has no lock on the Handle, return -1 or 0. */
+      if( !current ) {
+         *result = ( others & OTHER_WRITE ) ? -1 : 0;
+         error_handle = handle;
 
-/* Locked for reading by the current thread (other threads may also have
-   a read lock on the Handle). */
-               *result = 3;
-               break;
-            }
+/* Otherwise, ensure the lock is stored in the Handle itself rather than
+   inherited from an ancestor. For a non-recursive unlock, any deep lock is
+   then moved down to the children so that they remain locked. Then
+   remove the lock, plus any locks held on descendants if required. */
+      } else {
+         if( deep ) {
+            dat1PullDown( holder, handle, token, status );
+            if( !recurs ) dat1PushDown( handle, token, status );
          }
+         dat1SetLock( handle, token, 0, 0, status );
+         if( recurs ) dat1RemoveBelow( handle, token, status );
+         if( *status == SAI__OK ) *result = 1;
       }
 
-/* If required, check any child handles. If we already have a status of
-   2, (the supplied handle is locked read-write by another thread), we do
-   not need to check the children. */
-      if( recurs && *result != 2 ){
-         for( ichild = 0; ichild < handle->nchild; ichild++ ) {
-            child = handle->children[ichild];
-            if( child ) {
+/* Remove or add the locks held on the Handle and its descendants from or
+   to the counts stored in its ancestors.
+   ------------------------------------------------------------------ */
+   } else if( oper == 4 || oper == 5 ) {
+      nlock = ( handle->write_owner ? 1 : 0 ) + handle->nread_lock +
+              handle->nsublock;
+      dat1CountLocks( handle->parent, ( oper == 4 ) ? -nlock : nlock );
+      *result = 1;
 
-/* Get the lock status of the child. */
-               (void) dat1HandleLock( child, -1, 1, rdonly, &child_result,
-                                      status );
+/* Report an error for any other "oper" value. */
+   } else if( *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRepf( " ", "dat1HandleLock: Unknown 'oper' value (%d) supplied - "
+               "(internal HDS programming error).", status, oper );
+   }
 
-/* If it's 2, we can set the final result and exit immediately. */
-               if( child_result == 2 ) {
-                  *result = 2;
-                  break;
+/* Unlock the mutex so that other threads can access the lock
+   information. */
+   pthread_mutex_unlock( mutex );
 
-/* Otherwise, ensure the child gives the same result as all the others,
-   breaking out and returning the catch-all value if not. */
-               } else if(  child_result != *result ) {
-                  *result = 5;
-                  break;
-               }
-            }
-         }
-      }
+/* Return the error handle. */
+   return error_handle;
+}
 
+/* Return the token for the current thread, allocating one if this is
+   the first call in the thread. */
+static size_t dat1ThreadToken( void ) {
+   if( !ThreadToken ) ThreadToken = __atomic_add_fetch( &NextToken, 1,
+                                                         __ATOMIC_RELAXED );
+   return ThreadToken;
+}
 
+/* Return the mutex that serialises access to the lock information for
+   the container file holding the object described by "handle". This is
+   the "lockmutex" in the top-level Handle for the file. The top-level
+   Handle does not change while any thread holds a lock within the file,
+   since Handles are only moved within a file (see datMove). */
+static pthread_mutex_t *dat1LockMutex( Handle *handle ) {
+   while( handle->parent ) handle = handle->parent;
+   return &(handle->lockmutex);
+}
 
+/* Copy a read lock word into the first free slot of "handle->read_owners".
+   Nothing is recorded if all slots are in use, in which case the thread's
+   lock will be found by the full check in dat1HandleLock. Must be called
+   with the mutex locked. */
+static void dat1AddReadOwner( Handle *handle, size_t word ) {
+   int i;
+   for( i = 0; i < HDS__NFASTREAD; i++ ) {
+      if( handle->read_owners[ i ] == 0 ) {
+         __atomic_store_n( handle->read_owners + i, word, __ATOMIC_RELEASE );
+         break;
+      }
+   }
+}
 
+/* Remove a read lock word from "handle->read_owners". Must be called with
+   the mutex locked. */
+static void dat1RemoveReadOwner( Handle *handle, size_t word ) {
+   int i;
+   for( i = 0; i < HDS__NFASTREAD; i++ ) {
+      if( handle->read_owners[ i ] == word ) {
+         __atomic_store_n( handle->read_owners + i, 0, __ATOMIC_RELEASE );
+         break;
+      }
+   }
+}
 
-/* Lock the handle for use by the current thread.
-   ------------------------------------------------------------------ */
-   } else if( oper == 2 ) {
+/* Return the type of lock (WRITE, READ or zero) held on the Handle itself
+   by the thread with the given token, and whether it is a deep lock. */
+static int dat1OwnLock( Handle *handle, size_t token, int *deep ) {
+   int i;
 
-/* A read-only lock requested.... */
-      if( rdonly ) {
-
-/* If the current thread has a read-write lock on the Handle, demote it
-   to a read-only lock and return 1 (success). In this case, we know
-   there will be no other read-locks. Otherwise if any other thread has
-   read-write lock, return zero (failure). */
-         if( handle->nwrite_lock ) {
-            if( pthread_equal( handle->write_locker, pthread_self() )) {
-
-/* If we do not have an array in which to store read lock thread IDs,
-   allocate one now with room for NTHREAD locks. It will be extended as
-   needed. */
-               if( !handle->read_lockers ) {
-                  handle->read_lockers = MEM_CALLOC(NTHREAD,sizeof(pthread_t));
-                  if( !handle->read_lockers ) {
-                     *status = DAT__NOMEM;
-                     emsRep( "", "Could not allocate memory for HDS "
-                             "Handle read locks list.", status );
-                  }
-               }
+   if( LOCKTOKEN( handle->write_owner ) == token ) {
+      *deep = ( handle->write_owner & DEEP );
+      return WRITE;
+   }
 
-/* If we now have an array, store the current thread in the first element. */
-               if( handle->read_lockers ) {
-                  handle->read_lockers[ 0 ] = pthread_self();
-                  handle->nread_lock = 1;
-                  handle->nwrite_lock = 0;
-                  *result = 1;
-               }
-            }
+   for( i = 0; i < handle->nread_lock; i++ ) {
+      if( LOCKTOKEN( handle->read_lockers[ i ] ) == token ) {
+         *deep = ( handle->read_lockers[ i ] & DEEP );
+         return READ;
+      }
+   }
 
-/* If there is no read-write lock on the Handle, add the current thread
-   to the list of threads that currently have a read-only lock, but only
-   if it is not already there. */
-         } else {
+   *deep = 0;
+   return 0;
+}
 
-/* Set "result" to 1 if the current thread already has a read-only lock. */
-            locker = handle->read_lockers;
-            for( i = 0; i < handle->nread_lock;i++,locker++ ) {
-               if( pthread_equal( *locker, pthread_self() )) {
-                  *result = 1;
-                  break;
-               }
+/* Replace any lock held on the Handle by the thread with the given token
+   with a lock of the given type (no lock if "type" is zero), and update
+   the counts of locks stored in the ancestors. */
+static void dat1SetLock( Handle *handle, size_t token, int type, int deep,
+                         int *status ) {
+   int delta = 0;
+   int i;
+   int maxreaders;
+   size_t *lockers;
+   size_t word;
+
+/* Remove any existing lock. */
+   if( LOCKTOKEN( handle->write_owner ) == token ) {
+      __atomic_store_n( &(handle->write_owner), 0, __ATOMIC_RELEASE );
+      delta--;
+   } else {
+      for( i = 0; i < handle->nread_lock; i++ ) {
+         if( LOCKTOKEN( handle->read_lockers[ i ] ) == token ) {
+            dat1RemoveReadOwner( handle, handle->read_lockers[ i ] );
+            for( i++; i < handle->nread_lock; i++ ) {
+               handle->read_lockers[ i - 1 ] = handle->read_lockers[ i ];
             }
+            handle->nread_lock--;
+            delta--;
+            break;
+         }
+      }
+   }
 
-/* If not, extend the read lock thread ID array if necessary, and append
-   the current thread ID to the end. */
-            if( *result == 0 ) {
-               handle->nread_lock++;
-               if( handle->maxreaders < handle->nread_lock ) {
-                  handle->maxreaders += NTHREAD;
-                  handle->read_lockers = MEM_REALLOC( handle->read_lockers,
-                                                    handle->maxreaders*sizeof(pthread_t));
-                  if( !handle->read_lockers ) {
-                     *status = DAT__NOMEM;
-                     emsRep( "", "Could not reallocate memory for HDS "
-                             "Handle read locks list.", status );
-                  }
-               }
-
-               if( handle->read_lockers ) {
-                  handle->read_lockers[ handle->nread_lock - 1 ] = pthread_self();
-
-/* Indicate the read-only lock was applied successfully. */
-                  *result = 1;
-               }
+/* Store the new lock, extending the array of read lock words if
+   necessary. */
+   word = LOCKWORD( token, deep );
+   if( type == WRITE ) {
+      __atomic_store_n( &(handle->write_owner), word, __ATOMIC_RELEASE );
+      delta++;
+
+   } else if( type == READ ) {
+      if( handle->nread_lock == handle->maxreaders ) {
+
+/* The first array comes from a pool. Larger arrays are allocated
+   individually. */
+         if( handle->maxreaders == 0 ) {
+            lockers = dat1PoolAlloc( HDS__POOL_LOCKERS, status );
+            maxreaders = HDS__POOLLOCKERS;
+         } else if( handle->maxreaders == HDS__POOLLOCKERS ) {
+            maxreaders = handle->maxreaders + NTHREAD;
+            lockers = MEM_MALLOC( maxreaders*sizeof(size_t) );
+            if( lockers ) {
+               memcpy( lockers, handle->read_lockers,
+                       handle->maxreaders*sizeof(size_t) );
+               dat1PoolFree( HDS__POOL_LOCKERS, handle->read_lockers );
             }
+         } else {
+            maxreaders = handle->maxreaders + NTHREAD;
+            lockers = MEM_REALLOC( handle->read_lockers,
+                                   maxreaders*sizeof(size_t) );
          }
+         if( lockers ) {
+            handle->read_lockers = lockers;
+            handle->maxreaders = maxreaders;
+         } else if( *status == SAI__OK ) {
+            *status = DAT__NOMEM;
+            emsRep( "", "Could not reallocate memory for HDS "
+                    "Handle read locks list.", status );
+         }
+      }
 
-/* A read-write lock requested. */
-      } else {
+      if( handle->nread_lock < handle->maxreaders ) {
+         handle->read_lockers[ handle->nread_lock++ ] = word;
+         dat1AddReadOwner( handle, word );
+         delta++;
+      }
+   }
 
-/* If there are currently no locks of any kind, apply the lock. */
-         if( handle->nread_lock == 0 ) {
-            if( handle->nwrite_lock == 0 ) {
-               handle->write_locker = pthread_self();
-               handle->nwrite_lock = 1;
-               *result = 1;
+   if( delta ) dat1CountLocks( handle->parent, delta );
+}
 
-/* If the current thread already has a read-write lock, indicate success. */
-            } else if( pthread_equal( handle->write_locker, pthread_self() )) {
-               *result = 1;
-            }
+/* Add "delta" to the count of descendant locks stored in the supplied
+   Handle and all its ancestors. */
+static void dat1CountLocks( Handle *handle, int delta ) {
+   for( ; handle; handle = handle->parent ) handle->nsublock += delta;
+}
 
-/* If there is currently only one read-only lock, and it is owned by the
-   current thread, then promote it to a read-write lock. */
-         } else if( handle->nread_lock == 1 &&
-                    pthread_equal( handle->read_lockers[0], pthread_self() )) {
-            handle->nread_lock = 0;
-            handle->write_locker = pthread_self();
-            handle->nwrite_lock = 1;
-            *result = 1;
+/* Return the type of lock held by the thread with the given token on the
+   supplied Handle, either on the Handle itself or inherited from a deep
+   lock on an ancestor. Locks on the Handle itself (as opposed to deep
+   locks) are ignored if "incown" is zero, giving the lock that would be
+   inherited by a child of the Handle with no locks of its own. Also
+   returns the Handle holding the lock, whether it is a deep lock, and
+   OTHER_ bits describing the locks held by other threads. */
+static int dat1EffectiveLock( Handle *handle, int incown, size_t token,
+                              int *deep, Handle **holder, int *others ) {
+   Handle *parent;
+   int i;
+   int result = 0;
+   size_t word;
+
+   *deep = 0;
+   *holder = NULL;
+   *others = 0;
+
+   for( parent = handle; parent; parent = parent->parent ) {
+      word = parent->write_owner;
+      if( word && ( incown || ( word & DEEP ) ) ) {
+         if( LOCKTOKEN( word ) != token ) {
+            *others |= OTHER_WRITE;
+         } else if( !result ) {
+            result = WRITE;
+            *deep = ( word & DEEP );
+            *holder = parent;
          }
       }
 
-/* If required, and if the above lock operation was successful, lock any
-   child handles that can be locked. */
-      if( *result ){
-         if( recurs ){
-            for( ichild = 0; ichild < handle->nchild; ichild++ ) {
-               child = handle->children[ichild];
-               if( child ) {
-                  error_handle = dat1HandleLock( child, -2, 1, rdonly,
-                                                 result, status );
-                  if( error_handle ) break;
-               }
+      for( i = 0; i < parent->nread_lock; i++ ) {
+         word = parent->read_lockers[ i ];
+         if( incown || ( word & DEEP ) ) {
+            if( LOCKTOKEN( word ) != token ) {
+               *others |= OTHER_READ;
+            } else if( !result ) {
+               result = READ;
+               *deep = ( word & DEEP );
+               *holder = parent;
             }
          }
-
-/* If the lock operation failed, return a pointer to the Handle. */
-      } else {
-         error_handle = handle;
       }
 
+      incown = 0;
+   }
 
+   return result;
+}
 
+/* Convert the values returned by dat1EffectiveLock into the "result"
+   value returned by oper 1 for a single Handle. */
+static int dat1LockResult( int type, int others ) {
+   if( type ) return type;
+   if( others & OTHER_WRITE ) return 2;
+   if( others & OTHER_READ ) return 4;
+   return 0;
+}
 
-/* Unlock the handle.
-   ----------------- */
-   } else if( oper == 3 ) {
+/* Return the "result" value for oper 1. */
+static int dat1QueryLock( Handle *handle, size_t token, int recurs ) {
+   Handle *child;
+   Handle *holder;
+   int child_result;
+   int deep;
+   int ichild;
+   int others;
+   int result;
+   int type;
 
-/* Assume failure. */
-      *result = 0;
+   type = dat1EffectiveLock( handle, 1, token, &deep, &holder, &others );
+   result = dat1LockResult( type, others );
 
-/* If the current thread has a read-write lock, remove it. */
-      if( handle->nwrite_lock ) {
-         if( pthread_equal( handle->write_locker, pthread_self() )) {
-            handle->nwrite_lock = 0;
-            *result = 1;
-         } else {
-            *result = -1;
+/* If required, check any child handles. If we already have a status of
+   2, (the supplied handle is locked read-write by another thread), we do
+   not need to check the children. If no locks are held on any
+   descendant, every child inherits the same locks, so we only need to
+   check one. Otherwise check each child. */
+   if( recurs && result != 2 && HAS_CHILDREN( handle ) ) {
+      if( handle->nsublock == 0 ) {
+         type = dat1EffectiveLock( handle, 0, token, &deep, &holder, &others );
+         child_result = dat1LockResult( type, others );
+         if( child_result == 2 ) {
+            result = 2;
+         } else if( child_result != result ) {
+            result = 5;
          }
 
-/* Otherwise, if the current thread has a read-only lock, remove it. */
       } else {
+         for( ichild = 0; ichild < handle->nchild; ichild++ ) {
+            child = handle->children[ ichild ];
+            if( child ) {
+               child_result = dat1QueryLock( child, token, 1 );
 
-/* Loop through all the threads that have read-only locks. */
-         locker = handle->read_lockers;
-         for( i = 0; i < handle->nread_lock; i++,locker++ ) {
+/* If it's 2, we can set the final result and exit immediately. */
+               if( child_result == 2 ) {
+                  result = 2;
+                  break;
 
-/* If the current thread is found, shuffle any remaining threads down one
-   slot to fill the gap left by removing the current thread from the list. */
-            if( pthread_equal( *locker, pthread_self() )) {
-               rlocker = locker + 1;
-               for( j = i + 1; j < handle->nread_lock; j++,locker++ ) {
-                  *locker = *(rlocker++);
+/* Otherwise, ensure the child gives the same result as all the others,
+   breaking out and returning the catch-all value if not. */
+               } else if( child_result != result ) {
+                  result = 5;
+                  break;
                }
-
-/* Reduce the number of read-only locks. */
-               handle->nread_lock--;
-               *result = 1;
-               break;
             }
          }
       }
+   }
+
+   return result;
+}
+
+/* Return a pointer to the first descendant of the supplied Handle on
+   which another thread holds a lock that conflicts with a lock of the
+   given type. Only those parts of the tree that contain locks are
+   searched. */
+static Handle *dat1LockConflict( Handle *handle, size_t token, int type ) {
+   Handle *child;
+   Handle *result = NULL;
+   int i;
+   int ichild;
 
-/* If required, and if the above unlock operation was successful, unlock any
-   child handles that can be unlocked. */
-      if( *result == 1 ){
-         if( recurs ){
-            for( ichild = 0; ichild < handle->nchild; ichild++ ) {
-               child = handle->children[ichild];
-               if( child ) {
-                  error_handle = dat1HandleLock( child, -3, 1, 0,
-                                                 result, status );
-                  if( error_handle ) break;
+   for( ichild = 0; ichild < handle->nchild && handle->nsublock > 0 &&
+                    !result; ichild++ ) {
+      child = handle->children[ ichild ];
+      if( child ) {
+         if( child->write_owner && LOCKTOKEN( child->write_owner ) != token ) {
+            result = child;
+         } else if( type == WRITE ) {
+            for( i = 0; i < child->nread_lock; i++ ) {
+               if( LOCKTOKEN( child->read_lockers[ i ] ) != token ) {
+                  result = child;
+                  break;
                }
             }
          }
-
-/* If the unlock operation failed, return a pointer to the Handle. */
-      } else {
-         error_handle = handle;
+         if( !result && child->nsublock > 0 ) {
+            result = dat1LockConflict( child, token, type );
+         }
       }
+   }
 
+   return result;
+}
 
+/* Remove any locks held on descendants of the supplied Handle by the
+   thread with the given token. Only those parts of the tree that contain
+   locks are searched. */
+static void dat1RemoveBelow( Handle *handle, size_t token, int *status ) {
+   Handle *child;
+   int deep;
+   int ichild;
 
-
-/* Report an error for any other "oper" value. */
-   } else if( *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRepf( " ", "dat1HandleLock: Unknown 'oper' value (%d) supplied - "
-               "(internal HDS programming error).", status, oper );
+   for( ichild = 0; ichild < handle->nchild && handle->nsublock > 0;
+        ichild++ ) {
+      child = handle->children[ ichild ];
+      if( child ) {
+         if( dat1OwnLock( child, token, &deep ) ) {
+            dat1SetLock( child, token, 0, 0, status );
+         }
+         if( child->nsublock > 0 ) dat1RemoveBelow( child, token, status );
+      }
    }
+}
 
-/* If this is a top-level entry, unlock the Handle's mutex so that other
-   threads can access the values in the Handle. */
-   if( top_level ) pthread_mutex_unlock( &(handle->mutex) );
-
-/* Return the error handle. */
-   return error_handle;
+/* If the thread with the given token holds a deep lock on the supplied
+   Handle, change it to a lock on the Handle alone and give each known
+   child a deep lock of the same type, so that the rest of the tree keeps
+   the same lock. */
+static void dat1PushDown( Handle *handle, size_t token, int *status ) {
+   Handle *child;
+   int deep;
+   int ichild;
+   int type;
+
+   type = dat1OwnLock( handle, token, &deep );
+   if( type && deep ) {
+      dat1SetLock( handle, token, type, 0, status );
+      for( ichild = 0; ichild < handle->nchild; ichild++ ) {
+         child = handle->children[ ichild ];
+         if( child ) dat1SetLock( child, token, type, 1, status );
+      }
+   }
 }
 
+/* Move a deep lock held by the thread with the given token on the
+   "holder" Handle down the tree until it is held on the supplied Handle,
+   which must be a descendant of "holder". */
+static void dat1PullDown( Handle *holder, Handle *handle, size_t token,
+                          int *status ) {
+   if( handle == holder || !handle->parent ) return;
+   dat1PullDown( holder, handle->parent, token, status );
+   dat1PushDown( handle->parent, token, status );
+}
@@ -0,0 +1,139 @@
+/*
+*+
+*  Name:
+*     dat1IndexType
+
+*  Purpose:
+*     Get the HDF5 index to use when accessing components by position
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     H5_index_t dat1IndexType( hid_t group_id, Handle *handle, int *status );
+
+*  Arguments:
+*     group_id = hid_t (Given)
+*        Identifier for the HDF5 group holding the structure.
+*     handle = Handle * (Given)
+*        The Handle for the structure. May be NULL.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     H5_INDEX_CRT_ORDER if the structure's group indexes the creation
+*     order of its links, and H5_INDEX_NAME otherwise (including if an error
+*     occurs).
+
+*  Description:
+*     Returns the index type that should be used to access the components
+*     of a structure by position (e.g. in datIndex and datIterate). Groups
+*     created by this version of HDS index the creation order of their
+*     links (see dat1GroupCreatePlist), so components are accessed in the
+*     order in which they were created. Groups in older files do not, so
+*     their components are accessed in alphabetical order.
+
+*  Notes:
+*     - The result is cached in the supplied Handle, if any.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Take a group identifier and an optional Handle, so that it can be used by datWalk.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+H5_index_t dat1IndexType( hid_t group_id, Handle *handle, int *status ) {
+
+/* Local Variables; */
+   H5_index_t result = H5_INDEX_NAME;
+   hid_t gcpl = 0;
+   unsigned flags = 0;
+
+/* Return immediately if an error has already occurred. */
+   if( *status != SAI__OK ) return result;
+
+/* Use the value cached in the Handle if available. */
+   if( dat1MetaCached( handle, HDS__META_ORDER ) ) {
+      return handle->metaorder ? H5_INDEX_CRT_ORDER : H5_INDEX_NAME;
+   }
+
+   CALLHDFE( hid_t, gcpl,
+             H5Gget_create_plist( group_id ),
+             DAT__HDF5E,
+             emsRep( "dat1IndexType_1", "Error getting HDF5 group "
+                     "creation properties", status )
+           );
+   CALLHDFQ( H5Pget_link_creation_order( gcpl, &flags ) );
+
+   if( flags & H5P_CRT_ORDER_INDEXED ) result = H5_INDEX_CRT_ORDER;
+
+/* Cache the result in the Handle. */
+   if( handle ) {
+      handle->metaorder = ( result == H5_INDEX_CRT_ORDER );
+      dat1MetaStore( handle, HDS__META_ORDER );
+   }
+
+CLEANUP:
+   if( gcpl > 0 ) H5Pclose( gcpl );
+   return result;
+}
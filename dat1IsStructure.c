@@ -30,6 +30,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -39,6 +40,11 @@
 *  History:
 *     2014-09-03 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Handle locators whose HDF5 object has not yet been opened.
+*     2026-10-16 (AGENT):
+*        Read the identifier of the parent of an unopened object
+*        atomically.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -95,6 +101,11 @@ int
 dat1IsStructure( const HDSLoc * locator, int * status ) {
   if (*status != SAI__OK) return 0;
   if (!locator) return 0;
+  /* Check for an unopened object first, since another thread may open
+     it at any time (see dat1Deferred.c) */
+  if (__atomic_load_n( &(locator->defer_id), __ATOMIC_ACQUIRE ) > 0) {
+    return locator->deferstruc;
+  }
   if (locator->group_id > 0) return 1;
   return 0;
 }
@@ -0,0 +1,153 @@
+/*
+*+
+*  Name:
+*     dat1LinkHandle
+
+*  Purpose:
+*     Record a Handle as a child of another Handle.
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1LinkHandle( Handle *parent, Handle *child, int *status );
+
+*  Arguments:
+*     parent = Handle * (Given)
+*        The parent Handle.
+*     child = Handle * (Given)
+*        The child Handle. Its name must already be set.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     The child is stored in the parent's array of children, re-using a
+*     free slot if one is available, and added to the parent's hash table
+*     of children, keyed by the child's name. The parent pointer in the
+*     child is set.
+
+*  Notes:
+*     - The child should not already be linked to a parent (see
+*     dat1UnlinkHandle).
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Add the locks held on the child to the counts in its new ancestors.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include <string.h>
+
+#include "ems.h"
+#include "sae_par.h"
+#include "dat1.h"
+#include "dat_err.h"
+
+void dat1LinkHandle( Handle *parent, Handle *child, int *status ) {
+
+/* Local Variables; */
+   Handle **children;
+   int *freechild;
+   int ichild;
+   int lstat;
+   int maxchild;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* If an unused slot in the children array is available, we re-use it.
+   Otherwise we use the next slot at the end of the array, extending the
+   array (and the list of free slots) if necessary. Note "nchild" is the
+   used length of the "children" array - this is not necessarily the same
+   as the actual number of active children since this array may contain
+   some NULL pointers. */
+   if( parent->nfree > 0 ) {
+      ichild = parent->freechild[ --parent->nfree ];
+
+   } else {
+      if( parent->nchild == parent->maxchild ) {
+         maxchild = parent->maxchild ? 2*parent->maxchild : 8;
+         children = MEM_REALLOC( parent->children,
+                                 maxchild*sizeof(Handle *) );
+         if( children ) {
+            parent->children = children;
+            freechild = MEM_REALLOC( parent->freechild,
+                                     maxchild*sizeof(int) );
+            if( freechild ) {
+               parent->freechild = freechild;
+               parent->maxchild = maxchild;
+            }
+         }
+      }
+
+      if( parent->nchild < parent->maxchild ) {
+         ichild = parent->nchild++;
+      } else {
+         *status = DAT__NOMEM;
+         emsRep("dat1LinkHandle", "Could not reallocate memory for "
+                "child links in an HDS Handle", status );
+         return;
+      }
+   }
+
+/* Store the child in the parent's array of children and hash table. */
+   parent->children[ ichild ] = child;
+   child->ichild = ichild;
+   child->parent = parent;
+   if( child->name ) HASH_ADD_KEYPTR( hh, parent->childhash, child->name,
+                                      strlen( child->name ), child );
+
+/* Add any locks held on the child (or its descendants) to the counts
+   stored in its new ancestors. A Handle that is still being created
+   (and so is not yet valid) has no locks. */
+   if( HANDLE_VALID( child ) ) dat1HandleLock( child, 5, 0, 0, &lstat,
+                                               status );
+}
@@ -0,0 +1,125 @@
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hds1.h"
+#include "dat1.h"
+
+/* Metadata that is constant for an HDF5 object (its type, name and
+   structure dimensions) is cached in the Handle shared by all locators
+   that refer to the object, so that repeated queries do not need to go
+   back to HDF5. The functions in this file record which items are
+   cached and keep counts of cache hits and misses.
+
+   Any thread that holds a lock on an object may fill the cache, so the
+   flags are accessed atomically. The value of an item is stored before
+   its flag is set (with release semantics), and the flag is tested
+   (with acquire semantics) before the value is used. Two threads filling
+   the same item will both store identical values. The cache is only
+   invalidated by routines that change an object, which require a
+   read-write lock and so exclude any other thread.
+
+   Each structure also remembers the last few component names that were
+   looked up and found not to exist, so that repeated probes for optional
+   components do not go to HDF5. These lists are changed by threads that
+   hold only a read lock, so they are guarded by the Handle mutex. Any
+   routine that creates a component must clear the list for the parent
+   structure. */
+
+/* Counts of cache hits and misses. Updated atomically. */
+static size_t META_HITS = 0;
+static size_t META_MISSES = 0;
+
+/* Return true if the given item is cached in the Handle, and count the
+   query as a hit or a miss. */
+
+hdsbool_t dat1MetaCached( const Handle *handle, int item ) {
+  if (handle &&
+      (__atomic_load_n( &(handle->metaflags), __ATOMIC_ACQUIRE ) & item)) {
+    __atomic_add_fetch( &META_HITS, 1, __ATOMIC_RELAXED );
+    return HDS_TRUE;
+  }
+  __atomic_add_fetch( &META_MISSES, 1, __ATOMIC_RELAXED );
+  return HDS_FALSE;
+}
+
+/* Indicate that the given item has been stored in the Handle. */
+
+void dat1MetaStore( Handle *handle, int item ) {
+  if (handle) __atomic_or_fetch( &(handle->metaflags), item, __ATOMIC_RELEASE );
+}
+
+/* Forget the given items for the Handle and, if "recurse" is true, for
+   all its known descendants. */
+
+void dat1MetaInvalidate( Handle *handle, int items, hdsbool_t recurse ) {
+  int ichild;
+  if (!handle) return;
+  __atomic_and_fetch( &(handle->metaflags), ~items, __ATOMIC_RELEASE );
+  if (recurse) {
+    for (ichild = 0; ichild < handle->nchild; ichild++) {
+      dat1MetaInvalidate( handle->children[ichild], items, recurse );
+    }
+  }
+}
+
+/* Return the number of cache hits and misses so far. */
+
+void dat1MetaStats( size_t *hits, size_t *misses ) {
+  *hits = __atomic_load_n( &META_HITS, __ATOMIC_RELAXED );
+  *misses = __atomic_load_n( &META_MISSES, __ATOMIC_RELAXED );
+}
+
+/* Return true if the given (cleaned) component name is known not to
+   exist in the structure described by the Handle. */
+
+hdsbool_t dat1MetaIsAbsent( Handle *handle, const char *name ) {
+  hdsbool_t result = HDS_FALSE;
+  int i;
+  if (!handle || !__atomic_load_n( &(handle->nabsent), __ATOMIC_ACQUIRE )) {
+    return result;
+  }
+  pthread_mutex_lock( &(handle->mutex) );
+  for (i = 0; i < handle->nabsent; i++) {
+    if (!strcmp( handle->absent[i], name )) {
+      result = HDS_TRUE;
+      break;
+    }
+  }
+  pthread_mutex_unlock( &(handle->mutex) );
+  return result;
+}
+
+/* Remember that the given (cleaned) component name does not exist in the
+   structure described by the Handle, replacing the oldest name if the
+   list is full. */
+
+void dat1MetaSetAbsent( Handle *handle, const char *name ) {
+  if (!handle || strlen( name ) > DAT__SZNAM) return;
+  pthread_mutex_lock( &(handle->mutex) );
+  if (!handle->absent) {
+    handle->absent = MEM_CALLOC( HDS__MXABSENT, sizeof(*(handle->absent)) );
+  }
+  if (handle->absent) {
+    strcpy( handle->absent[handle->nextabsent], name );
+    handle->nextabsent = ( handle->nextabsent + 1 ) % HDS__MXABSENT;
+    if (handle->nabsent < HDS__MXABSENT) {
+      __atomic_store_n( &(handle->nabsent), handle->nabsent + 1,
+                        __ATOMIC_RELEASE );
+    }
+  }
+  pthread_mutex_unlock( &(handle->mutex) );
+}
+
+/* Forget all the names known not to exist in the structure described by
+   the Handle. Must be called whenever a component is created in it. */
+
+void dat1MetaClearAbsent( Handle *handle ) {
+  if (!handle || !__atomic_load_n( &(handle->nabsent), __ATOMIC_ACQUIRE )) {
+    return;
+  }
+  pthread_mutex_lock( &(handle->mutex) );
+  __atomic_store_n( &(handle->nabsent), 0, __ATOMIC_RELEASE );
+  handle->nextabsent = 0;
+  pthread_mutex_unlock( &(handle->mutex) );
+}
@@ -15,7 +15,8 @@
 *  Invocation:
 *     HDSLoc * dat1New( const HDSLoc *locator, hdsbool_t isprimary,
 *                       const char *name_str, const char *type_str,
-*                       int ndim, const hdsdim dims[], int * status );
+*                       int ndim, const hdsdim dims[],
+*                       const HDSCreateProps *props, int * status );
 
 *  Arguments:
 *     locator = const HDSLoc * (Given)
@@ -33,6 +34,10 @@
 *     dims = const hdsdim [] (Given)
 *        Dimensionality of the object. Should be dimensioned with ndim. The array
 *        is not accessed if ndim == 0.
+*     props = const HDSCreateProps * (Given)
+*        The storage properties for a new primitive (see datNewP), or NULL
+*        to use the defaults set by the tuning parameters. Ignored when
+*        creating a structure.
 *     status = int* (Given and Returned)
 *        Pointer to global status.
 
@@ -45,13 +50,12 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Primitive non-scalar types are created with unlimited dimensions to
-*       allow resizing but the chunk size is configured to match the supplied
-*       dimensions. The HDS API has no means to control whether resizing will
-*       be required and how the chunking should be handled.
+*     - The layout of a new primitive (compact, contiguous or chunked) and
+*       the filters applied to it are chosen by dat1NewPrim.
 
 *  History:
 *     2014-08-20 (TIMJ):
@@ -65,6 +69,21 @@
 *        created as secondary locators.
 *     2014-11-22 (TIMJ):
 *        Now the HDS root is the HDF5 root group "/"
+*     2026-10-16 (AGENT):
+*        Do not create the cells of a structure array. They are now
+*        created by datCell on first access.
+*     2026-10-16 (AGENT):
+*        Discard any metadata cached in a re-used Handle.
+*     2026-10-16 (AGENT):
+*        Clear the list of names known not to exist in the parent.
+*     2026-10-16 (AGENT):
+*        Create groups that index the creation order of their links.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Add argument "props".
+*     2026-10-16 (AGENT):
+*        Create an empty structure cell before adding a component to it.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -129,6 +148,7 @@ dat1New( const HDSLoc    *locator,
         const char      *type_str,
         int       ndim,
         const hdsdim    dims[],
+        const HDSCreateProps *props,
         int       *status) {
 
   char cleanname[DAT__SZNAM+1];
@@ -140,6 +160,7 @@ dat1New( const HDSLoc    *locator,
   hid_t cparms = 0;
   hid_t h5type = 0;
   hid_t place = 0;
+  hid_t gcpl = H5P_DEFAULT;
   int isprim;
   hsize_t h5dims[DAT__MXDIM];
 
@@ -153,9 +174,15 @@ dat1New( const HDSLoc    *locator,
   /* Copy dimensions if appropriate */
   dat1ImportDims( "dat1New", ndim, dims, h5dims, status );
 
+  /* Create the cell if this is the first thing written into it */
+  dat1OpenCell( locator, HDS_TRUE, status );
+
   /* Work out where to place the component */
   place = dat1RetrieveContainer( locator, status );
 
+  /* Adding a component invalidates any catalogue in the file */
+  dat1CatalogueStale( locator, status );
+
   /* Convert the HDS data type to HDF5 data type */
   isprim = dau1CheckType( 0, type_str, &h5type, groupstr,
                           sizeof(groupstr), status );
@@ -165,7 +192,7 @@ dat1New( const HDSLoc    *locator,
 
   /* Now create the group or dataset */
   if (isprim) {
-    dat1NewPrim( place, ndim, h5dims, h5type, cleanname,
+    dat1NewPrim( place, ndim, h5dims, h5type, props, cleanname,
                  &dataset_id, &dataspace_id, status );
 
     /* If this is intended to be a root locator we indicate this with an attribute
@@ -191,11 +218,14 @@ dat1New( const HDSLoc    *locator,
       dat1SetAttrString( group_id, HDS__ATTR_ROOT_NAME, cleanname, status );
 
     } else {
+      gcpl = dat1GroupCreatePlist( HDS_FALSE, status );
       CALLHDFE( hid_t, group_id,
-               H5Gcreate2(place, cleanname, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+               H5Gcreate2(place, cleanname, H5P_DEFAULT, gcpl, H5P_DEFAULT),
                DAT__HDF5E,
                emsRepf("dat1New_4", "Error creating structure/group '%s'", status, cleanname)
                );
+      H5Pclose( gcpl );
+      gcpl = H5P_DEFAULT;
     }
 
     /* Actual data type of the structure/group must be stored in an attribute */
@@ -204,9 +234,6 @@ dat1New( const HDSLoc    *locator,
     if (ndim > 0) {
       /* HDF5 can not define an array of structures so we create a collection
          of groups below the parent group. */
-      int i;
-      size_t ngroups = 1;
-      size_t n;
 
       /* Write dimensionality as an attribute */
       dat1SetStructureDims( group_id, ndim, dims, status );
@@ -221,25 +248,25 @@ dat1New( const HDSLoc    *locator,
            know that ROOT.RECORDS.HDSCELL(3,2).SOMEINT will have an
            effective trace of ROOT.RECORDS(3,2).SOMEINT [simply remove
            the ".HDSCELL(3,2)" from the full path.
-      */
-
-      for (i = 0; i < ndim; i++) {
-        ngroups *= h5dims[i];
-      }
 
-      for (n = 1; n <= ngroups; n++) {
-        hid_t cellgroup_id = 0;
-        cellgroup_id = dat1CreateStructureCell( group_id, n, groupstr, cleanname, ndim, dims, status );
-        if (cellgroup_id > 0) H5Gclose(cellgroup_id);
-      }
+         The cells are not created here. Each one is created the first
+         time something is written into it (see dat1OpenCell.c), so large structure arrays that are
+         only sparsely used do not need a group for every element. */
     }
   }
 
+  /* The component now exists in the parent structure */
+  if (*status == SAI__OK) dat1MetaClearAbsent( locator->handle );
+
   /* We now have to store this in a new locator */
   if (*status == SAI__OK) {
     HDSLoc *thisloc = dat1AllocLoc( status );
     if (*status == SAI__OK) {
       thisloc->handle = dat1Handle( locator, cleanname, 0, status );
+
+      /* The Handle may be left over from an earlier object of the same
+         name, so discard any cached metadata. */
+      dat1MetaInvalidate( thisloc->handle, HDS__META_ALL, HDS_TRUE );
       thisloc->dataset_id = dataset_id;
       thisloc->group_id = group_id;
       thisloc->dataspace_id = dataspace_id;
@@ -258,6 +285,7 @@ dat1New( const HDSLoc    *locator,
   if (dataset_id) H5Dclose(dataset_id);
   if (dataspace_id) H5Sclose(dataspace_id);
   if (cparms > 0 && cparms != H5P_DEFAULT) H5Pclose(cparms);
+  if (gcpl > 0 && gcpl != H5P_DEFAULT) H5Pclose(gcpl);
   if (group_id) H5Gclose(group_id);
   return NULL;
 }
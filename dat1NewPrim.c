@@ -14,7 +14,8 @@
 
 *  Invocation:
 *     dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type,
-                   const char * name_str, hid_t * dataset_id, hid_t *dataspace_id, int *status);
+                   const HDSCreateProps *props, const char * name_str,
+                   hid_t * dataset_id, hid_t *dataspace_id, int *status);
 
 *  Arguments:
 *     group_id = hid_t (Given)
@@ -25,6 +26,10 @@
 *        Dimensions in HDF5 C order. No more than DAT__MXDIM.
 *     h5type = hid_t (Given)
 *        HDF5 datatype of new dataset.
+*     props = const HDSCreateProps * (Given)
+*        Requested storage properties (chunking and filters) for the new
+*        dataset. May be NULL, in which case the defaults set by the
+*        tuning parameters are used (see dat1DatasetCreatePlist).
 *     name_str = const char * (Given)
 *        Name of new dataset. Not constrained by HDS rules so can
 *        be longer than DAT__SZNAM.
@@ -38,8 +43,19 @@
 *  Description:
 *     Creates an HDF5 dataset given HDF5-style arguments.
 
+*  Notes:
+*     - The layout of the dataset is chosen by dat1DatasetCreatePlist.
+*       Chunked datasets have unlimited maximum dimensions.
+*     - A dataset holding no more than the number of bytes given by the
+*       COMPACT tuning parameter is created with a compact layout, so that
+*       its data are stored in the object header rather than in a separate
+*       block of the file. Space for a compact dataset is always allocated,
+*       so an HDS__ATTR_UNDEFINED attribute is attached to it to indicate
+*       that it has no defined value (see dat1IsDefined).
+
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -50,6 +66,15 @@
 *        Rely on datAlter to not attempt this.
 *     2014-11-06 (TIMJ):
 *        Chunked datasets is now a compile-time switch.
+*     2026-10-16 (AGENT):
+*        Use a compact layout for small datasets. Close the creation
+*        property list.
+*     2026-10-16 (AGENT):
+*        Add argument "props", and use dat1DatasetCreatePlist to choose
+*        the layout and filters.
+*     2026-10-16 (AGENT):
+*        Use dat1DatasetAccessPlist to give chunked datasets a large enough
+*        chunk cache.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -105,13 +130,21 @@
 #include "dat_err.h"
 
 void dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type,
-                  const char * name_str, hid_t * dataset_id, hid_t *dataspace_id, int *status ) {
+                  const HDSCreateProps *props, const char * name_str,
+                  hid_t * dataset_id, hid_t *dataspace_id, int *status ) {
   hid_t cparms = H5P_DEFAULT;
+  hid_t aparms = H5P_DEFAULT;
+  H5D_layout_t layout = H5D_CONTIGUOUS;
   *dataset_id = 0;
   *dataspace_id = 0;
 
   if (*status != SAI__OK) return;
 
+  /* Decide how the data are to be stored */
+  cparms = dat1DatasetCreatePlist( ndim, h5dims, h5type, props, &layout,
+                                   status );
+  if (*status != SAI__OK) goto CLEANUP;
+
   if (ndim == 0) {
 
     CALLHDFE( hid_t, *dataspace_id,
@@ -126,34 +159,16 @@ void dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type
        dataset, if we are to allow resizing we have to make it unlimited. */
     const hsize_t *maxdims = NULL;
 
-    CALLHDFE( hid_t, cparms,
-             H5Pcreate( H5P_DATASET_CREATE ),
-             DAT__HDF5E,
-             emsRepf("dat1New_1b", "Error creating parameters for data set %s",
-                     status, name_str)
-             );
-
     /* Create a primitive -- if we create it chunked we can not memory map
        but we can resize. If we create a fixed size then in theory we can
-       memory map but resizes (datAlter) have to be done by copy and delete. */
-
-#if HDS_USE_CHUNKED_DATASETS
-    /* Create the dataspace with chunked storage that is resizable. For this
-       to happen we just need two updates:
-       - a parameter indicating that chunking is enabled.
-       - the max dimensions.
-    */
-    const hsize_t h5max[DAT__MXDIM] = { H5S_UNLIMITED, H5S_UNLIMITED, H5S_UNLIMITED,
-                                        H5S_UNLIMITED, H5S_UNLIMITED, H5S_UNLIMITED,
-                                        H5S_UNLIMITED };
-    /* Unlimited dimensions */
-    maxdims = h5max;
-
-    /* We can not find out the optimum chunk size from HDS API so we choose
-       the initial size. */
-    CALLHDFQ( H5Pset_chunk( cparms, ndim, h5dims ) );
-
-#endif
+       memory map but resizes (datAlter) have to be done by copy and delete.
+       A compact dataset can not be chunked or memory mapped, and is
+       resized by copy and delete. */
+    static const hsize_t h5max[DAT__MXDIM] = { H5S_UNLIMITED, H5S_UNLIMITED,
+                                               H5S_UNLIMITED, H5S_UNLIMITED,
+                                               H5S_UNLIMITED, H5S_UNLIMITED,
+                                               H5S_UNLIMITED };
+    if (layout == H5D_CHUNKED) maxdims = h5max;
 
     /* Create the data space for the dataset */
     CALLHDFE( hid_t, *dataspace_id,
@@ -165,16 +180,27 @@ void dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type
 
   }
 
+  /* Give a chunked dataset a larger chunk cache if it needs one */
+  aparms = dat1DatasetAccessPlist( cparms, *dataspace_id, h5type, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
   /* now place the dataset */
   CALLHDFE( hid_t, *dataset_id,
            H5Dcreate2(group_id, name_str, h5type, *dataspace_id,
-                      H5P_DEFAULT, cparms, H5P_DEFAULT),
+                      H5P_DEFAULT, cparms, aparms),
            DAT__HDF5E,
            emsRepf("dat1New_2", "Error placing the data space in the file for %s",
                    status, name_str )
            );
 
+  /* A compact dataset is allocated when it is created, so record that it
+     has not yet been given a value */
+  if (layout == H5D_COMPACT) dat1SetAttrBool( *dataset_id, HDS__ATTR_UNDEFINED,
+                                             HDS_TRUE, status );
+
  CLEANUP:
+  if (cparms != H5P_DEFAULT) H5Pclose( cparms );
+  if (aparms != H5P_DEFAULT) H5Pclose( aparms );
   if (*status != SAI__OK) {
     /* tidy */
     if (*dataspace_id > 0) {
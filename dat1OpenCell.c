@@ -0,0 +1,170 @@
+/*
+*+
+*  Name:
+*     dat1OpenCell
+
+*  Purpose:
+*     Open or create the group for an empty structure array cell
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1OpenCell( const HDSLoc *locator, hdsbool_t create, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given and Returned)
+*        Locator for a cell of a structure array.
+*     create = hdsbool_t (Given)
+*        If true, the cell is created if it does not yet exist.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     The cells of a structure array are only created when something is
+*     written into them, so the locator returned by datCell for a cell
+*     that does not yet exist is flagged as an empty cell and holds the
+*     group identifier for the array itself. This routine replaces that
+*     identifier with one for the cell, opening the cell if it has since
+*     been created through another locator, or creating it if "create"
+*     is true. Nothing is done if the locator is not an empty cell, or if
+*     the cell does not exist and "create" is false.
+
+*  Notes:
+*     - Routines that write into a cell should call this with "create"
+*     set to true, having first checked that the current thread has a
+*     read-write lock on the cell (see dat1ValidateLocator). Readers
+*     hold read locks on the cell, so can not be using it at the same
+*     time.
+*     - The identifiers in a locator are state that is filled in on
+*     demand, so this is allowed for a const locator. The Handle mutex
+*     prevents two threads that have read locks on the cell from opening
+*     it at the same time.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <pthread.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+void dat1OpenCell( const HDSLoc *locator, hdsbool_t create, int *status ) {
+
+  HDSLoc *loc = (HDSLoc *) locator;
+  char typestr[DAT__SZTYP+1];
+  const char *cellname;
+  hid_t cell_id = 0;
+  hid_t gcpl = H5P_DEFAULT;
+  htri_t exists = 0;
+
+  if (*status != SAI__OK || !loc || !loc->isemptycell) return;
+
+  pthread_mutex_lock( &(loc->handle->mutex) );
+
+  if (loc->isemptycell) {
+    cellname = loc->handle->name;
+
+    CALLHDFE( htri_t, exists,
+              H5Lexists( loc->group_id, cellname, H5P_DEFAULT ),
+              DAT__HDF5E,
+              emsRepf("dat1OpenCell_1", "Error checking existence of cell %s",
+                      status, cellname)
+              );
+
+    if (exists) {
+      CALLHDFE( hid_t, cell_id,
+                H5Gopen2( loc->group_id, cellname, H5P_DEFAULT ),
+                DAT__OBJIN,
+                emsRepf("dat1OpenCell_2", "Error opening cell %s", status,
+                        cellname)
+                );
+
+    } else if (create) {
+      /* The cell has the same type as the array */
+      dat1GetAttrString( loc->group_id, HDS__ATTR_STRUCT_TYPE, HDS_TRUE,
+                         "HDF5NATIVEGROUP", typestr, sizeof(typestr),
+                         status );
+      gcpl = dat1GroupCreatePlist( HDS_FALSE, status );
+      if (*status != SAI__OK) goto CLEANUP;
+      CALLHDFE( hid_t, cell_id,
+                H5Gcreate2( loc->group_id, cellname, H5P_DEFAULT, gcpl,
+                            H5P_DEFAULT ),
+                DAT__HDF5E,
+                emsRepf("dat1OpenCell_3", "Error creating cell %s", status,
+                        cellname)
+                );
+      dat1SetAttrString( cell_id, HDS__ATTR_STRUCT_TYPE, typestr, status );
+    }
+
+    if (cell_id > 0 && *status == SAI__OK) {
+      H5Gclose( loc->group_id );
+      loc->group_id = cell_id;
+      cell_id = 0;
+      loc->isemptycell = HDS_FALSE;
+    }
+  }
+
+ CLEANUP:
+  if (gcpl != H5P_DEFAULT) H5Pclose( gcpl );
+  if (cell_id > 0) H5Gclose( cell_id );
+  pthread_mutex_unlock( &(loc->handle->mutex) );
+}
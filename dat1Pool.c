@@ -0,0 +1,276 @@
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "dat_err.h"
+
+/* Locators, Handles and the initial arrays of read lock words in each
+   Handle are created and freed very often (e.g. one of each for every
+   cell visited by a datCell loop). Rather than going to the system
+   allocator each time, the functions in this file keep freed objects on
+   a free list for each type of object (a "pool") and hand them out
+   again. New objects are carved out of "slabs" of HDS__POOLSLAB objects.
+   Slabs are never returned to the system.
+
+   Each thread keeps a short list of free objects for each pool so that
+   most allocations and frees do not need to lock a mutex. When a
+   thread's list is empty, a batch of objects is moved to it from the
+   shared list for the pool (allocating a new slab if necessary). When it
+   gets too long, a batch is moved back to the shared list. The lists of
+   a thread that terminates are moved to the shared lists.
+
+   Objects are always zeroed before being put on a free list, so that a
+   locator or Handle that is used after being freed fails validation in
+   the same way as before. The only exception is the area of each object
+   described by the pool's "keep" fields (e.g. the mutex in a Handle),
+   which is left unchanged so that it need only be initialised once.
+
+   If the DEBUG_HDS macro is non-zero, the pools are not used and every
+   object is allocated and freed individually, so that tools that detect
+   use of freed memory still work. */
+
+/* The number of objects in each slab. */
+#define HDS__POOLSLAB 64
+
+/* The number of objects moved between a thread's list and the shared
+   list at a time. A thread's list never holds more than twice this
+   number of objects. */
+#define HDS__POOLBATCH 32
+
+/* A description of each pool. */
+typedef struct HdsPool {
+   size_t size;         /* Size of each object, in bytes */
+   size_t link;         /* Offset of the pointer used to link free objects */
+   size_t keep;         /* Offset of first byte not to be zeroed */
+   size_t nkeep;        /* Number of bytes not to be zeroed */
+   pthread_mutex_t mutex; /* Guards the following fields */
+   void *head;          /* Head of the shared list of free objects */
+   int nfree;           /* Number of objects in the shared list */
+   void **slabs;        /* Array of pointers to all slabs */
+   int nslab;           /* Number of slabs */
+   int maxslab;         /* Allocated length of the "slabs" array */
+} HdsPool;
+
+/* A thread's lists of free objects. */
+typedef struct HdsPoolCache {
+   void *head[HDS__NPOOL]; /* Head of the list for each pool */
+   int nfree[HDS__NPOOL];  /* Number of objects in each list */
+} HdsPoolCache;
+
+/* The pools, indexed by the HDS__POOL_ constants defined in dat1.h. The
+   link pointer in a free object overwrites a component that should be
+   zero (or NULL) in a valid object, rather than the "hds_version" or
+   "check" components used to validate locators and Handles. */
+static HdsPool Pools[HDS__NPOOL] = {
+   { sizeof(HDSLoc), offsetof(HDSLoc, prev), 0, 0,
+     PTHREAD_MUTEX_INITIALIZER, NULL, 0, NULL, 0, 0 },
+   { sizeof(Handle), offsetof(Handle, parent), offsetof(Handle, mutex),
+     offsetof(Handle, write_owner) - offsetof(Handle, mutex),
+     PTHREAD_MUTEX_INITIALIZER, NULL, 0, NULL, 0, 0 },
+   { HDS__POOLLOCKERS*sizeof(size_t), 0, 0, 0,
+     PTHREAD_MUTEX_INITIALIZER, NULL, 0, NULL, 0, 0 }
+};
+
+/* The lists for the current thread, and a key used to free them when the
+   thread terminates. */
+static __thread HdsPoolCache *Cache = NULL;
+static pthread_key_t CacheKey;
+static pthread_once_t CacheOnce = PTHREAD_ONCE_INIT;
+
+/* Local functions. */
+static HdsPoolCache *dat1PoolCache( void );
+static void dat1PoolCacheKey( void );
+static void dat1PoolFlush( void *data );
+static void dat1PoolRefill( int pool, HdsPoolCache *cache, int *status );
+static void dat1PoolRelease( int pool, HdsPoolCache *cache, int n );
+
+/* Macro to get and set the link pointer in a free object. */
+#define NEXT(pool,obj) (*((void **)( (char *)(obj) + Pools[pool].link )))
+
+/* Return a pointer to a new object from the specified pool. The object
+   is filled with zeros, except for any area that the pool keeps (which
+   will be zero if the object has not been used before). NULL is returned
+   if an error occurs. */
+
+void *dat1PoolAlloc( int pool, int *status ) {
+  HdsPoolCache *cache;
+  void *result = NULL;
+
+  if (*status != SAI__OK) return result;
+
+#if DEBUG_HDS
+  result = MEM_CALLOC( 1, Pools[pool].size );
+  if (!result) {
+    *status = DAT__NOMEM;
+    emsRep( " ", "Could not allocate memory for an HDS object.", status );
+  }
+#else
+  cache = dat1PoolCache();
+  if (!cache) {
+    *status = DAT__NOMEM;
+    emsRep( " ", "Could not allocate memory for HDS object pools.",
+            status );
+  } else if (!cache->head[pool]) {
+    dat1PoolRefill( pool, cache, status );
+  }
+
+  if (cache && cache->head[pool]) {
+    result = cache->head[pool];
+    cache->head[pool] = NEXT(pool,result);
+    cache->nfree[pool]--;
+    NEXT(pool,result) = NULL;
+  }
+#endif
+
+  return result;
+}
+
+/* Return an object to the specified pool. The object is zeroed, except
+   for any area that the pool keeps. */
+
+void dat1PoolFree( int pool, void *obj ) {
+  HdsPool *p = Pools + pool;
+  HdsPoolCache *cache;
+
+  if (!obj) return;
+
+#if DEBUG_HDS
+  memset( obj, 0, p->size );
+  MEM_FREE( obj );
+#else
+  if (p->nkeep) {
+    memset( obj, 0, p->keep );
+    memset( (char *) obj + p->keep + p->nkeep, 0,
+            p->size - p->keep - p->nkeep );
+  } else {
+    memset( obj, 0, p->size );
+  }
+
+/* If the lists for the current thread cannot be created, put the object
+   straight onto the shared list. */
+  cache = dat1PoolCache();
+  if (!cache) {
+    pthread_mutex_lock( &(p->mutex) );
+    NEXT(pool,obj) = p->head;
+    p->head = obj;
+    p->nfree++;
+    pthread_mutex_unlock( &(p->mutex) );
+    return;
+  }
+
+  NEXT(pool,obj) = cache->head[pool];
+  cache->head[pool] = obj;
+  if (++(cache->nfree[pool]) >= 2*HDS__POOLBATCH) {
+    dat1PoolRelease( pool, cache, HDS__POOLBATCH );
+  }
+#endif
+}
+
+/* Return the lists for the current thread, creating them if necessary.
+   NULL is returned if they cannot be created. */
+
+static HdsPoolCache *dat1PoolCache( void ) {
+  if (!Cache) {
+    pthread_once( &CacheOnce, dat1PoolCacheKey );
+    Cache = MEM_CALLOC( 1, sizeof(*Cache) );
+    if (Cache) pthread_setspecific( CacheKey, Cache );
+  }
+  return Cache;
+}
+
+/* Create the key used to flush the lists of a terminating thread. */
+
+static void dat1PoolCacheKey( void ) {
+  pthread_key_create( &CacheKey, dat1PoolFlush );
+}
+
+/* Move all the objects on the supplied thread lists to the shared lists
+   and free the thread lists. Called when a thread terminates. */
+
+static void dat1PoolFlush( void *data ) {
+  HdsPoolCache *cache = data;
+  int pool;
+
+  for (pool = 0; pool < HDS__NPOOL; pool++) {
+    dat1PoolRelease( pool, cache, cache->nfree[pool] );
+  }
+  if (cache == Cache) Cache = NULL;
+  MEM_FREE( cache );
+}
+
+/* Move a batch of objects from the shared list to the supplied thread
+   list, first allocating a new slab if the shared list is empty. */
+
+static void dat1PoolRefill( int pool, HdsPoolCache *cache, int *status ) {
+  HdsPool *p = Pools + pool;
+  char *slab;
+  void **slabs;
+  void *obj;
+  int i;
+
+  if (*status != SAI__OK) return;
+
+  pthread_mutex_lock( &(p->mutex) );
+
+  if (!p->head) {
+    slabs = p->slabs;
+    if (p->nslab == p->maxslab) {
+      slabs = MEM_REALLOC( p->slabs, (2*p->maxslab + 16)*sizeof(*slabs) );
+      if (slabs) {
+        p->slabs = slabs;
+        p->maxslab = 2*p->maxslab + 16;
+      }
+    }
+    slab = slabs ? MEM_CALLOC( HDS__POOLSLAB, p->size ) : NULL;
+    if (slab) {
+      p->slabs[ p->nslab++ ] = slab;
+      for (i = HDS__POOLSLAB - 1; i >= 0; i--) {
+        obj = slab + i*p->size;
+        NEXT(pool,obj) = p->head;
+        p->head = obj;
+      }
+      p->nfree += HDS__POOLSLAB;
+    } else {
+      *status = DAT__NOMEM;
+      emsRep( " ", "Could not allocate memory for HDS object pools.",
+              status );
+    }
+  }
+
+  for (i = 0; i < HDS__POOLBATCH && p->head; i++) {
+    obj = p->head;
+    p->head = NEXT(pool,obj);
+    p->nfree--;
+    NEXT(pool,obj) = cache->head[pool];
+    cache->head[pool] = obj;
+    cache->nfree[pool]++;
+  }
+
+  pthread_mutex_unlock( &(p->mutex) );
+}
+
+/* Move "n" objects from the supplied thread list to the shared list. */
+
+static void dat1PoolRelease( int pool, HdsPoolCache *cache, int n ) {
+  HdsPool *p = Pools + pool;
+  void *obj;
+  int i;
+
+  if (n <= 0) return;
+
+  pthread_mutex_lock( &(p->mutex) );
+  for (i = 0; i < n && cache->head[pool]; i++) {
+    obj = cache->head[pool];
+    cache->head[pool] = NEXT(pool,obj);
+    cache->nfree[pool]--;
+    NEXT(pool,obj) = p->head;
+    p->head = obj;
+    p->nfree++;
+  }
+  pthread_mutex_unlock( &(p->mutex) );
+}
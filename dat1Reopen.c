@@ -42,11 +42,22 @@
 
 *  Authors:
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     8-MAY-2019 (DSB):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Create any empty structure array cells referenced by locators
+*        when the file is re-opened for writing.
+*     2026-10-16 (AGENT):
+*        Open the HDF5 objects for deferred locators before re-opening the file.
+*     2026-10-16 (AGENT):
+*        Create new cells using dat1GroupCreatePlist.
+*     2026-10-16 (AGENT):
+*        Leave empty structure array cells to be created when something is
+*        written into them.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -127,7 +138,7 @@ hid_t dat1Reopen( hid_t file_id, unsigned int flags, hid_t fapl,
    if( *status == SAI__OK ) {
       loc = loclist;
       for( iloc = 0; iloc < nloc; iloc++,loc++ ) {
-         if( (*loc)->regpntr ) {
+         if( (*loc)->map && (*loc)->map->regpntr ) {
             hdsTrace( (*loc), &nlev, path, file, status, sizeof(path), sizeof(file) );
             *status = DAT__PRMAP;
             emsRepf( " ", "hdsOpen: Cannot re-open '%s' in read-write mode "
@@ -137,6 +148,15 @@ hid_t dat1Reopen( hid_t file_id, unsigned int flags, hid_t fapl,
       }
    }
 
+/* Open the HDF5 object for any locators that have not yet done so, so
+   that they can be re-opened in the same way as other locators. */
+   if( *status == SAI__OK ) {
+      loc = loclist;
+      for( iloc = 0; iloc < nloc; iloc++,loc++ ) {
+         dat1OpenDeferred( *loc, status );
+      }
+   }
+
 /* Store the path to the HDF5 object associated with each active locator,
    and also a flag indicating if the HDF5 object is a group or dataset.
    Then close the HDF5 objects. */
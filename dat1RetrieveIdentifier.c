@@ -27,6 +27,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -35,6 +36,8 @@
 *  History:
 *     2014-08-26 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Open the HDF5 object if it has not yet been opened.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -91,6 +94,9 @@ hid_t dat1RetrieveIdentifier( const HDSLoc * locator, int * status ) {
   if (*status != SAI__OK) return 0;
   if (!locator) return 0;
 
+  dat1OpenDeferred( locator, status );
+  if (*status != SAI__OK) return 0;
+
   if (locator->group_id > 0) return locator->group_id;
   if (locator->dataset_id > 0) return locator->dataset_id;
   return 0;
@@ -0,0 +1,141 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "dat_err.h"
+
+/* The functions in this file implement the locator scopes started and
+   ended by hdsBegin and hdsEnd. Each thread has its own stack of nested
+   scopes. While a scope is active, every locator created by the thread
+   (see dat1AllocLoc) is appended to the list of locators owned by the
+   innermost scope, and it is removed from the list again when it is
+   freed (see dat1FreeLoc). This includes locators that have been
+   annulled automatically because the last primary locator for their
+   container file was annulled, but which have not yet been freed by a
+   call to datAnnul. When the scope ends, hdsEnd annuls and frees all the
+   locators still in the list.
+
+   Locators owned by a scope may be freed by a different thread (e.g.
+   after being passed to the other thread using datUnlock/datLock), so
+   the list is protected by a mutex. However, they should not be annulled
+   by another thread while the owning thread is executing hdsEnd. */
+
+/* The innermost scope for the current thread. */
+static __thread HdsScope *CurrentScope = NULL;
+
+/* Begin a new scope, nested within any scope that is already active for
+   the current thread. */
+
+void dat1ScopeBegin( int *status ) {
+  HdsScope *scope;
+
+  if (*status != SAI__OK) return;
+
+  scope = MEM_CALLOC( 1, sizeof(*scope) );
+  if (!scope) {
+    *status = DAT__NOMEM;
+    emsRep( " ", "Could not allocate memory for an HDS locator scope.",
+            status );
+    return;
+  }
+
+  pthread_mutex_init( &(scope->mutex), NULL );
+  scope->parent = CurrentScope;
+  CurrentScope = scope;
+}
+
+/* End the innermost scope for the current thread, freeing the scope and
+   returning a pointer to a dynamically allocated array holding the
+   locators that it owned. Each locator is detached from the scope. The
+   returned array should be freed using MEM_FREE when no longer needed.
+   NULL is returned (and "*nloc" is set to zero) if the scope owned no
+   locators. An error is reported if there is no active scope. This
+   function attempts to execute even if an error has already occurred. */
+
+HDSLoc **dat1ScopeEnd( int *nloc, int *status ) {
+  HDSLoc **result;
+  HdsScope *scope = CurrentScope;
+  int i;
+
+  *nloc = 0;
+
+  if (!scope) {
+    if (*status == SAI__OK) {
+      *status = DAT__FATAL;
+      emsRep( " ", "hdsEnd called without a matching call to hdsBegin.",
+              status );
+    }
+    return NULL;
+  }
+  CurrentScope = scope->parent;
+
+  pthread_mutex_lock( &(scope->mutex) );
+  result = scope->locs;
+  *nloc = scope->nloc;
+  for (i = 0; i < *nloc; i++) result[i]->scope = NULL;
+  scope->locs = NULL;
+  scope->nloc = 0;
+  pthread_mutex_unlock( &(scope->mutex) );
+
+  pthread_mutex_destroy( &(scope->mutex) );
+  MEM_FREE( scope );
+
+  return result;
+}
+
+/* Add a newly created locator to the innermost scope for the current
+   thread, if any. */
+
+void dat1ScopeAdd( HDSLoc *locator, int *status ) {
+  HDSLoc **locs;
+  HdsScope *scope = CurrentScope;
+
+  if (*status != SAI__OK || !scope || !locator) return;
+
+  pthread_mutex_lock( &(scope->mutex) );
+
+  if (scope->nloc == scope->maxloc) {
+    locs = MEM_REALLOC( scope->locs,
+                        (2*scope->maxloc + 64)*sizeof(*locs) );
+    if (locs) {
+      scope->locs = locs;
+      scope->maxloc = 2*scope->maxloc + 64;
+    } else {
+      *status = DAT__NOMEM;
+      emsRep( " ", "Could not allocate memory for an HDS locator scope.",
+              status );
+    }
+  }
+
+  if (*status == SAI__OK) {
+    locator->scope = scope;
+    locator->iscope = scope->nloc;
+    scope->locs[ scope->nloc++ ] = locator;
+  }
+
+  pthread_mutex_unlock( &(scope->mutex) );
+}
+
+/* Remove a locator that is about to be freed from the scope that owns
+   it, if any. The last locator in the scope's list is moved into the
+   vacated slot. */
+
+void dat1ScopeRemove( HDSLoc *locator ) {
+  HDSLoc *last;
+  HdsScope *scope;
+
+  if (!locator || !locator->scope) return;
+  scope = locator->scope;
+
+  pthread_mutex_lock( &(scope->mutex) );
+  last = scope->locs[ --(scope->nloc) ];
+  scope->locs[ locator->iscope ] = last;
+  last->iscope = locator->iscope;
+  locator->scope = NULL;
+  locator->iscope = 0;
+  pthread_mutex_unlock( &(scope->mutex) );
+}
@@ -0,0 +1,264 @@
+/*
+*+
+*  Name:
+*     dat1TransferNumeric
+
+*  Purpose:
+*     Read or write a primitive numeric object with type conversion
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1TransferNumeric( const HDSLoc *locator, hdsbool_t towrite,
+*                          hdstype_t usertype, size_t nbuser, void *values,
+*                          int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator for the primitive object. Its type must be numeric.
+*     towrite = hdsbool_t (Given)
+*        If true, "values" are converted and written to the object.
+*        Otherwise the object is read and converted into "values".
+*     usertype = hdstype_t (Given)
+*        The numeric type of the "values" array.
+*     nbuser = size_t (Given)
+*        Number of bytes per element of "values".
+*     values = void * (Given and Returned)
+*        Array holding one element of type "usertype" for each element
+*        of the object, in Fortran order. Only read if "towrite" is true.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     int = inherited status on exit. This is for compatibility with the
+*        original HDS API.
+
+*  Description:
+*     Transfers data between an array of one numeric type in memory and
+*     a primitive object of a different numeric type, using dat1CvtNumeric
+*     rather than the HDF5 type conversion system. The data are read from
+*     or written to the file in their native type, a block of rows (i.e.
+*     of planes along the last HDS axis) at a time, so that the temporary
+*     buffer needed to hold the native values stays small enough to remain
+*     in the processor cache. Slices and vectorised objects are transferred
+*     in a single block.
+
+*  Notes:
+*     - Every element is converted even if some conversions fail. Values
+*       that cannot be converted are set to the bad value of the output type
+*       and DAT__CONER is returned once all the data have been transferred.
+*       When writing, this means the object will contain bad values in
+*       place of the values that could not be converted.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Use dat1FileSpace so that vectorized locators work with chunked
+*        datasets.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* The maximum number of bytes to convert at once. The temporary buffer
+   and the corresponding part of the user's array should fit into the
+   level 2 cache. */
+#define BLOCK_BYTES 262144
+
+int
+dat1TransferNumeric( const HDSLoc *locator, hdsbool_t towrite,
+                     hdstype_t usertype, size_t nbuser, void *values,
+                     int *status ) {
+
+  char *userptr;
+  hdstype_t filetype = HDSTYPE_NONE;
+  hid_t filespace_id = 0;
+  hid_t filetype_id = 0;
+  hid_t memspace_id = 0;
+  hid_t memtype_id = 0;
+  hsize_t count[DAT__MXDIM];
+  hsize_t h5dims[DAT__MXDIM];
+  hsize_t nblock;
+  hsize_t start[DAT__MXDIM];
+  int i;
+  int rank = 0;
+  size_t nbad;
+  size_t nbadtot = 0;
+  size_t nbfile = 0;
+  size_t nelem = 0;
+  size_t nrow = 1;
+  size_t nrowblock;
+  size_t row;
+  size_t rowlen;
+  void *buffer = NULL;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Get the type of the object and the equivalent native memory type. */
+  filetype = dat1Type( locator, status );
+  datSize( locator, &nelem, status );
+
+  CALLHDFE( hid_t, filetype_id,
+            H5Dget_type( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep("dat1TransferNumeric_1", "dat1TransferNumeric: Error "
+                   "obtaining data type of dataset", status)
+            );
+  memtype_id = dau1Native2MemType( filetype_id, status );
+  CALLHDFE( size_t, nbfile,
+            H5Tget_size( memtype_id ),
+            DAT__HDF5E,
+            emsRep("dat1TransferNumeric_2", "dat1TransferNumeric: Error "
+                   "obtaining size of data type", status)
+            );
+  if (*status != SAI__OK || nelem == 0) goto CLEANUP;
+
+  /* If the locator refers to the whole of a multi-dimensional object,
+     we can transfer it in blocks of rows along the first HDF5 axis (the
+     last HDS axis) using a hyperslab. Otherwise, transfer everything at
+     once. */
+  if( !locator->isslice && !locator->vectorized &&
+      H5Sget_select_type( locator->dataspace_id ) == H5S_SEL_ALL ) {
+    rank = H5Sget_simple_extent_dims( locator->dataspace_id, h5dims, NULL );
+    if( rank > 0 && h5dims[0] > 1 ) nrow = h5dims[0];
+  }
+  rowlen = nelem / nrow;
+
+  nrowblock = BLOCK_BYTES / ( rowlen * ( nbfile > nbuser ? nbfile : nbuser ) );
+  if( nrowblock < 1 ) nrowblock = 1;
+  if( nrowblock > nrow ) nrowblock = nrow;
+
+  if( nrowblock < nrow ) {
+    CALLHDFE( hid_t, filespace_id,
+              H5Scopy( locator->dataspace_id ),
+              DAT__HDF5E,
+              emsRep("dat1TransferNumeric_3", "dat1TransferNumeric: Error "
+                     "copying dataspace", status)
+              );
+    for( i = 1; i < rank; i++ ) {
+      start[i] = 0;
+      count[i] = h5dims[i];
+    }
+  } else {
+    filespace_id = dat1FileSpace( locator, status );
+  }
+
+  buffer = MEM_MALLOC( nrowblock * rowlen * nbfile );
+  if( !buffer ) {
+    *status = DAT__NOMEM;
+    emsRep("dat1TransferNumeric_4", "dat1TransferNumeric: Unable to "
+           "allocate memory", status);
+    goto CLEANUP;
+  }
+
+  for( row = 0; row < nrow && *status == SAI__OK; row += nrowblock ) {
+    if( nrowblock > nrow - row ) nrowblock = nrow - row;
+    nblock = nrowblock * rowlen;
+    userptr = (char *) values + row * rowlen * nbuser;
+
+    if( nrowblock < nrow ) {
+      start[0] = row;
+      count[0] = nrowblock;
+      CALLHDFQ( H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, start,
+                                     NULL, count, NULL ) );
+    }
+
+    CALLHDFE( hid_t, memspace_id,
+              H5Screate_simple( 1, &nblock, NULL ),
+              DAT__HDF5E,
+              emsRep("dat1TransferNumeric_5", "dat1TransferNumeric: Error "
+                     "allocating in-memory dataspace", status)
+              );
+
+    if( towrite ) {
+      dat1CvtNumeric( nblock, usertype, nbuser, filetype, nbfile, userptr,
+                      buffer, &nbad, status );
+      CALLHDFQ( H5Dwrite( locator->dataset_id, memtype_id, memspace_id,
+                          filespace_id, H5P_DEFAULT, buffer ) );
+    } else {
+      CALLHDFQ( H5Dread( locator->dataset_id, memtype_id, memspace_id,
+                         filespace_id, H5P_DEFAULT, buffer ) );
+      dat1CvtNumeric( nblock, filetype, nbfile, usertype, nbuser, buffer,
+                      userptr, &nbad, status );
+    }
+    nbadtot += nbad;
+
+    H5Sclose( memspace_id );
+    memspace_id = 0;
+  }
+
+  /* Report an error if any values could not be converted. */
+  if( nbadtot > 0 && *status == SAI__OK ) {
+    *status = DAT__CONER;
+    emsRepf("dat1TransferNumeric_6", "%zu of %zu values could not be "
+            "converted and were set bad.", status, nbadtot, nelem );
+  }
+
+ CLEANUP:
+  if (buffer) MEM_FREE( buffer );
+  if (memspace_id > 0) H5Sclose( memspace_id );
+  if (filespace_id > 0 && filespace_id != locator->dataspace_id) {
+    H5Sclose( filespace_id );
+  }
+  if (memtype_id > 0) H5Tclose( memtype_id );
+  if (filetype_id > 0) H5Tclose( filetype_id );
+  return *status;
+}
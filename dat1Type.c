@@ -33,11 +33,16 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-08-27 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Cache the type in the Handle. Close the HDF5 datatype.
+*     2026-10-16 (AGENT):
+*        Open the HDF5 object if it has not yet been opened.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -103,6 +108,14 @@ dat1Type( const HDSLoc *locator, int * status ) {
   /* if this is a group locator we can return straightaway */
   if (dat1IsStructure(locator, status)) return HDSTYPE_STRUCTURE;
 
+  /* Use the type cached in the Handle if available */
+  if (dat1MetaCached( locator->handle, HDS__META_TYPE )) {
+    return locator->handle->metatype;
+  }
+
+  dat1OpenDeferred( locator, status );
+  if (*status != SAI__OK) return thetype;
+
   CALLHDFE( hid_t, h5type,
            H5Dget_type( locator->dataset_id ),
            DAT__HDF5E,
@@ -111,7 +124,13 @@ dat1Type( const HDSLoc *locator, int * status ) {
 
   thetype = dau1HdsType( h5type, status );
 
+  if (*status == SAI__OK && locator->handle) {
+    locator->handle->metatype = thetype;
+    dat1MetaStore( locator->handle, HDS__META_TYPE );
+  }
+
  CLEANUP:
+  if (h5type > 0) H5Tclose( h5type );
   return thetype;
 }
 
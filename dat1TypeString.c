@@ -0,0 +1,140 @@
+/*
+*+
+*  Name:
+*     dat1TypeString
+
+*  Purpose:
+*     Get the HDS type string for a primitive data type
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1TypeString( hdstype_t hdstyp, size_t nchar, char type_str[DAT__SZTYP+1], int *status );
+
+*  Arguments:
+*     hdstyp = hdstype_t (Given)
+*        The primitive data type.
+*     nchar = size_t (Given)
+*        The number of characters in each element. Only used if "hdstyp"
+*        is HDSTYPE_CHAR.
+*     type_str = char * (Returned)
+*        Buffer of size DAT__SZTYP+1 to receive the type string.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Returns the HDS type string (e.g. "_INTEGER" or "_CHAR*12") that
+*     describes a primitive data type.
+
+*  Notes:
+*     - An error is reported if "hdstyp" is not a primitive type.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+#include "star/one.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+void
+dat1TypeString( hdstype_t hdstyp, size_t nchar, char type_str[DAT__SZTYP+1],
+                int *status ) {
+
+  if (*status != SAI__OK) return;
+
+  switch (hdstyp) {
+  case HDSTYPE_INTEGER:
+    one_strlcpy( type_str, "_INTEGER", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_REAL:
+    one_strlcpy( type_str, "_REAL", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_DOUBLE:
+    one_strlcpy( type_str, "_DOUBLE", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_BYTE:
+    one_strlcpy( type_str, "_BYTE", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_UBYTE:
+    one_strlcpy( type_str, "_UBYTE", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_WORD:
+    one_strlcpy( type_str, "_WORD", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_UWORD:
+    one_strlcpy( type_str, "_UWORD", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_LOGICAL:
+    one_strlcpy( type_str, "_LOGICAL", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_INT64:
+    one_strlcpy( type_str, "_INT64", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_CHAR:
+    one_snprintf( type_str, DAT__SZTYP+1, "_CHAR*%zu", status, nchar );
+    break;
+  default:
+    *status = DAT__TYPIN;
+    emsRepf("dat1TypeString_1","Unknown type associated with dataset/group (%d)",
+            status, hdstyp);
+  }
+}
@@ -0,0 +1,74 @@
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "dat_err.h"
+
+/* HDF5 allocates the space for a dataset when data are first written to
+   it, and HDS uses that to decide if a primitive has a defined value (see
+   datState). This does not work for datasets with a compact layout, since
+   their data are stored in the object header and so are allocated when
+   the dataset is created. dat1NewPrim therefore attaches an
+   HDS__ATTR_UNDEFINED attribute to each compact dataset it creates, and
+   datPut removes it the first time a value is written. Datasets that do
+   not have a compact layout never carry the attribute.
+
+   Once a dataset is known to have a defined value, that is recorded in
+   its Handle (if it has one) so that later calls need not ask HDF5 for
+   the space status or check for the attribute. A defined value only
+   becomes undefined if the dataset is replaced (datReset, datAlter),
+   and those routines invalidate the cached state. An undefined state is
+   never cached, since a value may be written by other means (e.g. a
+   mapped file). */
+
+/* Return HDS_TRUE if the supplied dataset has a defined value. "handle"
+   may be NULL. */
+
+hdsbool_t dat1IsDefined( hid_t dataset_id, Handle *handle, int *status ) {
+  H5D_space_status_t dstatus = 0;
+  hdsbool_t result = HDS_FALSE;
+  htri_t exists;
+
+  if (*status != SAI__OK) return result;
+  if (handle && dat1MetaCached( handle, HDS__META_DEFINED )) return HDS_TRUE;
+
+  CALLHDFQ( H5Dget_space_status( dataset_id, &dstatus ) );
+  if (dstatus == H5D_SPACE_STATUS_ALLOCATED ||
+      dstatus == H5D_SPACE_STATUS_PART_ALLOCATED) {
+    CALLHDFE( htri_t, exists,
+              H5Aexists( dataset_id, HDS__ATTR_UNDEFINED ),
+              DAT__HDF5E,
+              emsRep( " ", "Error checking the state of a primitive", status )
+              );
+    result = exists ? HDS_FALSE : HDS_TRUE;
+  }
+  if (result) dat1MetaStore( handle, HDS__META_DEFINED );
+
+ CLEANUP:
+  return result;
+}
+
+/* Record that a value has been written to the supplied dataset. "handle"
+   may be NULL. */
+
+void dat1MarkDefined( hid_t dataset_id, Handle *handle, int *status ) {
+  htri_t exists;
+
+  if (*status != SAI__OK) return;
+  if (handle && dat1MetaCached( handle, HDS__META_DEFINED )) return;
+
+  CALLHDFE( htri_t, exists,
+            H5Aexists( dataset_id, HDS__ATTR_UNDEFINED ),
+            DAT__HDF5E,
+            emsRep( " ", "Error checking the state of a primitive", status )
+            );
+  if (exists) {
+    CALLHDFQ( H5Adelete( dataset_id, HDS__ATTR_UNDEFINED ) );
+  }
+  dat1MetaStore( handle, HDS__META_DEFINED );
+
+ CLEANUP:
+  return;
+}
@@ -0,0 +1,105 @@
+/*
+*+
+*  Name:
+*     dat1UnlinkHandle
+
+*  Purpose:
+*     Remove a Handle from its parent's list of children.
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1UnlinkHandle( Handle *child );
+
+*  Arguments:
+*     child = Handle * (Given)
+*        The child Handle.
+
+*  Description:
+*     The child is removed from its parent's array of children and hash
+*     table, and the slot it occupied in the array is recorded as free for
+*     re-use. The parent pointer in the child is not changed. Nothing is
+*     done if the child has no parent or is not linked to it.
+
+*  Notes:
+*     - This function will attempt to execute even if an error has
+*     already occurred.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Remove the locks held on the child from the counts in its ancestors.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include "sae_par.h"
+#include "dat1.h"
+
+void dat1UnlinkHandle( Handle *child ) {
+
+/* Local Variables; */
+   Handle *parent;
+   int lstat;
+   int status = SAI__OK;
+
+   parent = child ? child->parent : NULL;
+   if( parent && child->ichild < parent->nchild &&
+       parent->children[ child->ichild ] == child ) {
+
+/* Remove any locks held on the child (or its descendants) from the
+   counts stored in its ancestors. */
+      if( HANDLE_VALID( child ) ) dat1HandleLock( child, 4, 0, 0, &lstat,
+                                                  &status );
+      parent->children[ child->ichild ] = NULL;
+      parent->freechild[ parent->nfree++ ] = child->ichild;
+      if( child->name ) HASH_DELETE( hh, parent->childhash, child );
+   }
+}
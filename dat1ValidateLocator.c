@@ -42,14 +42,32 @@
 *     that has been annulled automatically as a result of the file being
 *     closed. An error is also reported if the current thread does no
 *     have an appropriate lock on the supplied object.
+*
+*     If the locator refers to an HDF5 object that has not yet been
+*     opened (see dat1Deferred.c), the object is opened. Likewise, a
+*     locator for an empty structure cell is updated to refer to the
+*     cell if the cell has since been created (see dat1OpenCell.c).
+*
+*     The dat1ValidateQuery function performs the same checks as
+*     dat1ValidateLocator (with "checklock" and "rdonly" both non-zero),
+*     but does not open the HDF5 object. It should be used by functions
+*     that can often answer a query without the object, and which call
+*     dat1OpenDeferred before using any of the HDF5 identifiers in the
+*     locator.
 
 *  Authors:
 *     DSB: David Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     7-JUL-2017 (DSB):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Open the HDF5 object for a deferred locator, and add
+*        dat1ValidateQuery, which does not.
+*     2026-10-16 (AGENT):
+*        Open empty structure cells created through other locators.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -85,8 +103,23 @@
 #include "hds.h"
 #include "dat_err.h"
 
+static int dat1Validate( const char *func, int checklock, const HDSLoc *loc,
+                         int rdonly, int * status );
+
 int dat1ValidateLocator( const char *func, int checklock, const HDSLoc *loc,
                          int rdonly, int * status ) {
+   dat1Validate( func, checklock, loc, rdonly, status );
+   dat1OpenDeferred( loc, status );
+   dat1OpenCell( loc, HDS_FALSE, status );
+   return *status;
+}
+
+int dat1ValidateQuery( const char *func, const HDSLoc *loc, int * status ) {
+   return dat1Validate( func, 1, loc, 1, status );
+}
+
+static int dat1Validate( const char *func, int checklock, const HDSLoc *loc,
+                         int rdonly, int * status ) {
 
 /* Local Variables; */
    int valid;
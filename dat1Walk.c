@@ -0,0 +1,352 @@
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+#include "star/one.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* The functions in this file walk through an HDS hierarchy using HDF5
+   identifiers directly, without creating any locators. They are used by
+   datWalk, which describes the object at the top of the hierarchy using
+   its locator, and by dat1CatalogueWrite, which walks the whole of a
+   container file while it is being closed (when no locator for the root
+   object may exist). */
+
+/* The state of a walk. */
+typedef struct WalkContext {
+  int (*func)( const HDSWalkNode *node, void *data, int *status );
+  void *data;
+  int flags;
+  char *path;           /* Path to the object being visited */
+  size_t pathsize;      /* Allocated size of "path" */
+  hdsbool_t stop;       /* Has "func" asked for the walk to end? */
+  int *status;
+} WalkContext;
+
+/* The information passed to the HDF5 callback function. */
+typedef struct WalkLinkData {
+  WalkContext *ctx;
+  int level;
+} WalkLinkData;
+
+static herr_t dat1WalkLink( hid_t group_id, const char *name,
+                           const H5L_info_t *info, void *op_data );
+static size_t dat1WalkReport( HDSWalkNode *node, WalkContext *ctx );
+static void dat1WalkCells( hid_t group_id, const char *name, const char *type,
+                          int ndim, const hdsdim dims[], int level,
+                          WalkContext *ctx );
+static void dat1WalkGroup( hid_t group_id, int level, WalkContext *ctx );
+static void dat1WalkObject( hid_t obj_id, const char *name, hdsbool_t iscell,
+                           int level, WalkContext *ctx );
+
+
+/* Visit the object identified by "obj_id" and everything within it.
+   If "top" is NULL, "obj_id" should be a group or dataset and it is
+   described from the HDF5 object itself, using the supplied HDS name.
+   Otherwise "top" describes the object (which may be a slice or an
+   untouched cell, say), and "obj_id" is only used to find the contents
+   of a structure. "obj_id" may then be zero if there are no contents. */
+
+void dat1Walk( hid_t obj_id, const char *name, const HDSWalkNode *top,
+               int flags,
+               int (*func)( const HDSWalkNode *node, void *data, int *status ),
+               void *data, int *status ) {
+  WalkContext ctx;
+  HDSWalkNode node;
+
+  if (*status != SAI__OK) return;
+
+  memset( &ctx, 0, sizeof(ctx) );
+  ctx.func = func;
+  ctx.data = data;
+  ctx.flags = flags;
+  ctx.status = status;
+
+  if (!top) {
+    dat1WalkObject( obj_id, name, HDS_FALSE, 0, &ctx );
+
+  } else {
+    node = *top;
+    node.level = 0;
+    dat1WalkReport( &node, &ctx );
+
+    if (node.isstruc && obj_id > 0) {
+      if (node.ndim == 0) {
+        dat1WalkGroup( obj_id, 1, &ctx );
+      } else if (!(flags & HDS_WALK_NOCELLS)) {
+        dat1WalkCells( obj_id, node.name, node.type, node.ndim, node.dims, 1,
+                       &ctx );
+      }
+    }
+  }
+
+  if (ctx.path) MEM_FREE( ctx.path );
+}
+
+/* Append the name of the supplied object to the current path and pass
+   the object to the user's function, unless the walk has ended.
+   Returns the previous length of the path, which the caller should
+   restore once the object's contents have been visited. */
+
+static size_t dat1WalkReport( HDSWalkNode *node, WalkContext *ctx ) {
+  const char *tail;
+  char *path;
+  size_t oldlen;
+  size_t newlen;
+  int *status = ctx->status;
+
+  oldlen = ctx->path ? strlen( ctx->path ) : 0;
+  if (*status != SAI__OK || ctx->stop) return oldlen;
+
+  /* The path to a cell is the path to the array followed by the
+     subscripts. */
+  if (node->level == 0) {
+    tail = node->name;
+  } else if (node->iscell) {
+    tail = strchr( node->name, '(' );
+  } else {
+    tail = node->name;
+  }
+
+  newlen = oldlen + strlen( tail ) + 2;
+  if (newlen > ctx->pathsize) {
+    path = MEM_REALLOC( ctx->path, 2*newlen );
+    if (!path) {
+      *status = DAT__NOMEM;
+      emsRep( "datWalk_1", "datWalk: Could not allocate memory for an "
+              "object path", status );
+      return oldlen;
+    }
+    if (!ctx->path) path[0] = 0;
+    ctx->path = path;
+    ctx->pathsize = 2*newlen;
+  }
+
+  if (node->level > 0 && !node->iscell) strcat( ctx->path, "." );
+  strcat( ctx->path, tail );
+  node->path = ctx->path;
+
+  if (ctx->func( node, ctx->data, status )) ctx->stop = HDS_TRUE;
+
+  return oldlen;
+}
+
+/* Visit each component of the structure held in the supplied group, in
+   the same order as datIndex. */
+
+static void dat1WalkGroup( hid_t group_id, int level, WalkContext *ctx ) {
+  WalkLinkData linkdata;
+  H5_index_t idxtype;
+  hsize_t idx = 0;
+  herr_t herr;
+  int *status = ctx->status;
+
+  if (*status != SAI__OK || ctx->stop) return;
+
+  linkdata.ctx = ctx;
+  linkdata.level = level;
+  idxtype = dat1IndexType( group_id, NULL, status );
+  if (*status != SAI__OK) return;
+
+  herr = H5Literate( group_id, idxtype, H5_ITER_INC, &idx, dat1WalkLink,
+                     &linkdata );
+  if (herr < 0 && *status == SAI__OK) {
+    *status = DAT__HDF5E;
+    dat1H5EtoEMS( status );
+    emsRep( "datWalk_2", "datWalk: Error iterating over the components "
+            "of a structure", status );
+  }
+}
+
+/* Called by H5Literate for each link in a group. Returns zero to
+   continue the iteration, a positive value if the walk has ended, and a
+   negative value if an error occurred. */
+
+static herr_t dat1WalkLink( hid_t group_id, const char *name,
+                           const H5L_info_t *info, void *op_data ) {
+  WalkLinkData *linkdata = op_data;
+  WalkContext *ctx = linkdata->ctx;
+  int *status = ctx->status;
+  hid_t obj_id;
+
+  if (*status != SAI__OK) return -1;
+
+  /* The catalogue of the file is not a component. */
+  if (!strcmp( name, DAT__CATNAME )) return 0;
+
+  obj_id = H5Oopen( group_id, name, H5P_DEFAULT );
+  if (obj_id < 0) {
+    *status = DAT__OBJIN;
+    dat1H5EtoEMS( status );
+    emsRepf( "datWalk_3", "datWalk: Error opening component %s", status,
+             name );
+    return -1;
+  }
+
+  dat1WalkObject( obj_id, name, HDS_FALSE, linkdata->level, ctx );
+  H5Oclose( obj_id );
+
+  if (*status != SAI__OK) return -1;
+  return ctx->stop ? 1 : 0;
+}
+
+/* Describe an opened HDF5 object, pass it to the user's function, and
+   then visit its contents. Objects that are neither groups nor datasets
+   are not part of the HDS hierarchy and are ignored. */
+
+static void dat1WalkObject( hid_t obj_id, const char *name, hdsbool_t iscell,
+                           int level, WalkContext *ctx ) {
+  H5I_type_t objtype;
+  HDSWalkNode node;
+  char type[DAT__SZTYP+1];
+  hdsdim dims[DAT__MXDIM];
+  hsize_t h5dims[DAT__MXDIM];
+  hdstype_t hdstyp;
+  hid_t dataspace_id = 0;
+  hid_t h5type = 0;
+  size_t actdims = 0;
+  size_t oldlen;
+  int i;
+  int rank = 0;
+  int *status = ctx->status;
+
+  if (*status != SAI__OK || ctx->stop) return;
+
+  memset( &node, 0, sizeof(node) );
+  objtype = H5Iget_type( obj_id );
+
+  if (objtype == H5I_GROUP) {
+    node.isstruc = HDS_TRUE;
+    dat1GetAttrString( obj_id, HDS__ATTR_STRUCT_TYPE, HDS_TRUE,
+                       "HDF5NATIVEGROUP", type, sizeof(type), status );
+    if (H5Aexists( obj_id, HDS__ATTR_STRUCT_DIMS ) > 0) {
+      dat1GetAttrHdsdims( obj_id, HDS__ATTR_STRUCT_DIMS, HDS_FALSE, 0, NULL,
+                          DAT__MXDIM, dims, &actdims, status );
+    }
+    rank = actdims;
+
+  } else if (objtype == H5I_DATASET) {
+    CALLHDFE( hid_t, h5type,
+              H5Dget_type( obj_id ),
+              DAT__HDF5E,
+              emsRepf( "datWalk_4", "datWalk: Error obtaining data type of "
+                       "primitive %s", status, name )
+              );
+    hdstyp = dau1HdsType( h5type, status );
+    dat1TypeString( hdstyp, H5Tget_size( h5type ), type, status );
+
+    CALLHDFE( hid_t, dataspace_id,
+              H5Dget_space( obj_id ),
+              DAT__HDF5E,
+              emsRepf( "datWalk_5", "datWalk: Error obtaining shape of "
+                       "primitive %s", status, name )
+              );
+    CALLHDFE( int, rank,
+              H5Sget_simple_extent_dims( dataspace_id, h5dims, NULL ),
+              DAT__DIMIN,
+              emsRepf( "datWalk_6", "datWalk: Error obtaining shape of "
+                       "primitive %s", status, name )
+              );
+    dat1ExportDims( rank, h5dims, dims, status );
+    node.nbytes = H5Tget_size( h5type );
+    for (i = 0; i < rank; i++) node.nbytes *= h5dims[i];
+
+    if (ctx->flags & HDS_WALK_STATE) {
+      node.state = dat1IsDefined( obj_id, NULL, status );
+    }
+
+  } else {
+    return;
+  }
+
+  if (*status != SAI__OK) goto CLEANUP;
+
+  node.name = name;
+  node.type = type;
+  node.level = level;
+  node.ndim = rank;
+  node.dims = dims;
+  node.iscell = iscell;
+  oldlen = dat1WalkReport( &node, ctx );
+
+  if (node.isstruc) {
+    if (rank == 0) {
+      dat1WalkGroup( obj_id, level + 1, ctx );
+    } else if (!(ctx->flags & HDS_WALK_NOCELLS)) {
+      dat1WalkCells( obj_id, name, type, rank, dims, level + 1, ctx );
+    }
+  }
+
+  if (ctx->path) ctx->path[ oldlen ] = 0;
+
+ CLEANUP:
+  if (h5type > 0) H5Tclose( h5type );
+  if (dataspace_id > 0) H5Sclose( dataspace_id );
+}
+
+/* Visit each cell of the structure array held in the supplied group, in
+   Fortran order. Cells that have not yet been created are visited as
+   empty structures. */
+
+static void dat1WalkCells( hid_t group_id, const char *name, const char *type,
+                          int ndim, const hdsdim dims[], int level,
+                          WalkContext *ctx ) {
+  HDSWalkNode node;
+  char cellname[128];
+  char nodename[DAT__SZNAM + 128];
+  hdsdim coords[DAT__MXDIM];
+  hid_t cell_id;
+  size_t i;
+  size_t nel = 1;
+  size_t oldlen;
+  htri_t exists;
+  int j;
+  int *status = ctx->status;
+
+  for (j = 0; j < ndim; j++) nel *= dims[j];
+
+  for (i = 1; i <= nel && *status == SAI__OK && !ctx->stop; i++) {
+    dat1Index2Coords( i, ndim, dims, coords, status );
+    dat1Coords2CellName( ndim, coords, cellname, sizeof(cellname), status );
+    one_snprintf( nodename, sizeof(nodename), "%s%s", status, name,
+                  strchr( cellname, '(' ) );
+    if (*status != SAI__OK) break;
+
+    exists = H5Lexists( group_id, cellname, H5P_DEFAULT );
+    if (exists > 0) {
+      cell_id = H5Gopen2( group_id, cellname, H5P_DEFAULT );
+      if (cell_id < 0) {
+        *status = DAT__OBJIN;
+        dat1H5EtoEMS( status );
+        emsRepf( "datWalk_7", "datWalk: Error opening cell %s", status,
+                 nodename );
+      } else {
+        dat1WalkObject( cell_id, nodename, HDS_TRUE, level, ctx );
+        H5Gclose( cell_id );
+      }
+
+    } else if (exists == 0) {
+      memset( &node, 0, sizeof(node) );
+      node.name = nodename;
+      node.type = type;
+      node.level = level;
+      node.isstruc = HDS_TRUE;
+      node.iscell = HDS_TRUE;
+      oldlen = dat1WalkReport( &node, ctx );
+      if (ctx->path) ctx->path[ oldlen ] = 0;
+
+    } else {
+      *status = DAT__HDF5E;
+      dat1H5EtoEMS( status );
+      emsRepf( "datWalk_8", "datWalk: Error checking for cell %s", status,
+               nodename );
+    }
+  }
+}
@@ -34,6 +34,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -54,6 +55,18 @@
 *        it will be more efficient. It will only work if the dataset
 *        could not support memory mapping so the fact that the new
 *        one also won't is irrelevant.
+*     2026-10-16 (AGENT):
+*        Structure array cells are created lazily by datCell so do not
+*        create them when extending, and skip missing cells when shrinking.
+*     2026-10-16 (AGENT):
+*        Invalidate cached metadata, and erase the Handles of deleted cells.
+*     2026-10-16 (AGENT):
+*        Clear the list of names known not to exist in the parent.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Store the replacement dataset with the same chunking and filters
+*        as the original.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -118,6 +131,8 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
   hdsdim curdims[DAT__MXDIM];
   int curndim;
   int i;
+  HDSCreateProps props;
+  hdsdim chunk[DAT__MXDIM];
   HDSLoc * parloc = NULL;
   HDSLoc * temploc = NULL;
   hid_t new_dataset_id = 0;
@@ -137,7 +152,7 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
     return *status;
   }
 
-  if (locator->regpntr) {
+  if (locator->map && locator->map->regpntr) {
     *status = DAT__OBJIN;
     emsRep("datAlter_2", "Can not alter the size of a mapped primitive",
            status);
@@ -151,6 +166,9 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
     return *status;
   }
 
+  /* The catalogue records the shape of every object */
+  dat1CatalogueStale( locator, status );
+
   /* Get the current dimensions and validate new ones */
   datShape( locator, DAT__MXDIM, curdims, &curndim, status );
 
@@ -192,17 +210,8 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
     }
 
     if (newcount > curcount) {
-      /* Need to extend */
-      char grouptype[DAT__SZTYP+1];
-      char groupname[DAT__SZNAM+1];
-      datType( locator, grouptype, status );
-      datName( locator, groupname, status );
-
-      for (i=curcount+1; i <= newcount; i++) {
-        hid_t cellgroup_id = 0;
-        cellgroup_id = dat1CreateStructureCell( locator->group_id, i, grouptype, groupname, ndim, dims, status );
-        if (cellgroup_id > 0) H5Gclose(cellgroup_id);
-      }
+      /* Need to extend. The new cells are created by datCell when
+         they are first accessed so only the dimensions change. */
     } else if (newcount < curcount) {
       /* Need to shrink - delete each structure and complain if
          the structure is not empty -- use curdims */
@@ -214,6 +223,10 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
         dat1Index2Coords(i, ndim, curdims, coords, status );
         dat1Coords2CellName( ndim, coords, cellname, sizeof(cellname), status );
 
+        /* Cells that were never accessed do not exist */
+        if (*status == SAI__OK &&
+            H5Lexists( locator->group_id, cellname, H5P_DEFAULT ) <= 0) continue;
+
         /* Need to peak inside -- datCell would be a bit inefficient but use minimum code/
            Should still work as I remove earlier structures as part of the loop */
         datCell(locator, ndim, coords, &cell, status );
@@ -230,6 +243,7 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
         /* Remove the empty element -- can not use datErase because
            structure elements are deliberately too long. */
         CALLHDFQ( H5Ldelete( locator->group_id, cellname, H5P_DEFAULT ) );
+        dat1EraseHandle( locator->handle, cellname, status );
       }
     } else {
       /* Oddly, no change requested so we are done. Should this be an error? */
@@ -264,7 +278,9 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
          create datasets that can be memory mapped. We therefore
          resize by creating a new dataset of the correct size,
          copying in the contents from the original, deleting the
-         original, then renaming the new dataset. */
+         original, then renaming the new dataset. This is also the
+         route taken by a compact dataset, and dat1NewPrim chooses the
+         layout of the new dataset from its new size. */
 
       /* Need enclosing group locator */
       datParen( locator, &parloc, status );
@@ -289,7 +305,9 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
         H5Ldelete( parloc->group_id, tempname, H5P_DEFAULT);
       }
 
-      dat1NewPrim( parloc->group_id, ndim, h5dims, h5type, tempname,
+      /* Store the new dataset in the same way as the old one */
+      dat1DatasetProps( locator->dataset_id, &props, chunk, status );
+      dat1NewPrim( parloc->group_id, ndim, h5dims, h5type, &props, tempname,
                    &new_dataset_id, &new_dataspace_id, status );
 
       /* Nothing to copy if the source locator is not defined */
@@ -359,6 +377,7 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
       /* Relocate the new dataset */
       CALLHDFQ(H5Lmove( parloc->group_id, tempname,
                         parloc->group_id, primname, H5P_DEFAULT, H5P_DEFAULT));
+      dat1MetaClearAbsent( parloc->handle );
 
       /* Update the locator */
       locator->dataspace_id = new_dataspace_id;
@@ -384,6 +403,9 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
   }
 
  CLEANUP:
+  /* The cached shape of the object is no longer valid */
+  dat1MetaInvalidate( locator->handle, HDS__META_ALL, HDS_FALSE );
+
   datAnnul(&parloc, status);
   if (*status != SAI__OK) {
     if (h5type > 0) H5Tclose( h5type );
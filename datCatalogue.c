@@ -0,0 +1,138 @@
+/*
+*+
+*  Name:
+*     datCatalogue
+
+*  Purpose:
+*     Visit every object in an HDS hierarchy using the file catalogue
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datCatalogue( const HDSLoc *locator,
+*                   int (*func)( const HDSWalkNode *node, void *data, int *status ),
+*                   void *data, int flags, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator for the object at the top of the hierarchy.
+*     func = int (*)( const HDSWalkNode *node, void *data, int *status ) (Given)
+*        The function to call for each object (see datWalk).
+*     data = void * (Given)
+*        An arbitrary pointer that is passed on to "func".
+*     flags = int (Given)
+*        A combination of the HDS_WALK_STATE and HDS_WALK_NOCELLS flags, or
+*        zero (see datWalk).
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Calls the supplied function once for each object in the hierarchy
+*     below (and including) the supplied object, in exactly the same way as
+*     datWalk. However, if the container file holds an up to date catalogue
+*     of its contents, the objects are described using the catalogue, which
+*     is read from the file in a single operation, rather than by opening
+*     every object. Otherwise datWalk is used.
+*
+*     A catalogue is written to a container file when the file is closed,
+*     if the file has been modified and the CATALOGUE tuning parameter is
+*     set (see hdsTune). Each catalogue records the generation number of
+*     the file when it was written, and the first modification made to a
+*     file after it is opened increments its generation number. So a
+*     catalogue is not used once the file has been modified while the
+*     CATALOGUE tuning parameter was not set.
+
+*  Notes:
+*     - The catalogue is not used for a slice, a vectorised primitive, or
+*     an untouched cell of a structure array in a read-only file, or if
+*     the file has been modified since it was opened.
+*     - If the file has been modified by software that does not maintain
+*     the generation number (such as an earlier version of HDS), the
+*     catalogue may not be recognised as out of date.
+*     The catalogue is only used if it holds the same number of top-level
+*     components as the file, and if it contains the supplied object.
+*     - The state of each primitive is recorded in the catalogue, and so
+*     HDS_WALK_STATE has no extra cost if a catalogue is used.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+datCatalogue( const HDSLoc *locator,
+              int (*func)( const HDSWalkNode *node, void *data, int *status ),
+              void *data, int flags, int *status ) {
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datCatalogue", 1, locator, 1, status );
+  if (*status != SAI__OK) return *status;
+
+  /* Use the catalogue if possible, and otherwise walk the hierarchy. */
+  if (!dat1CatalogueScan( locator, func, data, flags, status )) {
+    datWalk( locator, func, data, flags, status );
+  }
+
+  return *status;
+}
@@ -36,6 +36,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -43,6 +44,9 @@
 *        Initial version
 *     2014-10-29 (TIMJ):
 *        Enable copying of an undefined primitive object.
+*     2026-10-16 (AGENT):
+*        An undefined primitive is copied with the same chunking and
+*        filters as the original.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -115,7 +119,8 @@ datCcopy(const HDSLoc *locator1, const HDSLoc *locator2, const char *name,
     datType( locator1, type_str, status );
     datShape( locator1, DAT__MXDIM, hdims, &ndims, status );
 
-    *locator3 = dat1New( locator2, 0, name, type_str, ndims, hdims, status );
+    *locator3 = dat1New( locator2, 0, name, type_str, ndims, hdims, NULL,
+                         status );
 
   } else {
     hdsbool_t state = 0;
@@ -124,10 +129,14 @@ datCcopy(const HDSLoc *locator1, const HDSLoc *locator2, const char *name,
     if ( state ) {
       datCopy( locator1, locator2, name, status );
     } else {
-      /* Undefined so just make something of the right shape and type */
+      /* Undefined so just make something of the right shape and type,
+         stored in the same way as the original */
+      HDSCreateProps props;
+      hdsdim chunk[DAT__MXDIM];
       datType( locator1, type_str, status );
       datShape( locator1, DAT__MXDIM, hdims, &ndims, status );
-      datNew( locator2, name, type_str, ndims, hdims, status );
+      dat1DatasetProps( locator1->dataset_id, &props, chunk, status );
+      datNewP( locator2, name, type_str, ndims, hdims, &props, status );
     }
 
     /* and get a locator to the copied entity */
@@ -33,6 +33,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -40,12 +41,22 @@
 *     array for subsequent access to its components, although this
 *     does not preclude its use in accessing a single pixel in a 2-D
 *     image for example.
+*
+*     Cells of a structure array are created the first time something
+*     is written into them (e.g. by datNew or datCopy). Until then the
+*     returned locator refers to an empty scalar structure.
 
 *  History:
 *     2014-09-06 (TIMJ):
 *        Initial version
 *     2014-10-28 (TIMJ):
 *        Fix case of vectorized 1-D structure.
+*     2026-10-16 (AGENT):
+*        Create structure array cells on first access.
+*     2026-10-16 (AGENT):
+*        Do not open the HDF5 group for an existing cell until it is needed.
+*     2026-10-16 (AGENT):
+*        Only create a new cell when something is written into it.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -154,6 +165,9 @@ datCell(const HDSLoc *locator1, int ndim, const hdsdim subs[],
   if (isstruct) {
     char cellname[128];
     hid_t group_id = 0;
+    htri_t exists = 0;
+    hdsbool_t isempty = HDS_FALSE;
+    hdsbool_t deferred = HDS_FALSE;
     int rank = 0;
     hdsdim groupsub[DAT__MXDIM];
 
@@ -196,11 +210,31 @@ datCell(const HDSLoc *locator1, int ndim, const hdsdim subs[],
 
     /* Calculate the relevant group name */
     dat1Coords2CellName( ndim, groupsub, cellname, sizeof(cellname), status );
-    CALLHDFE( hid_t, group_id,
-            H5Gopen2( locator1->group_id, cellname, H5P_DEFAULT ),
-            DAT__OBJIN,
-            emsRepf("datCell_3", "datCell: Error opening component %s", status, cellname)
-            );
+
+    /* Cells are only created when they are first needed, so the cell
+       may not exist yet. */
+    CALLHDFE( htri_t, exists,
+              H5Lexists( locator1->group_id, cellname, H5P_DEFAULT ),
+              DAT__HDF5E,
+              emsRepf("datCell_2", "datCell: Error checking existence of cell %s",
+                      status, cellname)
+              );
+
+    /* An existing cell is not opened until it is needed (see
+       dat1Deferred.c). A cell that does not exist is only created when
+       something is written into it (see dat1OpenCell.c), so until then
+       the locator refers to the array group and is flagged as an empty
+       cell. */
+    if (exists) {
+      deferred = HDS_TRUE;
+    } else {
+      CALLHDFE( hid_t, group_id,
+                H5Gopen2( locator1->group_id, ".", H5P_DEFAULT ),
+                DAT__OBJIN,
+                emsRepf("datCell_3b", "datCell: Error opening array %s", status, namestr)
+                );
+      isempty = HDS_TRUE;
+    }
 
     /* Create the locator */
     thisloc = dat1AllocLoc( status );
@@ -229,7 +263,12 @@ datCell(const HDSLoc *locator1, int ndim, const hdsdim subs[],
                  "a conflicting lock on the same component.", status );
       }
 
-      thisloc->group_id = group_id;
+      if (deferred) {
+        dat1DeferLocator( thisloc, locator1->group_id, HDS_TRUE, status );
+      } else {
+        thisloc->group_id = group_id;
+      }
+      thisloc->isemptycell = isempty;
 
       /* Secondary locator by definition */
       thisloc->file_id = locator1->file_id;
@@ -29,6 +29,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -41,6 +42,13 @@
 *  History:
 *     2014-09-04 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
+*     2026-10-16 (AGENT):
+*        A clone of a locator whose HDF5 object has not yet been opened is also
+*        not opened.
+*     2026-10-16 (AGENT):
+*        Copy the identifiers with the Handle mutex locked.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -84,6 +92,7 @@
 *-
 */
 
+#include <pthread.h>
 #include <string.h>
 
 #include "hdf5.h"
@@ -101,12 +110,13 @@ int
 datClone(const HDSLoc *locator1, HDSLoc **locator2, int *status) {
 
   HDSLoc * clonedloc = NULL;
+  int locked = 0;
 
   *locator2 = NULL;
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
-  dat1ValidateLocator( "datClone", 1, locator1, 1, status );
+  dat1ValidateQuery( "datClone", locator1, status );
 
   clonedloc = dat1AllocLoc( status );
   if (*status != SAI__OK) goto CLEANUP;
@@ -117,30 +127,45 @@ datClone(const HDSLoc *locator1, HDSLoc **locator2, int *status) {
   clonedloc->hdsFile = locator1->hdsFile;
   hds1RegLocator( clonedloc, status );
 
-  if (locator1->dataset_id > 0) {
-    CALLHDFE( hid_t, clonedloc->dataset_id,
-             H5Dopen2( locator1->dataset_id, ".", H5P_DEFAULT ),
-             DAT__HDF5E,
-             emsRep("datClone_1", "Error opening a dataset during clone",
-                    status )
-             );
-  }
-  if (locator1->dataspace_id > 0) {
-    CALLHDFE( hid_t, clonedloc->dataspace_id,
-             H5Scopy( locator1->dataspace_id ),
-             DAT__HDF5E,
-             emsRep("datClone_2", "Error copying a dataspace during clone",
-                    status )
-             );
-  }
-  if (locator1->group_id > 0) {
-    CALLHDFE( hid_t, clonedloc->group_id,
-             H5Gopen2( locator1->group_id, ".", H5P_DEFAULT ),
-             DAT__HDF5E,
-             emsRep("datClone_3", "Error opening a group ID during clone",
-                    status )
-             );
+  /* Another thread may open the HDF5 object for a deferred locator, or
+     create an empty cell, at any time (see dat1Deferred.c and
+     dat1OpenCell.c). So copy the identifiers with the Handle mutex
+     locked. If the HDF5 object has not yet been opened, neither is the
+     clone. */
+  pthread_mutex_lock( &(locator1->handle->mutex) );
+  locked = 1;
+  if (locator1->defer_id > 0) {
+    dat1DeferLocator( clonedloc, locator1->defer_id, locator1->deferstruc,
+                      status );
+  } else {
+    if (locator1->dataset_id > 0) {
+      CALLHDFE( hid_t, clonedloc->dataset_id,
+               H5Dopen2( locator1->dataset_id, ".", H5P_DEFAULT ),
+               DAT__HDF5E,
+               emsRep("datClone_1", "Error opening a dataset during clone",
+                      status )
+               );
+    }
+    if (locator1->dataspace_id > 0) {
+      CALLHDFE( hid_t, clonedloc->dataspace_id,
+               H5Scopy( locator1->dataspace_id ),
+               DAT__HDF5E,
+               emsRep("datClone_2", "Error copying a dataspace during clone",
+                      status )
+               );
+    }
+    if (locator1->group_id > 0) {
+      CALLHDFE( hid_t, clonedloc->group_id,
+               H5Gopen2( locator1->group_id, ".", H5P_DEFAULT ),
+               DAT__HDF5E,
+               emsRep("datClone_3", "Error opening a group ID during clone",
+                      status )
+               );
+    }
   }
+  clonedloc->isemptycell = locator1->isemptycell;
+  pthread_mutex_unlock( &(locator1->handle->mutex) );
+  locked = 0;
 
   /* Retain knowledge of vectorization, slicing, etc */
   clonedloc->vectorized = locator1->vectorized;
@@ -150,6 +175,7 @@ datClone(const HDSLoc *locator1, HDSLoc **locator2, int *status) {
   clonedloc->handle = locator1->handle;
 
  CLEANUP:
+  if (locked) pthread_mutex_unlock( &(locator1->handle->mutex) );
   if (*status != SAI__OK) {
     if (clonedloc) datAnnul( &clonedloc, status );
   } else {
@@ -33,6 +33,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -43,6 +44,14 @@
 *        Initial version
 *     2014-11-22 (TIMJ):
 *        Understand the possibility that we are copying the root group
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
+*     2026-10-16 (AGENT):
+*        Clear the list of names known not to exist in the parent.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Create an empty target cell before copying into it.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -102,6 +111,7 @@ int
 datCopy( const HDSLoc *locator1, const HDSLoc *locator2,
          const char *name_str, int *status) {
 
+  char catpath[DAT__SZNAM+sizeof(DAT__CATNAME)+1];
   char sourcename[DAT__SZNAM+1];
   char cleanname[DAT__SZNAM+1];
   hid_t parent_id = -1;
@@ -114,8 +124,19 @@ datCopy( const HDSLoc *locator1, const HDSLoc *locator2,
   dat1ValidateLocator( "datCopy", 1, locator2, 0, status );
 
   dau1CheckName( name_str, 1, cleanname, sizeof(cleanname), status );
+
+  /* Create the target cell if this is the first thing written into it */
+  dat1OpenCell( locator2, HDS_TRUE, status );
   if (*status != SAI__OK) return *status;
 
+  /* An untouched cell is just an empty structure */
+  if (locator1->isemptycell) {
+    char typestr[DAT__SZTYP+1];
+    datType( locator1, typestr, status );
+    datNew( locator2, cleanname, typestr, 0, NULL, status );
+    return *status;
+  }
+
   /* Have to give the source name as "." doesn't seem to be allowed.
      so get the name and the parent locator. */
   objid = dat1RetrieveIdentifier( locator1, status );
@@ -130,9 +151,27 @@ datCopy( const HDSLoc *locator1, const HDSLoc *locator2,
   } else {
     datName( locator1, sourcename, status );
   }
+  dat1CatalogueStale( locator2, status );
   CALLHDFQ(H5Ocopy( (parent_id == -1 ? objid : parent_id), sourcename,
                     locator2->group_id, cleanname, H5P_DEFAULT, H5P_DEFAULT));
 
+  /* A copy of the top-level object includes the catalogue and generation
+     number of the source file, which would be hidden in the copy but
+     never used. */
+  if (parent_id == -1) {
+    star_strlcpy( catpath, cleanname, sizeof(catpath) );
+    star_strlcat( catpath, "/" DAT__CATNAME, sizeof(catpath) );
+    if (H5Lexists( locator2->group_id, catpath, H5P_DEFAULT ) > 0) {
+      CALLHDFQ( H5Ldelete( locator2->group_id, catpath, H5P_DEFAULT ) );
+    }
+    if (H5Aexists_by_name( locator2->group_id, cleanname,
+                           HDS__ATTR_GENERATION, H5P_DEFAULT ) > 0) {
+      CALLHDFQ( H5Adelete_by_name( locator2->group_id, cleanname,
+                                   HDS__ATTR_GENERATION, H5P_DEFAULT ) );
+    }
+  }
+  dat1MetaClearAbsent( locator2->handle );
+
  CLEANUP:
   if (parent_id) H5Gclose(parent_id);
   return *status;
@@ -29,6 +29,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -36,6 +37,8 @@
 *        Initial version
 *     2014-11-13 (TIMJ):
 *        Must normalize the name. Also add better error checking and reporting.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -114,6 +117,9 @@ datErase(const HDSLoc   *locator, const char *name_str, int *status) {
   /* Ensure the name is cleaned up before we use it */
   dau1CheckName( name_str, 1, cleanname, sizeof(cleanname), status );
 
+  /* Any catalogue in the file will no longer be correct */
+  dat1CatalogueStale( locator, status );
+
   CALLHDFQ( H5Ldelete( locator->group_id, cleanname, H5P_DEFAULT ));
 
   /* Remove the handle for the erased component and all sub-components */
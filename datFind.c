@@ -30,6 +30,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -46,6 +47,11 @@
 *        Initial version
 *     2014-11-14 (TIMJ):
 *        Child locators must inherit group
+*     2026-10-16 (AGENT):
+*        Open the component with a single H5Oopen call, and use the list of
+*        names known not to exist in the parent structure.
+*     2026-10-16 (AGENT):
+*        Do not open the HDF5 object until it is needed.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -92,6 +98,7 @@
 #include "hdf5.h"
 
 #include "ems.h"
+#include "star/util.h"
 
 #include "hds1.h"
 #include "dat1.h"
@@ -108,10 +115,9 @@ datFind( const HDSLoc   *locator1,
 
   char cleanname[DAT__SZNAM+1];
   HDSLoc * thisloc = NULL;
-  H5O_info_t object_info;
+  hdsbool_t exists;
+  hdsbool_t isstruc;
   int rdonly;
-  int there = 0;
-  int havegroup = 0;
   int lockinfo;
 
   if (*status != SAI__OK) return *status;
@@ -132,35 +138,33 @@ datFind( const HDSLoc   *locator1,
   dau1CheckName( name_str, 1, cleanname, sizeof(cleanname), status );
   if (*status != SAI__OK) return *status;
 
-  /* First ensure that the component exists */
-  datThere( locator1, cleanname, &there, status );
-  if (!there) {
-    if (*status == SAI__OK) {
-      *status = DAT__OBJNF;
-      emsRepf("datFind_1b", "datFind: Object '%s' not found",
-              status, cleanname);
-    }
+  /* Names already known not to exist in this structure, and untouched
+     cells of structure arrays, need not be looked up. */
+  if (locator1->isemptycell || dat1MetaIsAbsent( locator1->handle, cleanname )) {
+    *status = DAT__OBJNF;
+    emsRepf("datFind_1b", "datFind: Object '%s' not found",
+            status, cleanname);
     return *status;
   }
 
-  /* Check the type of the requested object */
-  CALLHDFQ( H5Oget_info_by_name( locator1->group_id, cleanname,
-                                 &object_info, H5P_DEFAULT ) );
-
-  /* Make sure we have a supported type */
-  if (*status == SAI__OK) {
-    H5O_type_t type = object_info.type;
-
-    if (type == H5O_TYPE_GROUP) {
-      havegroup = 1;
-    } else if (type == H5O_TYPE_DATASET) {
-      havegroup = 0;
+  /* Find out if the component exists and whether it is a structure,
+     without opening it. Only if it does not exist do we check whether
+     it was because the link does not exist, in which case the name is
+     remembered. */
+  exists = dat1PeekStruc( locator1, cleanname, &isstruc, status );
+  if (*status != SAI__OK) return *status;
+  if (!exists) {
+    if (H5Lexists( locator1->group_id, cleanname, H5P_DEFAULT ) == 0) {
+      dat1MetaSetAbsent( locator1->handle, cleanname );
+      *status = DAT__OBJNF;
+      emsRepf("datFind_1b", "datFind: Object '%s' not found",
+              status, cleanname);
     } else {
       *status = DAT__OBJIN;
-      emsRepf("datFind_1c", "datFind: Component '%s' exists but is neither group"
-              " nor dataset.", status, cleanname);
-      goto CLEANUP;
+      dat1H5EtoEMS( status );
+      emsRepf("datFind_2", "Error opening component %s", status, cleanname);
     }
+    return *status;
   }
 
   /* Create the locator */
@@ -172,46 +176,23 @@ datFind( const HDSLoc   *locator1,
   thisloc->hdsFile = locator1->hdsFile;
   hds1RegLocator( thisloc, status );
 
-  /* Use the simplification layer to see if we have a dataset of this name */
-  if (!havegroup) {
-    /* we are finding a dataset */
-    hid_t dataset_id;
-    hid_t dataspace_id;
-
-    CALLHDFE( hid_t, dataset_id,
-            H5Dopen2( locator1->group_id, cleanname, H5P_DEFAULT),
-            DAT__OBJIN,
-            emsRepf("datFind_2", "Error opening primitive named %s", status, cleanname)
-            );
-
-    /* and data space */
-    CALLHDFE( hid_t, dataspace_id,
-            H5Dget_space( dataset_id ),
-            DAT__OBJIN,
-            emsRepf("datFind_2b", "Error retrieving data space from primitive named %s",
-                    status, cleanname)
-            );
-
-    if (*status == SAI__OK) {
-      thisloc->dataset_id = dataset_id;
-      thisloc->dataspace_id = dataspace_id;
-    }
-  } else {
-    /* Try to open it as a group */
-    hid_t group_id;
-    CALLHDFE( hid_t, group_id,
-            H5Gopen2( locator1->group_id, cleanname, H5P_DEFAULT ),
-            DAT__OBJIN,
-            emsRepf("datFind_3", "Error opening component %s", status, cleanname)
-            );
-    if (*status == SAI__OK) thisloc->group_id = group_id;
-  }
+  /* The HDF5 object is not opened until it is needed (see
+     dat1Deferred.c). Just keep a reference to the parent group. */
+  dat1DeferLocator( thisloc, locator1->group_id, isstruc, status );
 
   /* Store a pointer to the handle for the returned HDF object */
   thisloc->handle = dat1Handle( locator1, cleanname, 0, status );
+  /* Cache the structure flag and the name (which is the name of the
+     HDF5 link), so that these can be enquired without opening the
+     object. */
+  if (*status == SAI__OK) {
+    thisloc->handle->metastruc = isstruc;
+    star_strlcpy( thisloc->handle->metaname, cleanname, DAT__SZNAM+1 );
+    dat1MetaStore( thisloc->handle, HDS__META_STRUC | HDS__META_NAME );
+  }
 
   /* We have to propagate groupness to the child */
-  if ( (locator1->grpname)[0] != '\0') hdsLink(thisloc, locator1->grpname, status);
+  if (locator1->grpname) hdsLink(thisloc, locator1->grpname, status);
 
   /* Determine if the current thread has a read-only or read-write lock
      on the parent object, referenced by the supplied locator. */
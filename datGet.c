@@ -38,10 +38,14 @@
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
-*
+*     - Conversions between numeric types are done by dat1CvtNumeric.
+*       Bad values are converted to the bad value of the requested type,
+*       and values that cannot be represented in the requested type are
+*       set bad and cause DAT__CONER to be returned.
 
 *  History:
 *     2014-08-28 (TIMJ):
@@ -53,6 +57,15 @@
 *        If getting a _CHAR*nnn, report an error (DAT__TRUNC) if the supplied
 *        buffer is too small for the returned string. This mimics HDS_V4
 *        behaviour.
+*     2026-10-16 (AGENT):
+*        Use dat1TransferNumeric for conversions between numeric types
+*        instead of the HDF5 type conversion.
+*     2026-10-16 (AGENT):
+*        Use dat1FileSpace so that vectorized locators work with chunked
+*        datasets.
+*     2026-10-16 (AGENT):
+*        Decompress the chunks of a filtered dataset on several threads
+*        (see the NTHREADS tuning parameter).
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -121,17 +134,18 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   hdstype_t outtype = HDSTYPE_NONE;
   hid_t tmptype = 0;
   hid_t h5type = 0;
+  hid_t file_dataspace_id = 0;
   hid_t mem_dataspace_id = 0;
   hsize_t h5dims[DAT__MXDIM];
   int actdim;
   int defined = 0;
   int i;
   int isprim;
-  size_t inlen;
+  size_t inlen = 0;
   size_t nbin = 0;
   size_t nbout = 0;
   size_t nelem = 0;
-  size_t outlen;
+  size_t outlen = 0;
   void * tmpvalues = NULL;
 
   if (*status != SAI__OK) return *status;
@@ -200,9 +214,26 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   } else if ((outtype == HDSTYPE_LOGICAL && intype != HDSTYPE_LOGICAL) ||
              (outtype != HDSTYPE_LOGICAL && intype == HDSTYPE_LOGICAL)) {
     doconv = HDSTYPE_LOGICAL;
+  } else if (outtype != intype && HDSTYPE_ISNUMERIC(outtype) &&
+             HDSTYPE_ISNUMERIC(intype)) {
+    doconv = outtype;
   }
 
-  if ( doconv == HDSTYPE_LOGICAL || doconv == HDSTYPE_CHAR ) {
+  if ( HDSTYPE_ISNUMERIC(doconv) ) {
+    /* Do numeric conversions ourselves rather than letting HDF5 do them.
+       This is faster, and it means that bad values and values that
+       cannot be represented in the output type are handled the same
+       way as in HDS v4. */
+    CALLHDFE( size_t, nbout,
+            H5Tget_size( h5type ),
+            DAT__HDF5E,
+            emsRep("datGet_size", "datGet: Error obtaining size of output type",
+                   status)
+            );
+    dat1TransferNumeric( locator, HDS_FALSE, outtype, nbout, values, status );
+    goto CLEANUP;
+
+  } else if ( doconv == HDSTYPE_LOGICAL || doconv == HDSTYPE_CHAR ) {
     /* We need to do the conversion because HDF5 does not seem
        to be able to convert numerical to string or string
        to numerical types internally. HDS has always been able
@@ -260,6 +291,12 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
      }
   }
 
+  /* The chunks of a compressed dataset may be decompressed on several
+     threads. Otherwise let HDF5 read the values. */
+  if (!tmpvalues && dat1ReadChunks( locator, h5type, values, status )) {
+    goto CLEANUP;
+  }
+
   /* Copy dimensions if appropriate */
   dat1ImportDims( "datGet", ndim, dims, h5dims, status );
 
@@ -271,8 +308,13 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
                    status, namestr )
            );
 
+  /* The file dataspace of a vectorized locator must have the rank of
+     the dataset */
+  file_dataspace_id = dat1FileSpace( locator, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
   CALLHDFQ( H5Dread( locator->dataset_id, h5type, mem_dataspace_id,
-                     locator->dataspace_id, H5P_DEFAULT,
+                     file_dataspace_id, H5P_DEFAULT,
                      (tmpvalues ? tmpvalues : values ) ) );
 
   if (tmpvalues) {
@@ -320,6 +362,9 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   if (tmpvalues) MEM_FREE(tmpvalues);
   if (h5type) H5Tclose(h5type);
   if (mem_dataspace_id > 0) H5Sclose(mem_dataspace_id);
+  if (file_dataspace_id > 0 && file_dataspace_id != locator->dataspace_id) {
+    H5Sclose(file_dataspace_id);
+  }
   return *status;
 
 }
@@ -31,16 +31,25 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
 *     - HDS uses 1-based indexing.
 *     - If the parent locator is associated with a group, the child locator
 *       will also be associated with that group.
+*     - Components are numbered in the order in which they were created,
+*       as in HDS version 4. Structures in files written by earlier
+*       versions of HDS-v5 do not record the creation order, and their
+*       components are numbered in alphabetical order.
 
 *  History:
 *     2014-09-12 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Use the creation order index if the structure has one.
+*     2026-10-16 (AGENT):
+*        Skip over the catalogue of the file.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -100,6 +109,8 @@ datIndex(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status ) {
   char namestr[2 * DAT__SZNAM + 1];
   char groupnam[DAT__SZNAM+1];
   ssize_t lenstr = 0;
+  H5_index_t idxtype;
+  hsize_t idx = 0;
   int ncomp = 0;
   *locator2 = NULL;
 
@@ -124,11 +135,16 @@ datIndex(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status ) {
     goto CLEANUP;
   }
 
-  /* HDF5 is 0-based - so adjust index */
+  /* HDF5 is 0-based - so adjust index. Components are numbered in
+     order of creation if the group indexes its creation order (as do
+     all groups created by this version of HDS), and in alphabetical
+     order otherwise. */
+  idxtype = dat1IndexType( locator1->group_id, locator1->handle, status );
+  idx = dat1CatalogueIndex( locator1->group_id, idxtype, index-1, status );
   CALLHDFE( ssize_t,
             lenstr,
-            H5Lget_name_by_idx( locator1->group_id, ".", H5_INDEX_NAME, H5_ITER_INC,
-                                index-1, namestr, sizeof(namestr), H5P_DEFAULT ),
+            H5Lget_name_by_idx( locator1->group_id, ".", idxtype, H5_ITER_INC,
+                                idx, namestr, sizeof(namestr), H5P_DEFAULT ),
             DAT__OBJNF,
             emsRepf("datIndex_1", "datIndex: Error obtaining name of component %d from group %s",
                     status, index, groupnam )
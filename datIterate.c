@@ -0,0 +1,193 @@
+/*
+*+
+*  Name:
+*     datIterate
+
+*  Purpose:
+*     Call a function for each component of a structure
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     int datIterate( const HDSLoc *locator, int (*func)( HDSLoc *comp, void *data, int *status ), void *data, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator for a scalar structure, or a cell of a structure array.
+*     func = int (*)( HDSLoc *comp, void *data, int *status ) (Given)
+*        The function to call for each component. It is passed a locator
+*        for the component, the supplied "data" pointer, and the inherited
+*        status. It should return zero to continue the iteration, and a
+*        non-zero value to end it early. The locator is annulled by
+*        datIterate when the function returns, and so should not be annulled
+*        by the function (use datClone to retain it).
+*     data = void * (Given)
+*        An arbitrary pointer that is passed on to "func".
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Calls the supplied function once for each component of a structure,
+*     in the same order as datIndex. This is equivalent to calling datIndex
+*     for each index from 1 to the value returned by datNcomp, but avoids
+*     looking up each component by position.
+
+*  Notes:
+*     - The components are visited in the order in which they were
+*     created. Structures in files written by earlier versions of HDS-v5
+*     do not record the creation order, and their components are visited
+*     in alphabetical order.
+*     - The iteration ends if "func" returns a non-zero value or sets the
+*     status to an error value.
+*     - Components should not be added to, or erased from, the structure by
+*     "func".
+*     - The function is not called if the locator is for a cell that has
+*     not yet been created in a file opened for read-only access.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* The information passed to the HDF5 callback function. */
+typedef struct IterateData {
+  const HDSLoc *locator;
+  int (*func)( HDSLoc *comp, void *data, int *status );
+  void *data;
+  int *status;
+} IterateData;
+
+static herr_t datIterateFunc( hid_t group_id, const char *name,
+                              const H5L_info_t *info, void *op_data );
+
+int
+datIterate( const HDSLoc *locator,
+            int (*func)( HDSLoc *comp, void *data, int *status ),
+            void *data, int *status ) {
+  IterateData itdata;
+  H5_index_t idxtype;
+  hsize_t idx = 0;
+  herr_t herr;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datIterate", 1, locator, 1, status );
+  if (*status != SAI__OK) return *status;
+
+  if (!dat1IsStructure( locator, status)) {
+    *status = DAT__OBJIN;
+    emsRep( "datIterate_1", "datIterate: Object is not a structure",
+            status );
+    return *status;
+  }
+
+  /* An untouched cell in a read-only file has no components */
+  if (locator->isemptycell) return *status;
+
+  itdata.locator = locator;
+  itdata.func = func;
+  itdata.data = data;
+  itdata.status = status;
+
+  idxtype = dat1IndexType( locator->group_id, locator->handle, status );
+  herr = H5Literate( locator->group_id, idxtype, H5_ITER_INC, &idx,
+                     datIterateFunc, &itdata );
+
+  /* A negative value is returned if the callback reported an error, or
+     if HDF5 failed. */
+  if (herr < 0 && *status == SAI__OK) {
+    *status = DAT__HDF5E;
+    dat1H5EtoEMS( status );
+    emsRep( "datIterate_2", "datIterate: Error iterating over the "
+            "components of a structure", status );
+  }
+
+  return *status;
+}
+
+/* Called by H5Literate for each link in the group. Returns zero to
+   continue the iteration, a positive value if the user's function asked
+   for it to end, and a negative value if an error occurred. */
+
+static herr_t datIterateFunc( hid_t group_id, const char *name,
+                              const H5L_info_t *info, void *op_data ) {
+  IterateData *itdata = op_data;
+  HDSLoc *comp = NULL;
+  int *status = itdata->status;
+  int result = 0;
+
+  if (*status != SAI__OK) return -1;
+
+  /* The catalogue of the file is not a component. */
+  if (!strcmp( name, DAT__CATNAME )) return 0;
+
+  datFind( itdata->locator, name, &comp, status );
+  if (*status == SAI__OK) result = itdata->func( comp, itdata->data, status );
+  datAnnul( &comp, status );
+
+  if (*status != SAI__OK) return -1;
+  return result ? 1 : 0;
+}
@@ -82,14 +82,21 @@
 *     current thread will change the type of lock (read-only or
 *     read-write) if the lock types differ, but will otherwise have no
 *     effect.
+*     - A recursive lock is stored with the supplied object and is
+*     inherited by all component objects, including any that are accessed
+*     for the first time later. The time taken does not depend on the
+*     number of components.
 
 *  Authors:
 *     DSB: David S Berry (DSB)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     10-JUL-2017 (DSB):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Document that recursive locks are inherited by components.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -29,7 +29,7 @@
 *        Object dimensions.
 *     pntr = void ** (Returned)
 *        Pointer to be updated with the mapped data.
-*        In WRITE mode the buffer will be filled with zeroes by the operating system.
+*        In WRITE mode the initial contents of the buffer are undefined.
 *        In READ or UPDATE mode the buffer will contain the contents of the dataset.
 *     status = int* (Given and Returned)
 *        Pointer to global status.
@@ -39,6 +39,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -54,6 +55,20 @@
 *       written to the HDF5 file on datUnmap() or datAnnul().
 *     - The resultant pointer can be used from both C and Fortran
 *       using CNF.
+*     - If the requested type matches the type on disk and the dataset
+*       is stored contiguously, the file itself is mapped (unless
+*       disabled using the MAP tuning parameter). This is done for all
+*       access modes. Files opened for writing are only mapped if HDF5
+*       does not keep a sieve buffer for them, which requires that the
+*       MAPUPDATE tuning parameter was set (or SIEVE was zero) when they
+*       were opened. In WRITE mode storage for a new dataset is then
+*       allocated before mapping so that the data go straight to disk.
+*     - Slices and vectorised locators can also be mapped directly if
+*       the selected elements form a single contiguous range within the
+*       dataset (e.g. a single plane of a cube).
+*     - The file is only mapped if the first mapped element starts on a
+*       multiple of the element size within the file. Otherwise the data
+*       are copied into suitably aligned memory.
 
 *  History:
 *     2014-08-29 (TIMJ):
@@ -63,6 +78,21 @@
 *        disabled as it is not quite working correctly.
 *     2014-11-20 (TIMJ):
 *        Do not use mmap if we can't mmap a file. Use cnfCalloc directly.
+*     2026-10-16 (AGENT):
+*        Allow true mmap in UPDATE and WRITE mode on files opened for
+*        update. Allocate storage for new datasets mapped for WRITE.
+*     2026-10-16 (AGENT):
+*        Map contiguous slices and vectorised sub-ranges directly from the file.
+*     2026-10-16 (AGENT):
+*        Store the mapping details in a structure that is only allocated
+*        for mapped locators.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Do not map the file if the data are not aligned for their type.
+*     2026-10-16 (AGENT):
+*        Files opened for writing are only mapped if they have no sieve
+*        buffer, as set up by MAPUPDATE.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -131,6 +161,13 @@
 static void *
 dat1Mmap( size_t nbytes, int prot, int flags, int fd, off_t offset, int *isreg, void **pntr, size_t * actbytes, int * status );
 
+static haddr_t
+dat1AllocContig( const HDSLoc *locator, hid_t h5type, int *status );
+
+static hdsbool_t
+dat1ContigSlice( const HDSLoc *locator, hsize_t *first, hsize_t *nelem,
+                 int *status );
+
 int
 datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
        const hdsdim dims[], void **pntr, int *status) {
@@ -147,6 +184,11 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   hdsbool_t try_mmap = HDS_FALSE;
   unsigned intent = 0;
   size_t actbytes = 0;
+  hsize_t first = 0;
+  hsize_t nelem = 0;
+  int fdmap = 0;
+  hdsbool_t uses_true_mmap = HDS_FALSE;
+  HdsLocMap *map = NULL;
 
   if (*status != SAI__OK) return *status;
 
@@ -211,6 +253,9 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
              status, mode_str);
       goto CLEANUP;
     }
+
+    /* The state of the primitive may change */
+    dat1CatalogueStale( locator, status );
   }
 
   /* Verify that the specified dimensions match the locator dimensions */
@@ -285,39 +330,91 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   }
 
 
-  /* Work out whether memory mapping is possible -- at the moment
-     I'm pretty sure the only safe use of mmap is when we are reading
-     the data and the file itself was opened readonly. I'm not sure what happens
-     if other components are removed or added -- will the offset change? Maybe we just try */
-  offset = H5Dget_offset( locator->dataset_id );
-  if (offset != HADDR_UNDEF) {
+  /* Work out whether memory mapping is possible. We can only map the
+     dataset directly if the requested type matches the type of the
+     low-level dataset and the data are stored contiguously in the file
+     (in which case HDF5 will give us an offset). */
+  {
     hid_t dataset_h5type = 0;
-    /* In theory we can do a memory map so now compare
-       the data types of the request and the low-level dataset. */
     CALLHDFE( hid_t, dataset_h5type,
              H5Dget_type( locator->dataset_id ),
              DAT__HDF5E,
              emsRep("datMap_type", "datType: Error obtaining data type of dataset", status)
              );
-    if (H5Tequal( dataset_h5type, h5type )) {
+    if (H5Tequal( dataset_h5type, h5type ) > 0) {
       try_mmap = HDS_TRUE;
     }
     H5Tclose(dataset_h5type);
   }
 
-  /* If this is a locator to a slice then for now we can't memory map. In theory
-     if we knew the slice was contiguous (e.g a vectorized slice, or a single
-     plane of a cube then we could mmap it anyhow. We do not want to have to
-     emulate HDF5 dataspaces here */
-  if (locator->isslice) try_mmap = 0;
-
-  /* There seem to be issues doing this on files opened for update/write.
-     For now only allow mmap for files opened read only */
-  if (intent != H5F_ACC_RDONLY) try_mmap = 0;
+  /* If this is a locator to a slice we can only memory map it if the
+     selected elements occupy a single contiguous range within the dataset
+     (e.g. a vectorized slice, or a single plane of a cube). In that case
+     we map just that range of the file. */
+  if (try_mmap && locator->isslice) {
+    try_mmap = ( !locator->isdiscont &&
+                 dat1ContigSlice( locator, &first, &nelem, status ) );
+  }
 
   /* If mmap has been disabled by tuning the environment we just force it off here. */
   if (!hds1GetUseMmap()) try_mmap = 0;
 
+  /* A file that is open for writing can only be mapped if HDF5 has been told
+     not to keep its own copy of raw data in the sieve buffer, which is done
+     if the MAPUPDATE tuning parameter was set when the file was opened
+     (see dat1FileAccessPlist). Otherwise HDF5 could later use an out of date copy
+     of data we have modified through the mapping. */
+  if (try_mmap && intent != H5F_ACC_RDONLY) {
+    hid_t fapl_id = -1;
+    size_t sieve_size = 0;
+    fapl_id = H5Fget_access_plist( locator->file_id );
+    if (fapl_id < 0 || H5Pget_sieve_buf_size( fapl_id, &sieve_size ) < 0 ||
+        sieve_size > 0) try_mmap = 0;
+    if (fapl_id > 0) H5Pclose( fapl_id );
+  }
+
+  offset = HADDR_UNDEF;
+  if (try_mmap) {
+    offset = H5Dget_offset( locator->dataset_id );
+
+    /* A freshly created dataset has no storage allocated until it is first
+       written. When mapping for WRITE we allocate it now so that the mapping
+       can go straight onto disk rather than through a copy. */
+    if (offset == HADDR_UNDEF && accmode == HDSMODE_WRITE &&
+        intent != H5F_ACC_RDONLY) {
+      offset = dat1AllocContig( locator, h5type, status );
+    }
+
+    /* Chunked or compact datasets have no single offset. */
+    if (offset == HADDR_UNDEF) try_mmap = 0;
+
+    /* For a slice, move the offset on to the first selected element. The
+       selection must cover exactly the number of bytes being mapped. */
+    if (try_mmap && locator->isslice) {
+      size_t typsize = H5Tget_size( h5type );
+      if (nelem * typsize == nbytes) {
+        offset += first * typsize;
+      } else {
+        try_mmap = 0;
+      }
+    }
+
+    /* The mapped pointer is used by the caller as an array of the requested
+       type, so the data must start on a suitable boundary. HDF5 does not
+       align the raw data of a dataset by default (its alignment is one
+       byte), so map a copy instead if the first element is misaligned.
+       Character data need no alignment. */
+    if (try_mmap && H5Tget_class( h5type ) != H5T_STRING &&
+        offset % H5Tget_size( h5type ) != 0) try_mmap = 0;
+  }
+
+  /* If the file is open for update HDF5 may be holding recently written
+     data in its own buffers. Make sure the file on disk is up to date
+     before we look at it directly. */
+  if (try_mmap && intent != H5F_ACC_RDONLY) {
+    CALLHDFQ( H5Dflush( locator->dataset_id ) );
+  }
+
 #if DEBUG_HDS
   {
     char *name_str;
@@ -390,10 +487,10 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
         if (*status == SAI__OK) {
           mapped = dat1Mmap( nbytes, prot, mflags, fd, offset, &isreg, &regpntr, &actbytes, status );
           if (*status == SAI__OK) {
-            /* Store the file descriptor in the locator to allow us to close */
+            /* Remember the file descriptor to allow us to close */
             if (mapped) {
-              if (opened_fd) locator->fdmap = fd;
-              locator->uses_true_mmap = 1;
+              if (opened_fd) fdmap = fd;
+              uses_true_mmap = 1;
             }
           } else {
             /* Not currently fatal -- we can try without the file */
@@ -435,8 +532,21 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   /* Cleanups that must happen always */
   if (h5type) H5Tclose(h5type);
 
+  /* Get a structure in which to store the details of the mapping. This
+     is only allocated for locators that are mapped. */
+  if (*status == SAI__OK) {
+    map = locator->map;
+    if (!map) map = MEM_CALLOC( 1, sizeof(*map) );
+    if (!map) {
+      *status = DAT__NOMEM;
+      emsRep("datMap_map", "datMap: Unable to allocate memory to describe "
+             "the mapping", status);
+    }
+  }
+
   /* cleanups that only happen if status is bad */
   if (*status != SAI__OK) {
+    if (fdmap > 0) close(fdmap);
     if (mapped) {
       if (isreg == 1) cnfUregp( regpntr );
       if ( munmap( mapped, actbytes ) != 0 ) {
@@ -453,21 +563,24 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   /* Update the locator to reflect the mapped status */
   if (*status == SAI__OK) {
     int i;
-    locator->pntr = mapped;
-    locator->regpntr = regpntr;
-    locator->bytesmapped = actbytes;
-    locator->accmode = accmode;
+    locator->map = map;
+    map->pntr = mapped;
+    map->regpntr = regpntr;
+    map->bytesmapped = actbytes;
+    map->accmode = accmode;
+    map->uses_true_mmap = uses_true_mmap;
+    map->fdmap = fdmap;
 
     /* In order to copy the data back into the underlying HDF5 dataset
        we need to store additional information about how this was mapped
        to allow us to either call datPut later on or at least a new
        dataspace. For now store the arguments so we can pass them straight
        to datPut */
-    locator->ndims = ndim;
+    map->ndims = ndim;
     for (i=0; i<ndim; i++) {
-      (locator->mapdims)[i] = dims[i];
+      (map->mapdims)[i] = dims[i];
     }
-    star_strlcpy( locator->maptype, normtypestr, sizeof(locator->maptype) );
+    star_strlcpy( map->maptype, normtypestr, sizeof(map->maptype) );
   }
 
   /* Note that the returned pointer is not necessarily the same as the
@@ -557,3 +670,149 @@ dat1Mmap( size_t nbytes, int prot, int flags, int fd, off_t offset, int *isreg,
  CLEANUP:
   return mapped;
 }
+
+/* Force HDF5 to allocate the storage for a contiguous dataset that has
+   not yet been written to, and return its offset in the file. HDF5 has
+   no public call to do this, but allocating a contiguous dataset is all
+   or nothing so writing the final element is enough. Writing the final
+   element also extends the file on disk so that the whole region can be
+   mapped. HADDR_UNDEF is returned if the dataset is not contiguous. */
+
+static haddr_t
+dat1AllocContig( const HDSLoc *locator, hid_t h5type, int *status ) {
+  haddr_t offset = HADDR_UNDEF;
+  hid_t dcpl_id = -1;
+  hid_t filespace_id = -1;
+  hid_t memspace_id = -1;
+  hsize_t h5dims[DAT__MXDIM];
+  hsize_t h5start[DAT__MXDIM];
+  hsize_t h5count[DAT__MXDIM];
+  size_t typsize = 0;
+  void *zero = NULL;
+  int rank = 0;
+  int i;
+
+  if (*status != SAI__OK) return offset;
+
+  CALLHDFE( hid_t, dcpl_id,
+            H5Dget_create_plist( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep("dat1AllocContig_1", "datMap: Error obtaining dataset "
+                   "creation properties", status)
+            );
+  if (H5Pget_layout( dcpl_id ) != H5D_CONTIGUOUS) goto CLEANUP;
+
+  CALLHDFE( hid_t, filespace_id,
+            H5Dget_space( locator->dataset_id ),
+            DAT__HDF5E,
+            emsRep("dat1AllocContig_2", "datMap: Error obtaining dataspace "
+                   "of dataset", status)
+            );
+  CALLHDFE( int, rank,
+            H5Sget_simple_extent_dims( filespace_id, h5dims, NULL ),
+            DAT__DIMIN,
+            emsRep("dat1AllocContig_3", "datMap: Error obtaining shape of object",
+                   status)
+            );
+
+  /* Select the last element (a scalar has only the one) */
+  if (rank > 0) {
+    for (i=0; i<rank; i++) {
+      if (h5dims[i] == 0) goto CLEANUP;
+      h5start[i] = h5dims[i] - 1;
+      h5count[i] = 1;
+    }
+    CALLHDFQ( H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, h5start,
+                                   NULL, h5count, NULL ) );
+  }
+  CALLHDFE( hid_t, memspace_id,
+            H5Screate( H5S_SCALAR ),
+            DAT__HDF5E,
+            emsRep("dat1AllocContig_4", "datMap: Error allocating data space",
+                   status)
+            );
+
+  /* Write a zero. Any data in the rest of the file region will read back
+     as zero as well, matching the behaviour of an anonymous mapping. */
+  CALLHDFE( size_t, typsize,
+            H5Tget_size( h5type ),
+            DAT__HDF5E,
+            emsRep("dat1AllocContig_5", "datMap: Error obtaining size of data type",
+                   status)
+            );
+  zero = MEM_CALLOC( 1, typsize );
+  if (!zero) {
+    *status = DAT__NOMEM;
+    emsRep("dat1AllocContig_6", "datMap: Unable to allocate memory", status);
+    goto CLEANUP;
+  }
+  CALLHDFQ( H5Dwrite( locator->dataset_id, h5type, memspace_id, filespace_id,
+                      H5P_DEFAULT, zero ) );
+  CALLHDFQ( H5Dflush( locator->dataset_id ) );
+
+  offset = H5Dget_offset( locator->dataset_id );
+
+ CLEANUP:
+  if (zero) MEM_FREE( zero );
+  if (memspace_id > 0) H5Sclose( memspace_id );
+  if (filespace_id > 0) H5Sclose( filespace_id );
+  if (dcpl_id > 0) H5Pclose( dcpl_id );
+  if (*status != SAI__OK) offset = HADDR_UNDEF;
+  return offset;
+}
+
+/* Determine whether the elements selected by a slice locator occupy a
+   single contiguous range of the dataset and if so return the zero-based
+   index of the first selected element (counting through the dataset in
+   storage order) and the number of selected elements. A vectorized
+   locator shares the storage order of the dataset so the same
+   calculation applies to it. */
+
+static hdsbool_t
+dat1ContigSlice( const HDSLoc *locator, hsize_t *first, hsize_t *nelem,
+                 int *status ) {
+  hsize_t h5dims[DAT__MXDIM];
+  hsize_t blockbuf[2*DAT__MXDIM];
+  hsize_t stride;
+  hsize_t count;
+  hssize_t nblocks;
+  hdsbool_t spanned;
+  int rank;
+  int i;
+
+  *first = 0;
+  *nelem = 0;
+  if (*status != SAI__OK) return HDS_FALSE;
+
+  rank = H5Sget_simple_extent_dims( locator->dataspace_id, h5dims, NULL );
+  if (rank <= 0) return HDS_FALSE;
+
+  /* A slice covering the whole array has no hyperslab selection */
+  if (H5Sget_select_type( locator->dataspace_id ) != H5S_SEL_HYPERSLABS) {
+    *nelem = 1;
+    for (i=0; i<rank; i++) *nelem *= h5dims[i];
+    return HDS_TRUE;
+  }
+
+  nblocks = H5Sget_select_hyper_nblocks( locator->dataspace_id );
+  if (nblocks != 1) return HDS_FALSE;
+  if (H5Sget_select_hyper_blocklist( locator->dataspace_id, 0, 1,
+                                     blockbuf ) < 0) return HDS_FALSE;
+
+  /* Work from the fastest varying (last) HDF5 axis towards the slowest.
+     Once an axis does not span the full extent of the dataset every slower
+     axis must be restricted to a single value. */
+  spanned = HDS_TRUE;
+  stride = 1;
+  *nelem = 1;
+  for (i=rank-1; i>=0; i--) {
+    count = blockbuf[i+rank] - blockbuf[i] + 1;
+    if (!spanned && count > 1) return HDS_FALSE;
+    if (count < h5dims[i]) spanned = HDS_FALSE;
+    *first += blockbuf[i] * stride;
+    *nelem *= count;
+    stride *= h5dims[i];
+  }
+
+  return HDS_TRUE;
+}
@@ -32,6 +32,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -51,6 +52,15 @@
 *     2014-11-04 (TIMJ):
 *        H5Lmove can only move items within a file so use datCopy/datErase
 *        if it seems that this is a move between files).
+*     2026-10-16 (AGENT):
+*        Move the Handle to the new parent and name, and invalidate cached
+*        metadata within the moved object.
+*     2026-10-16 (AGENT):
+*        Clear the list of names known not to exist in the parent.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Create empty source or target cells before moving.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -94,6 +104,8 @@
 *-
 */
 
+#include <string.h>
+
 #include "hdf5.h"
 
 #include "ems.h"
@@ -110,6 +122,8 @@ datMove( HDSLoc **locator1, const HDSLoc *locator2, const char *name_str,
          int *status ) {
 
   HDSLoc * parentloc = NULL;
+  Handle * handle = NULL;
+  char * newname = NULL;
   char sourcename[DAT__SZNAM+1];
   char cleanname[DAT__SZNAM+1];
 
@@ -120,8 +134,17 @@ datMove( HDSLoc **locator1, const HDSLoc *locator2, const char *name_str,
   dat1ValidateLocator( "datMove", 1, locator2, 0, status );
 
   dau1CheckName( name_str, 1, cleanname, sizeof(cleanname), status );
+
+  /* Moving an untouched cell, or moving an object into one, needs the
+     cell to exist */
+  dat1OpenCell( *locator1, HDS_TRUE, status );
+  dat1OpenCell( locator2, HDS_TRUE, status );
   if (*status != SAI__OK) return *status;
 
+  /* Invalidate any catalogue in either file */
+  dat1CatalogueStale( *locator1, status );
+  dat1CatalogueStale( locator2, status );
+
   /* Have to give the source name as "." doesn't seem to be allowed.
      so get the name and the parent locator */
   datParen( *locator1, &parentloc, status );
@@ -135,6 +158,22 @@ datMove( HDSLoc **locator1, const HDSLoc *locator2, const char *name_str,
   if ((*locator1)->file_id == locator2->file_id) {
     CALLHDFQ(H5Lmove( parentloc->group_id, sourcename,
                       locator2->group_id, cleanname, H5P_DEFAULT, H5P_DEFAULT));
+
+    /* Move the object's Handle to the new parent and name, so that
+       other locators for the object find it. Any cached names within
+       the moved object are now wrong. */
+    handle = (*locator1)->handle;
+    newname = MEM_MALLOC( strlen(cleanname) + 1 );
+    if (newname) {
+      strcpy( newname, cleanname );
+      dat1EraseHandle( locator2->handle, cleanname, status );
+      dat1UnlinkHandle( handle );
+      MEM_FREE( handle->name );
+      handle->name = newname;
+      dat1LinkHandle( locator2->handle, handle, status );
+    }
+    dat1MetaInvalidate( handle, HDS__META_ALL, HDS_TRUE );
+    dat1MetaClearAbsent( locator2->handle );
   } else {
     datCopy( *locator1, locator2, name_str, status );
     datErase( parentloc, sourcename, status );
@@ -30,6 +30,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -37,6 +38,12 @@
 *        Initial version
 *     2014-11-22 (TIMJ):
 *        Support use of HDF5 root group as HDS root
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
+*     2026-10-16 (AGENT):
+*        Cache the name in the Handle.
+*     2026-10-16 (AGENT):
+*        Do not open the HDF5 object unless it is needed.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -113,7 +120,14 @@ datName(const HDSLoc *locator,
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
-  dat1ValidateLocator( "datName", 1, locator, 1, status );
+  dat1ValidateQuery( "datName", locator, status );
+  if (*status != SAI__OK) return *status;
+
+  /* Use the name cached in the Handle if available */
+  if (dat1MetaCached( locator->handle, HDS__META_NAME )) {
+    star_strlcpy( name_str, locator->handle->metaname, DAT__SZNAM+1 );
+    return *status;
+  }
 
   objid = dat1RetrieveIdentifier( locator, status );
   if (*status != SAI__OK) return *status;
@@ -152,6 +166,19 @@ datName(const HDSLoc *locator,
     } else {
       one_strlcpy( name_str, &(cleanstr[startpos]), DAT__SZNAM+1, status );
     }
+
+    /* An empty cell refers to the array group so the subscripts
+       are taken from the cell name in the handle */
+    if (locator->isemptycell) {
+      one_strlcat( name_str, strstr( locator->handle->name, "(" ),
+                   DAT__SZNAM+1, status );
+    }
+  }
+
+  /* Cache the name in the Handle */
+  if (*status == SAI__OK && locator->handle) {
+    star_strlcpy( locator->handle->metaname, name_str, DAT__SZNAM+1 );
+    dat1MetaStore( locator->handle, HDS__META_NAME );
   }
 
   if (tempstr != cleanstr) MEM_FREE(cleanstr);
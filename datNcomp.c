@@ -28,6 +28,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -37,6 +38,10 @@
 *  History:
 *     2014-09-03 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
+*     2026-10-16 (AGENT):
+*        Do not count the catalogue of the file as a component.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -106,9 +111,14 @@ datNcomp( const HDSLoc *locator, int *ncomp, int *status) {
     return *status;
   }
 
+  /* An untouched cell in a read-only file has no components */
+  if (locator->isemptycell) return *status;
+
   CALLHDFQ( H5Gget_info( locator->group_id, &group_info ) );
 
-  *ncomp = group_info.nlinks;
+  /* The root group may also hold the catalogue of the file. */
+  *ncomp = group_info.nlinks - dat1CatalogueHidden( locator->group_id,
+                                                    status );
 
  CLEANUP:
   return *status;
@@ -115,7 +115,8 @@ datNew( const HDSLoc    *locator,
   /* Validate input locator. */
   dat1ValidateLocator( "datNew", 1, locator, 0, status );
 
-  newloc = dat1New( locator, 0, name_str, type_str, ndim, dims, status );
+  newloc = dat1New( locator, 0, name_str, type_str, ndim, dims, NULL,
+                    status );
 
   /* Free the locator as datNew does not expect you to use the
      component you have just created */
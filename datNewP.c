@@ -0,0 +1,175 @@
+/*
+*+
+*  Name:
+*     datNewP
+
+*  Purpose:
+*     Create a new component in a structure with given storage properties
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     int datNewP( const HDSLoc *locator, const char *name_str,
+*                  const char *type_str, int ndim, const hdsdim dims[],
+*                  const HDSCreateProps *props, int * status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator to structure that will receive the new component.
+*     name = const char * (Given)
+*        Name of the object in the container.
+*     type = const char * (Given)
+*        Type of object. If type matches one of the HDS primitive type names
+*        a primitive of that type is created, otherwise the object is assumed
+*        to be a structure.
+*     ndim = int (Given)
+*        Number of dimensions. Use 0 for a scalar.
+*     dims = const hdsdim [] (Given)
+*        Dimensionality of the object. Should be dimensioned with ndim. The
+*        array is not accessed if ndim == 0.
+*     props = const HDSCreateProps * (Given)
+*        The storage properties for a new primitive. Should be initialised
+*        using datInitProps before setting the required fields. May be NULL,
+*        in which case this routine is equivalent to datNew.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     int = inherited status on exit.
+
+*  Description:
+*     Creates a new component in an existing structure in the same way as
+*     datNew, but allows the way in which a new primitive is stored in the
+*     file to be controlled. The fields of the HDSCreateProps structure
+*     are:
+*
+*     - chunk: Pointer to an array of "ndim" chunk dimensions. The data
+*       are stored in chunks of this shape, each of which is compressed
+*       separately. NULL means use chunks of about CHUNKSIZE bytes (see
+*       hdsTune) if any filter is used, and no chunks otherwise.
+*     - deflate: The deflate (gzip) compression level, 0 (none) to 9.
+*     - shuffle: Non-zero if the bytes of each value should be shuffled
+*       before compression, which usually improves the compression of
+*       numerical data.
+*     - fletcher32: Non-zero if a checksum should be stored with each
+*       chunk, and checked when the chunk is read.
+*     - scaleoffset: Zero for none. Otherwise, integer values are stored
+*       using the minimum number of bits needed to hold the range of values
+*       in each chunk (this is lossless), and floating point values are
+*       rounded to this number of decimal places before being stored in the
+*       same way (this is lossy). Bad values are preserved. Ignored for
+*       _LOGICAL and _CHAR data.
+*
+*     Any field holding HDS_PROP_DEFAULT takes its value from the
+*     corresponding tuning parameter (DEFLATE, SHUFFLE, FLETCHER32 or
+*     SCALEOFFSET).
+
+*  Notes:
+*     - The properties are ignored when creating a structure, a scalar,
+*     or a primitive small enough to be stored in compact form (see the
+*     COMPACT tuning parameter).
+*     - A chunked primitive can not be memory mapped directly from the
+*     file, so datMap will always copy the data. datGet, datPut and datMap
+*     are otherwise unaffected by the storage properties.
+*     - The storage properties are retained if the primitive is resized
+*     by datAlter, reset by datReset, or copied by datCopy.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+datNewP( const HDSLoc *locator, const char *name_str, const char *type_str,
+         int ndim, const hdsdim dims[], const HDSCreateProps *props,
+         int *status ) {
+
+  HDSLoc * newloc;
+  int i;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datNewP", 1, locator, 0, status );
+
+  /* Check any chunk dimensions */
+  if (*status == SAI__OK && props && props->chunk) {
+    for (i = 0; i < ndim; i++) {
+      if (props->chunk[i] < 1) {
+        *status = DAT__DIMIN;
+        emsRepf( "datNewP_1", "datNewP: Chunk dimension %d (%" HDS_DIM_FORMAT
+                 ") is invalid for component '%s'", status, i + 1,
+                 props->chunk[i], name_str );
+        return *status;
+      }
+    }
+  }
+
+  newloc = dat1New( locator, 0, name_str, type_str, ndim, dims, props,
+                    status );
+
+  /* Free the locator as datNewP does not expect you to use the
+     component you have just created */
+  datAnnul( &newloc, status );
+
+  return *status;
+}
@@ -29,6 +29,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -57,6 +58,8 @@
 *        Initial version
 *     2014-11-14 (TIMJ):
 *        Child locators must inherit group
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -126,8 +129,18 @@ datParen( const HDSLoc *locator1, HDSLoc **locator2, int *status ) {
   /* Need to get the relevant identfier */
   objid = dat1RetrieveIdentifier( locator1, status );
 
-  /* Get the parent group. Do not want the root group */
-  parent_id = dat1GetParentID( objid, 1, status );
+  /* Get the parent group. Do not want the root group. An empty cell
+     already refers to its parent array. */
+  if (locator1->isemptycell) {
+    CALLHDFE( hid_t, parent_id,
+              H5Gopen2( objid, ".", H5P_DEFAULT ),
+              DAT__HDF5E,
+              emsRep("datParen_1", "datParen: Error opening parent of empty cell",
+                     status )
+              );
+  } else {
+    parent_id = dat1GetParentID( objid, 1, status );
+  }
 
   thisloc = dat1AllocLoc( status );
 
@@ -138,9 +151,10 @@ datParen( const HDSLoc *locator1, HDSLoc **locator2, int *status ) {
     thisloc->file_id = locator1->file_id;
     thisloc->hdsFile = locator1->hdsFile;
     hds1RegLocator( thisloc, status );
-    if ( (locator1->grpname)[0] != '\0') hdsLink(thisloc, locator1->grpname, status);
+    if (locator1->grpname) hdsLink(thisloc, locator1->grpname, status);
   }
 
+ CLEANUP:
   if (*status != SAI__OK) {
     datAnnul( &thisloc, status );
   } else {
@@ -36,12 +36,17 @@
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
 *     - Character strings are given as a single character buffer and not as char **.
 *       The type string indicates how many characters are expected per element
 *       and the buffer is assumed to be space padded.
+*     - Conversions between numeric types are done by dat1CvtNumeric.
+*       Bad values are converted to the bad value of the object's type.
+*       Values that cannot be represented in the object's type are
+*       stored as bad values and cause DAT__CONER to be returned.
 
 *  History:
 *     2014-08-27 (TIMJ):
@@ -53,6 +58,22 @@
 *     2017-05-24 (DSB):
 *        Report an error if the supplied dimensions are different to the
 *        shape of the supplied object.
+*     2026-10-16 (AGENT):
+*        Use dat1TransferNumeric for conversions between numeric types
+*        instead of the HDF5 type conversion.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Remove any marker indicating that a compact dataset is undefined.
+*     2026-10-16 (AGENT):
+*        Use dat1FileSpace so that vectorized locators work with chunked
+*        datasets.
+*     2026-10-16 (AGENT):
+*        Compress the chunks of a filtered dataset on several threads (see
+*        the NTHREADS tuning parameter).
+*     2026-10-16 (AGENT):
+*        Only mark a primitive as defined once the values have been
+*        written.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -118,6 +139,7 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
   hdstype_t intype = HDSTYPE_NONE;
   hdstype_t outtype = HDSTYPE_NONE;
   hid_t h5type = 0;
+  hid_t file_dataspace_id = 0;
   hid_t mem_dataspace_id = 0;
   hsize_t h5dims[DAT__MXDIM];
   int actdim;
@@ -130,6 +152,9 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
   /* Validate input locator. */
   dat1ValidateLocator( "datPut", 1, locator, 0, status );
 
+  /* Writing defines the primitive, so any catalogue becomes stale */
+  dat1CatalogueStale( locator, status );
+
   namestr[ 0 ] = 0;
   datName(locator, namestr, status);
 
@@ -194,9 +219,38 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
   } else if ((outtype == HDSTYPE_LOGICAL && intype != HDSTYPE_LOGICAL) ||
              (outtype != HDSTYPE_LOGICAL && intype == HDSTYPE_LOGICAL)) {
     doconv = HDSTYPE_LOGICAL;
+  } else if (outtype != intype && HDSTYPE_ISNUMERIC(outtype) &&
+             HDSTYPE_ISNUMERIC(intype)) {
+    doconv = intype;
   }
 
-  if ( doconv == HDSTYPE_LOGICAL || doconv == HDSTYPE_CHAR ) {
+  if ( HDSTYPE_ISNUMERIC(doconv) ) {
+    /* Do numeric conversions ourselves rather than letting HDF5 do them.
+       This is faster, and it means that bad values and values that
+       cannot be represented in the output type are handled the same
+       way as in HDS v4. */
+    size_t nbin = 0;
+    CALLHDFE( size_t, nbin,
+            H5Tget_size( h5type ),
+            DAT__HDF5E,
+            emsRep("datPut_size", "datPut: Error obtaining size of input type",
+                   status)
+            );
+    dat1TransferNumeric( locator, HDS_TRUE, intype, nbin, (void *) values,
+                         status );
+
+    /* Values that can not be converted are written as bad values, so the
+       primitive is defined even if DAT__CONER is returned. */
+    if (*status == DAT__CONER) {
+      emsBegin( status );
+      dat1MarkDefined( locator->dataset_id, locator->handle, status );
+      emsEnd( status );
+    } else {
+      dat1MarkDefined( locator->dataset_id, locator->handle, status );
+    }
+    goto CLEANUP;
+
+  } else if ( doconv == HDSTYPE_LOGICAL || doconv == HDSTYPE_CHAR ) {
     /* We need to do the conversion because HDF5 does not seem
        to be able to convert numerical to string or string
        to numerical types internally. HDS has always been able
@@ -245,6 +299,14 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
     h5type = tmptype;
   }
 
+  /* The chunks of a compressed dataset may be compressed on several
+     threads. Otherwise let HDF5 write the values. */
+  if (dat1WriteChunks( locator, h5type, (tmpvalues ? tmpvalues : values),
+                       status )) {
+    dat1MarkDefined( locator->dataset_id, locator->handle, status );
+    goto CLEANUP;
+  }
+
   /* Copy dimensions if appropriate */
   dat1ImportDims( "datPut", ndim, dims, h5dims, status );
 
@@ -255,14 +317,26 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
            emsRep("datPut_2", "Error allocating in-memory dataspace", status )
            );
 
+  /* The file dataspace of a vectorized locator must have the rank of
+     the dataset */
+  file_dataspace_id = dat1FileSpace( locator, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
   CALLHDFQ( H5Dwrite( locator->dataset_id, h5type, mem_dataspace_id,
-                      locator->dataspace_id, H5P_DEFAULT,
+                      file_dataspace_id, H5P_DEFAULT,
                       (tmpvalues ? tmpvalues : values )
                       ) );
 
+  /* A compact dataset is marked as undefined until it is written (see
+     dat1Undefined.c) */
+  dat1MarkDefined( locator->dataset_id, locator->handle, status );
+
  CLEANUP:
   if (h5type) H5Tclose(h5type);
   if (mem_dataspace_id > 0) H5Sclose(mem_dataspace_id);
+  if (file_dataspace_id > 0 && file_dataspace_id != locator->dataspace_id) {
+    H5Sclose(file_dataspace_id);
+  }
   if (tmpvalues) MEM_FREE(tmpvalues);
   if (*status != SAI__OK) {
     emsRepf("datPut_3", "datPut: Error writing data of type '%s' into primitive %s",
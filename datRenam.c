@@ -28,6 +28,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -38,6 +39,9 @@
 *  History:
 *     2014-09-04 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Open the HDF5 object for the renamed component before taking its
+*        identifiers.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -129,6 +133,7 @@ datRenam( HDSLoc *locator, const char *name_str, int  *status) {
 
   /* but now we have to find the thing we just moved */
   datFind( parentloc, name_str, &movedloc, status );
+  dat1OpenDeferred( movedloc, status );
 
   /* and we now do the fiddly bit where we have to
      replace the bits in the callers locator */
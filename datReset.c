@@ -28,6 +28,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -39,6 +40,13 @@
 *     2014-11-21 (TIMJ):
 *        Stop using an attribute and switch to deleting
 *        the primitive and recreating it empty.
+*     2026-10-16 (AGENT):
+*        Invalidate any catalogue in the container file.
+*     2026-10-16 (AGENT):
+*        Recreate the dataset with the same chunking and filters as the
+*        original.
+*     2026-10-16 (AGENT):
+*        Forget any cached defined state.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -97,6 +105,8 @@ int
 datReset(HDSLoc *locator, int *status) {
   unsigned intent = 0;
   char name_str[DAT__SZNAM+1];
+  HDSCreateProps props;
+  hdsdim chunk[DAT__MXDIM];
   hid_t h5type = -1;
   hid_t new_dataset_id = -1;
   hid_t new_dataspace_id = -1;
@@ -117,6 +127,9 @@ datReset(HDSLoc *locator, int *status) {
     return *status;
   }
 
+  /* Resetting changes the state recorded in any catalogue */
+  dat1CatalogueStale( locator, status );
+
     /* How did we open this file? */
   CALLHDFQ( H5Fget_intent( locator->file_id, &intent ));
   /* Must check whether the file was opened for write */
@@ -147,13 +160,19 @@ datReset(HDSLoc *locator, int *status) {
            emsRep("dat1Type_1", "datType: Error obtaining data type of dataset", status)
            );
 
+  /* The new dataset is stored in the same way as the old one */
+  dat1DatasetProps( locator->dataset_id, &props, chunk, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
   /* Delete the current dataset */
   CALLHDFQ( H5Ldelete( parent_id, name_str, H5P_DEFAULT ));
 
+  /* The new dataset has no value */
+  dat1MetaInvalidate( locator->handle, HDS__META_DEFINED, HDS_FALSE );
+
   /* Create the brand new primitive */
-  /* Create the brand new primitive */
-  dat1NewPrim( parent_id, rank, h5dims, h5type, name_str, &new_dataset_id,
-               &new_dataspace_id, status );
+  dat1NewPrim( parent_id, rank, h5dims, h5type, &props, name_str,
+               &new_dataset_id, &new_dataspace_id, status );
 
   if (*status == SAI__OK) {
     H5Sclose(locator->dataspace_id);
@@ -33,11 +33,14 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-08-29 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Do not open the HDF5 object unless it is needed.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -105,7 +108,7 @@ datShape( const HDSLoc *locator, int maxdim, hdsdim dims[],
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
-  dat1ValidateLocator( "datShape", 1, locator, 1, status );
+  dat1ValidateQuery( "datShape", locator, status );
 
   /* Single cells should always be considered scalar. */
   if( locator->iscell ){
@@ -29,11 +29,14 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-08-26 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Do not open the HDF5 object unless it is needed.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -102,7 +105,7 @@ datSize(const HDSLoc *locator,
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
-  dat1ValidateLocator( "datSize", 1, locator, 1, status );
+  dat1ValidateQuery( "datSize", locator, status );
 
   /* Do not duplicate code from datShape -- just call it and we know then
      that it works for arrays of structures and for slices */
@@ -37,6 +37,7 @@
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     DSB: David S Berry (EAO)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -61,6 +62,9 @@
 *        Remove explicit handling of vectorised arrays. Today's new version
 *        of datVec means that vectorised arrays can be treated like any
 *        other array.
+*     2026-10-16 (AGENT):
+*        Fix the test for a discontiguous slice, which compared zero-based
+*        lower bounds with 1.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -248,11 +252,13 @@ datSlice(const HDSLoc *locator1, int ndim, const hdsdim lower[],
      selection in memory. This is the case if the selection on any of
      the axes except for the last HDS axis (i.e. the first HDF5 axis)
      does not span the whole array. If the locator is not currently
-     discontiguous then we know that h5dims must be the dimensions of
-     the full array (at least on all axes except the first HDF5 axis). */
+     discontiguous then we know that loc1dims must be the dimensions of
+     the full array (at least on all axes except the last HDS axis). Use
+     the 1-based HDS bounds since h5lower may have been made zero-based
+     above. */
   if( !sliceloc->isdiscont ) {
-    for (i=1; i<ndim; i++) {
-      if( h5lower[i] > 1 || h5upper[i] < h5dims[i] ) {
+    for (i=0; i<ndim-1; i++) {
+      if( loc2lower[i] > 1 || loc2upper[i] < loc1dims[i] ) {
          sliceloc->isdiscont = 1;
       }
     }
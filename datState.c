@@ -28,6 +28,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
@@ -37,6 +38,10 @@
 *        If the attribute is missing, query the dataset directly.
 *     2014-11-21 (TIMJ):
 *        Remove attribute. Just query dataset.
+*     2026-10-16 (AGENT):
+*        Use dat1IsDefined so that compact datasets are handled.
+*     2026-10-16 (AGENT):
+*        Let dat1IsDefined cache the state in the Handle.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -93,7 +98,6 @@
 
 int
 datState( const HDSLoc *locator, hdsbool_t *state, int *status) {
-  H5D_space_status_t dstatus = 0;
   *state = HDS_FALSE;
 
   if (*status != SAI__OK) return *status;
@@ -108,12 +112,8 @@ datState( const HDSLoc *locator, hdsbool_t *state, int *status) {
     return *status;
   }
 
-  /* Query the dataset to determine whether it has been allocated yet */
-  CALLHDFQ( H5Dget_space_status( locator->dataset_id, &dstatus) );
-  *state = ( (dstatus == H5D_SPACE_STATUS_ALLOCATED ||
-              dstatus == H5D_SPACE_STATUS_PART_ALLOCATED)
-             ? HDS_TRUE : HDS_FALSE );
+  /* Query the dataset to determine whether it has been given a value */
+  *state = dat1IsDefined( locator->dataset_id, locator->handle, status );
 
- CLEANUP:
   return *status;
 }
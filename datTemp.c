@@ -187,7 +187,8 @@ datTemp( const char *type_str, int ndim, const hdsdim dims[],
   } while (there);
 
   /* Now create the temporary object of the correct type and size */
-  *locator = dat1New( tmploc, 0, tempname, type_str, ndim, dims, status );
+  *locator = dat1New( tmploc, 0, tempname, type_str, ndim, dims, NULL,
+                      status );
 
   /* Unlock the container file so that other threads can create temporary
      objects in it. */
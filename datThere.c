@@ -31,11 +31,16 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-08-28 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
+*     2026-10-16 (AGENT):
+*        Remember names that do not exist.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -115,7 +120,13 @@ datThere( const HDSLoc * locator, const char * name, hdsbool_t *there,
   dau1CheckName( name, 1, cleanname, sizeof(cleanname), status );
   if (*status != SAI__OK) return *status;
 
+  /* An untouched cell in a read-only file has no components, and names
+     already known not to exist need not be looked up again. */
+  if (locator->isemptycell) return *status;
+  if (dat1MetaIsAbsent( locator->handle, cleanname )) return *status;
+
   exists = H5Lexists( locator->group_id, cleanname, H5P_DEFAULT);
+  if (exists == 0) dat1MetaSetAbsent( locator->handle, cleanname );
 
   if (exists < 0) {
     *status = DAT__HDF5E;
@@ -28,11 +28,18 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-08-27 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Cache the type string in the Handle.
+*     2026-10-16 (AGENT):
+*        Do not open the HDF5 object unless it is needed.
+*     2026-10-16 (AGENT):
+*        Use dat1TypeString to get the type string for primitives.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -81,6 +88,7 @@
 #include "hdf5.h"
 
 #include "star/one.h"
+#include "star/util.h"
 #include "ems.h"
 #include "sae_par.h"
 
@@ -99,61 +107,47 @@ datType( const HDSLoc *locator, char type_str[DAT__SZTYP+1], int * status ) {
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
-  dat1ValidateLocator( "datType", 1, locator, 1, status );
+  dat1ValidateQuery( "datType", locator, status );
+  if (*status != SAI__OK) return *status;
+
+  /* Use the type string cached in the Handle if available */
+  if (dat1MetaCached( locator->handle, HDS__META_TYPESTR )) {
+    star_strlcpy( type_str, locator->handle->metatypestr, DAT__SZTYP+1 );
+    return *status;
+  }
 
   hdstyp = dat1Type( locator, status );
   if (*status != SAI__OK) return *status;
 
   switch (hdstyp) {
-  case HDSTYPE_INTEGER:
-    one_strlcpy( type_str, "_INTEGER", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_REAL:
-    one_strlcpy( type_str, "_REAL", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_DOUBLE:
-    one_strlcpy( type_str, "_DOUBLE", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_BYTE:
-    one_strlcpy( type_str, "_BYTE", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_UBYTE:
-    one_strlcpy( type_str, "_UBYTE", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_WORD:
-    one_strlcpy( type_str, "_WORD", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_UWORD:
-    one_strlcpy( type_str, "_UWORD", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_LOGICAL:
-    one_strlcpy( type_str, "_LOGICAL", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_INT64:
-    one_strlcpy( type_str, "_INT64", DAT__SZTYP+1, status);
-    break;
   case HDSTYPE_CHAR:
     /* Get the type from the dataset and request its size */
     {
       size_t dsize = 0;
+      dat1OpenDeferred( locator, status );
       CALLHDFE( hid_t, h5type,
                H5Dget_type( locator->dataset_id ),
                DAT__HDF5E,
                emsRep("datType_1", "datType: Error obtaining data type of dataset", status)
                );
       dsize = H5Tget_size( h5type );
-      one_snprintf( type_str, DAT__SZTYP+1, "_CHAR*%zu", status, dsize );
+      dat1TypeString( hdstyp, dsize, type_str, status );
     }
     break;
   case HDSTYPE_STRUCTURE:
     /* Read the type attribute */
+    dat1OpenDeferred( locator, status );
     dat1GetAttrString( locator->group_id, HDS__ATTR_STRUCT_TYPE, HDS_TRUE,
                        "HDF5NATIVEGROUP", type_str, DAT__SZTYP+1, status );
     break;
   default:
-    *status = DAT__TYPIN;
-    emsRepf("datType_inv","datType: Unknown type associated with dataset/group (%d)",
-            status, hdstyp);
+    dat1TypeString( hdstyp, 0, type_str, status );
+  }
+
+  /* Cache the type string in the Handle */
+  if (*status == SAI__OK && locator->handle) {
+    star_strlcpy( locator->handle->metatypestr, type_str, DAT__SZTYP+1 );
+    dat1MetaStore( locator->handle, HDS__META_TYPESTR );
   }
 
  CLEANUP:
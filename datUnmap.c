@@ -27,6 +27,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -44,6 +45,11 @@
 *        the file and do not use datPut.
 *     2014-11-20 (TIMJ):
 *        Use cnfFree if the pointer was not actually mapped.
+*     2026-10-16 (AGENT):
+*        Support data mapped directly from the file in WRITE and UPDATE
+*        mode. These are synchronised with msync rather than copied.
+*     2026-10-16 (AGENT):
+*        Free the structure holding the mapping details.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -106,19 +112,21 @@ int
 datUnmap( HDSLoc * locator, int * status ) {
   /* Try to unmap even if status is bad */
   int lstat = SAI__OK;
+  HdsLocMap *map;
 
   /* Just ignore a null pointer */
   if (!locator) return *status;
 
   /* if there is no mapped pointer in this locator do nothing */
-  if (!locator->regpntr) return *status;
+  map = locator->map;
+  if (!map || !map->regpntr) return *status;
 
   /* Validate input locator. */
-  dat1ValidateLocator( "datUnmap", 1, locator, (locator->accmode & HDSMODE_READ), status );
+  dat1ValidateLocator( "datUnmap", 1, locator, (map->accmode & HDSMODE_READ), status );
   if( *status == SAI__OK) {
 
   /* We only copy back explicitly if we did not do a native mmap on the file */
-     if (!locator->uses_true_mmap ) {
+     if (!map->uses_true_mmap ) {
 
        /* If these data were mapped for WRITE or UPDATE we have to copy
           back the data. Use datPut() for that. Mark the error stack
@@ -127,10 +135,10 @@ datUnmap( HDSLoc * locator, int * status ) {
 
        emsMark();
 
-       if (locator->accmode == HDSMODE_WRITE ||
-           locator->accmode == HDSMODE_UPDATE) {
-         datPut( locator, locator->maptype, locator->ndims, locator->mapdims,
-                 locator->regpntr, &lstat);
+       if (map->accmode == HDSMODE_WRITE ||
+           map->accmode == HDSMODE_UPDATE) {
+         datPut( locator, map->maptype, map->ndims, map->mapdims,
+                 map->regpntr, &lstat);
        }
 
        /* if we have bad status from this just ignore it. Release the error stack */
@@ -140,42 +148,44 @@ datUnmap( HDSLoc * locator, int * status ) {
 
      /* Need to free the memory and, if needed, unregister the pointer.
         If "pntr" is defined then this was mmapped. */
-     if (locator->pntr) {
-       cnfUregp( locator->regpntr );
+     if (map->pntr) {
+       cnfUregp( map->regpntr );
+
+       /* If the file itself was mapped for WRITE or UPDATE the data are
+          already in place, so we just schedule the modified pages to be
+          written to disk rather than copying them back. HDF5 reads the file
+          through the same page cache so it will see the new values. */
+       if (map->uses_true_mmap &&
+           (map->accmode == HDSMODE_WRITE ||
+            map->accmode == HDSMODE_UPDATE)) {
+         if ( msync( map->pntr, map->bytesmapped, MS_ASYNC ) != 0 ) {
+           if (*status == SAI__OK) {
+             *status = DAT__FILWR;
+             emsSyser( "MESSAGE", errno );
+             emsRep("datUnMap_5", "datUnmap: Error synchronising mapped "
+                    "data with file: ^MESSAGE", status);
+           }
+         }
+       }
 
-       if ( munmap( locator->pntr, locator->bytesmapped ) != 0 ) {
+       if ( munmap( map->pntr, map->bytesmapped ) != 0 ) {
          if (*status == SAI__OK) {
            *status = DAT__FILMP;
            emsSyser( "MESSAGE", errno );
            emsRep("datUnMap_4", "datUnmap: Error unmapping mapped memory: ^MESSAGE", status);
          }
        }
-     } else if (locator->regpntr) {
+     } else if (map->regpntr) {
        /* Allocated memory that needs to be freed by CNF but was not mmapped */
-       cnfFree( locator->regpntr );
-     }
-
-     /* If these data were mmap-ed directly on disk in WRITE mode then
-        we cause an error as this has not been tested. */
-     if (locator->uses_true_mmap) {
-       if (locator->accmode == HDSMODE_WRITE) {
-         if (*status == SAI__OK) {
-           *status = DAT__FATAL;
-           emsRep("datUnmap_no", "datUnmap: Unexpectedly mapped an array in WRITE mode",
-                  status);
-         }
-       }
+       cnfFree( map->regpntr );
      }
 
-     locator->pntr = NULL;
-     locator->regpntr = NULL;
-     locator->bytesmapped = 0;
-
      /* Close the file if we opened it -- ignore the return value */
-     if (locator->fdmap > 0) {
-       close(locator->fdmap);
-       locator->fdmap = 0;
-     }
+     if (map->fdmap > 0) close(map->fdmap);
+
+     /* Free the structure describing the mapping */
+     MEM_FREE( map );
+     locator->map = NULL;
   }
 
   return *status;
@@ -31,11 +31,17 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  History:
 *     2014-09-16 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        A locator whose HDF5 object has not yet been opened is valid.
+*     2026-10-16 (AGENT):
+*        Read the identifier of the parent of an unopened object
+*        atomically.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -99,7 +105,8 @@ datValid(const HDSLoc *locator, hdsbool_t *valid, int *status) {
    emsBegin( status );
 
 /* Check the validity of the locator */
-   if (locator->group_id > 0 || locator->dataset_id > 0 ) {
+   if (__atomic_load_n( &(locator->defer_id), __ATOMIC_ACQUIRE ) > 0 ||
+       locator->group_id > 0 || locator->dataset_id > 0 ) {
       if( HANDLE_VALID(locator->handle) ) *valid = 1;
    }
 
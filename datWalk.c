@@ -0,0 +1,192 @@
+/*
+*+
+*  Name:
+*     datWalk
+
+*  Purpose:
+*     Visit every object in an HDS hierarchy
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datWalk( const HDSLoc *locator,
+*              int (*func)( const HDSWalkNode *node, void *data, int *status ),
+*              void *data, int flags, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator for the object at the top of the hierarchy.
+*     func = int (*)( const HDSWalkNode *node, void *data, int *status ) (Given)
+*        The function to call for each object. It is passed a description
+*        of the object (see below), the supplied "data" pointer, and the
+*        inherited status. It should return zero to continue the walk, and
+*        a non-zero value to end it early.
+*     data = void * (Given)
+*        An arbitrary pointer that is passed on to "func".
+*     flags = int (Given)
+*        A combination of the following flags, or zero:
+*        - HDS_WALK_STATE: Determine the state of each primitive (see
+*        datState). Otherwise, the "state" component of each node is
+*        always false.
+*        - HDS_WALK_NOCELLS: Do not visit the cells of structure arrays, or
+*        anything within them.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Calls the supplied function once for each object in the hierarchy
+*     below (and including) the supplied object. Each object is visited
+*     before the objects it contains, and the components of each structure
+*     are visited in the same order as datIndex. The cells of a structure
+*     array are visited in Fortran order, each followed by its components.
+*
+*     The objects are described using HDS names, paths, types and shapes,
+*     but no locators are created for them and each HDF5 object is opened
+*     only once, so this is much faster than using datIndex, datType and
+*     datShape to recurse through the hierarchy.
+*
+*     The following components of the HDSWalkNode structure are set:
+*     - name: The name of the object, including subscripts for a cell.
+*     - path: The path to the object, starting with the name of the
+*     supplied object (e.g. "TOP.RECORDS(3,2).DATA").
+*     - type: The HDS type string.
+*     - level: The number of levels below the supplied object (zero for the
+*     supplied object).
+*     - ndim, dims: The shape of the object, as returned by datShape.
+*     - isstruc: Is the object a structure?
+*     - iscell: Is the object a cell of a structure array?
+*     - state: Does the primitive have a defined value? Only set if the
+*     HDS_WALK_STATE flag is supplied.
+*     - nbytes: The number of bytes of data in a primitive (zero for a
+*     structure).
+
+*  Notes:
+*     - The strings and dimensions in the HDSWalkNode structure are
+*     only valid until "func" returns.
+*     - The walk ends if "func" returns a non-zero value or sets the
+*     status to an error value.
+*     - "func" should not modify the hierarchy. It may create locators for
+*     the objects that it is passed (e.g. using datFind on a locator for
+*     the supplied object) if it needs their values.
+*     - Cells of a structure array that have not yet been created (see
+*     datCell) are visited as empty structures.
+*     - Only the supplied object needs to be locked by the current thread.
+*     The objects within it should not be locked for writing by any other
+*     thread.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     2026-10-16 (AGENT):
+*        Move the walk itself into dat1Walk so that it can also be used
+*        when writing a catalogue. Report the size of each primitive.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+datWalk( const HDSLoc *locator,
+         int (*func)( const HDSWalkNode *node, void *data, int *status ),
+         void *data, int flags, int *status ) {
+  HDSWalkNode node;
+  char name[DAT__SZNAM+1];
+  char type[DAT__SZTYP+1];
+  hdsdim dims[DAT__MXDIM];
+  size_t clen = 0;
+  size_t nel = 0;
+  int ndim = 0;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datWalk", 1, locator, 1, status );
+  if (*status != SAI__OK) return *status;
+
+  /* The supplied object may be a slice or a vectorised primitive, so
+     describe it using the public routines. */
+  memset( &node, 0, sizeof(node) );
+  datName( locator, name, status );
+  datType( locator, type, status );
+  datShape( locator, DAT__MXDIM, dims, &ndim, status );
+  node.isstruc = dat1IsStructure( locator, status );
+  if (!node.isstruc) {
+    datLen( locator, &clen, status );
+    datSize( locator, &nel, status );
+    node.nbytes = clen*nel;
+    if (flags & HDS_WALK_STATE) datState( locator, &node.state, status );
+  }
+  if (*status != SAI__OK) return *status;
+
+  node.name = name;
+  node.type = type;
+  node.ndim = ndim;
+  node.dims = dims;
+  node.iscell = ( node.isstruc && strchr( name, '(' ) != NULL );
+
+  /* Report the supplied object and then visit its contents. An untouched
+     cell in a read-only file has no components. */
+  dat1Walk( locator->isemptycell ? 0 : locator->group_id, name, &node,
+            flags, func, data, status );
+
+  return *status;
+}
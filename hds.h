@@ -37,6 +37,13 @@ datAnnul(HDSLoc **locator, int *status);
 int
 datBasic(const HDSLoc *locator, const char *mode_c, unsigned char **pntr, size_t *len, int *status);
 
+/*===========================================================*/
+/* datCatalogue - Visit every object using the file catalogue */
+/*===========================================================*/
+
+int
+datCatalogue(const HDSLoc *locator, int (*func)(const HDSWalkNode *node, void *data, int *status), void *data, int flags, int *status);
+
 /*=====================================*/
 /* datCcopy - copy one structure level */
 /*=====================================*/
@@ -354,6 +361,20 @@ datGetVL(const HDSLoc * locator, size_t maxval, hdsbool_t values[], size_t *actv
 int
 datIndex(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status);
 
+/*====================================================================*/
+/* datInitProps - Initialise the storage properties for a new primitive */
+/*====================================================================*/
+
+int
+datInitProps(HDSCreateProps *props, int *status);
+
+/*================================================================*/
+/* datIterate - Call a function for each component of a structure */
+/*================================================================*/
+
+int
+datIterate(const HDSLoc *locator, int (*func)(HDSLoc *comp, void *data, int *status), void *data, int *status);
+
 /*===================================*/
 /* datLen - Inquire primitive length */
 /*===================================*/
@@ -485,6 +506,13 @@ datNcomp(const HDSLoc *locator, int *ncomp, int *status);
 int
 datNew(const HDSLoc *locator, const char *name_str, const char *type_str, int ndim, const hdsdim dims[], int *status);
 
+/*=============================================================*/
+/* datNewP - Create new component with given storage properties */
+/*=============================================================*/
+
+int
+datNewP(const HDSLoc *locator, const char *name_str, const char *type_str, int ndim, const hdsdim dims[], const HDSCreateProps *props, int *status);
+
 /*============================================*/
 /* datNewC - Create new _CHAR type component */
 /*============================================*/
@@ -995,12 +1023,26 @@ datValid(const HDSLoc *locator, hdsbool_t *valid, int *status);
 int
 datVec(const HDSLoc *locator1, HDSLoc **locator2, int *status);
 
+/*==================================================*/
+/* datWalk - Visit every object in an HDS hierarchy */
+/*==================================================*/
+
+int
+datWalk(const HDSLoc *locator, int (*func)(const HDSWalkNode *node, void *data, int *status), void *data, int flags, int *status);
+
 /*================================================*/
 /* datWhere - Find primitive position in HDS file */
 /*            Currently not part of the public    */
 /*            C API                               */
 /*================================================*/
 
+/*======================================*/
+/* hdsBegin - Begin a new locator scope */
+/*======================================*/
+
+int
+hdsBegin(int *status);
+
 /*==================================================*/
 /* hdsCopy - Copy an object to a new container file */
 /*==================================================*/
@@ -1008,6 +1050,13 @@ datVec(const HDSLoc *locator1, HDSLoc **locator2, int *status);
 int
 hdsCopy(const HDSLoc *locator, const char *file_str, const char name_str[DAT__SZNAM], int *status);
 
+/*========================================*/
+/* hdsEnd - End the current locator scope */
+/*========================================*/
+
+int
+hdsEnd(int *status);
+
 /*=================================*/
 /* hdsErase - Erase container file */
 /*=================================*/
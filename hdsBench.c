@@ -0,0 +1,2048 @@
+/*
+*+
+*  Name:
+*     hdsBench
+
+*  Purpose:
+*     Measure the performance of selected parts of HDS
+
+*  Language:
+*     Starlink ANSI C
+
+*  Invocation:
+*     hdsBench [name ...]
+
+*  Description:
+*     This program runs a set of micro-benchmarks and prints the
+*     results to standard output. Each benchmark is identified by a
+*     name. If no names are given on the command line, all benchmarks
+*     are run. It is not run as part of "make check" - use
+*     "make hdsBench" to build it.
+*
+*     The following benchmarks are available:
+*
+*     - convert: Throughput of the numeric type conversions used by
+*       datGet and datPut, compared with the HDF5 type conversion
+*       system, both in memory and when reading a primitive from a file.
+*     - cvtchar: Throughput of the conversions between _CHAR and numeric
+*       types done by dat1CvtChar, compared with the per-element sscanf
+*       and snprintf calls that it used previously.
+*     - cells: Time to get a locator for every cell of a large structure
+*       array.
+*     - meta: Time to query the type, shape and name of objects
+*       repeatedly.
+*     - find: Time to follow a path of nested components and to probe
+*       for components that do not exist.
+*     - lockcheck: Time for calls that only need to validate the
+*       supplied locator and check the lock held on it, made from one
+*       thread and from several threads sharing a read lock.
+*     - handoff: Time to unlock and re-lock a large tree of objects
+*       recursively, as is done when passing it between threads.
+*     - reopen: Time to open and close a file, through a different
+*       path, while it is already open.
+*     - alloc: Time to create and free batches of locators and Handles.
+*     - liveloc: Time to create, query and annul a million locators that
+*       are all live at the same time, and the peak memory used.
+*     - scope: Time to release a large number of secondary locators and
+*       close their file, either by annulling each locator or by ending
+*       the hdsBegin scope in which they were created.
+*     - walk: Time to list the name, type and structure-ness of every
+*       object in a tree, as done by hdsShow-style listings, both for the
+*       first walk of a newly opened file and for later walks, and the
+*       time taken by datWalk to list the same tree (with shapes). Also
+*       the time taken by datCatalogue to list it using the catalogue
+*       written to the file, and the time taken to write the catalogue
+*       when the file is closed.
+*     - index: Time to get the name of every component of a structure
+*       with many components, using datIndex and using datIterate.
+*     - compact: Size of a file holding many small scalars and short
+*       strings, the time to write it, and the time and number of read
+*       calls needed to read every value after the file has been removed
+*       from the operating system's cache, with and without compact
+*       storage for small primitives.
+*     - compress: File size, write speed and uncached read speed for an
+*       image, a cube, an integer time series and a quality array,
+*       stored without compression and with several combinations of
+*       the deflate, shuffle and scale-offset filters.
+*     - pwrite: Write speed for a compressed image when its chunks are
+*       compressed on 1, 2, 4, 8 and 16 threads (see the NTHREADS tuning
+*       parameter), using a fast and a slow deflate level.
+*     - pread: Read speed for the whole of a compressed image, and for a
+*       section of it, when its chunks are decompressed on 1, 2, 4, 8
+*       and 16 threads.
+*     - planes: Speed at which a compressed cube is read one plane at a
+*       time, using a chunk cache of the HDF5 default size and using the
+*       larger cache chosen by HDS (see the RAWCACHE tuning parameter).
+*     - layout: The number of extents occupied on the disk by two files
+*       that grow at the same time, with and without disk space reserved
+*       for them when they are created (see the INAL tuning parameter),
+*       and the size of a file holding many structures of 20 components,
+*       with and without space reserved for the components (see NCOM).
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Original.
+*     {enter_further_changes_here}
+
+*  Licence:
+*     This program is free software; you can redistribute it and/or
+*     modify it under the terms of the GNU General Public License as
+*     published by the Free Software Foundation; either version 2 of
+*     the License, or (at your option) any later version.
+*
+*     This program is distributed in the hope that it will be
+*     useful, but WITHOUT ANY WARRANTY; without even the implied
+*     warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*     PURPOSE. See the GNU General Public License for more details.
+*
+*     You should have received a copy of the GNU General Public
+*     License along with this program; if not, write to the Free
+*     Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+*     MA 02110-1301, USA
+
+*  Bugs:
+*     {note_any_bugs_here}
+
+*-
+*/
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <float.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#endif
+#include <unistd.h>
+
+#include "hdf5.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "ems.h"
+#include "dat_err.h"
+#include "sae_par.h"
+
+/* Number of times each timed operation is repeated. The fastest time
+   is reported. */
+#define NREP 5
+
+/* Number of elements in the arrays used by the "convert" benchmark. */
+#define NCONVERT 4000000
+
+/* Number of elements, and length of each string, used by the "cvtchar"
+   benchmark. */
+#define NCVTCHAR 1000000
+#define LCVTCHAR 16
+
+/* Number of cells in the structure array used by the "cells" benchmark. */
+#define NCELLS 100000
+
+/* Number of metadata queries made by the "meta" benchmark. */
+#define NMETA 1000000
+
+/* Number of times the "find" benchmark opens a nested component, and
+   the number of times it probes for missing components. */
+#define NFIND 100000
+#define NPROBE 1000000
+
+/* Number of calls made by each thread in the "lockcheck" benchmark, and
+   the number of threads. */
+#define NLOCKCHECK 2000000
+#define NLCTHREAD 4
+
+/* Number of cells in the structure array used by the "handoff"
+   benchmark, and the number of times the tree is unlocked and locked. */
+#define NHOCELLS 10000
+#define NHANDOFF 1000
+
+/* Number of times the "reopen" benchmark opens the file. */
+#define NREOPEN 2000
+
+/* Number of objects in each batch created by the "alloc" benchmark, and
+   the number of batches. */
+#define NALLOC 100
+#define NALLOCREP 20000
+
+/* Number of live locators created by the "liveloc" benchmark. */
+#define NLIVELOC 1000000
+
+/* Number of secondary locators released by the "scope" benchmark. */
+#define NSCOPE 200000
+
+/* Number of structures in the tree walked by the "walk" benchmark, and
+   the number of primitives in each structure. */
+#define NWALK 500
+#define NWALKPRIM 10
+
+/* Number of components in the structure used by the "index" benchmark. */
+#define NINDEX 20000
+
+/* Number of structures in the file used by the "compact" benchmark, and
+   the number of scalars and strings in each structure. */
+#define NCOMPSTRUC 200
+#define NCOMPPRIM 50
+
+/* COMPACT tuning value used by the "compact" benchmark if compact
+   storage is not already enabled. */
+#define NCOMPBYTES 1024
+
+/* Number of bytes in each array used by the "compress" benchmark. */
+#define NCPRBYTES 8388608
+
+/* Number of bytes in the image written by the "pwrite" benchmark. */
+#define NPWBYTES 33554432
+
+/* Dimensions of the cube, and of its chunks, read by the "planes"
+   benchmark. */
+#define NPLXY 256
+#define NPLZ 64
+#define NPLCXY 128
+#define NPLCZ 16
+
+/* Number of primitives, and the number of bytes in each, written to each
+   of the two files in the "layout" benchmark, and the number of
+   structures of NLAYCOMP components written to a third file. */
+#define NLAYPRIM 1000
+#define NLAYBYTES 131072
+#define NLAYSTRUC 2000
+#define NLAYCOMP 20
+
+static double benchTime( void );
+static void benchNewFile( const char *name, const char *type, int ndim,
+                          const hdsdim dims[], HDSLoc **top, HDSLoc **loc,
+                          int *status );
+static void benchConvert( int *status );
+static void benchCvtChar( int *status );
+static void benchCells( int *status );
+static void benchMeta( int *status );
+static void benchFind( int *status );
+static void benchLockCheck( int *status );
+static void *benchLockCheckThread( void *data );
+static void benchHandoff( int *status );
+static void benchReopen( int *status );
+static void benchAlloc( int *status );
+static void benchLiveLoc( int *status );
+static void benchScope( int *status );
+static void benchWalk( int *status );
+static void benchWalkTree( const HDSLoc *loc, int *nobj, int *status );
+static int benchWalkFunc( const HDSWalkNode *node, void *data, int *status );
+static void benchIndex( int *status );
+static int benchIndexFunc( HDSLoc *comp, void *data, int *status );
+static void benchCompact( int *status );
+static void benchCompress( int *status );
+static void benchPWrite( int *status );
+static void benchPRead( int *status );
+static void benchPlanes( int *status );
+static void benchLayout( int *status );
+static long benchExtents( const char *path );
+static void benchDropCache( const char *path );
+static long benchReadCalls( void );
+static void oldCvtChar( size_t nval, hdstype_t intype, size_t nbin,
+                        hdstype_t outtype, size_t nbout, const void *imp,
+                        void *exp );
+
+/* The available benchmarks. */
+typedef struct {
+   const char *name;
+   void (*fun)( int *status );
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+   { "convert", benchConvert },
+   { "cvtchar", benchCvtChar },
+   { "cells", benchCells },
+   { "meta", benchMeta },
+   { "find", benchFind },
+   { "lockcheck", benchLockCheck },
+   { "handoff", benchHandoff },
+   { "reopen", benchReopen },
+   { "alloc", benchAlloc },
+   { "liveloc", benchLiveLoc },
+   { "scope", benchScope },
+   { "walk", benchWalk },
+   { "index", benchIndex },
+   { "compact", benchCompact },
+   { "compress", benchCompress },
+   { "pwrite", benchPWrite },
+   { "pread", benchPRead },
+   { "planes", benchPlanes },
+   { "layout", benchLayout },
+   { NULL, NULL }
+};
+
+int main( int argc, char *argv[] ) {
+   const Benchmark *bench;
+   int found;
+   int i;
+   int status = SAI__OK;
+
+   emsBegin( &status );
+
+   for( bench = benchmarks; bench->name && status == SAI__OK; bench++ ) {
+      found = ( argc < 2 );
+      for( i = 1; i < argc; i++ ) {
+         if( !strcmp( argv[ i ], bench->name ) ) found = 1;
+      }
+      if( found ) {
+         printf( "\n--- %s ---\n", bench->name );
+         bench->fun( &status );
+      }
+   }
+
+   emsEnd( &status );
+
+   return ( status == SAI__OK ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Return a monotonic time in seconds. */
+static double benchTime( void ) {
+   struct timespec ts;
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return ts.tv_sec + 1.0E-9*ts.tv_nsec;
+}
+
+/* Create the container file used by a benchmark, and return a locator
+   for its top-level structure in "top". If "name" is not NULL, a
+   component with the given name, type and dimensions is also created in
+   it and, if "loc" is not NULL, a locator for the component is returned
+   in "loc". */
+static void benchNewFile( const char *name, const char *type, int ndim,
+                          const hdsdim dims[], HDSLoc **top, HDSLoc **loc,
+                          int *status ) {
+   if( *status != SAI__OK ) return;
+
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, NULL, top, status );
+   if( name ) {
+      datNew( *top, name, type, ndim, dims, status );
+      if( loc ) datFind( *top, name, loc, status );
+   }
+}
+
+/* Compare dat1CvtNumeric with the HDF5 conversion functions. */
+static void benchConvert( int *status ) {
+   static const struct {
+      const char *intype;
+      const char *outtype;
+      hdstype_t hin;
+      hdstype_t hout;
+   } pairs[] = {
+      { "_REAL", "_DOUBLE", HDSTYPE_REAL, HDSTYPE_DOUBLE },
+      { "_DOUBLE", "_REAL", HDSTYPE_DOUBLE, HDSTYPE_REAL },
+      { "_WORD", "_REAL", HDSTYPE_WORD, HDSTYPE_REAL },
+      { "_INTEGER", "_DOUBLE", HDSTYPE_INTEGER, HDSTYPE_DOUBLE },
+      { "_INTEGER", "_REAL", HDSTYPE_INTEGER, HDSTYPE_REAL },
+      { "_DOUBLE", "_INTEGER", HDSTYPE_DOUBLE, HDSTYPE_INTEGER },
+      { "_UBYTE", "_REAL", HDSTYPE_UBYTE, HDSTYPE_REAL }
+   };
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   char normtype[ DAT__SZTYP + 1 ];
+   char *inbuf = NULL;
+   char *outbuf = NULL;
+   char *tmpbuf = NULL;
+   double t0;
+   double thdf;
+   double thdfmem;
+   double thds;
+   double thdsmem;
+   hdsdim dim = NCONVERT;
+   hid_t h5in;
+   hid_t h5out;
+   size_t i;
+   size_t ip;
+   size_t nbad;
+   size_t nbin;
+   size_t nbout;
+   int irep;
+
+   if( *status != SAI__OK ) return;
+
+   inbuf = MEM_MALLOC( NCONVERT*sizeof(double) );
+   outbuf = MEM_MALLOC( NCONVERT*sizeof(double) );
+   tmpbuf = MEM_MALLOC( NCONVERT*sizeof(double) );
+
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+
+   printf( "%d elements; throughput in millions of elements per second\n",
+           NCONVERT );
+   printf( "%-9s %-9s %10s %10s %10s %10s\n", "From", "To", "H5Tconvert",
+           "dat1Cvt", "H5Dread", "datGet" );
+
+   for( ip = 0; ip < sizeof(pairs)/sizeof(pairs[0]) && *status == SAI__OK;
+        ip++ ) {
+
+/* Fill an array of the input type with non-bad values that can be
+   represented in the output type. */
+      for( i = 0; i < NCONVERT; i++ ) {
+         double val = (double)( i % 200 );
+         switch( pairs[ ip ].hin ) {
+            case HDSTYPE_UBYTE: ((unsigned char *) inbuf)[ i ] = val; break;
+            case HDSTYPE_WORD: ((short *) inbuf)[ i ] = val; break;
+            case HDSTYPE_INTEGER: ((int *) inbuf)[ i ] = val; break;
+            case HDSTYPE_REAL: ((float *) inbuf)[ i ] = val; break;
+            default: ((double *) inbuf)[ i ] = val; break;
+         }
+      }
+
+      dau1CheckType( 1, pairs[ ip ].intype, &h5in, normtype,
+                     sizeof(normtype), status );
+      dau1CheckType( 1, pairs[ ip ].outtype, &h5out, normtype,
+                     sizeof(normtype), status );
+      nbin = H5Tget_size( h5in );
+      nbout = H5Tget_size( h5out );
+
+/* In memory. H5Tconvert converts in place so the input values need to
+   be copied into the conversion buffer first, as H5Dread would. */
+      thdfmem = thdsmem = 1.0E30;
+      for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+         t0 = benchTime();
+         memcpy( tmpbuf, inbuf, NCONVERT*nbin );
+         if( H5Tconvert( h5in, h5out, NCONVERT, tmpbuf, NULL,
+                         H5P_DEFAULT ) < 0 ) {
+            *status = DAT__HDF5E;
+            emsRep( "", "H5Tconvert failed", status );
+         }
+         t0 = benchTime() - t0;
+         if( t0 < thdfmem ) thdfmem = t0;
+
+         t0 = benchTime();
+         dat1CvtNumeric( NCONVERT, pairs[ ip ].hin, nbin, pairs[ ip ].hout,
+                         nbout, inbuf, outbuf, &nbad, status );
+         t0 = benchTime() - t0;
+         if( t0 < thdsmem ) thdsmem = t0;
+      }
+
+/* From a file. */
+      datNew( loc1, "DATA", pairs[ ip ].intype, 1, &dim, status );
+      datFind( loc1, "DATA", &loc2, status );
+      datPut( loc2, pairs[ ip ].intype, 1, &dim, inbuf, status );
+
+      thdf = thds = 1.0E30;
+      for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+         t0 = benchTime();
+         if( H5Dread( loc2->dataset_id, h5out, H5S_ALL, H5S_ALL,
+                      H5P_DEFAULT, outbuf ) < 0 ) {
+            *status = DAT__HDF5E;
+            emsRep( "", "H5Dread failed", status );
+         }
+         t0 = benchTime() - t0;
+         if( t0 < thdf ) thdf = t0;
+
+         t0 = benchTime();
+         datGet( loc2, pairs[ ip ].outtype, 1, &dim, outbuf, status );
+         t0 = benchTime() - t0;
+         if( t0 < thds ) thds = t0;
+      }
+
+      datAnnul( &loc2, status );
+      datErase( loc1, "DATA", status );
+      H5Tclose( h5in );
+      H5Tclose( h5out );
+
+      if( *status == SAI__OK ) {
+         printf( "%-9s %-9s %10.1f %10.1f %10.1f %10.1f\n",
+                 pairs[ ip ].intype, pairs[ ip ].outtype,
+                 1.0E-6*NCONVERT/thdfmem, 1.0E-6*NCONVERT/thdsmem,
+                 1.0E-6*NCONVERT/thdf, 1.0E-6*NCONVERT/thds );
+      }
+   }
+
+   hdsErase( &loc1, status );
+
+   MEM_FREE( inbuf );
+   MEM_FREE( outbuf );
+   MEM_FREE( tmpbuf );
+}
+
+/* Compare dat1CvtChar with the sscanf/snprintf approach it replaced. */
+static void benchCvtChar( int *status ) {
+   static const struct {
+      hdstype_t intype;
+      hdstype_t outtype;
+      size_t nbin;
+      size_t nbout;
+      const char *label;
+   } tests[] = {
+      { HDSTYPE_CHAR, HDSTYPE_DOUBLE, LCVTCHAR, sizeof(double), "_CHAR -> _DOUBLE" },
+      { HDSTYPE_CHAR, HDSTYPE_REAL, LCVTCHAR, sizeof(float), "_CHAR -> _REAL" },
+      { HDSTYPE_CHAR, HDSTYPE_INTEGER, LCVTCHAR, sizeof(int), "_CHAR -> _INTEGER" },
+      { HDSTYPE_DOUBLE, HDSTYPE_CHAR, sizeof(double), LCVTCHAR, "_DOUBLE -> _CHAR" },
+      { HDSTYPE_REAL, HDSTYPE_CHAR, sizeof(float), LCVTCHAR, "_REAL -> _CHAR" },
+      { HDSTYPE_INTEGER, HDSTYPE_CHAR, sizeof(int), LCVTCHAR, "_INTEGER -> _CHAR" }
+   };
+   char *chars = NULL;
+   char *outbuf = NULL;
+   double *dvals = NULL;
+   double t0;
+   double tnew;
+   double told;
+   float *rvals = NULL;
+   int *ivals = NULL;
+   int irep;
+   size_t i;
+   size_t it;
+   size_t nbad;
+   const void *in;
+
+   if( *status != SAI__OK ) return;
+
+   chars = MEM_MALLOC( NCVTCHAR*LCVTCHAR + 1 );
+   outbuf = MEM_MALLOC( NCVTCHAR*LCVTCHAR );
+   dvals = MEM_MALLOC( NCVTCHAR*sizeof(*dvals) );
+   rvals = MEM_MALLOC( NCVTCHAR*sizeof(*rvals) );
+   ivals = MEM_MALLOC( NCVTCHAR*sizeof(*ivals) );
+
+/* A mixture of integers and values with a fractional part, as might be
+   found in a table. */
+   for( i = 0; i < NCVTCHAR; i++ ) {
+      dvals[ i ] = ( i % 3 ) ? ( i % 100000 ) * 0.125 - 5000.0 : (double) i;
+      rvals[ i ] = dvals[ i ];
+      ivals[ i ] = (int) i - NCVTCHAR/2;
+   }
+   oldCvtChar( NCVTCHAR, HDSTYPE_DOUBLE, sizeof(double), HDSTYPE_CHAR,
+               LCVTCHAR, dvals, chars );
+
+   printf( "%d elements of _CHAR*%d; throughput in millions of elements "
+           "per second\n", NCVTCHAR, LCVTCHAR );
+   printf( "%-20s %10s %10s\n", "Conversion", "sscanf etc", "dat1Cvt" );
+
+   for( it = 0; it < sizeof(tests)/sizeof(tests[0]) && *status == SAI__OK;
+        it++ ) {
+      if( tests[ it ].intype == HDSTYPE_CHAR ) {
+         in = chars;
+      } else if( tests[ it ].intype == HDSTYPE_DOUBLE ) {
+         in = dvals;
+      } else if( tests[ it ].intype == HDSTYPE_REAL ) {
+         in = rvals;
+      } else {
+         in = ivals;
+      }
+
+      told = tnew = 1.0E30;
+      for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+         t0 = benchTime();
+         oldCvtChar( NCVTCHAR, tests[ it ].intype, tests[ it ].nbin,
+                     tests[ it ].outtype, tests[ it ].nbout, in, outbuf );
+         t0 = benchTime() - t0;
+         if( t0 < told ) told = t0;
+
+         t0 = benchTime();
+         dat1CvtChar( NCVTCHAR, tests[ it ].intype, tests[ it ].nbin,
+                      tests[ it ].outtype, tests[ it ].nbout, in, outbuf,
+                      &nbad, status );
+         t0 = benchTime() - t0;
+         if( t0 < tnew ) tnew = t0;
+      }
+
+      if( *status == SAI__OK ) {
+         printf( "%-20s %10.2f %10.2f\n", tests[ it ].label,
+                 1.0E-6*NCVTCHAR/told, 1.0E-6*NCVTCHAR/tnew );
+      }
+   }
+
+   MEM_FREE( chars );
+   MEM_FREE( outbuf );
+   MEM_FREE( dvals );
+   MEM_FREE( rvals );
+   MEM_FREE( ivals );
+}
+
+/* Walk every cell of a large structure array, getting a locator for
+   each cell and then annulling it. The first walk creates the Handles
+   for the cells (the cells themselves are empty so are not created).
+   Later walks find the existing Handles. */
+static void benchCells( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   double t0;
+   double tfirst;
+   double tnext;
+   hdsdim dim = NCELLS;
+   hdsdim sub;
+   int irep;
+
+   if( *status != SAI__OK ) return;
+
+   benchNewFile( "CELLS", "CELL", 1, &dim, &loc1, &loc2, status );
+
+   tnext = 1.0E30;
+   tfirst = 0.0;
+   for( irep = 0; irep <= NREP && *status == SAI__OK; irep++ ) {
+      t0 = benchTime();
+      for( sub = 1; sub <= NCELLS && *status == SAI__OK; sub++ ) {
+         datCell( loc2, 1, &sub, &loc3, status );
+         datAnnul( &loc3, status );
+      }
+      t0 = benchTime() - t0;
+      if( irep == 0 ) {
+         tfirst = t0;
+      } else if( t0 < tnext ) {
+         tnext = t0;
+      }
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "%d cells; time in seconds to get a locator for every cell\n",
+              NCELLS );
+      printf( "%-20s %10.3f\n", "First walk", tfirst );
+      printf( "%-20s %10.3f\n", "Later walks", tnext );
+   }
+
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+}
+
+/* Query the type, shape and name of a primitive and a structure array
+   repeatedly, as NDF-level code does, and report the cache hit rate. */
+static void benchMeta( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char type[ DAT__SZTYP + 1 ];
+   double t0;
+   double tbest;
+   hdsdim dims[ DAT__MXDIM ];
+   int actdim;
+   int hits0;
+   int hits1;
+   int i;
+   int irep;
+   int misses0;
+   int misses1;
+
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 100;
+   dims[ 1 ] = 20;
+   benchNewFile( "DATA", "_REAL", 2, dims, &loc1, &loc2, status );
+   datNew( loc1, "RECS", "REC", 2, dims, status );
+   datFind( loc1, "RECS", &loc3, status );
+
+   hdsInfoI( NULL, "CACHEHITS", NULL, &hits0, status );
+   hdsInfoI( NULL, "CACHEMISSES", NULL, &misses0, status );
+
+   tbest = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      t0 = benchTime();
+      for( i = 0; i < NMETA/2 && *status == SAI__OK; i++ ) {
+         datType( loc2, type, status );
+         datShape( loc2, DAT__MXDIM, dims, &actdim, status );
+         datName( loc2, name, status );
+         datType( loc3, type, status );
+         datShape( loc3, DAT__MXDIM, dims, &actdim, status );
+         datName( loc3, name, status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < tbest ) tbest = t0;
+   }
+
+   hdsInfoI( NULL, "CACHEHITS", NULL, &hits1, status );
+   hdsInfoI( NULL, "CACHEMISSES", NULL, &misses1, status );
+
+   if( *status == SAI__OK ) {
+      printf( "%d calls each of datType, datShape and datName\n", NMETA );
+      printf( "%-20s %10.3f\n", "Time (s)", tbest );
+      printf( "%-20s %10d\n", "Cache hits", hits1 - hits0 );
+      printf( "%-20s %10d\n", "Cache misses", misses1 - misses0 );
+   }
+
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+}
+
+/* Open a component four levels down, one level at a time, as is done
+   when following an NDF component path, and probe a structure for
+   optional components that do not exist. */
+static void benchFind( int *status ) {
+   static const char *levels[] = { "MORE", "SMURF", "EXPOSURE", "DATA_ARRAY" };
+   static const char *probes[] = { "QUALITY", "VARIANCE", "WCS" };
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   double t0;
+   double tfind;
+   double tprobe;
+   hdsdim dim = 10;
+   int i;
+   int irep;
+   int j;
+   int there;
+
+   if( *status != SAI__OK ) return;
+
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+   datClone( loc1, &loc2, status );
+   for( j = 0; j < 4; j++ ) {
+      for( i = 0; i < 20; i++ ) {
+         char name[ DAT__SZNAM + 1 ];
+         sprintf( name, "COMP%d", i );
+         datNew0I( loc2, name, status );
+      }
+      if( j < 3 ) {
+         datNew( loc2, levels[ j ], "EXT", 0, &dim, status );
+      } else {
+         datNew1R( loc2, levels[ j ], dim, status );
+      }
+      datFind( loc2, levels[ j ], &loc3, status );
+      datAnnul( &loc2, status );
+      loc2 = loc3;
+      loc3 = NULL;
+   }
+   datAnnul( &loc2, status );
+
+   tfind = tprobe = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      t0 = benchTime();
+      for( i = 0; i < NFIND && *status == SAI__OK; i++ ) {
+         datClone( loc1, &loc2, status );
+         for( j = 0; j < 4; j++ ) {
+            datFind( loc2, levels[ j ], &loc3, status );
+            datAnnul( &loc2, status );
+            loc2 = loc3;
+            loc3 = NULL;
+         }
+         datAnnul( &loc2, status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < tfind ) tfind = t0;
+
+      t0 = benchTime();
+      for( i = 0; i < NPROBE && *status == SAI__OK; i++ ) {
+         datThere( loc1, probes[ i % 3 ], &there, status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < tprobe ) tprobe = t0;
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "%-36s %10.3f\n", "4-level datFind path x 100000 (s)", tfind );
+      printf( "%-36s %10.3f\n", "datThere for missing x 1000000 (s)", tprobe );
+   }
+
+   hdsErase( &loc1, status );
+}
+
+/* Call datType (which uses the type cached in the Handle) repeatedly so
+   that the time is dominated by the validation of the locator and the
+   check that the current thread holds a lock on it. This is done first
+   in a single thread, and then in several threads at once, each holding a
+   read lock on the same object. */
+typedef struct {
+   HDSLoc *loc;
+   double time;
+   int lock;
+   int status;
+} LockCheckData;
+
+static void benchLockCheck( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   LockCheckData data[ NLCTHREAD ];
+   char type[ DAT__SZTYP + 1 ];
+   double tmulti;
+   double tsingle;
+   hdsdim dim = 10;
+   int i;
+   int irep;
+   pthread_t threads[ NLCTHREAD ];
+
+   if( *status != SAI__OK ) return;
+
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+   datNew1R( loc1, "DATA", dim, status );
+   datFind( loc1, "DATA", &loc2, status );
+   datType( loc2, type, status );
+
+   tsingle = tmulti = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      data[ 0 ].loc = loc2;
+      data[ 0 ].lock = 0;
+      benchLockCheckThread( data );
+      *status = data[ 0 ].status;
+      if( data[ 0 ].time < tsingle ) tsingle = data[ 0 ].time;
+
+/* Release the lock held by this thread so that the other threads can
+   each get a read lock. The elapsed time for the slowest thread is
+   used. */
+      datUnlock( loc2, 0, status );
+      if( *status == SAI__OK ) {
+         emsMark();
+         for( i = 0; i < NLCTHREAD; i++ ) {
+            data[ i ].loc = loc2;
+            data[ i ].lock = 1;
+            pthread_create( threads + i, NULL, benchLockCheckThread,
+                            data + i );
+         }
+         data[ 0 ].time = 0.0;
+         for( i = 0; i < NLCTHREAD; i++ ) {
+            pthread_join( threads[ i ], NULL );
+            if( data[ i ].status != SAI__OK ) *status = data[ i ].status;
+            if( data[ i ].time > data[ 0 ].time ) data[ 0 ].time = data[ i ].time;
+         }
+         if( data[ 0 ].time < tmulti ) tmulti = data[ 0 ].time;
+         emsRlse();
+      }
+      datLock( loc2, 0, 0, status );
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "%d calls to datType per thread; time in seconds\n",
+              NLOCKCHECK );
+      printf( "%-20s %10.3f\n", "1 thread", tsingle );
+      printf( "%d %-18s %10.3f\n", NLCTHREAD, "threads", tmulti );
+   }
+
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+}
+
+/* Make the calls for benchLockCheck in a single thread. If requested,
+   the supplied locator is locked for read-only access by the current
+   thread while the calls are made. */
+static void *benchLockCheckThread( void *data ) {
+   LockCheckData *lcdata = (LockCheckData *) data;
+   char type[ DAT__SZTYP + 1 ];
+   double t0;
+   int i;
+   int status = SAI__OK;
+
+   if( lcdata->lock ) datLock( lcdata->loc, 0, 1, &status );
+
+   t0 = benchTime();
+   for( i = 0; i < NLOCKCHECK && status == SAI__OK; i++ ) {
+      datType( lcdata->loc, type, &status );
+   }
+   lcdata->time = benchTime() - t0;
+
+   if( lcdata->lock ) datUnlock( lcdata->loc, 0, &status );
+   lcdata->status = status;
+   return NULL;
+}
+
+/* Create a structure array and a component in each of its cells, so
+   that the tree contains a Handle for every object. Then time recursive
+   calls to datUnlock and datLock on the top-level object. */
+static void benchHandoff( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   double t0;
+   double tbest;
+   hdsdim dim = NHOCELLS;
+   hdsdim sub;
+   int i;
+   int irep;
+
+   if( *status != SAI__OK ) return;
+
+   benchNewFile( "CELLS", "CELL", 1, &dim, &loc1, &loc2, status );
+   for( sub = 1; sub <= NHOCELLS && *status == SAI__OK; sub++ ) {
+      datCell( loc2, 1, &sub, &loc3, status );
+      datNew0I( loc3, "VALUE", status );
+      datFind( loc3, "VALUE", &loc4, status );
+      datAnnul( &loc4, status );
+      datAnnul( &loc3, status );
+   }
+   datAnnul( &loc2, status );
+
+   tbest = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      t0 = benchTime();
+      for( i = 0; i < NHANDOFF && *status == SAI__OK; i++ ) {
+         datUnlock( loc1, 1, status );
+         datLock( loc1, 1, 0, status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < tbest ) tbest = t0;
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "%d objects; time in seconds for %d recursive unlock/lock "
+              "pairs\n", 2*NHOCELLS + 2, NHANDOFF );
+      printf( "%-20s %10.3f\n", "Time (s)", tbest );
+   }
+
+   hdsErase( &loc1, status );
+}
+
+static void benchReopen( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   double t0;
+   double tbest;
+   int i;
+   int irep;
+
+   if( *status != SAI__OK ) return;
+
+   benchNewFile( "VALUE", "_INTEGER", 0, NULL, &loc1, NULL, status );
+
+   tbest = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      t0 = benchTime();
+      for( i = 0; i < NREOPEN && *status == SAI__OK; i++ ) {
+         hdsOpen( "./hds_bench", "READ", &loc2, status );
+         datAnnul( &loc2, status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < tbest ) tbest = t0;
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "Time in seconds to open an open file %d times\n", NREOPEN );
+      printf( "%-20s %10.3f\n", "Time (s)", tbest );
+   }
+
+   hdsErase( &loc1, status );
+}
+
+static void benchAlloc( int *status ) {
+   HDSLoc *locs[ NALLOC ];
+   Handle *handles[ NALLOC ];
+   double t0;
+   double tloc;
+   double thandle;
+   int i;
+   int irep;
+   int j;
+
+   if( *status != SAI__OK ) return;
+
+   tloc = 1.0E30;
+   thandle = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      t0 = benchTime();
+      for( i = 0; i < NALLOCREP && *status == SAI__OK; i++ ) {
+         for( j = 0; j < NALLOC; j++ ) locs[ j ] = dat1AllocLoc( status );
+         for( j = 0; j < NALLOC; j++ ) dat1FreeLoc( locs[ j ], status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < tloc ) tloc = t0;
+
+      t0 = benchTime();
+      for( i = 0; i < NALLOCREP/10 && *status == SAI__OK; i++ ) {
+         for( j = 0; j < NALLOC; j++ ) {
+            handles[ j ] = dat1Handle( NULL, "BENCH", 0, status );
+         }
+         for( j = 0; j < NALLOC; j++ ) dat1FreeHandle( handles[ j ], status );
+      }
+      t0 = benchTime() - t0;
+      if( t0 < thandle ) thandle = t0;
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "Time in seconds to create and free batches of %d objects\n",
+              NALLOC );
+      printf( "%-20s %10.3f (%d batches)\n", "Locators", tloc, NALLOCREP );
+      printf( "%-20s %10.3f (%d batches)\n", "Handles", thandle,
+              NALLOCREP/10 );
+   }
+}
+
+static void benchLiveLoc( int *status ) {
+   HDSLoc **locs;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char type[ DAT__SZTYP + 1 ];
+   double tannul;
+   double tcreate;
+   double tquery;
+   int i;
+   long rss0;
+   struct rusage usage;
+
+   if( *status != SAI__OK ) return;
+
+   locs = MEM_CALLOC( NLIVELOC, sizeof(*locs) );
+   if( !locs ) {
+      *status = DAT__NOMEM;
+      emsRep( " ", "benchLiveLoc: Cannot allocate memory", status );
+      return;
+   }
+
+   benchNewFile( "STRUCT", "STRUCT", 0, NULL, &loc1, &loc2, status );
+
+   getrusage( RUSAGE_SELF, &usage );
+   rss0 = usage.ru_maxrss;
+
+   tcreate = benchTime();
+   for( i = 0; i < NLIVELOC && *status == SAI__OK; i++ ) {
+      datClone( loc2, locs + i, status );
+   }
+   tcreate = benchTime() - tcreate;
+
+   tquery = benchTime();
+   for( i = 0; i < NLIVELOC && *status == SAI__OK; i++ ) {
+      datType( locs[ i ], type, status );
+      datName( locs[ i ], name, status );
+   }
+   tquery = benchTime() - tquery;
+
+   getrusage( RUSAGE_SELF, &usage );
+
+   tannul = benchTime();
+   for( i = 0; i < NLIVELOC; i++ ) {
+      if( locs[ i ] ) datAnnul( locs + i, status );
+   }
+   tannul = benchTime() - tannul;
+
+   if( *status == SAI__OK ) {
+      printf( "%d live locators (%zu bytes each); time in seconds\n",
+              NLIVELOC, sizeof(HDSLoc) );
+      printf( "%-20s %10.3f\n", "Create (datClone)", tcreate );
+      printf( "%-20s %10.3f\n", "Query (type, name)", tquery );
+      printf( "%-20s %10.3f\n", "Annul", tannul );
+      printf( "%-20s %10.1f\n", "Peak RSS growth (MB)",
+              ( usage.ru_maxrss - rss0 )/1024.0 );
+   }
+
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+   MEM_FREE( locs );
+}
+
+/* The conversions previously used by dat1CvtChar for the types used in
+   benchCvtChar: a nul-terminated copy and a call to sscanf for each
+   string, or a call to snprintf for each number. */
+static void oldCvtChar( size_t nval, hdstype_t intype, size_t nbin,
+                        hdstype_t outtype, size_t nbout, const void *imp,
+                        void *exp ) {
+   char *buffer;
+   char *outbuf = exp;
+   const char *inbuf = imp;
+   size_t i;
+   size_t n;
+   size_t nchar = 0;
+
+   if( intype == HDSTYPE_CHAR ) {
+      buffer = MEM_MALLOC( nbin + 1 );
+      buffer[ nbin ] = '\0';
+      for( n = 0; n < nval; n++ ) {
+         strncpy( buffer, inbuf, nbin );
+         inbuf += nbin;
+         if( outtype == HDSTYPE_DOUBLE ) {
+            sscanf( buffer, "%lf", ((double *) exp) + n );
+         } else if( outtype == HDSTYPE_REAL ) {
+            sscanf( buffer, "%f", ((float *) exp) + n );
+         } else {
+            sscanf( buffer, "%d", ((int *) exp) + n );
+         }
+      }
+   } else {
+      buffer = MEM_MALLOC( nbout + 1 );
+      for( n = 0; n < nval; n++ ) {
+         if( intype == HDSTYPE_DOUBLE ) {
+            nchar = snprintf( buffer, nbout + 1, "%.*G", DBL_DIG,
+                              ((double *) imp)[ n ] );
+         } else if( intype == HDSTYPE_REAL ) {
+            nchar = snprintf( buffer, nbout + 1, "%G", ((float *) imp)[ n ] );
+         } else {
+            nchar = snprintf( buffer, nbout + 1, "%d", ((int *) imp)[ n ] );
+         }
+         if( nchar > nbout ) nchar = nbout;
+         memcpy( outbuf, buffer, nchar );
+         for( i = nchar; i < nbout; i++ ) outbuf[ i ] = ' ';
+         outbuf += nbout;
+      }
+   }
+   MEM_FREE( buffer );
+}
+
+static void benchScope( int *status ) {
+   HDSLoc **locs;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   double tannul;
+   double tscope;
+   double t;
+   int i;
+   int irep;
+
+   if( *status != SAI__OK ) return;
+
+   locs = MEM_CALLOC( NSCOPE, sizeof(*locs) );
+   if( !locs ) {
+      *status = DAT__NOMEM;
+      emsRep( " ", "benchScope: Cannot allocate memory", status );
+      return;
+   }
+
+   benchNewFile( "STRUCT", "STRUCT", 0, NULL, &loc1, NULL, status );
+   datAnnul( &loc1, status );
+
+/* Annul each locator individually, then close the file. */
+   tannul = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      hdsOpen( "hds_bench", "READ", &loc1, status );
+      for( i = 0; i < NSCOPE && *status == SAI__OK; i++ ) {
+         datFind( loc1, "STRUCT", locs + i, status );
+      }
+      t = benchTime();
+      for( i = 0; i < NSCOPE; i++ ) {
+         if( locs[ i ] ) datAnnul( locs + i, status );
+      }
+      datAnnul( &loc1, status );
+      t = benchTime() - t;
+      if( t < tannul ) tannul = t;
+   }
+
+/* Create the locators within a scope and end the scope. */
+   tscope = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      hdsBegin( status );
+      hdsOpen( "hds_bench", "READ", &loc1, status );
+      for( i = 0; i < NSCOPE && *status == SAI__OK; i++ ) {
+         datFind( loc1, "STRUCT", &loc2, status );
+      }
+      t = benchTime();
+      hdsEnd( status );
+      t = benchTime() - t;
+      if( t < tscope ) tscope = t;
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "Release %d secondary locators and close the file; "
+              "time in seconds\n", NSCOPE );
+      printf( "%-20s %10.3f\n", "datAnnul each", tannul );
+      printf( "%-20s %10.3f\n", "hdsEnd", tscope );
+   }
+
+   hdsOpen( "hds_bench", "UPDATE", &loc1, status );
+   hdsErase( &loc1, status );
+   MEM_FREE( locs );
+}
+
+static void benchWalk( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   double tcat;
+   double tfirst;
+   double tnext;
+   double twalk;
+   double twrite;
+   double t;
+   hdsdim dim = 10;
+   int catalogue;
+   int i;
+   int irep;
+   int j;
+   int nobj = 0;
+   int nwalk;
+
+   if( *status != SAI__OK ) return;
+
+/* Create the tree in a file that has a catalogue. */
+   hdsGtune( "CATALOGUE", &catalogue, status );
+   hdsTune( "CATALOGUE", 1, status );
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+   for( i = 0; i < NWALK && *status == SAI__OK; i++ ) {
+      sprintf( name, "S%d", i );
+      datNew( loc1, name, "STRUCT", 0, &dim, status );
+      datFind( loc1, name, &loc2, status );
+      for( j = 0; j < NWALKPRIM && *status == SAI__OK; j++ ) {
+         sprintf( name, "P%d", j );
+         datNew( loc2, name, "_REAL", 1, &dim, status );
+      }
+      datAnnul( &loc2, status );
+   }
+   datAnnul( &loc1, status );
+   hdsTune( "CATALOGUE", catalogue, status );
+
+/* Walk the tree of a newly opened file, and then walk it again. */
+   tcat = 1.0E30;
+   tfirst = 1.0E30;
+   tnext = 1.0E30;
+   twalk = 1.0E30;
+   twrite = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      hdsOpen( "hds_bench", "READ", &loc1, status );
+      nobj = 0;
+      t = benchTime();
+      benchWalkTree( loc1, &nobj, status );
+      t = benchTime() - t;
+      if( t < tfirst ) tfirst = t;
+
+      datClone( loc1, &loc3, status );
+      nobj = 0;
+      t = benchTime();
+      benchWalkTree( loc3, &nobj, status );
+      t = benchTime() - t;
+      if( t < tnext ) tnext = t;
+      datAnnul( &loc3, status );
+      datAnnul( &loc1, status );
+
+/* Walk it using datWalk, which also gets the shape of each object. */
+      hdsOpen( "hds_bench", "READ", &loc1, status );
+      nwalk = 0;
+      t = benchTime();
+      datWalk( loc1, benchWalkFunc, &nwalk, 0, status );
+      t = benchTime() - t;
+      if( t < twalk ) twalk = t;
+      datAnnul( &loc1, status );
+
+/* List it using the catalogue. */
+      hdsOpen( "hds_bench", "READ", &loc1, status );
+      nwalk = 0;
+      t = benchTime();
+      datCatalogue( loc1, benchWalkFunc, &nwalk, 0, status );
+      t = benchTime() - t;
+      if( t < tcat ) tcat = t;
+      datAnnul( &loc1, status );
+
+/* Time closing the file after a change, which writes a new catalogue. */
+      hdsOpen( "hds_bench", "UPDATE", &loc1, status );
+      datNew0I( loc1, "EXTRA", status );
+      datErase( loc1, "EXTRA", status );
+      t = benchTime();
+      datAnnul( &loc1, status );
+      t = benchTime() - t;
+      if( t < twrite ) twrite = t;
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "Walk a tree of %d objects; time in seconds\n", nobj );
+      printf( "%-20s %10.3f\n", "First walk", tfirst );
+      printf( "%-20s %10.3f\n", "Later walk", tnext );
+      printf( "%-20s %10.3f\n", "datWalk", twalk );
+      printf( "%-20s %10.3f\n", "datCatalogue", tcat );
+      printf( "%-20s %10.3f\n", "Write catalogue", twrite );
+   }
+
+   hdsOpen( "hds_bench", "UPDATE", &loc1, status );
+   hdsErase( &loc1, status );
+}
+
+/* Get the name, type and structure-ness of each component of the
+   supplied structure, recursing into any components that are
+   structures. */
+
+static void benchWalkTree( const HDSLoc *loc, int *nobj, int *status ) {
+   HDSLoc *cloc = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char type[ DAT__SZTYP + 1 ];
+   hdsbool_t struc;
+   int i;
+   int ncomp;
+
+   datNcomp( loc, &ncomp, status );
+   for( i = 1; i <= ncomp && *status == SAI__OK; i++ ) {
+      datIndex( loc, i, &cloc, status );
+      datName( cloc, name, status );
+      datType( cloc, type, status );
+      datStruc( cloc, &struc, status );
+      (*nobj)++;
+      if( struc ) benchWalkTree( cloc, nobj, status );
+      datAnnul( &cloc, status );
+   }
+}
+
+/* Count the objects visited by datWalk. */
+
+static int benchWalkFunc( const HDSWalkNode *node, void *data, int *status ) {
+   (*(int *) data)++;
+   return 0;
+}
+
+static void benchIndex( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   double tindex;
+   double titer;
+   double t;
+   hdsdim dim = 0;
+   int i;
+   int irep;
+   int nvisit;
+
+   if( *status != SAI__OK ) return;
+
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+   for( i = 0; i < NINDEX && *status == SAI__OK; i++ ) {
+      sprintf( name, "C%d", i );
+      datNew0I( loc1, name, status );
+   }
+   datAnnul( &loc1, status );
+
+   tindex = 1.0E30;
+   titer = 1.0E30;
+   for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+      hdsOpen( "hds_bench", "READ", &loc1, status );
+
+      t = benchTime();
+      for( i = 1; i <= NINDEX && *status == SAI__OK; i++ ) {
+         datIndex( loc1, i, &loc2, status );
+         datName( loc2, name, status );
+         datAnnul( &loc2, status );
+      }
+      t = benchTime() - t;
+      if( t < tindex ) tindex = t;
+
+      nvisit = 0;
+      t = benchTime();
+      datIterate( loc1, benchIndexFunc, &nvisit, status );
+      t = benchTime() - t;
+      if( t < titer ) titer = t;
+
+      datAnnul( &loc1, status );
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "Get the names of %d components; time in seconds\n", NINDEX );
+      printf( "%-20s %10.3f\n", "datIndex", tindex );
+      printf( "%-20s %10.3f\n", "datIterate", titer );
+   }
+
+   hdsOpen( "hds_bench", "UPDATE", &loc1, status );
+   hdsErase( &loc1, status );
+}
+
+/* Get the name of a component visited by datIterate, and count it. */
+
+static int benchIndexFunc( HDSLoc *comp, void *data, int *status ) {
+   char name[ DAT__SZNAM + 1 ];
+   datName( comp, name, status );
+   (*(int *) data)++;
+   return 0;
+}
+
+static void benchCompact( int *status ) {
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char cval[ 17 ];
+   double tread[ 2 ];
+   double twrite[ 2 ];
+   double t;
+   hdsdim dim = 0;
+   int compact;
+   int i;
+   int irep;
+   int iset;
+   int ival;
+   int j;
+   long nread[ 2 ];
+   long n;
+   off_t fsize[ 2 ];
+   struct stat st;
+
+   if( *status != SAI__OK ) return;
+   hdsGtune( "COMPACT", &compact, status );
+
+/* Use contiguous and then compact storage. */
+   for( iset = 0; iset < 2 && *status == SAI__OK; iset++ ) {
+      hdsTune( "COMPACT", iset ? ( compact ? compact : NCOMPBYTES ) : 0,
+               status );
+      twrite[ iset ] = 1.0E30;
+      tread[ iset ] = 1.0E30;
+      for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+
+/* Create the file. */
+         t = benchTime();
+         hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+         for( i = 0; i < NCOMPSTRUC && *status == SAI__OK; i++ ) {
+            sprintf( name, "S%d", i );
+            datNew( loc1, name, "STRUCT", 0, &dim, status );
+            datFind( loc1, name, &loc2, status );
+            for( j = 0; j < NCOMPPRIM && *status == SAI__OK; j++ ) {
+               sprintf( name, "I%d", j );
+               datNew0I( loc2, name, status );
+               datFind( loc2, name, &loc3, status );
+               datPut0I( loc3, j, status );
+               datAnnul( &loc3, status );
+
+               sprintf( name, "C%d", j );
+               datNew0C( loc2, name, 16, status );
+               datFind( loc2, name, &loc3, status );
+               datPut0C( loc3, "A short string", status );
+               datAnnul( &loc3, status );
+            }
+            datAnnul( &loc2, status );
+         }
+         datAnnul( &loc1, status );
+         t = benchTime() - t;
+         if( t < twrite[ iset ] ) twrite[ iset ] = t;
+         fsize[ iset ] = ( stat( "hds_bench.sdf", &st ) == 0 ) ? st.st_size : 0;
+
+/* Read every value, starting with the file not cached. */
+         benchDropCache( "hds_bench.sdf" );
+         n = benchReadCalls();
+         t = benchTime();
+         hdsOpen( "hds_bench", "READ", &loc1, status );
+         for( i = 0; i < NCOMPSTRUC && *status == SAI__OK; i++ ) {
+            sprintf( name, "S%d", i );
+            datFind( loc1, name, &loc2, status );
+            for( j = 0; j < NCOMPPRIM && *status == SAI__OK; j++ ) {
+               sprintf( name, "I%d", j );
+               datFind( loc2, name, &loc3, status );
+               datGet0I( loc3, &ival, status );
+               datAnnul( &loc3, status );
+
+               sprintf( name, "C%d", j );
+               datFind( loc2, name, &loc3, status );
+               datGet0C( loc3, cval, sizeof( cval ), status );
+               datAnnul( &loc3, status );
+            }
+            datAnnul( &loc2, status );
+         }
+         datAnnul( &loc1, status );
+         t = benchTime() - t;
+         if( t < tread[ iset ] ) tread[ iset ] = t;
+         nread[ iset ] = ( n < 0 ) ? -1 : benchReadCalls() - n;
+
+         hdsOpen( "hds_bench", "UPDATE", &loc1, status );
+         hdsErase( &loc1, status );
+      }
+   }
+   hdsTune( "COMPACT", compact, status );
+
+   if( *status == SAI__OK ) {
+      printf( "%d scalars and strings; file size in kB, time in seconds to "
+              "write and to read when not cached, read calls\n",
+              2*NCOMPSTRUC*NCOMPPRIM );
+      printf( "%-20s %10.0f %10.3f %10.3f %10ld\n", "Contiguous",
+              fsize[ 0 ]/1024.0, twrite[ 0 ], tread[ 0 ], nread[ 0 ] );
+      printf( "%-20s %10.0f %10.3f %10.3f %10ld\n", "Compact",
+              fsize[ 1 ]/1024.0, twrite[ 1 ], tread[ 1 ], nread[ 1 ] );
+   }
+}
+
+/* Write and read arrays of several typical shapes and contents using
+   each of several combinations of chunk filters. */
+
+static void benchCompress( int *status ) {
+   static const char *shapes[] = { "Image", "Cube", "Time series",
+                                   "Quality" };
+   static const char *types[] = { "_REAL", "_REAL", "_INTEGER", "_UBYTE" };
+   static const char *settings[] = { "None", "Deflate 1",
+                                     "Shuffle+deflate 1",
+                                     "Shuffle+deflate 6",
+                                     "Scale-offset+deflate 1" };
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   double t;
+   double tread;
+   double twrite;
+   float *fvals;
+   hdsdim dim = 0;
+   hdsdim dims[ 3 ];
+   int *ivals;
+   int irep;
+   int iset;
+   int ishape;
+   int ndim;
+   size_t el;
+   size_t i;
+   size_t nbytes;
+   struct stat st;
+   unsigned char *bvals;
+   unsigned int seed = 1;
+   void *data;
+   void *rdata;
+   off_t fsize;
+
+   if( *status != SAI__OK ) return;
+
+   data = MEM_MALLOC( NCPRBYTES );
+   rdata = MEM_MALLOC( NCPRBYTES );
+   fvals = data;
+   ivals = data;
+   bvals = data;
+
+   printf( "File size in MB, compression ratio, write and uncached read "
+           "speed in MB/s\n" );
+
+   for( ishape = 0; ishape < 4 && *status == SAI__OK; ishape++ ) {
+
+/* Create the test data. An image and a cube of smooth emission plus
+   noise, a slowly varying integer time series, and a quality array that
+   is mostly zero. */
+      if( ishape == 0 ) {
+         ndim = 2;
+         dims[ 0 ] = 2048;
+         dims[ 1 ] = NCPRBYTES/( 2048*sizeof( float ) );
+      } else if( ishape == 1 ) {
+         ndim = 3;
+         dims[ 0 ] = 128;
+         dims[ 1 ] = 128;
+         dims[ 2 ] = NCPRBYTES/( 128*128*sizeof( float ) );
+      } else if( ishape == 2 ) {
+         ndim = 1;
+         dims[ 0 ] = NCPRBYTES/sizeof( int );
+      } else {
+         ndim = 1;
+         dims[ 0 ] = NCPRBYTES;
+      }
+      el = 1;
+      for( i = 0; i < (size_t) ndim; i++ ) el *= dims[ i ];
+      for( i = 0; i < el; i++ ) {
+         seed = seed*1103515245 + 12345;
+         if( ishape < 2 ) {
+            fvals[ i ] = 100.0 + ( i % 4096 )/64.0 + ( seed >> 16 )/8192.0;
+         } else if( ishape == 2 ) {
+            ivals[ i ] = 50000 + i/1000 + ( seed >> 24 );
+         } else {
+            bvals[ i ] = ( ( seed >> 16 ) % 100 == 0 ) ? 4 : 0;
+         }
+      }
+      nbytes = ( ishape < 3 ) ? 4*el : el;
+
+      for( iset = 0; iset < 5 && *status == SAI__OK; iset++ ) {
+         datInitProps( &props, status );
+         props.deflate = ( iset == 0 ) ? 0 : ( iset == 3 ) ? 6 : 1;
+         props.shuffle = ( iset == 2 || iset == 3 );
+         props.fletcher32 = 0;
+         props.scaleoffset = ( iset == 4 ) ? 2 : 0;
+
+         twrite = 1.0E30;
+         tread = 1.0E30;
+         fsize = 0;
+         for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+
+/* Create and close the file. */
+            t = benchTime();
+            hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1,
+                    status );
+            datNewP( loc1, "DATA", types[ ishape ], ndim, dims, &props,
+                     status );
+            datFind( loc1, "DATA", &loc2, status );
+            datPut( loc2, types[ ishape ], ndim, dims, data, status );
+            datAnnul( &loc2, status );
+            datAnnul( &loc1, status );
+            t = benchTime() - t;
+            if( t < twrite ) twrite = t;
+            fsize = ( stat( "hds_bench.sdf", &st ) == 0 ) ? st.st_size : 0;
+
+/* Read the array, starting with the file not cached. */
+            benchDropCache( "hds_bench.sdf" );
+            t = benchTime();
+            hdsOpen( "hds_bench", "READ", &loc1, status );
+            datFind( loc1, "DATA", &loc2, status );
+            datGet( loc2, types[ ishape ], ndim, dims, rdata, status );
+            datAnnul( &loc2, status );
+            datAnnul( &loc1, status );
+            t = benchTime() - t;
+            if( t < tread ) tread = t;
+
+            hdsOpen( "hds_bench", "UPDATE", &loc1, status );
+            hdsErase( &loc1, status );
+         }
+
+         if( *status == SAI__OK ) {
+            printf( "%-12s %-24s %8.1f %8.2f %8.1f %8.1f\n",
+                    iset ? "" : shapes[ ishape ], settings[ iset ],
+                    fsize/1.0E6, (double) nbytes/fsize,
+                    nbytes/( 1.0E6*twrite ), nbytes/( 1.0E6*tread ) );
+         }
+      }
+   }
+
+   MEM_FREE( data );
+   MEM_FREE( rdata );
+}
+
+/* Write a compressed image using different numbers of threads to
+   compress its chunks. */
+
+static void benchPWrite( int *status ) {
+   static const int nthreads[] = { 1, 2, 4, 8, 16 };
+   static const int levels[] = { 1, 6 };
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   double t;
+   double tone[ 2 ];
+   double twrite;
+   float *fvals;
+   hdsdim dim = 0;
+   hdsdim dims[ 2 ];
+   int ilev;
+   int ithr;
+   int irep;
+   int oldthreads;
+   size_t el;
+   size_t i;
+   unsigned int seed = 1;
+
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 4096;
+   dims[ 1 ] = NPWBYTES/( 4096*sizeof( float ) );
+   el = dims[ 0 ]*dims[ 1 ];
+   fvals = MEM_MALLOC( NPWBYTES );
+   for( i = 0; i < el; i++ ) {
+      seed = seed*1103515245 + 12345;
+      fvals[ i ] = 100.0 + ( i % 4096 )/64.0 + ( seed >> 16 )/8192.0;
+   }
+
+   hdsGtune( "NTHREADS", &oldthreads, status );
+
+   printf( "%ld x %ld _REAL image with shuffle; write speed in MB/s "
+           "and speed-up for each deflate level\n", (long) dims[ 0 ], (long) dims[ 1 ] );
+   printf( "%-10s   Deflate %d        Deflate %d\n", "Threads",
+           levels[ 0 ], levels[ 1 ] );
+
+   for( ithr = 0; ithr < (int)( sizeof(nthreads)/sizeof(nthreads[0]) ) &&
+                  *status == SAI__OK; ithr++ ) {
+      hdsTune( "NTHREADS", nthreads[ ithr ], status );
+      printf( "%-10d", nthreads[ ithr ] );
+
+      for( ilev = 0; ilev < 2 && *status == SAI__OK; ilev++ ) {
+         datInitProps( &props, status );
+         props.deflate = levels[ ilev ];
+         props.shuffle = 1;
+
+         twrite = 1.0E30;
+         for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+            hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1,
+                    status );
+            datNewP( loc1, "DATA", "_REAL", 2, dims, &props, status );
+            datFind( loc1, "DATA", &loc2, status );
+            t = benchTime();
+            datPutR( loc2, 2, dims, fvals, status );
+            datAnnul( &loc2, status );
+            t = benchTime() - t;
+            if( t < twrite ) twrite = t;
+            hdsErase( &loc1, status );
+         }
+
+/* The speed-up is relative to the single-threaded time. */
+         if( ithr == 0 ) tone[ ilev ] = twrite;
+         if( *status == SAI__OK ) {
+            printf( " %8.1f %8.2f", NPWBYTES/( 1.0E6*twrite ),
+                    tone[ ilev ]/twrite );
+         }
+      }
+      printf( "\n" );
+   }
+
+   hdsTune( "NTHREADS", oldthreads, status );
+   MEM_FREE( fvals );
+}
+
+/* Read a compressed image, and a section of it, using different numbers
+   of threads to decompress its chunks. The file is already cached, so
+   this measures the time spent decompressing. */
+
+static void benchPRead( int *status ) {
+   static const int nthreads[] = { 1, 2, 4, 8, 16 };
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   double t;
+   double tone[ 2 ];
+   double tread;
+   float *fvals;
+   hdsdim dim = 0;
+   hdsdim dims[ 2 ];
+   hdsdim lbnd[ 2 ];
+   hdsdim sdims[ 2 ];
+   hdsdim ubnd[ 2 ];
+   int isec;
+   int ithr;
+   int irep;
+   int oldthreads;
+   size_t el;
+   size_t i;
+   size_t nbytes;
+   unsigned int seed = 1;
+
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 4096;
+   dims[ 1 ] = NPWBYTES/( 4096*sizeof( float ) );
+   el = dims[ 0 ]*dims[ 1 ];
+   fvals = MEM_MALLOC( NPWBYTES );
+   for( i = 0; i < el; i++ ) {
+      seed = seed*1103515245 + 12345;
+      fvals[ i ] = 100.0 + ( i % 4096 )/64.0 + ( seed >> 16 )/8192.0;
+   }
+
+/* The section covers the central quarter of the image. */
+   lbnd[ 0 ] = dims[ 0 ]/4 + 1;
+   lbnd[ 1 ] = dims[ 1 ]/4 + 1;
+   ubnd[ 0 ] = 3*dims[ 0 ]/4;
+   ubnd[ 1 ] = 3*dims[ 1 ]/4;
+   sdims[ 0 ] = ubnd[ 0 ] - lbnd[ 0 ] + 1;
+   sdims[ 1 ] = ubnd[ 1 ] - lbnd[ 1 ] + 1;
+
+   hdsGtune( "NTHREADS", &oldthreads, status );
+   hdsTune( "NTHREADS", 1, status );
+
+   datInitProps( &props, status );
+   props.deflate = 1;
+   props.shuffle = 1;
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+   datNewP( loc1, "DATA", "_REAL", 2, dims, &props, status );
+   datFind( loc1, "DATA", &loc2, status );
+   datPutR( loc2, 2, dims, fvals, status );
+   datSlice( loc2, 2, lbnd, ubnd, &loc3, status );
+
+   printf( "%ld x %ld _REAL image with shuffle and deflate 1; read speed "
+           "in MB/s and speed-up\n", (long) dims[ 0 ], (long) dims[ 1 ] );
+   printf( "%-10s   Whole image        Central quarter\n", "Threads" );
+
+   for( ithr = 0; ithr < (int)( sizeof(nthreads)/sizeof(nthreads[0]) ) &&
+                  *status == SAI__OK; ithr++ ) {
+      hdsTune( "NTHREADS", nthreads[ ithr ], status );
+      printf( "%-10d", nthreads[ ithr ] );
+
+      for( isec = 0; isec < 2 && *status == SAI__OK; isec++ ) {
+         tread = 1.0E30;
+         for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+            t = benchTime();
+            if( isec == 0 ) {
+               datGetR( loc2, 2, dims, fvals, status );
+            } else {
+               datGetR( loc3, 2, sdims, fvals, status );
+            }
+            t = benchTime() - t;
+            if( t < tread ) tread = t;
+         }
+
+/* The speed-up is relative to the single-threaded time. */
+         if( ithr == 0 ) tone[ isec ] = tread;
+         nbytes = ( isec == 0 ) ? NPWBYTES : NPWBYTES/4;
+         if( *status == SAI__OK ) {
+            printf( " %8.1f %8.2f", nbytes/( 1.0E6*tread ),
+                    tone[ isec ]/tread );
+         }
+      }
+      printf( "\n" );
+   }
+
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+   hdsTune( "NTHREADS", oldthreads, status );
+   MEM_FREE( fvals );
+}
+
+/* Read a compressed cube one plane at a time. HDF5 chooses the chunk
+   cache for a dataset when it is opened, so the cube is opened afresh
+   for each repetition. The HDF5 default cache is used by opening the
+   cube with H5Dopen2 directly. */
+
+static void benchPlanes( int *status ) {
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   double t;
+   double tread[ 2 ];
+   float *fvals;
+   hdsdim dim = 0;
+   hdsdim dims[ 3 ];
+   hdsdim lbnd[ 3 ];
+   hdsdim pchunk[ 3 ];
+   hdsdim pdims[ 3 ];
+   hdsdim ubnd[ 3 ];
+   hid_t dataset_id;
+   hid_t filespace_id;
+   hid_t memspace_id;
+   hsize_t count[ 3 ];
+   hsize_t start[ 3 ];
+   int imode;
+   int irep;
+   int iz;
+   int oldthreads;
+   size_t el;
+   size_t i;
+   unsigned int seed = 1;
+
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = NPLXY;
+   dims[ 1 ] = NPLXY;
+   dims[ 2 ] = NPLZ;
+   pchunk[ 0 ] = NPLCXY;
+   pchunk[ 1 ] = NPLCXY;
+   pchunk[ 2 ] = NPLCZ;
+   el = NPLXY*NPLXY*NPLZ;
+   fvals = MEM_MALLOC( el*sizeof( float ) );
+   for( i = 0; i < el; i++ ) {
+      seed = seed*1103515245 + 12345;
+      fvals[ i ] = 100.0 + ( i % NPLXY )/64.0 + ( seed >> 16 )/8192.0;
+   }
+
+/* The chunks are decompressed by HDF5 (the planes are read by HDS on a
+   single thread). */
+   hdsGtune( "NTHREADS", &oldthreads, status );
+   hdsTune( "NTHREADS", 1, status );
+
+   datInitProps( &props, status );
+   props.chunk = pchunk;
+   props.deflate = 1;
+   props.shuffle = 1;
+   hdsNew( "hds_bench", "HDS_BENCH", "BENCH", 0, &dim, &loc1, status );
+   datNewP( loc1, "DATA", "_REAL", 3, dims, &props, status );
+   datFind( loc1, "DATA", &loc2, status );
+   datPutR( loc2, 3, dims, fvals, status );
+   datAnnul( &loc2, status );
+
+   pdims[ 0 ] = NPLXY;
+   pdims[ 1 ] = NPLXY;
+   pdims[ 2 ] = 1;
+   start[ 1 ] = 0;
+   start[ 2 ] = 0;
+   count[ 0 ] = 1;
+   count[ 1 ] = NPLXY;
+   count[ 2 ] = NPLXY;
+
+   for( imode = 0; imode < 2 && *status == SAI__OK; imode++ ) {
+      tread[ imode ] = 1.0E30;
+      for( irep = 0; irep < NREP && *status == SAI__OK; irep++ ) {
+         t = benchTime();
+
+         if( imode == 0 ) {
+            dataset_id = H5Dopen2( loc1->group_id, "DATA", H5P_DEFAULT );
+            filespace_id = H5Dget_space( dataset_id );
+            memspace_id = H5Screate_simple( 3, count, NULL );
+            for( iz = 0; iz < NPLZ; iz++ ) {
+               start[ 0 ] = iz;
+               H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, start,
+                                    NULL, count, NULL );
+               if( H5Dread( dataset_id, H5T_NATIVE_FLOAT, memspace_id,
+                            filespace_id, H5P_DEFAULT, fvals ) < 0 ) {
+                  *status = DAT__FATAL;
+                  emsRep( "", "H5Dread failed", status );
+                  break;
+               }
+            }
+            H5Sclose( memspace_id );
+            H5Sclose( filespace_id );
+            H5Dclose( dataset_id );
+
+         } else {
+            datFind( loc1, "DATA", &loc2, status );
+            for( iz = 1; iz <= NPLZ && *status == SAI__OK; iz++ ) {
+               lbnd[ 0 ] = 1;
+               lbnd[ 1 ] = 1;
+               lbnd[ 2 ] = iz;
+               ubnd[ 0 ] = NPLXY;
+               ubnd[ 1 ] = NPLXY;
+               ubnd[ 2 ] = iz;
+               datSlice( loc2, 3, lbnd, ubnd, &loc3, status );
+               datGetR( loc3, 3, pdims, fvals, status );
+               datAnnul( &loc3, status );
+            }
+            datAnnul( &loc2, status );
+         }
+
+         t = benchTime() - t;
+         if( t < tread[ imode ] ) tread[ imode ] = t;
+      }
+   }
+
+   if( *status == SAI__OK ) {
+      printf( "%d x %d x %d _REAL cube in %d x %d x %d chunks with shuffle "
+              "and deflate 1\n", NPLXY, NPLXY, NPLZ, NPLCXY, NPLCXY,
+              NPLCZ );
+      printf( "Read one plane at a time (MB/s):\n" );
+      printf( "   HDF5 default cache:  %8.1f\n",
+              el*sizeof( float )/( 1.0E6*tread[ 0 ] ) );
+      printf( "   HDS sized cache:     %8.1f\n",
+              el*sizeof( float )/( 1.0E6*tread[ 1 ] ) );
+   }
+
+   hdsErase( &loc1, status );
+   hdsTune( "NTHREADS", oldthreads, status );
+   MEM_FREE( fvals );
+}
+
+/* Write two files at the same time, one primitive to each in turn, as a
+   program that writes several output NDFs would. Without reserved space
+   the file system interleaves the space it gives to the two files. The
+   files are written to the disk every 100 primitives, as happens when
+   files are larger than the memory available to cache them. The files
+   are written once only, since the number of extents does not depend on
+   timing noise. */
+
+static void benchLayout( int *status ) {
+   static const char *paths[] = { "hds_bench1.sdf", "hds_bench2.sdf" };
+   HDSLoc *loc1[ 2 ] = { NULL, NULL };
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   double t;
+   float *fvals;
+   hdsdim dim = 0;
+   hdsdim nel;
+   int icomp;
+   int ifile;
+   int imode;
+   int iprim;
+   int istruc;
+   int oldinal;
+   int oldncomp;
+   long extents[ 2 ];
+   size_t i;
+   struct stat buf;
+
+   if( *status != SAI__OK ) return;
+
+   nel = NLAYBYTES/sizeof( float );
+   fvals = MEM_MALLOC( NLAYBYTES );
+   for( i = 0; i < (size_t) nel; i++ ) fvals[ i ] = i;
+
+   hdsGtune( "INAL", &oldinal, status );
+   hdsGtune( "NCOM", &oldncomp, status );
+
+   printf( "Two files of %d _REAL primitives of %d bytes, written "
+           "together\n", NLAYPRIM, NLAYBYTES );
+   printf( "%-28s %10s %10s %10s\n", "", "Time (s)", "Extents 1",
+           "Extents 2" );
+
+   for( imode = 0; imode < 2 && *status == SAI__OK; imode++ ) {
+      hdsTune( "INAL", ( imode == 0 ) ? 0 :
+               (int)( ( 1.1*NLAYPRIM*NLAYBYTES )/512 ), status );
+
+      t = benchTime();
+      for( ifile = 0; ifile < 2; ifile++ ) {
+         hdsNew( paths[ ifile ], "HDS_BENCH", "BENCH", 0, &dim,
+                 &loc1[ ifile ], status );
+      }
+      for( iprim = 0; iprim < NLAYPRIM && *status == SAI__OK; iprim++ ) {
+         sprintf( name, "DATA%d", iprim + 1 );
+         for( ifile = 0; ifile < 2; ifile++ ) {
+            datNew1R( loc1[ ifile ], name, nel, status );
+            datFind( loc1[ ifile ], name, &loc2, status );
+            datPut1R( loc2, nel, fvals, status );
+            datAnnul( &loc2, status );
+            if( iprim % 100 == 99 ) benchDropCache( paths[ ifile ] );
+         }
+      }
+      for( ifile = 0; ifile < 2; ifile++ ) datAnnul( &loc1[ ifile ], status );
+      t = benchTime() - t;
+
+      for( ifile = 0; ifile < 2; ifile++ ) {
+         extents[ ifile ] = benchExtents( paths[ ifile ] );
+         unlink( paths[ ifile ] );
+      }
+      if( *status == SAI__OK ) {
+         printf( "%-28s %10.3f %10ld %10ld\n", ( imode == 0 ) ?
+                 "No reserved space" : "INAL set to 1.1 x final size", t,
+                 extents[ 0 ], extents[ 1 ] );
+      }
+   }
+   hdsTune( "INAL", oldinal, status );
+
+/* A file holding many structures, each with NLAYCOMP scalar
+   components. */
+   printf( "\n%d structures of %d _INTEGER components\n", NLAYSTRUC,
+           NLAYCOMP );
+   printf( "%-28s %10s %10s\n", "", "Time (s)", "Size (kB)" );
+   for( imode = 0; imode < 2 && *status == SAI__OK; imode++ ) {
+      hdsTune( "NCOM", ( imode == 0 ) ? 0 : NLAYCOMP, status );
+
+      t = benchTime();
+      hdsNew( paths[ 0 ], "HDS_BENCH", "BENCH", 0, &dim, &loc1[ 0 ],
+              status );
+      for( istruc = 0; istruc < NLAYSTRUC && *status == SAI__OK; istruc++ ) {
+         sprintf( name, "STRUC%d", istruc + 1 );
+         datNew( loc1[ 0 ], name, "STRUC", 0, &dim, status );
+         datFind( loc1[ 0 ], name, &loc2, status );
+         for( icomp = 0; icomp < NLAYCOMP; icomp++ ) {
+            sprintf( name, "COMP%d", icomp + 1 );
+            datNew0I( loc2, name, status );
+            datFind( loc2, name, &loc3, status );
+            datPut0I( loc3, icomp, status );
+            datAnnul( &loc3, status );
+         }
+         datAnnul( &loc2, status );
+      }
+      datAnnul( &loc1[ 0 ], status );
+      t = benchTime() - t;
+
+      if( *status == SAI__OK && stat( paths[ 0 ], &buf ) == 0 ) {
+         printf( "%-28s %10.3f %10.1f\n", ( imode == 0 ) ?
+                 "NCOM not set" : "NCOM set to 20", t,
+                 buf.st_size/1024.0 );
+      }
+      unlink( paths[ 0 ] );
+   }
+   hdsTune( "NCOM", oldncomp, status );
+
+   MEM_FREE( fvals );
+}
+
+/* Return the number of extents that a file occupies on the disk, or -1
+   if this is not known. */
+
+static long benchExtents( const char *path ) {
+   long result = -1;
+#ifdef FS_IOC_FIEMAP
+   struct fiemap map;
+   int fd = open( path, O_RDONLY );
+   if( fd >= 0 ) {
+      memset( &map, 0, sizeof( map ) );
+      map.fm_length = FIEMAP_MAX_OFFSET;
+      map.fm_flags = FIEMAP_FLAG_SYNC;
+      if( ioctl( fd, FS_IOC_FIEMAP, &map ) == 0 ) {
+         result = map.fm_mapped_extents;
+      }
+      close( fd );
+   }
+#endif
+   return result;
+}
+
+/* Ask the operating system to discard any cached pages of a file, so
+   that the next read has to fetch it from disk. */
+
+static void benchDropCache( const char *path ) {
+   int fd = open( path, O_RDONLY );
+   if( fd >= 0 ) {
+      fsync( fd );
+      posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+      close( fd );
+   }
+}
+
+/* Return the number of read system calls made so far by this process,
+   or -1 if this is not known (it is only available on Linux). */
+
+static long benchReadCalls( void ) {
+   FILE *fd;
+   char line[ 80 ];
+   long result = -1;
+
+   fd = fopen( "/proc/self/io", "r" );
+   if( fd ) {
+      while( fgets( line, sizeof( line ), fd ) ) {
+         if( sscanf( line, "syscr: %ld", &result ) == 1 ) break;
+      }
+      fclose( fd );
+   }
+   return result;
+}
@@ -0,0 +1,156 @@
+/*
+*+
+*  Name:
+*     hdsEnd
+
+*  Purpose:
+*     End the current locator scope
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hdsEnd( int *status );
+
+*  Arguments:
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     int = inherited status on exit. This is for compatibility with the
+*     original HDS API.
+
+*  Description:
+*     End the innermost locator scope started by hdsBegin in the current
+*     thread. All locators created within the scope that have not already
+*     been freed are annulled and freed. This includes locators that have
+*     already been annulled automatically because the last primary locator
+*     for their container file was annulled, but which have not yet been
+*     freed using datAnnul (such locators are otherwise never freed).
+*
+*     Primary locators are annulled first. When the last primary locator
+*     for a container file is annulled, the file is closed and all its
+*     remaining secondary locators are annulled in a single pass, so there
+*     is no need to annul each secondary locator individually.
+
+*  Notes:
+*     - This routine attempts to execute even if status is set on entry,
+*       although no further error report will be made if it subsequently
+*       fails under these circumstances.
+*     - An error is reported if there is no active scope for the current
+*       thread.
+*     - None of the locators created within the scope should be used by
+*       any thread while this function is executing.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Initial version
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+hdsEnd( int *status ) {
+
+/* Local Variables: */
+  HDSLoc **locs;
+  HDSLoc *loc;
+  int i;
+  int nloc;
+
+/* Begin an entirely new error context as we need to run this
+   regardless of external errors */
+  emsBegin( status );
+
+/* End the scope, getting a list of the locators that it owned. */
+  locs = dat1ScopeEnd( &nloc, status );
+
+/* First annul the primary locators that are still registered with a
+   container file. Annulling the last primary locator for a file closes
+   the file, and with it all the remaining secondary locators for the
+   file. Secondary locators annulled in this way stay in the list, but
+   will have a NULL "hdsFile" pointer. */
+  for (i = 0; i < nloc; i++) {
+    loc = locs[ i ];
+    if (loc->isprimary && loc->hdsFile) {
+      datAnnul( &loc, status );
+      locs[ i ] = NULL;
+    }
+  }
+
+/* Now free the remaining locators. Those that have already been annulled
+   need only be freed. Any others are secondary locators for files that
+   are still held open by primary locators outside the scope, and so
+   must be annulled individually. */
+  for (i = 0; i < nloc; i++) {
+    loc = locs[ i ];
+    if (!loc) continue;
+    if (loc->hdsFile) {
+      datAnnul( &loc, status );
+    } else {
+      dat1FreeLoc( loc, status );
+    }
+  }
+
+  if (locs) MEM_FREE( locs );
+
+/* End the error context and return the final status */
+  emsEnd( status );
+
+  return *status;
+}
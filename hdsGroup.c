@@ -102,6 +102,8 @@ hdsGroup(const HDSLoc *locator, char group_str[DAT__SZGRP+1],
   /* Validate input locator. */
   dat1ValidateLocator( "hdsGroup", 1, locator, 1, status );
 
-  one_strlcpy( group_str, locator->grpname, DAT__SZGRP+1, status );
+  if (locator->grpname) {
+    one_strlcpy( group_str, locator->grpname, DAT__SZGRP+1, status );
+  }
   return *status;
 }
@@ -29,6 +29,11 @@
 *        - FILES : Return the number of open files
 *        - VERSION : Return the HDS implementation version number for the
 *                    supplied HDS locator.
+*        - CACHEHITS : Return the number of object metadata queries
+*                      (type, name, structure dimensions) answered from
+*                      the cache held for each object.
+*        - CACHEMISSES : Return the number of object metadata queries
+*                        that had to be answered by reading the file.
 *     extra = const char * (Given)
 *        Extra options to control behaviour. The content depends on
 *        the particular TOPIC. See NOTES for more information.
@@ -47,6 +52,7 @@
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     DSB:  David S Berry (EAO):
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -73,6 +79,8 @@
 *        Initial version
 *     2017-05-16 (DSB):
 *        Add topic VERSION.
+*     2026-10-16 (AGENT):
+*        Add topics CACHEHITS and CACHEMISSES.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -118,6 +126,7 @@
 
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 #include "ems.h"
 #include "sae_par.h"
@@ -139,6 +148,14 @@ hdsInfoI(const HDSLoc* loc, const char *topic_str, const char *extra,
 
   if (strncasecmp(topic_str, "VERSION", 7) == 0) {
     *result = loc->hds_version;
+  } else if (strncasecmp(topic_str, "CACHEH", 6) == 0 ||
+             strncasecmp(topic_str, "CACHEM", 6) == 0 ) {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t count;
+    dat1MetaStats( &hits, &misses );
+    count = ( topic_str[5] == 'H' || topic_str[5] == 'h' ) ? hits : misses;
+    *result = ( count > INT_MAX ) ? INT_MAX : (int) count;
   } else if (strncasecmp(topic_str, "FIL", 3) == 0) {
     *result = hds1CountFiles();
   } else if (strncasecmp(topic_str, "ALOC", 4) == 0 ||
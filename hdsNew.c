@@ -46,11 +46,14 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
 *     - A file extension of DAT__FLEXT (".h5sdf") is the default.
 *     - HDF5 file opened with mode H5F_ACC_TRUNC.
+*     - If the INAL tuning parameter is non-zero, that many 512-byte blocks
+*     of disk space are reserved for the new file (see hdsTune).
 *     - HDF5 does not know how to create arrays of structures. When the HDS layer is asked
 *     to create a structure array a group (in the HDF5 sense) is created of that name
 *     with the string "_STRUCTURE_ARRAY" appended. Inside this group further groups are
@@ -61,6 +64,13 @@
 *  History:
 *     2014-08-15 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Use dat1FileAccessPlist to get the file access properties.
+*     2026-10-16 (AGENT):
+*        Create the root group so that it indexes the creation order of its links.
+*     2026-10-16 (AGENT):
+*        Reserve disk space for the new file if the INAL tuning parameter
+*        is set.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -104,6 +114,8 @@
 *-
 */
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -134,7 +146,12 @@ hdsNew(const char *file_str,
   hsize_t h5dims[DAT__MXDIM];
   HDSLoc * thisloc = NULL;
   hid_t h5type = 0;
+  hid_t fapl = H5P_DEFAULT;
+  hid_t fcpl = H5P_DEFAULT;
   char *fname = NULL;
+  int *fd = NULL;
+  int inal;
+  int err;
 
   /* Returns the inherited status for compatibility reasons */
   if (*status != SAI__OK) return *status;
@@ -164,13 +181,43 @@ hdsNew(const char *file_str,
   fname = dau1CheckFileName( file_str, status );
 
   /* Create the HDF5 file */
+  fapl = dat1FileAccessPlist( H5F_ACC_TRUNC, status );
+  fcpl = dat1GroupCreatePlist( HDS_TRUE, status );
   CALLHDFE( hid_t, file_id,
             H5Fcreate( fname, H5F_ACC_TRUNC,
-                       H5P_DEFAULT, H5P_DEFAULT ),
+                       fcpl, fapl ),
             DAT__FILCR,
             emsRepf("hdsNew","Error creating file '%s'", status, fname )
             );
 
+  /* Reserve the initial allocation of disk space for the file (see the
+     INAL tuning parameter), so that the file system can give it a few
+     large extents. HDF5 releases any space that has not been used when
+     the file is closed. File systems that can not reserve space are not
+     an error. */
+  inal = hds1GetInal();
+  if (inal > 0) {
+    CALLHDF( err,
+              H5Fget_vfd_handle( file_id, fapl, (void **) &fd ),
+              DAT__FILCR,
+              emsRepf("hdsNew_inal1", "Error getting the file descriptor "
+                      "for file '%s'", status, fname )
+              );
+    err = posix_fallocate( *fd, 0, (off_t) inal * HDS__BLOCKSIZE );
+    if (err != 0 && err != EINVAL && err != EOPNOTSUPP) {
+      *status = DAT__FILCR;
+      emsSyser( "MESSAGE", err );
+      emsRepf("hdsNew_inal2", "Error allocating %d blocks of disk space "
+              "for file '%s': ^MESSAGE", status, inal, fname );
+      goto CLEANUP;
+    }
+  }
+
+  if (fapl != H5P_DEFAULT) H5Pclose( fapl );
+  fapl = H5P_DEFAULT;
+  if (fcpl != H5P_DEFAULT) H5Pclose( fcpl );
+  fcpl = H5P_DEFAULT;
+
   /* Create the top-level structure/primitive */
   if (*status == SAI__OK) {
     HDSLoc *tmploc = dat1AllocLoc( status );
@@ -187,7 +234,8 @@ hdsNew(const char *file_str,
 
       /* We use dat1New instead of datNew so that we do not have to follow
          up immediately with a datFind */
-      thisloc = dat1New( tmploc, 1, name_str, type_str, ndim, dims, status );
+      thisloc = dat1New( tmploc, 1, name_str, type_str, ndim, dims, NULL,
+                         status );
 
       /* Annul the temporary locator. The file will not close if
          we still have a primary from the dat1New */
@@ -210,6 +258,8 @@ hdsNew(const char *file_str,
   }
   if (*status != SAI__OK) unlink(fname);
   if (file_id > 0) H5Fclose(file_id);
+  if (fapl != H5P_DEFAULT) H5Pclose(fapl);
+  if (fcpl != H5P_DEFAULT) H5Pclose(fcpl);
   if (fname) MEM_FREE(fname);
 
   return *status;
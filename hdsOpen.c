@@ -32,6 +32,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -72,6 +73,14 @@
 *        If a file is to be opened in read mode that has already been opened in
 *        read-write mode, then the lock on the file should be left as read-write
 *        and not changed to read-only.
+*     2026-10-16 (AGENT):
+*        Use dat1FileAccessPlist to get the file access properties.
+*     2026-10-16 (AGENT):
+*        Find the top-level Handle using the HdsFile stored in the locator
+*        rather than looking up the file path again.
+*     2026-10-16 (AGENT):
+*        If the file is already open, re-use its HDF5 file identifier instead
+*        of opening it again.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -135,9 +144,12 @@ hdsOpen( const char *file_str, const char *mode_str,
   HDSLoc *temploc = NULL;
   Handle *error_handle = NULL;
   Handle *handle = NULL;
+  HdsFile *hdsFile = NULL;
   char * fname = NULL;
   hid_t file_id = 0;
+  hid_t shared_id = 0;
   hid_t group_id = 0;
+  hid_t fapl = H5P_DEFAULT;
   htri_t filstat = 0;
   unsigned int flags = 0;
   int rdonly = 0;
@@ -170,25 +182,35 @@ hdsOpen( const char *file_str, const char *mode_str,
 
   /* work out the file name */
   fname = dau1CheckFileName( file_str, status );
-
-  /* Before we go any further, check that the file really is an HDF5
-     file. If it isn't then we return with a special error code that
-     allows the putative wrapper library to know to fall back to HDSv4
-     or whatever. */
   if (*status != SAI__OK) goto CLEANUP;
-  filstat = H5Fis_hdf5( fname );
-  if (filstat < 0) {
-    /* Probably indicates the file is not there */
-    *status = DAT__FILNF;
-    emsRepf("hdsOpen_fnf", "File '%s' does not seem to exist",
-           status, fname);
-    goto CLEANUP;
-  }
 
-  /* Open the HDF5 file. First check status is good so we can tell if the
-    file open has failed.  */
-  if( *status == SAI__OK ) {
-     file_id = H5Fopen( fname, flags, H5P_DEFAULT );
+  /* If the file is already open with suitable access (possibly via a
+     different path), re-use the existing HDF5 file identifier rather
+     than opening the file again. The identifier remains owned by the
+     locators that are already using it. */
+  shared_id = hds1FindFileId( fname, flags, &hdsFile, status );
+  if( shared_id > 0 ) {
+    file_id = shared_id;
+
+  } else {
+    /* Before we go any further, check that the file really is an HDF5
+       file. If it isn't then we return with a special error code that
+       allows the putative wrapper library to know to fall back to HDSv4
+       or whatever. */
+    filstat = H5Fis_hdf5( fname );
+    if (filstat < 0) {
+      /* Probably indicates the file is not there */
+      *status = DAT__FILNF;
+      emsRepf("hdsOpen_fnf", "File '%s' does not seem to exist",
+             status, fname);
+      goto CLEANUP;
+    }
+
+    /* Open the HDF5 file. First check status is good so we can tell if the
+      file open has failed.  */
+    fapl = dat1FileAccessPlist( flags, status );
+    if( *status == SAI__OK ) {
+       file_id = H5Fopen( fname, flags, fapl );
 
 /* If the file could not be opened, and we are attempting to open it in
    UPDATE or WRITE mode, the error may be caused by it already being open
@@ -197,22 +219,23 @@ hdsOpen( const char *file_str, const char *mode_str,
    previously been opened read-only, although the second open may fail
    if the file is write-protected. Some starlink apps rely on this
    behaviour]. */
-     if( file_id < 0 && !rdonly ) {
-        file_id = H5Fopen( fname, H5F_ACC_RDONLY, H5P_DEFAULT );
+       if( file_id < 0 && !rdonly ) {
+          file_id = H5Fopen( fname, H5F_ACC_RDONLY, H5P_DEFAULT );
 
 /* If the file was opened successfully in READ mode, we need to
    close the file and then re-open it in the requested mode, re-establishing
    all the active locators associated with the file. */
-        if( file_id > 0 ) {
-           file_id = dat1Reopen( file_id, flags, H5P_DEFAULT, status );
-        } else {
-           *status = DAT__HDF5E;
-           dat1H5EtoEMS( status );
-           emsRepf( "hdsOpen_1", "Error opening HDS file: %s",
-                    status, fname );
-           goto CLEANUP;
-        }
-     }
+          if( file_id > 0 ) {
+             file_id = dat1Reopen( file_id, flags, fapl, status );
+          } else {
+             *status = DAT__HDF5E;
+             dat1H5EtoEMS( status );
+             emsRepf( "hdsOpen_1", "Error opening HDS file: %s",
+                      status, fname );
+             goto CLEANUP;
+          }
+       }
+    }
   }
 
   /* Now we need to find a top-level object. This will usually simply
@@ -241,8 +264,9 @@ hdsOpen( const char *file_str, const char *mode_str,
       file_id = 0; /* now owned by the locator system */
       temploc->isprimary = HDS_TRUE;
       temploc->group_id = group_id;
+      temploc->hdsFile = hdsFile;
       hds1RegLocator( temploc, status );
-      handle = hds1FindHandle( temploc->file_id, status );
+      handle = hds1FindHandle( temploc->hdsFile, status );
     }
     datFind( temploc, primname, locator, status );
 
@@ -257,8 +281,9 @@ hdsOpen( const char *file_str, const char *mode_str,
       temploc->file_id = file_id;
       group_id = file_id = 0; /* now owned by the locator system */
       temploc->isprimary = HDS_TRUE;
+      temploc->hdsFile = hdsFile;
       hds1RegLocator( temploc, status );
-      handle = hds1FindHandle( temploc->file_id, status );
+      handle = hds1FindHandle( temploc->hdsFile, status );
     }
     if (*status == SAI__OK) {
       /* Assign this locator to the caller */
@@ -312,6 +337,7 @@ hdsOpen( const char *file_str, const char *mode_str,
 
  CLEANUP:
   if (fname) MEM_FREE(fname);
+  if (fapl != H5P_DEFAULT) H5Pclose(fapl);
 
   /* Free the temporary which will close the parent group */
   if (temploc) datAnnul(&temploc, status );
@@ -323,7 +349,7 @@ hdsOpen( const char *file_str, const char *mode_str,
         datAnnul( locator, status );
     }
 
-    if (file_id > 0) H5Fclose( file_id );
+    if (file_id > 0 && file_id != shared_id) H5Fclose( file_id );
   }
 
   return *status;
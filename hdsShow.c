@@ -26,10 +26,13 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
 *     The following topics are supported:
+*     - DATA: List every object in each open container file (see
+*       datCatalogue).
 *     - FILES: List all open file objects.
 *     - LOCATORS: List all open primitives and structure locators.
 
@@ -38,6 +41,10 @@
 *        Initial version
 *     2014-11-07 (TIMJ):
 *        Add preliminary support for FILES and LOCATORS.
+*     2026-10-16 (AGENT):
+*        Add support for DATA, using datWalk.
+*     2026-10-16 (AGENT):
+*        Use datCatalogue for DATA.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -82,6 +89,7 @@
 */
 
 #include <string.h>
+#include <unistd.h>
 
 #include "hdf5.h"
 
@@ -94,6 +102,8 @@
 
 #include "dat_err.h"
 
+static int hdsShowNode( const HDSWalkNode *node, void *data, int *status );
+
 int
 hdsShow(const char *topic_str, int  *status) {
 
@@ -102,9 +112,31 @@ hdsShow(const char *topic_str, int  *status) {
   if (*status != SAI__OK) return *status;
 
   if (strncasecmp( topic_str, "DAT", 3 ) == 0) {
-    *status = DAT__FATAL;
-    emsRep("hdsShow", "hdsShow: DATA reporting not yet implemented for HDF5",
-           status);
+    HDSLoc *loc = NULL;
+    char **paths = NULL;
+    int npath = 0;
+    int i;
+
+    /* Get a new locator for the top-level object in each registered
+       file, and list everything below it. The paths are copied first
+       since opening a file updates the registry. Scratch files created
+       by datTemp are deleted as soon as they are created, and so cannot
+       be re-opened. */
+    paths = hds1GetPaths( &npath, status );
+    printf("hdsShow: %d open container file%s\n", npath,
+           (npath == 1 ? "" : "s"));
+    for (i = 0; i < npath && *status == SAI__OK; i++) {
+      printf("File: %s\n", paths[i]);
+      if (access( paths[i], F_OK ) != 0) {
+        printf("   (deleted scratch file - not listed)\n");
+        continue;
+      }
+      hdsOpen( paths[i], "READ", &loc, status );
+      datCatalogue( loc, hdsShowNode, NULL, HDS_WALK_STATE, status );
+      datAnnul( &loc, status );
+    }
+    if (paths) MEM_FREE(paths);
+
   } else if (strncasecmp( topic_str, "FIL", 3 ) == 0 ||
              strncasecmp( topic_str, "LOC", 3 ) == 0 ) {
     hid_t *obj_id_list = NULL;
@@ -220,3 +252,22 @@ hdsShow(const char *topic_str, int  *status) {
   if (obj_id_list) MEM_FREE(obj_id_list);
   return *status;
 }
+
+/* Print one line describing an object visited by datCatalogue. */
+
+static int hdsShowNode( const HDSWalkNode *node, void *data, int *status ) {
+  int i;
+
+  printf("   %*s%s", 3*node->level, "", node->name );
+  if (node->ndim > 0) {
+    printf("(");
+    for (i = 0; i < node->ndim; i++) {
+      printf("%s%" HDS_DIM_FORMAT, (i ? "," : ""), node->dims[i] );
+    }
+    printf(")");
+  }
+  printf("  <%s>%s\n", node->type,
+         ((node->isstruc || node->state) ? "" : "  {undefined}") );
+
+  return 0;
+}
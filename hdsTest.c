@@ -68,6 +68,8 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 static void traceme (const HDSLoc * loc, const char * expected, int explev,
                      int *status);
@@ -77,6 +79,29 @@ static void cmpprec ( const HDSLoc * loc1, const char * name, int * status );
 static void cmpintarr( size_t nelem, const int result[],
                        const int expected[], int *status );
 static void testSliceVec( int *status );
+static void testMapUpdate( int *status );
+static void testConvert( int *status );
+static void testNewFile( const char *path, const char *name, int ndim,
+                         const hdsdim dims[], HDSLoc **top, HDSLoc **recs,
+                         int *status );
+static void testStructCells( int *status );
+static void testMetaCache( int *status );
+static void testDeepLock( int *status );
+static void testFileKey( int *status );
+static void testScope( int *status );
+static void testDeferred( int *status );
+static void testIterate( int *status );
+static int testIterateFunc( HDSLoc *comp, void *data, int *status );
+static void testWalk( int *status );
+static int testWalkFunc( const HDSWalkNode *node, void *data, int *status );
+static void testCatalogue( int *status );
+static void testCompact( int *status );
+static void testCompress( int *status );
+static void testChunkWrite( int *status );
+static void testChunkRead( int *status );
+static void testChunkCache( int *status );
+static void testFileLayout( int *status );
+static void *test1DeepLock( void *data );
 static void testThreadSafety( const char *path, int *status );
 static void *test1ThreadSafety( void *data );
 static void *test2ThreadSafety( void *data );
@@ -91,6 +116,7 @@ typedef struct threadData {
    int rdonly;
    int id;
    int status;
+   int stage;
    const char *path;
 } threadData;
 
@@ -782,6 +808,57 @@ int main (void) {
 /* Test thread safety */
   testThreadSafety( path, &status );
 
+/* Test mapping directly onto a file opened for update */
+  testMapUpdate( &status );
+
+/* Test numeric type conversion */
+  testConvert( &status );
+
+/* Test lazy creation of structure array cells */
+  testStructCells( &status );
+
+/* Test caching of object metadata */
+  testMetaCache( &status );
+
+/* Test recursive locking of a tree of objects */
+  testDeepLock( &status );
+
+/* Test a file opened through different paths is only opened once */
+  testFileKey( &status );
+
+/* Test locators are annulled and freed at the end of a scope */
+  testScope( &status );
+
+/* Test HDF5 objects are only opened when needed */
+  testDeferred( &status );
+
+/* Test components are indexed and iterated in order of creation */
+  testIterate( &status );
+
+/* Test every object in a hierarchy is visited by datWalk */
+  testWalk( &status );
+
+/* Test objects are listed from the catalogue stored in a file */
+  testCatalogue( &status );
+
+/* Test small primitives stored with a compact layout */
+  testCompact( &status );
+
+/* Test primitives stored in compressed chunks */
+  testCompress( &status );
+
+/* Test compressed chunks written on several threads */
+  testChunkWrite( &status );
+
+/* Test compressed chunks read on several threads */
+  testChunkRead( &status );
+
+/* Test the size of the chunk caches */
+  testChunkCache( &status );
+
+/* Test the space allocated for new files and structures */
+  testFileLayout( &status );
+
   if (status == SAI__OK) {
     printf("HDS C installation test succeeded\n");
     emsEnd(&status);
@@ -1014,579 +1091,3176 @@ static  void testSliceVec( int *status ){
 
 
 
-static void testThreadSafety( const char *path, int *status ) {
-
-/* Local Variables; */
+static void testMapUpdate( int *status ){
    HDSLoc *loc1 = NULL;
-   HDSLoc *loc1b = NULL;
    HDSLoc *loc2 = NULL;
    HDSLoc *loc3 = NULL;
    HDSLoc *loc4 = NULL;
-   HDSLoc *loc4b = NULL;
    hdsdim dims[2];
+   hdsdim subs[2];
+   hdsbool_t defined;
+   size_t nel;
+   size_t i;
+   int *ip;
+   int *outvals = NULL;
+   int deflate;
+   int fletcher32;
    int ival;
-   pthread_t t1, t2;
-   threadData threaddata1;
-   threadData threaddata2;
-   double *ip1;
-   double *ip2;
-   hdsdim dim;
-   hdsdim i;
-   char typestr[DAT__SZTYP+1];
+   int mapupdate;
+   int scaleoffset;
+   int shuffle;
 
 /* Check inherited status */
    if( *status != SAI__OK ) return;
 
-/* Open the HDS file created by the initial testing above. */
-   hdsOpen( path, "Read", &loc1, status );
-
-/* Get a locator for component "HDS_TEST.RECORDS(3,2).INTINCELL" */
-   datFind( loc1, "Records", &loc2, status );
-   dims[0] = 3;
-   dims[1] = 2;
-   datCell( loc2, 2, dims, &loc3, status );
-   datAnnul( &loc2, status );
-   datFind( loc3, "IntInCell", &loc4, status );
-   datAnnul( &loc3, status );
-
-/* Check it has the value -999 (assiged when it was created). */
-   datGet0I( loc4, &ival, status );
-   if( ival != -999 && *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRepf("", "testThreadSafety error 1: Got %d but expected -999", status,
-              ival );
-   }
-
-/* Check the top level object is locked for read-only access by the current
-   thread. */
-   ival = datLocked( loc1, 0, status );
-   if( ival != 3 && *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 101: Top-level object not "
-              "locked by current thread.",  status );
-   }
-
-/* Check the bottom level object is also locked by the current thread. */
-   ival = datLocked( loc4, 1, status );
-   if( ival != 3 && *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 102: Bottom-level object not "
-              "locked by current thread.",  status );
-   }
-
-/* Open the HDS file again. Note we have not yet closed it, so it is now
-   open twice. */
-   hdsOpen( path, "Read", &loc1b, status );
-
-/* Get a locator for the same component as before. */
-   datFind( loc1b, "Records", &loc2, status );
-   dims[0] = 3;
-   dims[1] = 2;
-   datCell( loc2, 2, dims, &loc3, status );
-   datAnnul( &loc2, status );
-   datFind( loc3, "IntInCell", &loc4b, status );
-   datAnnul( &loc3, status );
-
-/* Check it has the value -999. */
-   datGet0I( loc4b, &ival, status );
-   if( ival != -999 && *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRepf("", "testThreadSafety error 2: Got %d but expected -999", status,
-              ival );
+/* Chunked primitives can not be mapped from the file, so ensure that the
+   tuning parameters do not select any filters. */
+   hdsGtune( "DEFLATE", &deflate, status );
+   hdsGtune( "SHUFFLE", &shuffle, status );
+   hdsGtune( "FLETCHER32", &fletcher32, status );
+   hdsGtune( "SCALEOFFSET", &scaleoffset, status );
+   hdsTune( "DEFLATE", 0, status );
+   hdsTune( "SHUFFLE", 0, status );
+   hdsTune( "FLETCHER32", 0, status );
+   hdsTune( "SCALEOFFSET", 0, status );
+
+/* Files opened for writing are only mapped directly if MAPUPDATE is
+   set. */
+   hdsGtune( "MAPUPDATE", &mapupdate, status );
+   hdsTune( "MAPUPDATE", 1, status );
+
+/* Create a new file holding a 2-dimensional array. */
+   dims[0] = 300;
+   dims[1] = 200;
+   nel = dims[0]*dims[1];
+   hdsNew( "hds_mtest", "HDS_MTEST", "TEST", 0, dims, &loc1, status );
+   datNew( loc1, "DATA", "_INTEGER", 2, dims, status );
+   datFind( loc1, "DATA", &loc2, status );
+
+/* Map it for WRITE access. The file is open for update so the data
+   should be mapped directly from the file. */
+   datMapI( loc2, "WRITE", 2, dims, &ip, status );
+   if( *status == SAI__OK ) {
+      if( hds1GetUseMmap() && !loc2->map->uses_true_mmap ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testMapUpdate error 1: WRITE mode did not map the file",
+                 status );
+      } else {
+         for( i = 0; i < nel; i++ ) ip[ i ] = i;
+      }
    }
+   datUnmap( loc2, status );
 
-/* Check the top level object is locked by the current thread. */
-   ival = datLocked( loc1b, 0, status );
-   if( ival != 3 && *status == SAI__OK ) {
+   datState( loc2, &defined, status );
+   if( !defined && *status == SAI__OK ) {
       *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 201: Top-level object not "
-              "locked by current thread.",  status );
+      emsRep( "", "testMapUpdate error 2: Array not defined after WRITE "
+              "mapping", status );
    }
 
-/* Check the bottom level object is also locked by the current thread. */
-   ival = datLocked( loc4b, 1, status );
-   if( ival != 3 && *status == SAI__OK ) {
+/* Read one element through HDF5 before mapping again, so that HDF5 has a
+   copy of some of the data in its own buffers. */
+   subs[0] = 10;
+   subs[1] = 2;
+   datCell( loc2, 2, subs, &loc3, status );
+   datGet0I( loc3, &ival, status );
+   if( ival != 309 && *status == SAI__OK ) {
       *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 202: Bottom-level object not "
-              "locked by current thread.",  status );
+      emsRepf( "", "testMapUpdate error 3: Got %d but expected 309", status,
+               ival );
    }
 
-/* Promote the lock to a read/write lock using the first locator. */
-   datLock( loc1, 1, 0, status );
-
-/* Check the other locator now also has a read/write lock. */
-   ival = datLocked( loc1b, 0, status );
-   if( ival != 1 && *status == SAI__OK ) {
+/* Map for UPDATE and negate every element. */
+   datMapI( loc2, "UPDATE", 2, dims, &ip, status );
+   if( *status == SAI__OK && hds1GetUseMmap() && !loc2->map->uses_true_mmap ) {
       *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 2021: Top-level object not "
-              "locked by current thread.",  status );
+      emsRep( "", "testMapUpdate error 8: UPDATE mode did not map the file",
+              status );
    }
-
-/* Required for use of EMS within threads. */
-   emsMark();
-
-/* Create two threads, and pass a locator for the top-level object to each.
-   Note, these locators are still locked for read/write by the current thread,
-   so we should get DAT__THREAD errors when test1ThreadSafety tries to use
-   them. */
    if( *status == SAI__OK ) {
-      threaddata1.loc = loc1;
-      pthread_create( &t1, NULL, test1ThreadSafety, &threaddata1 );
-      threaddata2.loc = loc1b;
-      pthread_create( &t2, NULL, test1ThreadSafety, &threaddata2 );
-
-/* Wait for them to terminate. */
-      pthread_join( t1, NULL );
-      pthread_join( t2, NULL );
-      emsStat( status );
+      for( i = 0; i < nel; i++ ) {
+         if( ip[ i ] != (int) i ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 4: Got %d but expected %d",
+                     status, ip[ i ], (int) i );
+            break;
+         }
+         ip[ i ] = -ip[ i ];
+      }
    }
+   datUnmap( loc2, status );
 
-/* Unlock the top level object using the first locator. Then check that
-   it is also unlocked using the second locator. */
-   datUnlock( loc1, 0, status );
-   ival = datLocked( loc1b, 0, status );
-   if( ival != 0 && *status == SAI__OK ) {
+/* Check the new values can be read through HDF5. */
+   datGet0I( loc3, &ival, status );
+   if( ival != -309 && *status == SAI__OK ) {
       *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 203: Top-level object still "
-              "locked.",  status );
+      emsRepf( "", "testMapUpdate error 5: Got %d but expected -309", status,
+               ival );
    }
+   datAnnul( &loc3, status );
 
-/* The above unlock was non-recursive so check the bottom of the tree is
-   still locked. */
-   if( !datLocked( loc4b, 1, status ) && *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 204: Bottom-level object not "
-              "locked.",  status );
+   outvals = MEM_MALLOC( nel*sizeof(*outvals) );
+   datGetI( loc2, 2, dims, outvals, status );
+   for( i = 0; i < nel && *status == SAI__OK; i++ ) {
+      if( outvals[ i ] != -(int) i ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testMapUpdate error 6: Got %d but expected %d",
+                  status, outvals[ i ], -(int) i );
+      }
    }
+   datAnnul( &loc2, status );
+   datAnnul( &loc1, status );
 
-/* Now lock it again and then unlock the top recursively. Then check the
-   bottom is no longer locked. */
-   datLock( loc1b, 1, 1, status );
-   datUnlock( loc1b, 1, status );
-   if( datLocked( loc4, 1, status ) && *status == SAI__OK ) {
-      *status = DAT__FATAL;
-      emsRep( "", "testThreadSafety error 206: Bottom-level object still "
-              "locked.",  status );
+/* Re-open the file read-only and check the values made it to disk. The
+   locators used above have all been annulled, so nothing more is done
+   if an error has occurred. */
+   if( *status == SAI__OK ) {
+      hdsOpen( "hds_mtest", "READ", &loc1, status );
+      datFind( loc1, "DATA", &loc2, status );
+      datMapI( loc2, "READ", 2, dims, &ip, status );
+      for( i = 0; i < nel && *status == SAI__OK; i++ ) {
+         if( ip[ i ] != -(int) i ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 7: Got %d but expected %d",
+                     status, ip[ i ], -(int) i );
+         }
+      }
+      datUnmap( loc2, status );
+      datAnnul( &loc2, status );
+      hdsErase( &loc1, status );
    }
 
-/* Attempt to access the two top-level objects in two separate threads.
-   Each thread attempt to lock the object read/write, but only one can
-   win (assuming that the second thread starts up before the first thread
-   has finished and unlocked the object).
-   The other should report an error. */
+/* Create a cube and check that a single plane of it, and a vectorised
+   sub-range, can be mapped directly from the file. */
    if( *status == SAI__OK ) {
-      threaddata1.id = 1;
-      threaddata1.rdonly = 0;
-      threaddata1.loc = loc1;
-      pthread_create( &t1, NULL, test2ThreadSafety, &threaddata1 );
-      threaddata2.id = 2;
-      threaddata2.rdonly = 0;
-      threaddata2.loc = loc1b;
-      pthread_create( &t2, NULL, test2ThreadSafety, &threaddata2 );
-
-/* Wait for them to terminate. */
-      pthread_join( t1, NULL );
-      pthread_join( t2, NULL );
-      emsStat( status );
+      hdsdim cdims[3] = { 20, 10, 5 };
+      hdsdim lo[3] = { 1, 1, 3 };
+      hdsdim hi[3] = { 20, 10, 3 };
+      hdsdim vlo = 41;
+      hdsdim vhi = 160;
+      hdsdim pdims[3] = { 20, 10, 1 };
+      size_t nplane = cdims[0]*cdims[1];
+
+      nel = nplane*cdims[2];
+      hdsNew( "hds_mtest", "HDS_MTEST", "TEST", 0, cdims, &loc1, status );
+      datNew( loc1, "CUBE", "_INTEGER", 3, cdims, status );
+      datFind( loc1, "CUBE", &loc2, status );
+      datMapI( loc2, "WRITE", 3, cdims, &ip, status );
+      if( *status == SAI__OK ) {
+         for( i = 0; i < nel; i++ ) ip[ i ] = i;
+      }
+      datUnmap( loc2, status );
 
-/* Sanity check: if either of the threads failed, check that the status
-   value reflects this. */
-      if( threaddata1.status != SAI__OK || threaddata2.status != SAI__OK ) {
-         if( *status == SAI__OK ) {
+/* Map the third plane for update and increment it. */
+      datSlice( loc2, 3, lo, hi, &loc3, status );
+      datMapI( loc3, "UPDATE", 3, pdims, &ip, status );
+      if( *status == SAI__OK && hds1GetUseMmap() &&
+          !loc3->map->uses_true_mmap ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testMapUpdate error 9: Plane was not mapped from "
+                 "the file", status );
+      }
+      for( i = 0; i < nplane && *status == SAI__OK; i++ ) {
+         if( ip[ i ] != (int)( i + 2*nplane ) ) {
             *status = DAT__FATAL;
-            emsRepf( "", "ems failed to detect an error that occurred "
-                     "within a thread (test2, error code %d or %d)", status,
-                     threaddata1.status, threaddata2.status );
+            emsRepf( "", "testMapUpdate error 10: Got %d but expected %d",
+                     status, ip[ i ], (int)( i + 2*nplane ) );
          }
+         ip[ i ] += 1000000;
       }
-
-/* Check one, and only one, failed. */
-      if( threaddata1.failed + threaddata2.failed != 1 && *status == SAI__OK ) {
+      datUnmap( loc3, status );
+      datAnnul( &loc3, status );
+
+/* A slice that is not contiguous must still work, via a copy. */
+      lo[0] = 2;
+      hi[0] = 5;
+      pdims[0] = 4;
+      datSlice( loc2, 3, lo, hi, &loc3, status );
+      datMapI( loc3, "READ", 3, pdims, &ip, status );
+      if( *status == SAI__OK && loc3->map->uses_true_mmap ) {
          *status = DAT__FATAL;
-         emsRepf( "", "testThreadSafety error 205: %d read-write lock attempts "
-                  "failed - expected exactly 1 to fail.",  status,
-                  threaddata1.failed + threaddata2.failed );
+         emsRep( "", "testMapUpdate error 11: Discontiguous slice was "
+                 "mapped from the file", status );
       }
-
+      if( *status == SAI__OK && ip[ 4 ] != (int)( 2*nplane + 21 + 1000000 ) ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testMapUpdate error 12: Got %d but expected %d",
+                  status, ip[ 4 ], (int)( 2*nplane + 21 + 1000000 ) );
+      }
+      datUnmap( loc3, status );
+      datAnnul( &loc3, status );
+
+/* Map a sub-range of the vectorised cube that crosses the plane
+   boundaries. */
+      datVec( loc2, &loc3, status );
+      datSlice( loc3, 1, &vlo, &vhi, &loc4, status );
+      pdims[0] = vhi - vlo + 1;
+      datMapI( loc4, "READ", 1, pdims, &ip, status );
+      if( *status == SAI__OK && hds1GetUseMmap() &&
+          !loc4->map->uses_true_mmap ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testMapUpdate error 13: Vectorised slice was not "
+                 "mapped from the file", status );
+      }
+      for( i = 0; i < (size_t) pdims[0] && *status == SAI__OK; i++ ) {
+         if( ip[ i ] != (int)( i + vlo - 1 ) ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 14: Got %d but expected %d",
+                     status, ip[ i ], (int)( i + vlo - 1 ) );
+         }
+      }
+      datUnmap( loc4, status );
+      datAnnul( &loc4, status );
+      datAnnul( &loc3, status );
+
+/* Check the updated plane through HDF5. */
+      outvals = MEM_REALLOC( outvals, nel*sizeof(*outvals) );
+      datGetI( loc2, 3, cdims, outvals, status );
+      for( i = 0; i < nel && *status == SAI__OK; i++ ) {
+         int expect = i;
+         if( i >= 2*nplane && i < 3*nplane ) expect += 1000000;
+         if( outvals[ i ] != expect ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 15: Got %d but expected %d "
+                     "at element %zu", status, outvals[ i ], expect, i );
+         }
+      }
+      datAnnul( &loc2, status );
+      hdsErase( &loc1, status );
    }
 
-/* Attempt to access the two top-level objects in two separate threads.
-   Each thread attempt to lock the object read-only. Both should be
-   successful. */
+/* Create a _DOUBLE array whose data follow a single byte in the file, so
+   that they do not start on an 8-byte boundary. Mapping it for UPDATE
+   after re-opening the file must give a pointer that is aligned for
+   doubles, and the changes must still reach the file. */
    if( *status == SAI__OK ) {
-      threaddata1.rdonly = 1;
-      threaddata1.loc = loc1;
-      pthread_create( &t1, NULL, test2ThreadSafety, &threaddata1 );
-      threaddata2.rdonly = 1;
-      threaddata2.loc = loc1b;
-      pthread_create( &t2, NULL, test2ThreadSafety, &threaddata2 );
-
-/* Wait for them to terminate. */
-      pthread_join( t1, NULL );
-      pthread_join( t2, NULL );
-      emsStat( status );
-
-/* Sanity check: if either of the threads failed, check that the status
-   value reflects this. */
-      if( threaddata1.status != SAI__OK || threaddata2.status != SAI__OK ) {
-         if( *status == SAI__OK ) {
+      double *dp;
+      double dvals[ 100 ];
+      hdsdim ddim = 100;
+      haddr_t doff;
+      size_t actval;
+
+      for( i = 0; i < (size_t) ddim; i++ ) dvals[ i ] = 0.5*i;
+      testNewFile( "hds_mtest", "HDS_MTEST", 0, NULL, &loc1, NULL, status );
+      datNew0C( loc1, "FLAG", 1, status );
+      datFind( loc1, "FLAG", &loc2, status );
+      datPut0C( loc2, "Y", status );
+      datAnnul( &loc2, status );
+      datNew1D( loc1, "DDATA", ddim, status );
+      datFind( loc1, "DDATA", &loc2, status );
+      datPut1D( loc2, ddim, dvals, status );
+      datAnnul( &loc2, status );
+      datAnnul( &loc1, status );
+
+      hdsOpen( "hds_mtest", "UPDATE", &loc1, status );
+      datFind( loc1, "DDATA", &loc2, status );
+      doff = ( *status == SAI__OK ) ? H5Dget_offset( loc2->dataset_id ) :
+                                      HADDR_UNDEF;
+      if( *status == SAI__OK && doff != HADDR_UNDEF &&
+          doff % sizeof( double ) == 0 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testMapUpdate error 16: _DOUBLE data start at "
+                  "aligned offset %zu", status, (size_t) doff );
+      }
+      datMapD( loc2, "UPDATE", 1, &ddim, &dp, status );
+      if( *status == SAI__OK && (size_t) dp % sizeof( double ) != 0 ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testMapUpdate error 17: Mapped _DOUBLE array is "
+                 "misaligned", status );
+      }
+      for( i = 0; i < (size_t) ddim && *status == SAI__OK; i++ ) {
+         if( dp[ i ] != 0.5*i ) {
             *status = DAT__FATAL;
-            emsRepf( "", "ems failed to detect an error that occurred "
-                     "within a thread (test3, error code %d or %d)", status,
-                     threaddata1.status, threaddata2.status );
+            emsRepf( "", "testMapUpdate error 18: Got %g but expected %g",
+                     status, dp[ i ], 0.5*i );
          }
+         dp[ i ] = -dp[ i ];
       }
+      datUnmap( loc2, status );
+      datGet1D( loc2, ddim, dvals, &actval, status );
+      for( i = 0; i < (size_t) ddim && *status == SAI__OK; i++ ) {
+         if( dvals[ i ] != -0.5*i ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 19: Got %g but expected %g",
+                     status, dvals[ i ], -0.5*i );
+         }
+      }
+      datAnnul( &loc2, status );
+      hdsErase( &loc1, status );
+   }
 
-/* Check neither failed. */
-      if( threaddata1.failed + threaddata2.failed > 0 && *status == SAI__OK ) {
+/* Without MAPUPDATE, a file opened for writing keeps its sieve buffer
+   and, unless the buffer has zero size, is mapped through a copy of the
+   data. */
+   if( *status == SAI__OK ) {
+      hdsdim idim = 10;
+      hid_t fapl;
+      size_t sieve = 0;
+
+      hdsTune( "MAPUPDATE", 0, status );
+      testNewFile( "hds_mtest", "HDS_MTEST", 0, NULL, &loc1, NULL, status );
+      datNew1I( loc1, "DATA", idim, status );
+      datFind( loc1, "DATA", &loc2, status );
+      if( *status == SAI__OK ) {
+         fapl = H5Fget_access_plist( loc2->file_id );
+         H5Pget_sieve_buf_size( fapl, &sieve );
+         H5Pclose( fapl );
+         if( sieve != (size_t) hds1GetSieve() ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 20: Sieve buffer is %zu "
+                     "bytes but expected %d", status, sieve,
+                     hds1GetSieve() );
+         }
+      }
+      datMapI( loc2, "WRITE", 1, &idim, &ip, status );
+      if( *status == SAI__OK && sieve > 0 && loc2->map->uses_true_mmap ) {
          *status = DAT__FATAL;
-         emsRepf( "", "testThreadSafety error 2051: %d read-only lock attempts failed "
-                  "- expected 0 to fail.",  status,
-                  threaddata1.failed + threaddata2.failed );
+         emsRep( "", "testMapUpdate error 21: File was mapped without "
+                 "MAPUPDATE", status );
+      }
+      if( *status == SAI__OK ) {
+         for( i = 0; i < (size_t) idim; i++ ) ip[ i ] = i;
       }
+      datUnmap( loc2, status );
+      datGetI( loc2, 1, &idim, outvals, status );
+      for( i = 0; i < (size_t) idim && *status == SAI__OK; i++ ) {
+         if( outvals[ i ] != (int) i ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testMapUpdate error 22: Got %d but expected %d",
+                     status, outvals[ i ], (int) i );
+         }
+      }
+      datAnnul( &loc2, status );
+      hdsErase( &loc1, status );
    }
 
-/* Lock both top level locators for read-only use by the current thread. The
-   second of these calls will have no effect as the two locators refer to the
-   same object. These locks are recursive. */
-   datLock( loc1, 1, 1, status );
-   datLock( loc1b, 1, 1, status );
+   if( outvals ) MEM_FREE( outvals );
 
-/* Annul the first primary locator for the file. */
-   datAnnul( &loc1, status );
+/* Restore the tuning parameters even if an error has occurred. */
+   emsBegin( status );
+   hdsTune( "DEFLATE", deflate, status );
+   hdsTune( "SHUFFLE", shuffle, status );
+   hdsTune( "FLETCHER32", fletcher32, status );
+   hdsTune( "SCALEOFFSET", scaleoffset, status );
+   hdsTune( "MAPUPDATE", mapupdate, status );
+   emsEnd( status );
 
-/* Each thread creates a temporary object holding a large array of doubles
-   and does some heavy work on it. */
    if( *status == SAI__OK ) {
-      pthread_create( &t1, NULL, test3ThreadSafety, &threaddata1 );
-      pthread_create( &t2, NULL, test3ThreadSafety, &threaddata2 );
+      printf( "TestMapUpdate passed\n" );
+   } else {
+      emsRep( " ", "TestMapUpdate failed", status );
+   }
+}
 
-/* Wait for them to terminate. */
-      pthread_join( t1, NULL );
-      pthread_join( t2, NULL );
-      emsStat( status );
 
-/* Lock the locators for the arrays so that the current thread can have
-   read-only access them. */
-      datLock( threaddata1.loc, 0, 1, status );
-      datLock( threaddata2.loc, 0, 1, status );
 
-/* Check the two threads created equal values. */
-      dim = 10000;
-      datMap( threaddata1.loc, "_DOUBLE", "Read", 1, &dim, (void **) &ip1, status );
-      datMap( threaddata2.loc, "_DOUBLE", "Read", 1, &dim, (void **) &ip2, status );
-      if( *status == SAI__OK ) {
-         for( i = 0; i < dim; i++ ) {
-            if( ip1[i] != ip2[i] ) {
-               *status = DAT__FATAL;
-               emsRepf( "", "testThreadSafety error 206: Threads created "
-                        "different values (%.20g anbd %.20g) at element %"
-                        HDS_DIM_FORMAT, status, ip1[i], ip2[i], i );
-            }
-         }
-      }
 
-      datUnmap( threaddata1.loc, status );
-      datUnmap( threaddata2.loc, status );
 
-/* Attempt to modify each object. This should generate an error since
-   the current thread does not have a read-write lock on either of them. */
-      dims[0] = 10;
-      datCell( threaddata1.loc, 1, dims, &loc3, status );
-      if( *status == SAI__OK ) {
-         datPut0D( loc3, 1.0, status );
-         if( *status == DAT__THREAD ) {
-            emsAnnul( status );
-         } else {
-            int oldstat = *status;
-            emsAnnul( status );
-            *status = DAT__FATAL;
-            emsRepf("", "testThreadSafety error 207: Expected a DAT__LOCIN "
-                    "error but got status=%d", status, oldstat );
-         }
-         datAnnul( &loc3, status );
-      }
 
-      datCell( threaddata2.loc, 1, dims, &loc3, status );
-      if( *status == SAI__OK ) {
-         datPut0D( loc3, 1.0, status );
-         if( *status == DAT__THREAD ) {
-            emsAnnul( status );
-         } else {
-            int oldstat = *status;
-            emsAnnul( status );
-            *status = DAT__FATAL;
-            emsRepf("", "testThreadSafety error 208: Expected a DAT__LOCIN "
-                    "error but got status=%d", status, oldstat );
-         }
-         datAnnul( &loc3, status );
-      }
 
-      datAnnul( &(threaddata1.loc), status );
-      datAnnul( &(threaddata2.loc), status );
-   }
 
-/* Check for the exit status */
-   if( *status == SAI__OK ) emsStat( status );
-   emsRlse();
 
+static void testConvert( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HdsTypeInfo *typeinfo = dat1TypeInfo();
+   double *dp;
+   double *dvals = NULL;
+   float rvals[ 6 ];
+   hdsdim dims[2];
+   hdsdim lo[2];
+   hdsdim hi[2];
+   hdsdim n;
+   int ivals[ 6 ];
+   short wvals[ 3 ];
+   size_t i;
+   size_t nel;
+   unsigned char ubvals[ 3 ];
 
-/* The file should still be open because of the second locator. So test
-   the integer value can still be accessed using "loc4b" and "loc4". */
-   datGet0I( loc4, &ival, status );
-   if( ival != -999 && *status == SAI__OK ) {
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   dims[0] = 1000;
+   dims[1] = 300;
+   nel = dims[0]*dims[1];
+   hdsNew( "hds_cvtest", "HDS_CVTEST", "TEST", 0, dims, &loc1, status );
+
+/* Check bad values, rounding and overflow when converting _REAL to
+   _INTEGER. */
+   n = 6;
+   rvals[ 0 ] = 1.5;
+   rvals[ 1 ] = -2.5;
+   rvals[ 2 ] = typeinfo->BADR;
+   rvals[ 3 ] = 3.0E9;
+   rvals[ 4 ] = 2.49;
+   rvals[ 5 ] = -7.0;
+   datNew( loc1, "REAL", "_REAL", 1, &n, status );
+   datFind( loc1, "REAL", &loc2, status );
+   datPutR( loc2, 1, &n, rvals, status );
+
+   if( *status == SAI__OK ) {
+      datGetI( loc2, 1, &n, ivals, status );
+      if( *status == DAT__CONER ) {
+         emsAnnul( status );
+      } else if( *status == SAI__OK ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testConvert error 1: Overflow did not cause a "
+                 "conversion error", status );
+      }
+   }
+   if( *status == SAI__OK ) {
+      if( ivals[ 0 ] != 2 || ivals[ 1 ] != -3 ||
+          ivals[ 2 ] != typeinfo->BADI || ivals[ 3 ] != typeinfo->BADI ||
+          ivals[ 4 ] != 2 || ivals[ 5 ] != -7 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testConvert error 2: Got %d %d %d %d %d %d", status,
+                  ivals[ 0 ], ivals[ 1 ], ivals[ 2 ], ivals[ 3 ], ivals[ 4 ],
+                  ivals[ 5 ] );
+      }
+   }
+   datAnnul( &loc2, status );
+
+/* Check bad values are propagated from _WORD to _REAL, and that a value
+   too large for a _UBYTE is stored as bad. */
+   n = 3;
+   wvals[ 0 ] = -5;
+   wvals[ 1 ] = typeinfo->BADW;
+   wvals[ 2 ] = 300;
+   datNew( loc1, "WORD", "_WORD", 1, &n, status );
+   datFind( loc1, "WORD", &loc2, status );
+   datPutW( loc2, 1, &n, wvals, status );
+   datGetR( loc2, 1, &n, rvals, status );
+   if( *status == SAI__OK && ( rvals[ 0 ] != -5.0 ||
+       rvals[ 1 ] != typeinfo->BADR || rvals[ 2 ] != 300.0 ) ) {
       *status = DAT__FATAL;
-      emsRepf("", "testThreadSafety error 3: Got %d but expected -999", status,
-              ival );
+      emsRepf( "", "testConvert error 3: Got %g %g %g", status,
+               rvals[ 0 ], rvals[ 1 ], rvals[ 2 ] );
    }
+   datAnnul( &loc2, status );
 
-   datGet0I( loc4b, &ival, status );
-   if( ival != -999 && *status == SAI__OK ) {
+   datNew( loc1, "UBYTE", "_UBYTE", 1, &n, status );
+   datFind( loc1, "UBYTE", &loc2, status );
+   if( *status == SAI__OK ) {
+      datPutW( loc2, 1, &n, wvals, status );
+      if( *status == DAT__CONER ) {
+         emsAnnul( status );
+      } else if( *status == SAI__OK ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testConvert error 4: Overflow did not cause a "
+                 "conversion error", status );
+      }
+   }
+   datGet( loc2, "_UBYTE", 1, &n, ubvals, status );
+   if( *status == SAI__OK && ( ubvals[ 0 ] != typeinfo->BADUB ||
+       ubvals[ 1 ] != typeinfo->BADUB || ubvals[ 2 ] != typeinfo->BADUB ) ) {
       *status = DAT__FATAL;
-       emsRepf("", "testThreadSafety error 4: Got %d but expected -999", status,
-              ival );
-  }
+      emsRepf( "", "testConvert error 5: Got %d %d %d", status,
+               ubvals[ 0 ], ubvals[ 1 ], ubvals[ 2 ] );
+   }
+   datAnnul( &loc2, status );
 
+/* Write a large _REAL array as _DOUBLE so that it is converted in
+   several blocks, and read it back in full, as a slice and by mapping. */
+   datNew( loc1, "DATA", "_REAL", 2, dims, status );
+   datFind( loc1, "DATA", &loc2, status );
+   dvals = MEM_MALLOC( nel*sizeof(*dvals) );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < nel; i++ ) {
+         dvals[ i ] = ( i % 97 ) ? 0.5*i : typeinfo->BADD;
+      }
+   }
+   datPutD( loc2, 2, dims, dvals, status );
+   if( *status == SAI__OK ) memset( dvals, 0, nel*sizeof(*dvals) );
+   datGetD( loc2, 2, dims, dvals, status );
+   for( i = 0; i < nel && *status == SAI__OK; i++ ) {
+      double expect = ( i % 97 ) ? 0.5*i : typeinfo->BADD;
+      if( dvals[ i ] != expect ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testConvert error 6: Got %g but expected %g at "
+                  "element %zu", status, dvals[ i ], expect, i );
+      }
+   }
 
-/* Annul the second primary locator for the file. */
-   datAnnul( &loc1b, status );
+   lo[ 0 ] = 11;
+   lo[ 1 ] = 21;
+   hi[ 0 ] = 20;
+   hi[ 1 ] = 30;
+   datSlice( loc2, 2, lo, hi, &loc3, status );
+   lo[ 0 ] = 10;
+   lo[ 1 ] = 10;
+   datGetD( loc3, 2, lo, dvals, status );
+   for( i = 0; i < 100 && *status == SAI__OK; i++ ) {
+      size_t j = ( i % 10 ) + 10 + ( ( i / 10 ) + 20 )*dims[ 0 ];
+      double expect = ( j % 97 ) ? 0.5*j : typeinfo->BADD;
+      if( dvals[ i ] != expect ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testConvert error 7: Got %g but expected %g at "
+                  "element %zu", status, dvals[ i ], expect, i );
+      }
+   }
+   datAnnul( &loc3, status );
 
-/* The file should now be closed, so check an error is reported if
-   loc4/loc4b is used. */
+   datMapD( loc2, "UPDATE", 2, dims, &dp, status );
    if( *status == SAI__OK ) {
-      datGet0I( loc4, &ival, status );
-      if( *status == DAT__LOCIN ) {
-         emsAnnul( status );
-      } else {
-         int oldstat = *status;
+      for( i = 0; i < nel; i++ ) {
+         if( dp[ i ] != typeinfo->BADD ) dp[ i ] = -dp[ i ];
+      }
+   }
+   datUnmap( loc2, status );
+   datGetD( loc2, 2, dims, dvals, status );
+   for( i = 0; i < nel && *status == SAI__OK; i++ ) {
+      double expect = ( i % 97 ) ? -0.5*i : typeinfo->BADD;
+      if( dvals[ i ] != expect ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testConvert error 8: Got %g but expected %g at "
+                  "element %zu", status, dvals[ i ], expect, i );
+      }
+   }
+   datAnnul( &loc2, status );
+
+/* Check conversions between _CHAR and numeric types. */
+   n = 4;
+   datNew( loc1, "CHAR", "_CHAR*10", 1, &n, status );
+   datFind( loc1, "CHAR", &loc2, status );
+   datPutC( loc2, 1, &n, "  12      -3.5      1e3       abc       ", 10,
+            status );
+   if( *status == SAI__OK ) {
+      datGetI( loc2, 1, &n, ivals, status );
+      if( *status == DAT__CONER ) {
          emsAnnul( status );
+      } else if( *status == SAI__OK ) {
          *status = DAT__FATAL;
-         emsRepf("", "testThreadSafety error 5: Expected a DAT__LOCIN "
-                 "error but got status=%d", status, oldstat );
+         emsRep( "", "testConvert error 9: Bad string did not cause a "
+                 "conversion error", status );
       }
    }
+   if( *status == SAI__OK && ( ivals[ 0 ] != 12 || ivals[ 1 ] != -3 ||
+       ivals[ 2 ] != 1 || ivals[ 3 ] != typeinfo->BADI ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testConvert error 10: Got %d %d %d %d", status,
+               ivals[ 0 ], ivals[ 1 ], ivals[ 2 ], ivals[ 3 ] );
+   }
+   if( *status == SAI__OK ) {
+      datGetR( loc2, 1, &n, rvals, status );
+      if( *status == DAT__CONER ) emsAnnul( status );
+   }
+   if( *status == SAI__OK && ( rvals[ 0 ] != 12.0 || rvals[ 1 ] != -3.5 ||
+       rvals[ 2 ] != 1000.0 || rvals[ 3 ] != typeinfo->BADR ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testConvert error 11: Got %g %g %g %g", status,
+               rvals[ 0 ], rvals[ 1 ], rvals[ 2 ], rvals[ 3 ] );
+   }
 
-/* Open the file again (read-only) in a thread. After opening the file
-   the thread blocks until condition variable cond_page is broadcast. */
-   emsMark();
-   threaddata2.path = path;
-   pthread_create( &t1, NULL, test4ThreadSafety, &threaddata2 );
+   if( *status == SAI__OK ) {
+      char cvals[ 41 ];
+      const char *expect = "-1234.5678123456.7891E-200    0.00012   ";
+      dvals[ 0 ] = -1234.5678;
+      dvals[ 1 ] = 123456.789;
+      dvals[ 2 ] = 1.0E-200;
+      dvals[ 3 ] = 0.00012;
+      datPutD( loc2, 1, &n, dvals, status );
+      datGetC( loc2, 1, &n, cvals, 10, status );
+      cvals[ 40 ] = 0;
+      if( *status == SAI__OK && strcmp( cvals, expect ) ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testConvert error 12: Got '%s' but expected '%s'",
+                  status, cvals, expect );
+      }
+   }
+   datAnnul( &loc2, status );
 
-/* Block until the thread signals that the HDS file has been opened. */
-   pthread_mutex_lock( &mutex );
-   pthread_cond_wait( &cond, &mutex );
-   pthread_mutex_unlock( &mutex );
+   if( dvals ) MEM_FREE( dvals );
+   hdsErase( &loc1, status );
 
-/* Attempt also to open the file in this thread. */
-   hdsOpen( path, "Read", &loc1b, status );
+   if( *status == SAI__OK ) {
+      printf("TestConvert passed\n");
+   }
+}
 
-/* Attempt to use the locator for something. */
-   datType( loc1b, typestr, status );
+/* Create a new container file holding a scalar TEST structure, and
+   return a locator for it in "top". If "ndim" is greater than zero, a
+   REC structure array called RECS with dimensions "dims" is also
+   created in it and, if "recs" is not NULL, a locator for it is
+   returned in "recs". */
+static void testNewFile( const char *path, const char *name, int ndim,
+                         const hdsdim dims[], HDSLoc **top, HDSLoc **recs,
+                         int *status ){
 
-/* Broadcast the signal that tells the thread to close the file. */
-   pthread_mutex_lock( &mutex );
-   pthread_cond_broadcast( &cond );
-   pthread_mutex_unlock( &mutex );
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
 
-/* Attempt to use this thread's locator again. */
-   datType( loc1b, typestr, status );
+   hdsNew( path, name, "TEST", 0, NULL, top, status );
+   if( ndim > 0 ) {
+      datNew( *top, "RECS", "REC", ndim, dims, status );
+      if( recs ) datFind( *top, "RECS", recs, status );
+   }
+}
 
-/* Close the file in this thread too. */
-   datAnnul( &loc1b, status );
+static void testStructCells( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HDSLoc *loc5 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char path[ 128 ];
+   char file[ 256 ];
+   hdsdim dims[ DAT__MXDIM ];
+   hdsdim sub;
+   int actdim;
+   int ival;
+   int ncellcomp;
+   int ncomp;
+   int nlev;
+   int there;
 
-   if( *status == SAI__OK ) emsStat( status );
-   emsRlse();
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* Create a large structure array. None of its cells should exist yet. */
+   dims[ 0 ] = 100000;
+   testNewFile( "hds_sctest", "HDS_SCTEST", 1, dims, &loc1, &loc2, status );
+   datNcomp( loc2, &ncomp, status );
+   if( *status == SAI__OK && ncomp != 0 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 1: %d cells exist but expected 0",
+               status, ncomp );
+   }
 
+/* Access a cell. It should be empty and should not be created until
+   something is written into it, even though the file is writable. Only
+   that cell should then exist. */
+   sub = 5;
+   datCell( loc2, 1, &sub, &loc3, status );
+   datNcomp( loc3, &ncellcomp, status );
+   datNcomp( loc2, &ncomp, status );
+   if( *status == SAI__OK && ( ncellcomp != 0 || ncomp != 0 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 2: Cell has %d components and "
+               "%d cells exist", status, ncellcomp, ncomp );
+   }
+   datNew0I( loc3, "VAL", status );
+   datFind( loc3, "VAL", &loc4, status );
+   datPut0I( loc4, 42, status );
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   datNcomp( loc2, &ncomp, status );
+   if( *status == SAI__OK && ncomp != 1 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 3: %d cells exist but expected 1",
+               status, ncomp );
+   }
 
+/* Extend and then shrink the array. Cells that were never accessed
+   do not need to be deleted. */
+   dims[ 0 ] = 120000;
+   datAlter( loc2, 1, dims, status );
+   sub = 110000;
+   datCell( loc2, 1, &sub, &loc3, status );
+   datAnnul( &loc3, status );
+   dims[ 0 ] = 10;
+   datAlter( loc2, 1, dims, status );
+   datNcomp( loc2, &ncomp, status );
+   if( *status == SAI__OK && ncomp != 1 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 4: %d cells exist but expected 1",
+               status, ncomp );
+   }
+   datAnnul( &loc2, status );
+   hdsClose( &loc1, status );
+
+/* Re-open the file read-only. Untouched cells should look like empty
+   scalar structures. */
+   hdsOpen( "hds_sctest", "READ", &loc1, status );
+   datFind( loc1, "RECS", &loc2, status );
+   sub = 5;
+   datCell( loc2, 1, &sub, &loc3, status );
+   datFind( loc3, "VAL", &loc4, status );
+   datGet0I( loc4, &ival, status );
+   if( *status == SAI__OK && ival != 42 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 5: Got %d but expected 42",
+               status, ival );
+   }
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
 
+   sub = 6;
+   datCell( loc2, 1, &sub, &loc3, status );
+   datNcomp( loc3, &ncomp, status );
+   datThere( loc3, "VAL", &there, status );
+   datShape( loc3, DAT__MXDIM, dims, &actdim, status );
+   datName( loc3, name, status );
+   hdsTrace( loc3, &nlev, path, file, status, sizeof(path), sizeof(file) );
+   if( *status == SAI__OK && ( ncomp != 0 || there || actdim != 0 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 6: Empty cell has %d components, "
+               "%d dimensions and there=%d", status, ncomp, actdim, there );
+   }
+   if( *status == SAI__OK && ( strcmp( name, "RECS(6)" ) ||
+                               strcmp( path, "HDS_SCTEST.RECS(6)" ) ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 7: Got name '%s' and path '%s'",
+               status, name, path );
+   }
    if( *status == SAI__OK ) {
-      printf( "TestThreadSafety passed\n" );
-   } else {
-      emsRep( " ", "TestThreadSafety failed", status );
+      datFind( loc3, "VAL", &loc4, status );
+      if( *status == DAT__OBJNF ) {
+         emsAnnul( status );
+      } else if( *status == SAI__OK ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testStructCells error 8: Found a component in an "
+                 "empty cell", status );
+      }
+   }
+   datParen( loc3, &loc4, status );
+   datName( loc4, name, status );
+   if( *status == SAI__OK && strcmp( name, "RECS" ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 9: Parent of cell is '%s'",
+               status, name );
+   }
+   datAnnul( &loc4, status );
+   datNcomp( loc2, &ncomp, status );
+   if( *status == SAI__OK && ncomp != 1 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 10: %d cells exist but expected 1",
+               status, ncomp );
+   }
+
+/* Re-open the file for update while the empty cell locator is active.
+   Reading cells should still not create them. */
+   hdsOpen( "hds_sctest", "UPDATE", &loc5, status );
+   for( sub = 1; sub <= 10; sub++ ) {
+      datCell( loc2, 1, &sub, &loc4, status );
+      datNcomp( loc4, &ncellcomp, status );
+      datAnnul( &loc4, status );
+   }
+   datNcomp( loc2, &ncomp, status );
+   datNcomp( loc3, &ncellcomp, status );
+   if( *status == SAI__OK && ( ncomp != 1 || ncellcomp != 0 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 11: %d cells exist and cell has "
+               "%d components", status, ncomp, ncellcomp );
+   }
+
+/* Writing into the empty cell creates it, and the new component should
+   be visible through another locator for the same empty cell. The
+   objects were locked read-only when the file was opened for reading. */
+   datUnlock( loc1, 1, status );
+   datLock( loc1, 1, 0, status );
+   sub = 6;
+   datCell( loc2, 1, &sub, &loc4, status );
+   datNew0I( loc3, "VAL", status );
+   datNcomp( loc2, &ncomp, status );
+   datNcomp( loc4, &ncellcomp, status );
+   if( *status == SAI__OK && ( ncomp != 2 || ncellcomp != 1 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testStructCells error 12: %d cells exist and cell has "
+               "%d components", status, ncomp, ncellcomp );
    }
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   datAnnul( &loc5, status );
+   hdsErase( &loc1, status );
 
+   if( *status == SAI__OK ) {
+      printf("TestStructCells passed\n");
+   }
 }
 
+static void testMetaCache( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char type[ DAT__SZTYP + 1 ];
+   hdsdim dims[ DAT__MXDIM ];
+   int actdim;
+   int hits0;
+   int hits1;
+   int i;
+   int there;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 4;
+   dims[ 1 ] = 3;
+   testNewFile( "hds_mctest", "HDS_MCTEST", 2, dims, &loc1, NULL, status );
+   datNew1D( loc1, "DATA", 10, status );
+
+/* Repeated queries on the same object, through different locators,
+   should be answered from the cache. */
+   datFind( loc1, "DATA", &loc2, status );
+   datType( loc2, type, status );
+   datName( loc2, name, status );
+   hdsInfoI( NULL, "CACHEHITS", NULL, &hits0, status );
+   for( i = 0; i < 10; i++ ) {
+      datFind( loc1, "DATA", &loc3, status );
+      datType( loc3, type, status );
+      datName( loc3, name, status );
+      datAnnul( &loc3, status );
+   }
+   hdsInfoI( NULL, "CACHEHITS", NULL, &hits1, status );
+   if( *status == SAI__OK && ( hits1 - hits0 < 20 ||
+       strcmp( type, "_DOUBLE" ) || strcmp( name, "DATA" ) ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testMetaCache error 1: %d hits, type '%s', name '%s'",
+               status, hits1 - hits0, type, name );
+   }
+
+/* Renaming the object should update the name seen through another
+   locator. */
+   datFind( loc1, "DATA", &loc3, status );
+   datRenam( loc3, "DATA2", status );
+   datName( loc2, name, status );
+   if( *status == SAI__OK && strcmp( name, "DATA2" ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testMetaCache error 2: Got name '%s' after rename",
+               status, name );
+   }
+   datAnnul( &loc3, status );
+
+/* A new object with the old name should not see the old metadata. */
+   datNew0I( loc1, "DATA", status );
+   datFind( loc1, "DATA", &loc3, status );
+   datType( loc3, type, status );
+   if( *status == SAI__OK && strcmp( type, "_INTEGER" ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testMetaCache error 3: Got type '%s' but expected "
+               "_INTEGER", status, type );
+   }
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+
+/* Altering the shape of a structure array should be seen by other
+   locators, as should renaming it (which changes the names of its
+   cells). */
+   datFind( loc1, "RECS", &loc2, status );
+   datFind( loc1, "RECS", &loc3, status );
+   datShape( loc3, DAT__MXDIM, dims, &actdim, status );
+   dims[ 0 ] = 4;
+   dims[ 1 ] = 2;
+   datAlter( loc2, 2, dims, status );
+   datShape( loc3, DAT__MXDIM, dims, &actdim, status );
+   if( *status == SAI__OK && ( actdim != 2 || dims[ 1 ] != 2 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testMetaCache error 4: Got %d axes, last dim %d",
+               status, actdim, (int) dims[ 1 ] );
+   }
+   dims[ 0 ] = 3;
+   dims[ 1 ] = 2;
+   datCell( loc3, 2, dims, &loc4, status );
+   datName( loc4, name, status );
+   datRenam( loc2, "CELLS", status );
+   datName( loc4, name, status );
+   if( *status == SAI__OK && strcmp( name, "CELLS(3,2)" ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testMetaCache error 5: Got cell name '%s'",
+               status, name );
+   }
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+
+/* Names found not to exist are remembered, but must be forgotten when
+   a component of that name is created, through any locator. */
+   datClone( loc1, &loc2, status );
+   for( i = 0; i < 3; i++ ) {
+      datThere( loc1, "QUALITY", &there, status );
+      if( *status == SAI__OK && there ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testMetaCache error 6: Found QUALITY", status );
+      }
+      if( *status == SAI__OK ) {
+         datFind( loc1, "QUALITY", &loc3, status );
+         if( *status == DAT__OBJNF ) {
+            emsAnnul( status );
+         } else if( *status == SAI__OK ) {
+            *status = DAT__FATAL;
+            emsRep( "", "testMetaCache error 7: Found QUALITY", status );
+         }
+      }
+   }
+   datNew0I( loc2, "QUALITY", status );
+   datThere( loc1, "QUALITY", &there, status );
+   datFind( loc1, "QUALITY", &loc3, status );
+   datAnnul( &loc3, status );
+   if( *status == SAI__OK && !there ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testMetaCache error 8: QUALITY not found after "
+              "creation", status );
+   }
+   datThere( loc1, "VARIANCE", &there, status );
+   datFind( loc1, "DATA", &loc3, status );
+   datCopy( loc3, loc2, "VARIANCE", status );
+   datAnnul( &loc3, status );
+   datThere( loc1, "VARIANCE", &there, status );
+   if( *status == SAI__OK && !there ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testMetaCache error 9: VARIANCE not found after "
+              "copy", status );
+   }
+   datThere( loc1, "WCS", &there, status );
+   datFind( loc1, "QUALITY", &loc3, status );
+   datMove( &loc3, loc2, "WCS", status );
+   datThere( loc1, "WCS", &there, status );
+   if( *status == SAI__OK && !there ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testMetaCache error 10: WCS not found after move",
+              status );
+   }
+   datAnnul( &loc2, status );
+
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestMetaCache passed\n");
+   }
+}
+
+static void testDeepLock( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HDSLoc *loc5 = NULL;
+   hdsdim dims[ DAT__MXDIM ];
+   pthread_t t1;
+   threadData threaddata;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 5;
+   testNewFile( "hds_dltest", "HDS_DLTEST", 1, dims, &loc1, &loc2, status );
+   dims[ 0 ] = 3;
+   datCell( loc2, 1, dims, &loc3, status );
+   datNew1D( loc3, "DATA", 10, status );
+   datFind( loc3, "DATA", &loc4, status );
+
+/* Unlock the whole tree and then lock it again for read-only access.
+   The components should inherit the lock. */
+   datUnlock( loc1, 1, status );
+   if( *status == SAI__OK && datLocked( loc4, 0, status ) != 0 ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeepLock error 1: DATA still locked", status );
+   }
+   datLock( loc1, 1, 1, status );
+   if( *status == SAI__OK && ( datLocked( loc4, 0, status ) != 3 ||
+                               datLocked( loc1, 1, status ) != 3 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeepLock error 2: Tree not locked for reading",
+              status );
+   }
+
+/* Promote the lock on DATA alone, then unlock the cell containing it
+   without unlocking its components. */
+   datLock( loc4, 0, 0, status );
+   if( *status == SAI__OK && ( datLocked( loc4, 0, status ) != 1 ||
+                               datLocked( loc3, 0, status ) != 3 ||
+                               datLocked( loc1, 1, status ) != 5 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeepLock error 3: Bad locks after promoting DATA",
+              status );
+   }
+   datUnlock( loc3, 0, status );
+   if( *status == SAI__OK && ( datLocked( loc3, 0, status ) != 0 ||
+                               datLocked( loc4, 0, status ) != 1 ||
+                               datLocked( loc2, 0, status ) != 3 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeepLock error 4: Bad locks after unlocking cell",
+              status );
+   }
+
+/* Unlock everything and then lock DATA alone for read-write access.
+   Another thread should then be able to lock the top-level object alone,
+   but not the whole tree. */
+   datUnlock( loc1, 1, status );
+   if( *status == SAI__OK && datLocked( loc4, 0, status ) != 0 ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeepLock error 5: DATA still locked", status );
+   }
+   datLock( loc4, 0, 0, status );
+
+   emsMark();
+   if( *status == SAI__OK ) {
+      threaddata.loc = loc1;
+      threaddata.id = 1;
+      pthread_create( &t1, NULL, test1DeepLock, &threaddata );
+      pthread_join( t1, NULL );
+      emsStat( status );
+      if( *status == SAI__OK && ( threaddata.status != SAI__OK ||
+                                  threaddata.failed != 1 ) ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testDeepLock error 6: status %d, failed %d", status,
+                  threaddata.status, threaddata.failed );
+      }
+   }
+
+/* Lock the whole tree for read-write access. Another thread should not be
+   able to lock any component. */
+   datUnlock( loc4, 0, status );
+   datLock( loc1, 1, 0, status );
+   if( *status == SAI__OK ) {
+      threaddata.loc = loc3;
+      threaddata.id = 2;
+      pthread_create( &t1, NULL, test1DeepLock, &threaddata );
+      pthread_join( t1, NULL );
+      emsStat( status );
+      if( *status == SAI__OK && ( threaddata.status != SAI__OK ||
+                                  threaddata.failed != 1 ) ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testDeepLock error 7: status %d, failed %d", status,
+                  threaddata.status, threaddata.failed );
+      }
+   }
+   emsRlse();
+
+/* New components should inherit the lock. */
+   datNew0I( loc3, "NEWCOMP", status );
+   datFind( loc3, "NEWCOMP", &loc5, status );
+   if( *status == SAI__OK && datLocked( loc5, 0, status ) != 1 ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeepLock error 8: New component not locked",
+              status );
+   }
+
+   datAnnul( &loc5, status );
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestDeepLock passed\n");
+   }
+}
+
+/* Thread used by testDeepLock. If "id" is 1, a recursive lock on the
+   supplied object should fail and a non-recursive lock should succeed.
+   If "id" is 2, the supplied object should be locked by another thread
+   and locking it should fail. "failed" is returned set to 1 if this
+   happens. */
+void *test1DeepLock( void *data ) {
+   threadData *tdata = (threadData *) data;
+   int status = SAI__OK;
+
+   tdata->failed = 0;
+   if( tdata->id == 1 ) {
+      datLock( tdata->loc, 1, 1, &status );
+      if( status == DAT__THREAD ) {
+         emsAnnul( &status );
+         datLock( tdata->loc, 0, 1, &status );
+         if( status == SAI__OK && datLocked( tdata->loc, 0, &status ) == 3 ) {
+            tdata->failed = 1;
+         }
+         datUnlock( tdata->loc, 0, &status );
+      }
+
+   } else if( datLocked( tdata->loc, 0, &status ) == 2 ) {
+      datLock( tdata->loc, 0, 1, &status );
+      if( status == DAT__THREAD ) {
+         emsAnnul( &status );
+         tdata->failed = 1;
+      }
+   }
+
+   tdata->status = status;
+   return NULL;
+}
+
+static void testFileKey( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   int ival;
+   int nfile0;
+   int nfile1;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   testNewFile( "hds_fktest", "HDS_FKTEST", 0, NULL, &loc1, NULL, status );
+   datNew0I( loc1, "VALUE", status );
+   datAnnul( &loc1, status );
+
+   unlink( "hds_fklink" DAT__FLEXT );
+   if( *status == SAI__OK && symlink( "hds_fktest" DAT__FLEXT,
+                                      "hds_fklink" DAT__FLEXT ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testFileKey error 1: Cannot create symbolic link",
+              status );
+   }
+
+/* Opening the file again through a link or a different path should
+   re-use the HDF5 file and Handle tree that are already open. */
+   hdsInfoI( NULL, "FILES", NULL, &nfile0, status );
+   hdsOpen( "hds_fktest", "UPDATE", &loc1, status );
+   hdsOpen( "hds_fklink", "READ", &loc2, status );
+   hdsOpen( "./hds_fktest", "UPDATE", &loc3, status );
+   hdsInfoI( NULL, "FILES", NULL, &nfile1, status );
+   if( *status == SAI__OK && ( nfile1 - nfile0 != 1 ||
+                               loc2->file_id != loc1->file_id ||
+                               loc3->file_id != loc1->file_id ||
+                               loc2->handle != loc1->handle ||
+                               loc3->handle != loc1->handle ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testFileKey error 2: %d files opened", status,
+               nfile1 - nfile0 );
+   }
+
+/* A value written through one locator should be seen through another. */
+   datFind( loc3, "VALUE", &loc4, status );
+   datPut0I( loc4, 42, status );
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc1, status );
+   datFind( loc2, "VALUE", &loc4, status );
+   datGet0I( loc4, &ival, status );
+   datAnnul( &loc4, status );
+   if( *status == SAI__OK && ival != 42 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testFileKey error 3: Got %d but expected 42", status,
+               ival );
+   }
+
+/* Annulling the last primary locator should close the file. */
+   datAnnul( &loc2, status );
+   hdsInfoI( NULL, "FILES", NULL, &nfile1, status );
+   if( *status == SAI__OK && nfile1 != nfile0 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testFileKey error 4: %d files still open", status,
+               nfile1 - nfile0 );
+   }
+
+   unlink( "hds_fklink" DAT__FLEXT );
+   hdsOpen( "hds_fktest", "UPDATE", &loc1, status );
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestFileKey passed\n");
+   }
+}
+
+static void testScope( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HDSLoc *loc5 = NULL;
+   hdsdim dims[ DAT__MXDIM ];
+   int nfile0;
+   int nfile1;
+   int nloc0;
+   int nloc1;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   hdsInfoI( NULL, "FILES", NULL, &nfile0, status );
+   hdsInfoI( NULL, "LOCATORS", NULL, &nloc0, status );
+
+/* Create a file outside any scope. */
+   hdsNew( "hds_sctest", "HDS_SCTEST", "TEST", 0, dims, &loc1, status );
+   datNew0I( loc1, "VALUE", status );
+   datNew0I( loc1, "OTHER", status );
+
+/* Create secondary and primary locators within a scope, and a clone
+   within a nested scope. */
+   hdsBegin( status );
+   datFind( loc1, "VALUE", &loc2, status );
+   hdsOpen( "hds_sctest", "READ", &loc3, status );
+   datFind( loc3, "OTHER", &loc4, status );
+
+   hdsBegin( status );
+   datClone( loc1, &loc5, status );
+   if( *status == SAI__OK && ( !loc2->scope || loc4->scope != loc2->scope ||
+                               loc5->scope == loc2->scope ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testScope error 1: Locators owned by wrong scope",
+              status );
+   }
+
+/* Ending the inner scope should annul the clone only. */
+   hdsEnd( status );
+   hdsInfoI( NULL, "LOCATORS", NULL, &nloc1, status );
+   if( *status == SAI__OK && nloc1 - nloc0 != 4 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testScope error 2: %d locators active (expected 4)",
+               status, nloc1 - nloc0 );
+   }
+
+/* Ending the outer scope should leave only the locator created outside
+   it, and the file should still be open. */
+   hdsEnd( status );
+   hdsInfoI( NULL, "LOCATORS", NULL, &nloc1, status );
+   hdsInfoI( NULL, "FILES", NULL, &nfile1, status );
+   if( *status == SAI__OK && ( nloc1 - nloc0 != 1 ||
+                               nfile1 - nfile0 != 1 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testScope error 3: %d locators and %d files active "
+               "(expected 1 and 1)", status, nloc1 - nloc0,
+               nfile1 - nfile0 );
+   }
+
+/* Secondary locators that are annulled automatically when their file is
+   closed should be freed at the end of the scope. Leave "loc4" unannulled
+   to check that hdsEnd closes the file. */
+   datAnnul( &loc1, status );
+   hdsBegin( status );
+   hdsOpen( "hds_sctest", "UPDATE", &loc1, status );
+   datFind( loc1, "VALUE", &loc2, status );
+   datPut0I( loc2, 1, status );
+   datAnnul( &loc1, status );
+   hdsOpen( "hds_sctest", "UPDATE", &loc3, status );
+   datFind( loc3, "OTHER", &loc4, status );
+   hdsEnd( status );
+   hdsInfoI( NULL, "LOCATORS", NULL, &nloc1, status );
+   hdsInfoI( NULL, "FILES", NULL, &nfile1, status );
+   if( *status == SAI__OK && ( nloc1 != nloc0 || nfile1 != nfile0 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testScope error 4: %d locators and %d files active "
+               "(expected 0 and 0)", status, nloc1 - nloc0,
+               nfile1 - nfile0 );
+   }
+
+/* An unmatched hdsEnd should report an error. */
+   if( *status == SAI__OK ) {
+      emsMark();
+      hdsEnd( status );
+      if( *status == DAT__FATAL ) {
+         emsAnnul( status );
+      } else {
+         if( *status != SAI__OK ) emsAnnul( status );
+         *status = DAT__FATAL;
+         emsRep( "", "testScope error 5: Unmatched hdsEnd did not fail",
+                 status );
+      }
+      emsRlse();
+   }
+
+   hdsOpen( "hds_sctest", "UPDATE", &loc1, status );
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestScope passed\n");
+   }
+}
+
+static void testDeferred( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HDSLoc *loc5 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   char type[ DAT__SZTYP + 1 ];
+   hdsbool_t struc;
+   hdsdim dims[ DAT__MXDIM ];
+   hdsdim sub = 2;
+   int ival;
+   int ndim;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 3;
+   hdsNew( "hds_dftest", "HDS_DFTEST", "TEST", 0, dims, &loc1, status );
+   datNew0I( loc1, "VALUE", status );
+   datNew( loc1, "STRUCTS", "ELEM", 1, dims, status );
+   datFind( loc1, "VALUE", &loc2, status );
+   datPut0I( loc2, 42, status );
+   datType( loc2, type, status );
+   datAnnul( &loc2, status );
+
+/* Queries on the name, type and structure-ness of a component should
+   not need to open it once they have been cached. */
+   datFind( loc1, "VALUE", &loc2, status );
+   datName( loc2, name, status );
+   datType( loc2, type, status );
+   datStruc( loc2, &struc, status );
+   if( *status == SAI__OK && ( loc2->dataset_id || !loc2->defer_id ||
+                               strcmp( name, "VALUE" ) ||
+                               strcmp( type, "_INTEGER" ) || struc ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testDeferred error 1: %s %s %d", status, name, type,
+               struc );
+   }
+
+/* A clone should also be unopened, and should survive the annulment of
+   the locators for the original component and its parent. */
+   datClone( loc2, &loc3, status );
+   datAnnul( &loc2, status );
+   datFind( loc1, "STRUCTS", &loc4, status );
+   datCell( loc4, 1, &sub, &loc5, status );
+   datNew0I( loc5, "INCELL", status );
+   datAnnul( &loc5, status );
+   datCell( loc4, 1, &sub, &loc5, status );
+   datAnnul( &loc4, status );
+   datShape( loc5, DAT__MXDIM, dims, &ndim, status );
+   if( *status == SAI__OK && ( loc3->dataset_id || !loc3->defer_id ||
+                               loc5->group_id || !loc5->defer_id ||
+                               ndim != 0 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeferred error 2: Objects opened unexpectedly",
+              status );
+   }
+
+/* Reading the value should open the dataset. */
+   datGet0I( loc3, &ival, status );
+   if( *status == SAI__OK && ( ival != 42 || !loc3->dataset_id ||
+                               loc3->defer_id ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testDeferred error 3: Got %d but expected 42", status,
+               ival );
+   }
+
+/* Looking for a component in the cell should open its group. */
+   datThere( loc5, "INCELL", &struc, status );
+   if( *status == SAI__OK && ( !struc || !loc5->group_id ||
+                               loc5->defer_id ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testDeferred error 4: Cell not opened", status );
+   }
+
+   datAnnul( &loc3, status );
+   datAnnul( &loc5, status );
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestDeferred passed\n");
+   }
+}
+
+static void testIterate( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   const char *names[] = { "ZETA", "ALPHA", "MIDDLE", "BETA" };
+   char name[ DAT__SZNAM + 1 ];
+   char visited[ 4*( DAT__SZNAM + 1 ) + 1 ];
+   hdsdim dim = 2;
+   int i;
+   int pass;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   hdsNew( "hds_ittest", "HDS_ITTEST", "TEST", 0, &dim, &loc1, status );
+   datNew0I( loc1, names[ 0 ], status );
+   datNew( loc1, names[ 1 ], "ELEM", 1, &dim, status );
+   datNew0D( loc1, names[ 2 ], status );
+   datNew0L( loc1, names[ 3 ], status );
+
+/* Check the order both before and after re-opening the file. */
+   for( pass = 0; pass < 2 && *status == SAI__OK; pass++ ) {
+      if( pass == 1 ) {
+         datAnnul( &loc1, status );
+         hdsOpen( "hds_ittest", "READ", &loc1, status );
+      }
+
+/* datIndex should return the components in order of creation, not in
+   alphabetical order. */
+      for( i = 0; i < 4 && *status == SAI__OK; i++ ) {
+         datIndex( loc1, i + 1, &loc2, status );
+         datName( loc2, name, status );
+         datAnnul( &loc2, status );
+         if( *status == SAI__OK && strcmp( name, names[ i ] ) ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testIterate error 1: Component %d is %s (expected "
+                     "%s)", status, i + 1, name, names[ i ] );
+         }
+      }
+
+/* datIterate should visit the components in the same order. */
+      visited[ 0 ] = 0;
+      datIterate( loc1, testIterateFunc, visited, status );
+      if( *status == SAI__OK && strcmp( visited, "ZETA ALPHA MIDDLE BETA " ) ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testIterate error 2: Visited '%s'", status, visited );
+      }
+   }
+
+/* The iteration should stop early if the function returns non-zero
+   (testIterateFunc stops at ALPHA). An untouched cell has no
+   components. */
+   datFind( loc1, "ALPHA", &loc2, status );
+   datCell( loc2, 1, &dim, &loc3, status );
+   datIterate( loc3, testIterateFunc, visited, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   if( *status == SAI__OK && strcmp( visited, "ZETA ALPHA MIDDLE BETA " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testIterate error 3: Visited '%s'", status, visited );
+   }
+
+   strcpy( visited, "STOP " );
+   datIterate( loc1, testIterateFunc, visited, status );
+   if( *status == SAI__OK && strcmp( visited, "STOP ZETA ALPHA " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testIterate error 4: Visited '%s'", status, visited );
+   }
+
+   datAnnul( &loc1, status );
+   hdsOpen( "hds_ittest", "UPDATE", &loc1, status );
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestIterate passed\n");
+   }
+}
+
+/* Append the name of the supplied component to the string pointed to by
+   "data". Ends the iteration at component ALPHA if the string starts
+   with "STOP". */
+static int testIterateFunc( HDSLoc *comp, void *data, int *status ){
+   char *visited = data;
+   char name[ DAT__SZNAM + 1 ];
+
+   datName( comp, name, status );
+   if( *status != SAI__OK ) return 1;
+
+   strcat( visited, name );
+   strcat( visited, " " );
+   return !strncmp( visited, "STOP", 4 ) && !strcmp( name, "ALPHA" );
+}
+
+static void testWalk( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   char visited[ 512 ];
+   hdsdim dims[ 2 ];
+   hdsdim sub[ 2 ];
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   dims[ 0 ] = 2;
+   dims[ 1 ] = 3;
+   hdsNew( "hds_wktest", "HDS_WKTEST", "TEST", 0, dims, &loc1, status );
+   datNew1I( loc1, "VALUES", 4, status );
+   datNew( loc1, "RECORDS", "REC", 2, dims, status );
+   datNew0D( loc1, "SCALAR", status );
+   datFind( loc1, "SCALAR", &loc2, status );
+   datPut0D( loc2, 1.0, status );
+   datAnnul( &loc2, status );
+
+/* Only one cell of the structure array has any components. */
+   sub[ 0 ] = 1;
+   sub[ 1 ] = 2;
+   datFind( loc1, "RECORDS", &loc2, status );
+   datCell( loc2, 2, sub, &loc3, status );
+   datNewC( loc3, "LABEL", 8, 0, dims, status );
+   datAnnul( &loc3, status );
+
+/* Each object is visited before its contents, and the cells of the
+   structure array are visited in Fortran order. Primitives that have
+   no value are flagged with a "?". */
+   visited[ 0 ] = 0;
+   datWalk( loc1, testWalkFunc, visited, HDS_WALK_STATE, status );
+   if( *status == SAI__OK && strcmp( visited,
+         "0:HDS_WKTEST:TEST "
+         "1:HDS_WKTEST.VALUES:_INTEGER(4)? "
+         "1:HDS_WKTEST.RECORDS:REC(2,3) "
+         "2:HDS_WKTEST.RECORDS(1,1):REC "
+         "2:HDS_WKTEST.RECORDS(2,1):REC "
+         "2:HDS_WKTEST.RECORDS(1,2):REC "
+         "3:HDS_WKTEST.RECORDS(1,2).LABEL:_CHAR*8? "
+         "2:HDS_WKTEST.RECORDS(2,2):REC "
+         "2:HDS_WKTEST.RECORDS(1,3):REC "
+         "2:HDS_WKTEST.RECORDS(2,3):REC "
+         "1:HDS_WKTEST.SCALAR:_DOUBLE " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testWalk error 1: Visited '%s'", status, visited );
+   }
+
+/* Walk a sub-tree without visiting cells. */
+   visited[ 0 ] = 0;
+   datWalk( loc2, testWalkFunc, visited, HDS_WALK_NOCELLS, status );
+   if( *status == SAI__OK && strcmp( visited, "0:RECORDS:REC(2,3) " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testWalk error 2: Visited '%s'", status, visited );
+   }
+   datAnnul( &loc2, status );
+
+/* The walk should end if the function returns non-zero (testWalkFunc
+   stops at the first cell). */
+   strcpy( visited, "STOP " );
+   datWalk( loc1, testWalkFunc, visited, 0, status );
+   if( *status == SAI__OK && strcmp( visited, "STOP 0:HDS_WKTEST:TEST "
+         "1:HDS_WKTEST.VALUES:_INTEGER(4)? 1:HDS_WKTEST.RECORDS:REC(2,3) "
+         "2:HDS_WKTEST.RECORDS(1,1):REC " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testWalk error 3: Visited '%s'", status, visited );
+   }
+
+   hdsShow( "DATA", status );
+   hdsErase( &loc1, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestWalk passed\n");
+   }
+}
+
+/* Append a description of the supplied node to the string pointed to
+   by "data". Ends the walk at the first cell if the string starts with
+   "STOP". */
+static int testWalkFunc( const HDSWalkNode *node, void *data, int *status ){
+   char *visited = data;
+   char *p = visited + strlen( visited );
+   int i;
+
+   p += sprintf( p, "%d:%s:%s", node->level, node->path, node->type );
+   for( i = 0; i < node->ndim; i++ ) {
+      p += sprintf( p, "%s%" HDS_DIM_FORMAT "%s", i ? "," : "(",
+                    node->dims[ i ], ( i == node->ndim - 1 ) ? ")" : "" );
+   }
+   if( !node->isstruc && !node->state ) strcpy( p, "?" );
+   strcat( visited, " " );
+
+   return !strncmp( visited, "STOP", 4 ) && node->iscell;
+}
+
+static void testCatalogue( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   char expected[ 512 ];
+   char name[ DAT__SZNAM + 1 ];
+   char visited[ 512 ];
+   hdsdim dims[ 2 ];
+   hdsdim sub[ 2 ];
+   int catalogue;
+   int i;
+   int ncomp;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* Create a file with a catalogue. */
+   hdsGtune( "CATALOGUE", &catalogue, status );
+   hdsTune( "CATALOGUE", 1, status );
+   dims[ 0 ] = 2;
+   dims[ 1 ] = 3;
+   hdsNew( "hds_cattest", "HDS_CATTEST", "TEST", 0, dims, &loc1, status );
+   datNew1I( loc1, "VALUES", 4, status );
+   datNew( loc1, "RECORDS", "REC", 2, dims, status );
+   datNew0D( loc1, "SCALAR", status );
+   datFind( loc1, "SCALAR", &loc2, status );
+   datPut0D( loc2, 1.0, status );
+   datAnnul( &loc2, status );
+   sub[ 0 ] = 1;
+   sub[ 1 ] = 2;
+   datFind( loc1, "RECORDS", &loc2, status );
+   datCell( loc2, 2, sub, &loc3, status );
+   datNewC( loc3, "LABEL", 8, 0, dims, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   datAnnul( &loc1, status );
+   hdsTune( "CATALOGUE", 0, status );
+
+/* The catalogue should describe the file exactly as datWalk does. */
+   hdsOpen( "hds_cattest", "READ", &loc1, status );
+   expected[ 0 ] = 0;
+   datWalk( loc1, testWalkFunc, expected, HDS_WALK_STATE, status );
+   visited[ 0 ] = 0;
+   datCatalogue( loc1, testWalkFunc, visited, HDS_WALK_STATE, status );
+   if( *status == SAI__OK && strcmp( visited, expected ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 1: Visited '%s'", status, visited );
+   }
+
+/* List a cell of the structure array, and the array without its cells. */
+   datFind( loc1, "RECORDS", &loc2, status );
+   datCell( loc2, 2, sub, &loc3, status );
+   visited[ 0 ] = 0;
+   datCatalogue( loc3, testWalkFunc, visited, HDS_WALK_STATE, status );
+   if( *status == SAI__OK && strcmp( visited, "0:RECORDS(1,2):REC "
+                                     "1:RECORDS(1,2).LABEL:_CHAR*8? " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 2: Visited '%s'", status, visited );
+   }
+   datAnnul( &loc3, status );
+
+   visited[ 0 ] = 0;
+   datCatalogue( loc2, testWalkFunc, visited, HDS_WALK_NOCELLS, status );
+   if( *status == SAI__OK && strcmp( visited, "0:RECORDS:REC(2,3) " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 3: Visited '%s'", status, visited );
+   }
+   datAnnul( &loc2, status );
+
+/* The catalogue should not be a component of the top-level structure. */
+   datNcomp( loc1, &ncomp, status );
+   if( *status == SAI__OK && ncomp != 3 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 6: Got %d components but expected 3",
+               status, ncomp );
+   }
+   visited[ 0 ] = 0;
+   for( i = 1; i <= ncomp && *status == SAI__OK; i++ ) {
+      datIndex( loc1, i, &loc2, status );
+      datName( loc2, name, status );
+      strcat( visited, name );
+      strcat( visited, " " );
+      datAnnul( &loc2, status );
+   }
+   if( *status == SAI__OK && strcmp( visited, "VALUES RECORDS SCALAR " ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 7: Got components '%s'", status,
+               visited );
+   }
+   datAnnul( &loc1, status );
+
+/* Changing the file should update the catalogue when the file is
+   closed. While the file is open, the objects are found by walking the
+   file. */
+   hdsTune( "CATALOGUE", 1, status );
+   hdsOpen( "hds_cattest", "UPDATE", &loc1, status );
+   datErase( loc1, "VALUES", status );
+   visited[ 0 ] = 0;
+   datCatalogue( loc1, testWalkFunc, visited, 0, status );
+   if( *status == SAI__OK && strstr( visited, "VALUES" ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 4: Visited '%s'", status, visited );
+   }
+   datAnnul( &loc1, status );
+
+   hdsOpen( "hds_cattest", "READ", &loc1, status );
+   expected[ 0 ] = 0;
+   datWalk( loc1, testWalkFunc, expected, HDS_WALK_STATE, status );
+   visited[ 0 ] = 0;
+   datCatalogue( loc1, testWalkFunc, visited, HDS_WALK_STATE, status );
+   if( *status == SAI__OK && ( strcmp( visited, expected ) ||
+                               strstr( visited, "VALUES" ) ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 5: Visited '%s'", status, visited );
+   }
+   datAnnul( &loc1, status );
+
+/* Changing a nested object while the CATALOGUE tuning parameter is not
+   set leaves the catalogue out of date, so the objects should then be
+   found by walking the file (the catalogue would show the LABEL
+   component as undefined). */
+   hdsTune( "CATALOGUE", 0, status );
+   hdsOpen( "hds_cattest", "UPDATE", &loc1, status );
+   datFind( loc1, "RECORDS", &loc2, status );
+   datCell( loc2, 2, sub, &loc3, status );
+   datFind( loc3, "LABEL", &loc4, status );
+   datPut0C( loc4, "EDITED", status );
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   datAnnul( &loc1, status );
+
+   hdsOpen( "hds_cattest", "READ", &loc1, status );
+   expected[ 0 ] = 0;
+   datWalk( loc1, testWalkFunc, expected, HDS_WALK_STATE, status );
+   visited[ 0 ] = 0;
+   datCatalogue( loc1, testWalkFunc, visited, HDS_WALK_STATE, status );
+   if( *status == SAI__OK && ( strcmp( visited, expected ) ||
+                               strstr( visited, "LABEL:_CHAR*8?" ) ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCatalogue error 8: Visited '%s'", status, visited );
+   }
+
+   hdsErase( &loc1, status );
+   hdsTune( "CATALOGUE", catalogue, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestCatalogue passed\n");
+   }
+}
+
+static void testThreadSafety( const char *path, int *status ) {
+
+/* Local Variables; */
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc1b = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HDSLoc *loc4b = NULL;
+   hdsdim dims[2];
+   int ival;
+   pthread_t t1, t2;
+   threadData threaddata1;
+   threadData threaddata2;
+   double *ip1;
+   double *ip2;
+   hdsdim dim;
+   hdsdim i;
+   char typestr[DAT__SZTYP+1];
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* Open the HDS file created by the initial testing above. */
+   hdsOpen( path, "Read", &loc1, status );
+
+/* Get a locator for component "HDS_TEST.RECORDS(3,2).INTINCELL" */
+   datFind( loc1, "Records", &loc2, status );
+   dims[0] = 3;
+   dims[1] = 2;
+   datCell( loc2, 2, dims, &loc3, status );
+   datAnnul( &loc2, status );
+   datFind( loc3, "IntInCell", &loc4, status );
+   datAnnul( &loc3, status );
+
+/* Check it has the value -999 (assiged when it was created). */
+   datGet0I( loc4, &ival, status );
+   if( ival != -999 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRepf("", "testThreadSafety error 1: Got %d but expected -999", status,
+              ival );
+   }
+
+/* Check the top level object is locked for read-only access by the current
+   thread. */
+   ival = datLocked( loc1, 0, status );
+   if( ival != 3 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 101: Top-level object not "
+              "locked by current thread.",  status );
+   }
+
+/* Check the bottom level object is also locked by the current thread. */
+   ival = datLocked( loc4, 1, status );
+   if( ival != 3 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 102: Bottom-level object not "
+              "locked by current thread.",  status );
+   }
+
+/* Open the HDS file again. Note we have not yet closed it, so it is now
+   open twice. */
+   hdsOpen( path, "Read", &loc1b, status );
+
+/* Get a locator for the same component as before. */
+   datFind( loc1b, "Records", &loc2, status );
+   dims[0] = 3;
+   dims[1] = 2;
+   datCell( loc2, 2, dims, &loc3, status );
+   datAnnul( &loc2, status );
+   datFind( loc3, "IntInCell", &loc4b, status );
+   datAnnul( &loc3, status );
+
+/* Check it has the value -999. */
+   datGet0I( loc4b, &ival, status );
+   if( ival != -999 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRepf("", "testThreadSafety error 2: Got %d but expected -999", status,
+              ival );
+   }
+
+/* Check the top level object is locked by the current thread. */
+   ival = datLocked( loc1b, 0, status );
+   if( ival != 3 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 201: Top-level object not "
+              "locked by current thread.",  status );
+   }
+
+/* Check the bottom level object is also locked by the current thread. */
+   ival = datLocked( loc4b, 1, status );
+   if( ival != 3 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 202: Bottom-level object not "
+              "locked by current thread.",  status );
+   }
+
+/* Promote the lock to a read/write lock using the first locator. */
+   datLock( loc1, 1, 0, status );
+
+/* Check the other locator now also has a read/write lock. */
+   ival = datLocked( loc1b, 0, status );
+   if( ival != 1 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 2021: Top-level object not "
+              "locked by current thread.",  status );
+   }
+
+/* Required for use of EMS within threads. */
+   emsMark();
+
+/* Create two threads, and pass a locator for the top-level object to each.
+   Note, these locators are still locked for read/write by the current thread,
+   so we should get DAT__THREAD errors when test1ThreadSafety tries to use
+   them. */
+   if( *status == SAI__OK ) {
+      threaddata1.loc = loc1;
+      pthread_create( &t1, NULL, test1ThreadSafety, &threaddata1 );
+      threaddata2.loc = loc1b;
+      pthread_create( &t2, NULL, test1ThreadSafety, &threaddata2 );
+
+/* Wait for them to terminate. */
+      pthread_join( t1, NULL );
+      pthread_join( t2, NULL );
+      emsStat( status );
+   }
+
+/* Unlock the top level object using the first locator. Then check that
+   it is also unlocked using the second locator. */
+   datUnlock( loc1, 0, status );
+   ival = datLocked( loc1b, 0, status );
+   if( ival != 0 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 203: Top-level object still "
+              "locked.",  status );
+   }
+
+/* The above unlock was non-recursive so check the bottom of the tree is
+   still locked. */
+   if( !datLocked( loc4b, 1, status ) && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 204: Bottom-level object not "
+              "locked.",  status );
+   }
+
+/* Now lock it again and then unlock the top recursively. Then check the
+   bottom is no longer locked. */
+   datLock( loc1b, 1, 1, status );
+   datUnlock( loc1b, 1, status );
+   if( datLocked( loc4, 1, status ) && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testThreadSafety error 206: Bottom-level object still "
+              "locked.",  status );
+   }
+
+/* Attempt to access the two top-level objects in two separate threads.
+   Each thread attempt to lock the object read/write, but only one can
+   win (assuming that the second thread starts up before the first thread
+   has finished and unlocked the object).
+   The other should report an error. */
+   if( *status == SAI__OK ) {
+      threaddata1.id = 1;
+      threaddata1.rdonly = 0;
+      threaddata1.loc = loc1;
+      pthread_create( &t1, NULL, test2ThreadSafety, &threaddata1 );
+      threaddata2.id = 2;
+      threaddata2.rdonly = 0;
+      threaddata2.loc = loc1b;
+      pthread_create( &t2, NULL, test2ThreadSafety, &threaddata2 );
+
+/* Wait for them to terminate. */
+      pthread_join( t1, NULL );
+      pthread_join( t2, NULL );
+      emsStat( status );
+
+/* Sanity check: if either of the threads failed, check that the status
+   value reflects this. */
+      if( threaddata1.status != SAI__OK || threaddata2.status != SAI__OK ) {
+         if( *status == SAI__OK ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "ems failed to detect an error that occurred "
+                     "within a thread (test2, error code %d or %d)", status,
+                     threaddata1.status, threaddata2.status );
+         }
+      }
+
+/* Check one, and only one, failed. */
+      if( threaddata1.failed + threaddata2.failed != 1 && *status == SAI__OK ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testThreadSafety error 205: %d read-write lock attempts "
+                  "failed - expected exactly 1 to fail.",  status,
+                  threaddata1.failed + threaddata2.failed );
+      }
+
+   }
+
+/* Attempt to access the two top-level objects in two separate threads.
+   Each thread attempt to lock the object read-only. Both should be
+   successful. */
+   if( *status == SAI__OK ) {
+      threaddata1.rdonly = 1;
+      threaddata1.loc = loc1;
+      pthread_create( &t1, NULL, test2ThreadSafety, &threaddata1 );
+      threaddata2.rdonly = 1;
+      threaddata2.loc = loc1b;
+      pthread_create( &t2, NULL, test2ThreadSafety, &threaddata2 );
+
+/* Wait for them to terminate. */
+      pthread_join( t1, NULL );
+      pthread_join( t2, NULL );
+      emsStat( status );
+
+/* Sanity check: if either of the threads failed, check that the status
+   value reflects this. */
+      if( threaddata1.status != SAI__OK || threaddata2.status != SAI__OK ) {
+         if( *status == SAI__OK ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "ems failed to detect an error that occurred "
+                     "within a thread (test3, error code %d or %d)", status,
+                     threaddata1.status, threaddata2.status );
+         }
+      }
+
+/* Check neither failed. */
+      if( threaddata1.failed + threaddata2.failed > 0 && *status == SAI__OK ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testThreadSafety error 2051: %d read-only lock attempts failed "
+                  "- expected 0 to fail.",  status,
+                  threaddata1.failed + threaddata2.failed );
+      }
+   }
+
+/* Lock both top level locators for read-only use by the current thread. The
+   second of these calls will have no effect as the two locators refer to the
+   same object. These locks are recursive. */
+   datLock( loc1, 1, 1, status );
+   datLock( loc1b, 1, 1, status );
+
+/* Annul the first primary locator for the file. */
+   datAnnul( &loc1, status );
+
+/* Each thread creates a temporary object holding a large array of doubles
+   and does some heavy work on it. */
+   if( *status == SAI__OK ) {
+      pthread_create( &t1, NULL, test3ThreadSafety, &threaddata1 );
+      pthread_create( &t2, NULL, test3ThreadSafety, &threaddata2 );
+
+/* Wait for them to terminate. */
+      pthread_join( t1, NULL );
+      pthread_join( t2, NULL );
+      emsStat( status );
+
+/* Lock the locators for the arrays so that the current thread can have
+   read-only access them. */
+      datLock( threaddata1.loc, 0, 1, status );
+      datLock( threaddata2.loc, 0, 1, status );
+
+/* Check the two threads created equal values. */
+      dim = 10000;
+      datMap( threaddata1.loc, "_DOUBLE", "Read", 1, &dim, (void **) &ip1, status );
+      datMap( threaddata2.loc, "_DOUBLE", "Read", 1, &dim, (void **) &ip2, status );
+      if( *status == SAI__OK ) {
+         for( i = 0; i < dim; i++ ) {
+            if( ip1[i] != ip2[i] ) {
+               *status = DAT__FATAL;
+               emsRepf( "", "testThreadSafety error 206: Threads created "
+                        "different values (%.20g anbd %.20g) at element %"
+                        HDS_DIM_FORMAT, status, ip1[i], ip2[i], i );
+            }
+         }
+      }
+
+      datUnmap( threaddata1.loc, status );
+      datUnmap( threaddata2.loc, status );
+
+/* Attempt to modify each object. This should generate an error since
+   the current thread does not have a read-write lock on either of them. */
+      dims[0] = 10;
+      datCell( threaddata1.loc, 1, dims, &loc3, status );
+      if( *status == SAI__OK ) {
+         datPut0D( loc3, 1.0, status );
+         if( *status == DAT__THREAD ) {
+            emsAnnul( status );
+         } else {
+            int oldstat = *status;
+            emsAnnul( status );
+            *status = DAT__FATAL;
+            emsRepf("", "testThreadSafety error 207: Expected a DAT__LOCIN "
+                    "error but got status=%d", status, oldstat );
+         }
+         datAnnul( &loc3, status );
+      }
+
+      datCell( threaddata2.loc, 1, dims, &loc3, status );
+      if( *status == SAI__OK ) {
+         datPut0D( loc3, 1.0, status );
+         if( *status == DAT__THREAD ) {
+            emsAnnul( status );
+         } else {
+            int oldstat = *status;
+            emsAnnul( status );
+            *status = DAT__FATAL;
+            emsRepf("", "testThreadSafety error 208: Expected a DAT__LOCIN "
+                    "error but got status=%d", status, oldstat );
+         }
+         datAnnul( &loc3, status );
+      }
+
+      datAnnul( &(threaddata1.loc), status );
+      datAnnul( &(threaddata2.loc), status );
+   }
+
+/* Check for the exit status */
+   if( *status == SAI__OK ) emsStat( status );
+   emsRlse();
+
+
+/* The file should still be open because of the second locator. So test
+   the integer value can still be accessed using "loc4b" and "loc4". */
+   datGet0I( loc4, &ival, status );
+   if( ival != -999 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+      emsRepf("", "testThreadSafety error 3: Got %d but expected -999", status,
+              ival );
+   }
+
+   datGet0I( loc4b, &ival, status );
+   if( ival != -999 && *status == SAI__OK ) {
+      *status = DAT__FATAL;
+       emsRepf("", "testThreadSafety error 4: Got %d but expected -999", status,
+              ival );
+  }
+
+
+/* Annul the second primary locator for the file. */
+   datAnnul( &loc1b, status );
+
+/* The file should now be closed, so check an error is reported if
+   loc4/loc4b is used. */
+   if( *status == SAI__OK ) {
+      datGet0I( loc4, &ival, status );
+      if( *status == DAT__LOCIN ) {
+         emsAnnul( status );
+      } else {
+         int oldstat = *status;
+         emsAnnul( status );
+         *status = DAT__FATAL;
+         emsRepf("", "testThreadSafety error 5: Expected a DAT__LOCIN "
+                 "error but got status=%d", status, oldstat );
+      }
+   }
+
+/* Open the file again (read-only) in a thread. After opening the file
+   the thread blocks until condition variable cond_page is broadcast. */
+   emsMark();
+   threaddata2.path = path;
+   threaddata2.stage = 0;
+   pthread_create( &t1, NULL, test4ThreadSafety, &threaddata2 );
+
+/* Block until the thread signals that the HDS file has been opened. */
+   pthread_mutex_lock( &mutex );
+   while( threaddata2.stage != 1 ) pthread_cond_wait( &cond, &mutex );
+   pthread_mutex_unlock( &mutex );
+
+/* Attempt also to open the file in this thread. */
+   hdsOpen( path, "Read", &loc1b, status );
+
+/* Attempt to use the locator for something. */
+   datType( loc1b, typestr, status );
+
+/* Broadcast the signal that tells the thread to close the file. */
+   pthread_mutex_lock( &mutex );
+   threaddata2.stage = 2;
+   pthread_cond_broadcast( &cond );
+   pthread_mutex_unlock( &mutex );
+
+/* Attempt to use this thread's locator again. */
+   datType( loc1b, typestr, status );
+
+/* Close the file in this thread too. */
+   datAnnul( &loc1b, status );
+
+/* Wait for the thread to finish, since it writes to threaddata2. */
+   pthread_join( t1, NULL );
+
+   if( *status == SAI__OK ) emsStat( status );
+   emsRlse();
+
+
+
+   if( *status == SAI__OK ) {
+      printf( "TestThreadSafety passed\n" );
+   } else {
+      emsRep( " ", "TestThreadSafety failed", status );
+   }
+
+}
+
+
+
+void *test1ThreadSafety( void *data ) {
+   threadData *tdata = (threadData *) data;
+   HDSLoc *loc1 = tdata->loc;
+   HDSLoc *loc2 = NULL;
+   int status = SAI__OK;
+
+
+   datFind( loc1, "Records", &loc2, &status );
+   datAnnul( &loc2, &status );
+
+   if( status == DAT__THREAD ) {
+      emsAnnul( &status );
+
+   } else if( status == SAI__OK ) {
+      status = DAT__FATAL;
+      emsRepf("", "testThreadSafety error A1: Expected a DAT__THREAD "
+              "error but no error was reported", &status );
+
+   } else {
+      int oldstat = status;
+      emsAnnul( &status );
+      status = DAT__FATAL;
+      emsRepf("", "testThreadSafety error A1: Expected a DAT__THREAD "
+              "error but got status=%d", &status, oldstat );
+   }
+
+   tdata->status = status;
+   return NULL;
+}
+
+
+void *test2ThreadSafety( void *data ) {
+   threadData *tdata = (threadData *) data;
+   HDSLoc *loc1 = tdata->loc;
+   HDSLoc *loc2 = NULL;
+   int status = SAI__OK;
+   int expect = tdata->rdonly ? 3 : 1;
+   int i, ii;
+
+   datLock( loc1, 1, tdata->rdonly, &status );
+   if( status == DAT__THREAD ) {
+      emsAnnul( &status );
+      tdata->failed = 1;
+   } else if( status == SAI__OK ){
+
+      tdata->failed = 0;
+      datFind( loc1, "Records", &loc2, &status );
+
+      /* Check the component locator is locked by the current thread. */
+      ii = datLocked( loc2, 1, &status );
+      if( ii != expect && status == SAI__OK ) {
+         status = DAT__FATAL;
+         emsRepf("", "testThreadSafety error B1: loc2 is not locked by "
+                 "current thread (%d %d). ", &status, ii, expect );
+
+      }
+      datAnnul( &loc2, &status );
+
+      /* Do something time consuming to make it likely that this thread
+         will not have finished (and so unlocked the object), before the other
+         thread starts. */
+      for( i = 0; i < 1000000; i++ ) {
+         ii = datLocked( loc1, 1, &status );
+         if( ii != expect && status == SAI__OK ) {
+            status = SAI__ERROR;
+            emsRepf( " ", "test2ThreadSafety: Unexpected lock status %d - "
+                     "expected %d", &status, ii, expect );
+            break;
+         }
+      }
+
+      datUnlock( loc1, 1, &status );
+
+   }
+
+   tdata->status = status;
+
+   return NULL;
+}
+
+void *test3ThreadSafety( void *data ) {
+   threadData *tdata = (threadData *) data;
+   HDSLoc *loc1 = NULL;
+   int status = SAI__OK;
+   hdsdim i,k,dim;
+   double *ip;
+   double alpha = 0.1;
+
+   dim = 10000;
+   datTemp( "_DOUBLE", 1, &dim, &loc1, &status );
+   datMap( loc1, "_DOUBLE", "Write", 1, &dim, (void **) &ip, &status );
+   if( status == SAI__OK ) {
+      memset( ip, 0, sizeof(*ip)*dim );
+      *ip = 1E6;
+      for( k = 0; k < 10000; k++ ) {
+
+         double delta2 = 2*alpha*( ip[0] - ip[1] );
+         ip[0] -= delta2;
+         ip[1] += delta2;
+
+         for( i = 1; i < dim-1; i++ ) {
+            double delta1 = alpha*( ip[i] - ip[i-1] );
+            double delta2 = alpha*( ip[i] - ip[i+1] );
+            ip[i] -= delta1 + delta2;
+            ip[i-1] += delta1;
+            ip[i+1] += delta2;
+         }
+
+         double delta1 = 2*alpha*( ip[i] - ip[i-1] );
+         ip[i] -= delta1;
+         ip[i-1] += delta1;
+      }
+   }
+
+   datUnmap( loc1, &status );
+   datUnlock( loc1, 0, &status );
+   tdata->loc = loc1;
+
+   return NULL;
+}
+
+
+void *test4ThreadSafety( void *data ) {
+   threadData *tdata = (threadData *) data;
+   HDSLoc *loc1 = NULL;
+   char typestr[DAT__SZTYP+1];
+   int status = SAI__OK;
+
+   hdsOpen( tdata->path, "Read", &loc1, &status );
+   datType( loc1, typestr, &status );
+
+   pthread_mutex_lock( &mutex );
+   tdata->stage = 1;
+   pthread_cond_broadcast( &cond );
+   while( tdata->stage != 2 ) pthread_cond_wait( &cond, &mutex );
+   pthread_mutex_unlock( &mutex );
+
+   datAnnul( &loc1, &status );
+
+   tdata->status = status;
+   return NULL;
+}
+
+
+
+
+
+
+
+/* Display information about the locs on a locator. */
+void showloc( HDSLoc *loc, const char *title, int indent ) {
+   int i;
+   pthread_mutex_lock(&mutex);
+   printf("\n");
+   for( i = 0; i < indent; i++ ) printf(" ");
+   printf( "%s\n", title );
+   for( i = 0; i < indent; i++ ) printf(" ");
+   for( i = 0; i < strlen(title); i++ ) printf("-");
+   printf("\n");
+   showhan( loc->handle, indent );
+   pthread_mutex_unlock(&mutex);
+}
+
+void showhan( Handle *h, int indent ) {
+   if( !h ) return;
+
+   int i;
+   for( i = 0; i < indent; i++ ) printf(" ");
+   printf("'%s' ", h->name ? h->name : " " );
+   if( h->write_owner ) printf("w:%zu ", h->write_owner );
+   for( i = 0; i < h->nread_lock; i++ ) {
+      printf("r:%zu ", h->read_lockers[ i ] );
+   }
+   printf("\n");
+
+   for( i = 0; i < h->nchild; i++ ) {
+      showhan( h->children[i], indent + 3 );
+   }
+}
+
+static void testCompact( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   double dvals[ 20 ];
+   hdsbool_t state;
+   hdsdim dim;
+   int compact;
+   int i;
+   int ival;
+   int value;
+   size_t actval;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* The COMPACT tuning parameter is limited to the size of an object
+   header message. */
+   hdsGtune( "COMPACT", &compact, status );
+   hdsTune( "COMPACT", 1000000, status );
+   hdsGtune( "COMPACT", &value, status );
+   if( *status == SAI__OK && value != HDS__MXCOMPACT ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCompact error 1: Got COMPACT=%d", status, value );
+   }
+
+/* Use a compact layout for primitives of up to 64 bytes. */
+   hdsTune( "COMPACT", 64, status );
+   hdsNew( "hds_cmptest", "HDS_CMPTEST", "TEST", 0, &dim, &loc1, status );
+
+/* A compact scalar is undefined until a value is stored in it, and
+   undefined again after it is reset. */
+   datNew0I( loc1, "SCALAR", status );
+   datFind( loc1, "SCALAR", &loc2, status );
+   datState( loc2, &state, status );
+   if( *status == SAI__OK && state ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompact error 2: New scalar is defined", status );
+   }
+   datPut0I( loc2, 42, status );
+   datState( loc2, &state, status );
+   datGet0I( loc2, &ival, status );
+   if( *status == SAI__OK && ( !state || ival != 42 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCompact error 3: Got %d (state %d)", status,
+               ival, state );
+   }
+   datReset( loc2, status );
+   datState( loc2, &state, status );
+   if( *status == SAI__OK && state ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompact error 4: Reset scalar is defined", status );
+   }
+
+/* A string that can not be converted is not written, so the scalar is
+   still undefined. Numerical values that can not be converted are
+   written as bad values, so the scalar is then defined. */
+   if( *status == SAI__OK ) {
+      datPut0C( loc2, "notanumber", status );
+      if( *status != SAI__OK ) emsAnnul( status );
+      datState( loc2, &state, status );
+      if( *status == SAI__OK && state ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testCompact error 4a: Scalar is defined after a "
+                 "failed conversion", status );
+      }
+   }
+   if( *status == SAI__OK ) {
+      datPut0D( loc2, 1.0E20, status );
+      if( *status == DAT__CONER ) emsAnnul( status );
+      datState( loc2, &state, status );
+      if( *status == SAI__OK && !state ) {
+         *status = DAT__FATAL;
+         emsRep( "", "testCompact error 4b: Scalar is undefined after a "
+                 "numerical conversion error", status );
+      }
+   }
+   datReset( loc2, status );
+   datState( loc2, &state, status );
+   if( *status == SAI__OK && state ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompact error 4c: Reset scalar is defined", status );
+   }
+   datAnnul( &loc2, status );
+
+/* Extend a compact array beyond the limit, so that it is recreated with
+   a contiguous layout, and check its values are retained. */
+   dim = 4;
+   datNew1D( loc1, "ARRAY", dim, status );
+   datFind( loc1, "ARRAY", &loc2, status );
+   for( i = 0; i < dim; i++ ) dvals[ i ] = i + 1.0;
+   datPut1D( loc2, dim, dvals, status );
+   dim = 20;
+   datAlter( loc2, 1, &dim, status );
+   datAnnul( &loc2, status );
+   datAnnul( &loc1, status );
+
+   hdsOpen( "hds_cmptest", "READ", &loc1, status );
+   datFind( loc1, "ARRAY", &loc2, status );
+   datGet1D( loc2, dim, dvals, &actval, status );
+   if( *status == SAI__OK && actval != 20 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testCompact error 5: Got %zu values", status, actval );
+   }
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 20; i++ ) {
+         if( dvals[ i ] != ( i < 4 ? i + 1.0 : 0.0 ) ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompact error 5: Element %d is %g", status,
+                     i + 1, dvals[ i ] );
+            break;
+         }
+      }
+   }
+   datAnnul( &loc2, status );
+
+/* The state of a compact primitive is preserved in the file. */
+   datFind( loc1, "SCALAR", &loc2, status );
+   datState( loc2, &state, status );
+   if( *status == SAI__OK && state ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompact error 6: Reopened scalar is defined", status );
+   }
+   datAnnul( &loc2, status );
+
+   hdsErase( &loc1, status );
+   hdsTune( "COMPACT", compact, status );
+
+   if( *status == SAI__OK ) {
+      printf("TestCompact passed\n");
+   }
+}
+
+static void testCompress( int *status ){
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HdsTypeInfo *typeinfo = dat1TypeInfo();
+   double diff;
+   float fvals[ 1200 ];
+   float *fptr = NULL;
+   hdsdim chunk[ DAT__MXDIM ];
+   hdsdim dim;
+   hdsdim dims[ 2 ];
+   hdsdim pchunk[ 2 ];
+   int *iptr = NULL;
+   int chunksize;
+   int deflate;
+   int i;
+   int ivals[ 12000 ];
+   size_t nel;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+   hdsGtune( "DEFLATE", &deflate, status );
+   hdsGtune( "CHUNKSIZE", &chunksize, status );
+   hdsNew( "hds_cprtest", "HDS_CPRTEST", "TEST", 0, &dim, &loc1, status );
+
+/* A chunk dimension of zero is an error. */
+   dims[ 0 ] = 40;
+   dims[ 1 ] = 30;
+   pchunk[ 0 ] = 16;
+   pchunk[ 1 ] = 0;
+   datInitProps( &props, status );
+   props.chunk = pchunk;
+   if( *status == SAI__OK ) {
+      datNewP( loc1, "BAD", "_REAL", 2, dims, &props, status );
+      if( *status == DAT__DIMIN ) {
+         emsAnnul( status );
+      } else {
+         if( *status == SAI__OK ) *status = DAT__FATAL;
+         emsRep( "", "testCompress error 1: Zero chunk size accepted",
+                 status );
+      }
+   }
+
+/* Create a 2-D _REAL array with explicit chunks, compressed and
+   checksummed. */
+   pchunk[ 1 ] = 8;
+   props.deflate = 6;
+   props.shuffle = 1;
+   props.fletcher32 = 1;
+   datNewP( loc1, "IMAGE", "_REAL", 2, dims, &props, status );
+   datFind( loc1, "IMAGE", &loc2, status );
+   dat1OpenDeferred( loc2, status );
+   dat1DatasetProps( loc2->dataset_id, &props, chunk, status );
+   if( *status == SAI__OK && ( !props.chunk || chunk[ 0 ] != 16 ||
+                               chunk[ 1 ] != 8 || props.deflate != 6 ||
+                               !props.shuffle || !props.fletcher32 ||
+                               props.scaleoffset ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompress error 2: Wrong storage properties",
+              status );
+   }
+
+/* Check values survive a round trip through datPut, datGet and datMap. */
+   for( i = 0; i < 1200; i++ ) fvals[ i ] = i % 37;
+   datPut( loc2, "_REAL", 2, dims, fvals, status );
+   datMapR( loc2, "UPDATE", 2, dims, &fptr, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 1200; i++ ) {
+         if( fptr[ i ] != i % 37 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompress error 3: Element %d is %g", status,
+                     i + 1, fptr[ i ] );
+            break;
+         }
+         fptr[ i ] += 1.0;
+      }
+   }
+   datUnmap( loc2, status );
+   datGetR( loc2, 2, dims, fvals, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 1200; i++ ) {
+         if( fvals[ i ] != i % 37 + 1 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompress error 4: Element %d is %g", status,
+                     i + 1, fvals[ i ] );
+            break;
+         }
+      }
+   }
+
+/* A slice of the vectorised array crosses several chunks. */
+   datVec( loc2, &loc3, status );
+   dim = 41;
+   dims[ 0 ] = 160;
+   datSlice( loc3, 1, &dim, dims, &loc4, status );
+   datGet1R( loc4, 120, fvals, &nel, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 120; i++ ) {
+         if( fvals[ i ] != ( i + 40 ) % 37 + 1 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompress error 11: Element %d is %g", status,
+                     i + 41, fvals[ i ] );
+            break;
+         }
+      }
+   }
+   datAnnul( &loc4, status );
+   datAnnul( &loc3, status );
+   dims[ 0 ] = 40;
+
+/* An undefined copy is stored in the same way as the original. */
+   datNewP( loc1, "EMPTY", "_REAL", 2, dims, &props, status );
+   datFind( loc1, "EMPTY", &loc3, status );
+   datAnnul( &loc2, status );
+   datCcopy( loc3, loc1, "COPY", &loc2, status );
+   dat1OpenDeferred( loc2, status );
+   dat1DatasetProps( loc2->dataset_id, &props, chunk, status );
+   if( *status == SAI__OK && ( !props.chunk || chunk[ 0 ] != 16 ||
+                               chunk[ 1 ] != 8 || props.deflate != 6 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompress error 5: Copy has the wrong storage "
+              "properties", status );
+   }
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+
+/* Use the tuning defaults to compress a 1-D array, which is divided into
+   chunks no larger than CHUNKSIZE bytes. */
+   hdsTune( "DEFLATE", 1, status );
+   hdsTune( "CHUNKSIZE", 4096, status );
+   dim = 10000;
+   datNew1I( loc1, "TABLE", dim, status );
+   datFind( loc1, "TABLE", &loc2, status );
+   dat1OpenDeferred( loc2, status );
+   dat1DatasetProps( loc2->dataset_id, &props, chunk, status );
+   if( *status == SAI__OK && ( !props.chunk || props.deflate != 1 ||
+                               chunk[ 0 ]*sizeof( int ) > 4096 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompress error 6: Tuning defaults not used",
+              status );
+   }
+   hdsTune( "DEFLATE", deflate, status );
+   hdsTune( "CHUNKSIZE", chunksize, status );
+
+/* A compressed array is extended without losing its values or its
+   compression, and retains its compression when reset. */
+   for( i = 0; i < dim; i++ ) ivals[ i ] = i;
+   datPut1I( loc2, dim, ivals, status );
+   dim = 12000;
+   datAlter( loc2, 1, &dim, status );
+   datMapV( loc2, "_INTEGER", "READ", (void **) &iptr, &nel, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 10000; i++ ) {
+         if( iptr[ i ] != i ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompress error 7: Element %d is %d", status,
+                     i + 1, iptr[ i ] );
+            break;
+         }
+      }
+   }
+   datUnmap( loc2, status );
+   datReset( loc2, status );
+   dat1OpenDeferred( loc2, status );
+   dat1DatasetProps( loc2->dataset_id, &props, chunk, status );
+   if( *status == SAI__OK && ( !props.chunk || props.deflate != 1 ) ) {
+      *status = DAT__FATAL;
+      emsRep( "", "testCompress error 8: Compression lost by datReset",
+              status );
+   }
+   datAnnul( &loc2, status );
+
+/* The scale-offset filter is lossless for integers. */
+   datInitProps( &props, status );
+   props.scaleoffset = 1;
+   props.deflate = 0;
+   dim = 12000;
+   datNewP( loc1, "SOINT", "_INTEGER", 1, &dim, &props, status );
+   datFind( loc1, "SOINT", &loc2, status );
+   for( i = 0; i < dim; i++ ) ivals[ i ] = 1000000 + ( i*7 ) % 1001;
+   datPut1I( loc2, dim, ivals, status );
+   memset( ivals, 0, sizeof( ivals ) );
+   datGet1I( loc2, dim, ivals, &nel, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < dim; i++ ) {
+         if( ivals[ i ] != 1000000 + ( i*7 ) % 1001 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompress error 9: Element %d is %d", status,
+                     i + 1, ivals[ i ] );
+            break;
+         }
+      }
+   }
+   datAnnul( &loc2, status );
+
+/* It retains the requested number of decimal places for floating point
+   values, and preserves bad values. */
+   props.scaleoffset = 2;
+   dim = 1200;
+   datNewP( loc1, "SOREAL", "_REAL", 1, &dim, &props, status );
+   datFind( loc1, "SOREAL", &loc2, status );
+   for( i = 0; i < dim; i++ ) {
+      fvals[ i ] = ( i % 10 == 0 ) ? typeinfo->BADR : i/7.0;
+   }
+   datPut1R( loc2, dim, fvals, status );
+   datGet1R( loc2, dim, fvals, &nel, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < dim; i++ ) {
+         diff = ( i % 10 == 0 ) ? 0.0 : fvals[ i ] - i/7.0;
+         if( ( i % 10 == 0 && fvals[ i ] != typeinfo->BADR ) ||
+             diff > 0.005 || diff < -0.005 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testCompress error 10: Element %d is %g", status,
+                     i + 1, fvals[ i ] );
+            break;
+         }
+      }
+   }
+   datAnnul( &loc2, status );
+
+   hdsErase( &loc1, status );
 
+   if( *status == SAI__OK ) {
+      printf("TestCompress passed\n");
+   }
+}
 
-void *test1ThreadSafety( void *data ) {
-   threadData *tdata = (threadData *) data;
-   HDSLoc *loc1 = tdata->loc;
+static void testChunkWrite( int *status ){
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
    HDSLoc *loc2 = NULL;
-   int status = SAI__OK;
-
+   HDSLoc *loc3 = NULL;
+   float fvals[ 1200 ];
+   hdsdim dim;
+   hdsdim dims[ 3 ];
+   hdsdim lbnd[ 3 ];
+   hdsdim pchunk[ 3 ];
+   hdsdim ubnd[ 3 ];
+   int *iptr = NULL;
+   int i;
+   int ivals[ 810 ];
+   int nthreads;
 
-   datFind( loc1, "Records", &loc2, &status );
-   datAnnul( &loc2, &status );
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
 
-   if( status == DAT__THREAD ) {
-      emsAnnul( &status );
+   hdsGtune( "NTHREADS", &nthreads, status );
+   hdsTune( "NTHREADS", 4, status );
+   hdsNew( "hds_cwrtest", "HDS_CWRTEST", "TEST", 0, &dim, &loc1, status );
+
+/* A 2-D _REAL array with chunks that do not divide its shape, using all
+   the filters that HDS can apply itself. */
+   dims[ 0 ] = 40;
+   dims[ 1 ] = 30;
+   pchunk[ 0 ] = 16;
+   pchunk[ 1 ] = 7;
+   datInitProps( &props, status );
+   props.chunk = pchunk;
+   props.deflate = 4;
+   props.shuffle = 1;
+   props.fletcher32 = 1;
+   datNewP( loc1, "IMAGE", "_REAL", 2, dims, &props, status );
+   datFind( loc1, "IMAGE", &loc2, status );
+   for( i = 0; i < 1200; i++ ) fvals[ i ] = ( i*13 ) % 101 - 50.5;
+   datPutR( loc2, 2, dims, fvals, status );
+   memset( fvals, 0, sizeof( fvals ) );
+   datGetR( loc2, 2, dims, fvals, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 1200; i++ ) {
+         if( fvals[ i ] != ( i*13 ) % 101 - 50.5 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkWrite error 1: Element %d is %g", status,
+                     i + 1, fvals[ i ] );
+            break;
+         }
+      }
+   }
+   datAnnul( &loc2, status );
 
-   } else if( status == SAI__OK ) {
-      status = DAT__FATAL;
-      emsRepf("", "testThreadSafety error A1: Expected a DAT__THREAD "
-              "error but no error was reported", &status );
+/* A 3-D _INTEGER array that is deflated only. */
+   dims[ 0 ] = 10;
+   dims[ 1 ] = 9;
+   dims[ 2 ] = 7;
+   pchunk[ 0 ] = 4;
+   pchunk[ 1 ] = 4;
+   pchunk[ 2 ] = 4;
+   props.shuffle = 0;
+   props.fletcher32 = 0;
+   datNewP( loc1, "CUBE", "_INTEGER", 3, dims, &props, status );
+   datFind( loc1, "CUBE", &loc2, status );
+   for( i = 0; i < 630; i++ ) ivals[ i ] = i*i;
+   datPutI( loc2, 3, dims, ivals, status );
+
+/* Values changed through a mapped array are written back when it is
+   unmapped. */
+   datMapI( loc2, "UPDATE", 3, dims, &iptr, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 630; i++ ) {
+         if( iptr[ i ] != i*i ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkWrite error 2: Element %d is %d", status,
+                     i + 1, iptr[ i ] );
+            break;
+         }
+         iptr[ i ] = -i;
+      }
+   }
+   datUnmap( loc2, status );
+
+/* A section is written by HDF5 in the usual way. */
+   lbnd[ 0 ] = 3;
+   lbnd[ 1 ] = 2;
+   lbnd[ 2 ] = 5;
+   ubnd[ 0 ] = 6;
+   ubnd[ 1 ] = 4;
+   ubnd[ 2 ] = 7;
+   datSlice( loc2, 3, lbnd, ubnd, &loc3, status );
+   for( i = 0; i < 36; i++ ) ivals[ i ] = 1000;
+   dims[ 0 ] = 4;
+   dims[ 1 ] = 3;
+   dims[ 2 ] = 3;
+   datPutI( loc3, 3, dims, ivals, status );
+   datAnnul( &loc3, status );
 
-   } else {
-      int oldstat = status;
-      emsAnnul( &status );
-      status = DAT__FATAL;
-      emsRepf("", "testThreadSafety error A1: Expected a DAT__THREAD "
-              "error but got status=%d", &status, oldstat );
+/* Extending the array exposes the padding at the end of the last chunks,
+   which should hold the fill value. */
+   dims[ 0 ] = 10;
+   dims[ 1 ] = 9;
+   dims[ 2 ] = 9;
+   datAlter( loc2, 3, dims, status );
+   datGetI( loc2, 3, dims, ivals, status );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 810; i++ ) {
+         int ix = i % 10;
+         int iy = ( i / 10 ) % 9;
+         int iz = i / 90;
+         int expect = ( iz >= 7 ) ? 0 : -i;
+         if( ix >= 2 && ix <= 5 && iy >= 1 && iy <= 3 && iz >= 4 &&
+             iz <= 6 ) expect = 1000;
+         if( ivals[ i ] != expect ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkWrite error 3: Element %d is %d but "
+                     "should be %d", status, i + 1, ivals[ i ], expect );
+            break;
+         }
+      }
    }
+   datAnnul( &loc2, status );
 
-   tdata->status = status;
-   return NULL;
-}
+   hdsErase( &loc1, status );
+   hdsTune( "NTHREADS", nthreads, status );
 
+   if( *status == SAI__OK ) {
+      printf("TestChunkWrite passed\n");
+   }
+}
 
-void *test2ThreadSafety( void *data ) {
-   threadData *tdata = (threadData *) data;
-   HDSLoc *loc1 = tdata->loc;
+static void testChunkRead( int *status ){
+   HDSCreateProps props;
+   HDSLoc *loc1 = NULL;
    HDSLoc *loc2 = NULL;
-   int status = SAI__OK;
-   int expect = tdata->rdonly ? 3 : 1;
-   int i, ii;
+   HDSLoc *loc3 = NULL;
+   HDSLoc *loc4 = NULL;
+   HDSLoc *loc5 = NULL;
+   double *dptr = NULL;
+   double dvals[ 2 ][ 2400 ];
+   double svals[ 2 ][ 936 ];
+   double vvals[ 2 ][ 2400 ];
+   hdsdim dim;
+   hdsdim dims[ 3 ];
+   hdsdim lbnd[ 3 ];
+   hdsdim pchunk[ 3 ];
+   hdsdim ubnd[ 3 ];
+   int i;
+   int ipass;
+   int ivals[ 2 ][ 1000 ];
+   int nthreads;
+   size_t nel;
 
-   datLock( loc1, 1, tdata->rdonly, &status );
-   if( status == DAT__THREAD ) {
-      emsAnnul( &status );
-      tdata->failed = 1;
-   } else if( status == SAI__OK ){
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
 
-      tdata->failed = 0;
-      datFind( loc1, "Records", &loc2, &status );
+   hdsGtune( "NTHREADS", &nthreads, status );
+   hdsNew( "hds_crdtest", "HDS_CRDTEST", "TEST", 0, &dim, &loc1, status );
+
+/* A 2-D _DOUBLE array with chunks that do not divide its shape, using
+   all the filters that HDS can remove itself. */
+   dims[ 0 ] = 60;
+   dims[ 1 ] = 40;
+   pchunk[ 0 ] = 16;
+   pchunk[ 1 ] = 7;
+   datInitProps( &props, status );
+   props.chunk = pchunk;
+   props.deflate = 5;
+   props.shuffle = 1;
+   props.fletcher32 = 1;
+   datNewP( loc1, "IMAGE", "_DOUBLE", 2, dims, &props, status );
+   datFind( loc1, "IMAGE", &loc2, status );
+   for( i = 0; i < 2400; i++ ) dvals[ 0 ][ i ] = ( i*17 ) % 1003 - 0.25;
+   datPutD( loc2, 2, dims, dvals[ 0 ], status );
+
+/* A 3-D _INTEGER array that is deflated only, of which only a section
+   is written so that some chunks are never stored. */
+   dims[ 0 ] = 10;
+   dims[ 1 ] = 10;
+   dims[ 2 ] = 10;
+   pchunk[ 0 ] = 4;
+   pchunk[ 1 ] = 3;
+   pchunk[ 2 ] = 5;
+   props.shuffle = 0;
+   props.fletcher32 = 0;
+   datNewP( loc1, "CUBE", "_INTEGER", 3, dims, &props, status );
+   datFind( loc1, "CUBE", &loc3, status );
+   lbnd[ 0 ] = 2;
+   lbnd[ 1 ] = 1;
+   lbnd[ 2 ] = 1;
+   ubnd[ 0 ] = 9;
+   ubnd[ 1 ] = 6;
+   ubnd[ 2 ] = 5;
+   datSlice( loc3, 3, lbnd, ubnd, &loc4, status );
+   for( i = 0; i < 240; i++ ) ivals[ 0 ][ i ] = i + 1;
+   dims[ 0 ] = 8;
+   dims[ 1 ] = 6;
+   dims[ 2 ] = 5;
+   datPutI( loc4, 3, dims, ivals[ 0 ], status );
+   datAnnul( &loc4, status );
 
-      /* Check the component locator is locked by the current thread. */
-      ii = datLocked( loc2, 1, &status );
-      if( ii != expect && status == SAI__OK ) {
-         status = DAT__FATAL;
-         emsRepf("", "testThreadSafety error B1: loc2 is not locked by "
-                 "current thread (%d %d). ", &status, ii, expect );
+/* Read the same values using HDF5 alone and then using several threads,
+   so that they can be compared. */
+   for( ipass = 0; ipass < 2; ipass++ ) {
+      hdsTune( "NTHREADS", ( ipass == 0 ) ? 1 : 4, status );
 
+/* The whole image through a mapped array. */
+      dims[ 0 ] = 60;
+      dims[ 1 ] = 40;
+      datMapD( loc2, "READ", 2, dims, &dptr, status );
+      if( *status == SAI__OK ) {
+         memcpy( dvals[ ipass ], dptr, sizeof( dvals[ ipass ] ) );
       }
-      datAnnul( &loc2, &status );
+      datUnmap( loc2, status );
+
+/* A section of the image that crosses several chunks. */
+      lbnd[ 0 ] = 10;
+      lbnd[ 1 ] = 5;
+      ubnd[ 0 ] = 45;
+      ubnd[ 1 ] = 30;
+      datSlice( loc2, 2, lbnd, ubnd, &loc4, status );
+      dims[ 0 ] = 36;
+      dims[ 1 ] = 26;
+      datGetD( loc4, 2, dims, svals[ ipass ], status );
+      datAnnul( &loc4, status );
+
+/* The whole of the vectorised image, and then part of it (which is
+   always read by HDF5). */
+      datVec( loc2, &loc4, status );
+      datGetVD( loc4, 2400, vvals[ ipass ], &nel, status );
+      dim = 101;
+      ubnd[ 0 ] = 1700;
+      datSlice( loc4, 1, &dim, ubnd, &loc5, status );
+      datGet1D( loc5, 1600, vvals[ ipass ] + 100, &nel, status );
+      datAnnul( &loc5, status );
+      datAnnul( &loc4, status );
+
+/* The whole cube, including the parts that were never written. */
+      dims[ 0 ] = 10;
+      dims[ 1 ] = 10;
+      dims[ 2 ] = 10;
+      datGetI( loc3, 3, dims, ivals[ ipass ], status );
+   }
 
-      /* Do something time consuming to make it likely that this thread
-         will not have finished (and so unlocked the object), before the other
-         thread starts. */
-      for( i = 0; i < 1000000; i++ ) {
-         ii = datLocked( loc1, 1, &status );
-         if( ii != expect && status == SAI__OK ) {
-            status = SAI__ERROR;
-            emsRepf( " ", "test2ThreadSafety: Unexpected lock status %d - "
-                     "expected %d", &status, ii, expect );
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 2400; i++ ) {
+         if( dvals[ 1 ][ i ] != ( i*17 ) % 1003 - 0.25 ||
+             vvals[ 1 ][ i ] != dvals[ 0 ][ i ] ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkRead error 1: Image element %d is %g "
+                     "but should be %g", status, i + 1, dvals[ 1 ][ i ],
+                     dvals[ 0 ][ i ] );
+            break;
+         }
+      }
+   }
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 936; i++ ) {
+         if( svals[ 1 ][ i ] != svals[ 0 ][ i ] ||
+             svals[ 1 ][ i ] != dvals[ 0 ][ 9 + i % 36 + 60*( 4 + i/36 ) ] ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkRead error 2: Section element %d is %g "
+                     "but should be %g", status, i + 1, svals[ 1 ][ i ],
+                     svals[ 0 ][ i ] );
+            break;
+         }
+      }
+   }
+   if( *status == SAI__OK ) {
+      for( i = 0; i < 1000; i++ ) {
+         if( ivals[ 1 ][ i ] != ivals[ 0 ][ i ] ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkRead error 3: Cube element %d is %d "
+                     "but should be %d", status, i + 1, ivals[ 1 ][ i ],
+                     ivals[ 0 ][ i ] );
             break;
          }
       }
-
-      datUnlock( loc1, 1, &status );
-
    }
 
-   tdata->status = status;
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
+   hdsTune( "NTHREADS", nthreads, status );
 
-   return NULL;
+   if( *status == SAI__OK ) {
+      printf("TestChunkRead passed\n");
+   }
 }
 
-void *test3ThreadSafety( void *data ) {
-   threadData *tdata = (threadData *) data;
+static void testChunkCache( int *status ){
+   HDSCreateProps props;
    HDSLoc *loc1 = NULL;
-   int status = SAI__OK;
-   hdsdim i,k,dim;
-   double *ip;
-   double alpha = 0.1;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   double w0;
+   float fvals[ 32768 ];
+   float pvals[ 4096 ];
+   hdsdim dim;
+   hdsdim dims[ 3 ];
+   hdsdim lbnd[ 3 ];
+   hdsdim pchunk[ 3 ];
+   hdsdim ubnd[ 3 ];
+   hid_t plist;
+   int i;
+   int iplane;
+   int mdc;
+   int nblocks;
+   int rawcache;
+   int rawslots;
+   int ival;
+   size_t nbytes;
+   size_t nslots;
 
-   dim = 10000;
-   datTemp( "_DOUBLE", 1, &dim, &loc1, &status );
-   datMap( loc1, "_DOUBLE", "Write", 1, &dim, (void **) &ip, &status );
-   if( status == SAI__OK ) {
-      memset( ip, 0, sizeof(*ip)*dim );
-      *ip = 1E6;
-      for( k = 0; k < 10000; k++ ) {
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
 
-         double delta2 = 2*alpha*( ip[0] - ip[1] );
-         ip[0] -= delta2;
-         ip[1] += delta2;
+   hdsGtune( "RAWCACHE", &rawcache, status );
+   hdsGtune( "RAWSLOTS", &rawslots, status );
 
-         for( i = 1; i < dim-1; i++ ) {
-            double delta1 = alpha*( ip[i] - ip[i-1] );
-            double delta2 = alpha*( ip[i] - ip[i+1] );
-            ip[i] -= delta1 + delta2;
-            ip[i-1] += delta1;
-            ip[i+1] += delta2;
-         }
+/* NBLOCKS and MAXWPL are the sizes of the chunk cache in units of 512
+   bytes and in hash table slots. */
+   hdsTune( "NBLOCKS", 128, status );
+   hdsTune( "MAXWPL", 1009, status );
+   hdsGtune( "RAWCACHE", &ival, status );
+   hdsGtune( "NBLOCKS", &nblocks, status );
+   if( *status == SAI__OK && ( ival != 65536 || nblocks != 128 ) ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testChunkCache error 1: RAWCACHE is %d and NBLOCKS is "
+               "%d", status, ival, nblocks );
+   }
+   hdsGtune( "RAWSLOTS", &ival, status );
+   if( *status == SAI__OK && ival != 1009 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testChunkCache error 2: RAWSLOTS is %d", status, ival );
+   }
 
-         double delta1 = 2*alpha*( ip[i] - ip[i-1] );
-         ip[i] -= delta1;
-         ip[i-1] += delta1;
+/* New files use them. */
+   hdsNew( "hds_cchtest", "HDS_CCHTEST", "TEST", 0, &dim, &loc1, status );
+   if( *status == SAI__OK ) {
+      plist = H5Fget_access_plist( loc1->file_id );
+      H5Pget_cache( plist, &mdc, &nslots, &nbytes, &w0 );
+      H5Pclose( plist );
+      if( nbytes != 65536 || nslots != 1009 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testChunkCache error 3: File cache is %zu bytes "
+                  "with %zu slots", status, nbytes, nslots );
       }
    }
 
-   datUnmap( loc1, &status );
-   datUnlock( loc1, 0, &status );
-   tdata->loc = loc1;
-
-   return NULL;
-}
-
+/* A cube in which each plane spans four 32 KiB chunks, and so does not
+   fit in the default cache. */
+   dims[ 0 ] = 64;
+   dims[ 1 ] = 64;
+   dims[ 2 ] = 8;
+   pchunk[ 0 ] = 32;
+   pchunk[ 1 ] = 32;
+   pchunk[ 2 ] = 8;
+   datInitProps( &props, status );
+   props.chunk = pchunk;
+   props.deflate = 1;
+   datNewP( loc1, "CUBE", "_REAL", 3, dims, &props, status );
+   datFind( loc1, "CUBE", &loc2, status );
+   for( i = 0; i < 32768; i++ ) fvals[ i ] = i % 1000 + 0.5;
+   datPutR( loc2, 3, dims, fvals, status );
+   datAnnul( &loc2, status );
 
-void *test4ThreadSafety( void *data ) {
-   threadData *tdata = (threadData *) data;
-   HDSLoc *loc1 = NULL;
-   char typestr[DAT__SZTYP+1];
-   int status = SAI__OK;
+/* Once opened again, it is given a cache that holds a plane of chunks. */
+   datFind( loc1, "CUBE", &loc2, status );
+   datGetR( loc2, 3, dims, fvals, status );
+   if( *status == SAI__OK ) {
+      plist = H5Dget_access_plist( loc2->dataset_id );
+      H5Pget_chunk_cache( plist, &nslots, &nbytes, &w0 );
+      H5Pclose( plist );
+      if( nbytes != 131072 || nslots < 1009 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testChunkCache error 4: Cube cache is %zu bytes "
+                  "with %zu slots", status, nbytes, nslots );
+      }
+   }
 
-   hdsOpen( tdata->path, "Read", &loc1, &status );
-   datType( loc1, typestr, &status );
+/* Read it one plane at a time. */
+   dims[ 2 ] = 1;
+   for( iplane = 1; iplane <= 8 && *status == SAI__OK; iplane++ ) {
+      lbnd[ 0 ] = 1;
+      lbnd[ 1 ] = 1;
+      lbnd[ 2 ] = iplane;
+      ubnd[ 0 ] = 64;
+      ubnd[ 1 ] = 64;
+      ubnd[ 2 ] = iplane;
+      datSlice( loc2, 3, lbnd, ubnd, &loc3, status );
+      datGetR( loc3, 3, dims, pvals, status );
+      datAnnul( &loc3, status );
+      for( i = 0; i < 4096 && *status == SAI__OK; i++ ) {
+         if( pvals[ i ] != ( 4096*( iplane - 1 ) + i ) % 1000 + 0.5 ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testChunkCache error 5: Element %d of plane %d "
+                     "is %g", status, i + 1, iplane, pvals[ i ] );
+         }
+      }
+   }
+   datAnnul( &loc2, status );
 
-   pthread_mutex_lock( &mutex );
-   pthread_cond_broadcast( &cond );
-   pthread_cond_wait( &cond, &mutex );
-   pthread_mutex_unlock( &mutex );
+/* A plane of a smaller image fits in the default cache. */
+   dims[ 0 ] = 64;
+   dims[ 1 ] = 64;
+   pchunk[ 0 ] = 32;
+   pchunk[ 1 ] = 32;
+   datNewP( loc1, "IMAGE", "_REAL", 2, dims, &props, status );
+   datFind( loc1, "IMAGE", &loc2, status );
+   datPutR( loc2, 2, dims, fvals, status );
+   if( *status == SAI__OK ) {
+      plist = H5Dget_access_plist( loc2->dataset_id );
+      H5Pget_chunk_cache( plist, &nslots, &nbytes, &w0 );
+      H5Pclose( plist );
+      if( nbytes != 65536 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testChunkCache error 6: Image cache is %zu bytes",
+                  status, nbytes );
+      }
+   }
+   datAnnul( &loc2, status );
 
-   datAnnul( &loc1, &status );
+   hdsErase( &loc1, status );
+   hdsTune( "RAWCACHE", rawcache, status );
+   hdsTune( "RAWSLOTS", rawslots, status );
 
-   tdata->status = status;
-   return NULL;
+   if( *status == SAI__OK ) {
+      printf("TestChunkCache passed\n");
+   }
 }
 
+static void testFileLayout( int *status ){
+   H5F_fspace_strategy_t strategy;
+   H5G_info_t ginfo;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   char name[ DAT__SZNAM + 1 ];
+   hbool_t persist;
+   hdsdim dim;
+   hid_t plist;
+   hsize_t threshold;
+   int i;
+   int inal;
+   int istruc;
+   int ival;
+   int ncomp;
+   struct stat buf;
 
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
 
+   hdsGtune( "INAL", &inal, status );
+   hdsGtune( "NCOM", &ncomp, status );
 
+/* Reserve 1 MiB for the file, and expect 20 components per structure. */
+   hdsTune( "INAL", 2048, status );
+   hdsTune( "NCOM", 20, status );
+   hdsGtune( "INAL", &ival, status );
+   if( *status == SAI__OK && ival != 2048 ) {
+      *status = DAT__FATAL;
+      emsRepf( "", "testFileLayout error 1: INAL is %d", status, ival );
+   }
 
+   hdsNew( "hds_laytest", "HDS_LAYTEST", "TEST", 0, &dim, &loc1, status );
+   if( *status == SAI__OK ) {
+      if( stat( "hds_laytest.sdf", &buf ) != 0 || buf.st_size < 1048576 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testFileLayout error 2: New file has %ld bytes",
+                  status, (long) buf.st_size );
+      }
+   }
+   if( *status == SAI__OK ) {
+      plist = H5Fget_create_plist( loc1->file_id );
+      H5Pget_file_space_strategy( plist, &strategy, &persist, &threshold );
+      H5Pclose( plist );
+      if( strategy != H5F_FSPACE_STRATEGY_PAGE || !persist ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testFileLayout error 3: File space strategy is %d",
+                  status, (int) strategy );
+      }
+   }
 
-
-/* Display information about the locs on a locator. */
-void showloc( HDSLoc *loc, const char *title, int indent ) {
-   int i;
-   pthread_mutex_lock(&mutex);
-   printf("\n");
-   for( i = 0; i < indent; i++ ) printf(" ");
-   printf( "%s\n", title );
-   for( i = 0; i < indent; i++ ) printf(" ");
-   for( i = 0; i < strlen(title); i++ ) printf("-");
-   printf("\n");
-   showhan( loc->handle, indent );
-   pthread_mutex_unlock(&mutex);
-}
-
-void showhan( Handle *h, int indent ) {
-   if( !h ) return;
-
-   int i;
-   for( i = 0; i < indent; i++ ) printf(" ");
-   printf("'%s' ", h->name ? h->name : " " );
-   if( h->nwrite_lock ) printf("w:%zu ", h->write_locker );
-   for( i = 0; i < h->nread_lock; i++ ) {
-      printf("r:%zu ", h->read_lockers[ i ] );
+/* A structure with 20 components is stored in compact form, and one
+   created with the default NCOM is not. */
+   for( istruc = 0; istruc < 2; istruc++ ) {
+      if( istruc == 1 ) hdsTune( "NCOM", 0, status );
+      sprintf( name, "STRUC%d", istruc + 1 );
+      datNew( loc1, name, "STRUC", 0, &dim, status );
+      datFind( loc1, name, &loc2, status );
+      for( i = 0; i < 20; i++ ) {
+         sprintf( name, "COMP%d", i + 1 );
+         datNew0I( loc2, name, status );
+         datFind( loc2, name, &loc3, status );
+         datPut0I( loc3, i, status );
+         datAnnul( &loc3, status );
+      }
+      if( *status == SAI__OK ) {
+         H5Gget_info( loc2->group_id, &ginfo );
+         if( ( istruc == 0 ) !=
+             ( ginfo.storage_type == H5G_STORAGE_TYPE_COMPACT ) ) {
+            *status = DAT__FATAL;
+            emsRepf( "", "testFileLayout error 4: Structure %d has storage "
+                     "type %d", status, istruc + 1, (int) ginfo.storage_type );
+         }
+      }
+      datAnnul( &loc2, status );
    }
-   printf("\n");
 
-   for( i = 0; i < h->nchild; i++ ) {
-      showhan( h->children[i], indent + 3 );
+/* The unused space is released when the file is closed. */
+   datAnnul( &loc1, status );
+   if( *status == SAI__OK ) {
+      if( stat( "hds_laytest.sdf", &buf ) != 0 || buf.st_size >= 1048576 ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testFileLayout error 5: Closed file has %ld bytes",
+                  status, (long) buf.st_size );
+      }
    }
-}
 
+/* The components can be read back in the order they were created. */
+   hdsOpen( "hds_laytest", "READ", &loc1, status );
+   datFind( loc1, "STRUC1", &loc2, status );
+   for( i = 0; i < 20 && *status == SAI__OK; i++ ) {
+      datIndex( loc2, i + 1, &loc3, status );
+      datGet0I( loc3, &ival, status );
+      datAnnul( &loc3, status );
+      if( *status == SAI__OK && ival != i ) {
+         *status = DAT__FATAL;
+         emsRepf( "", "testFileLayout error 6: Component %d is %d", status,
+                  i + 1, ival );
+      }
+   }
+   datAnnul( &loc2, status );
+   hdsErase( &loc1, status );
 
+   hdsTune( "INAL", inal, status );
+   hdsTune( "NCOM", ncomp, status );
 
+   if( *status == SAI__OK ) {
+      printf("TestFileLayout passed\n");
+   }
+}
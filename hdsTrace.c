@@ -34,6 +34,7 @@
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
@@ -52,6 +53,8 @@
 *        Initial version
 *     2014-11-22 (TIMJ):
 *        The HDS root group may not be in the HDF5 full name
+*     2026-10-16 (AGENT):
+*        Handle untouched structure array cells in read-only files.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -130,6 +133,13 @@ int hdsTrace(const HDSLoc *locator, int  *nlev, char *path_str,
   /* First we get the path of the object */
   objid_to_name( objid, 0, path_str, path_length, status );
 
+  /* An empty cell refers to the array group so the subscripts
+     are taken from the cell name in the handle */
+  if (locator->isemptycell) {
+    one_strlcat( path_str, strstr( locator->handle->name, "(" ),
+                 path_length, status );
+  }
+
   /* Now walk through the string replacing "/" with "." */
   if (*status == SAI__OK) {
     hdsdim lower[DAT__MXDIM];
@@ -33,6 +33,13 @@ datAnnul_v5(HDSLoc **locator, int *status);
 int
 datBasic_v5(const HDSLoc *locator, const char *mode_c, unsigned char **pntr, size_t *len, int *status);
 
+/*===========================================================*/
+/* datCatalogue - Visit every object using the file catalogue */
+/*===========================================================*/
+
+int
+datCatalogue_v5(const HDSLoc *locator, int (*func)(const HDSWalkNode *node, void *data, int *status), void *data, int flags, int *status);
+
 /*=====================================*/
 /* datCcopy - copy one structure level */
 /*=====================================*/
@@ -350,6 +357,20 @@ datGetVL_v5(const HDSLoc * locator, size_t maxval, hdsbool_t values[], size_t *a
 int
 datIndex_v5(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status);
 
+/*====================================================================*/
+/* datInitProps - Initialise the storage properties for a new primitive */
+/*====================================================================*/
+
+int
+datInitProps_v5(HDSCreateProps *props, int *status);
+
+/*================================================================*/
+/* datIterate - Call a function for each component of a structure */
+/*================================================================*/
+
+int
+datIterate_v5(const HDSLoc *locator, int (*func)(HDSLoc *comp, void *data, int *status), void *data, int *status);
+
 /*===================================*/
 /* datLen - Inquire primitive length */
 /*===================================*/
@@ -479,6 +500,13 @@ datNcomp_v5(const HDSLoc *locator, int *ncomp, int *status);
 int
 datNew_v5(const HDSLoc *locator, const char *name_str, const char *type_str, int ndim, const hdsdim dims[], int *status);
 
+/*=============================================================*/
+/* datNewP - Create new component with given storage properties */
+/*=============================================================*/
+
+int
+datNewP_v5(const HDSLoc *locator, const char *name_str, const char *type_str, int ndim, const hdsdim dims[], const HDSCreateProps *props, int *status);
+
 /*============================================*/
 /* datNewC - Create new _CHAR type component */
 /*============================================*/
@@ -987,12 +1015,26 @@ datValid_v5(const HDSLoc *locator, hdsbool_t *valid, int *status);
 int
 datVec_v5(const HDSLoc *locator1, HDSLoc **locator2, int *status);
 
+/*==================================================*/
+/* datWalk - Visit every object in an HDS hierarchy */
+/*==================================================*/
+
+int
+datWalk_v5(const HDSLoc *locator, int (*func)(const HDSWalkNode *node, void *data, int *status), void *data, int flags, int *status);
+
 /*================================================*/
 /* datWhere - Find primitive position in HDS file */
 /*            Currently not part of the public    */
 /*            C API                               */
 /*================================================*/
 
+/*======================================*/
+/* hdsBegin - Begin a new locator scope */
+/*======================================*/
+
+int
+hdsBegin_v5(int *status);
+
 /*==================================================*/
 /* hdsCopy - Copy an object to a new container file */
 /*==================================================*/
@@ -1000,6 +1042,13 @@ datVec_v5(const HDSLoc *locator1, HDSLoc **locator2, int *status);
 int
 hdsCopy_v5(const HDSLoc *locator, const char *file_str, const char name_str[DAT__SZNAM], int *status);
 
+/*========================================*/
+/* hdsEnd - End the current locator scope */
+/*========================================*/
+
+int
+hdsEnd_v5(int *status);
+
 /*=================================*/
 /* hdsErase - Erase container file */
 /*=================================*/
@@ -1,6 +1,7 @@
 #define datAlter datAlter_v5
 #define datAnnul datAnnul_v5
 #define datBasic datBasic_v5
+#define datCatalogue datCatalogue_v5
 #define datCcopy datCcopy_v5
 #define datCctyp datCctyp_v5
 #define datCell datCell_v5
@@ -46,6 +47,8 @@
 #define datGetVR datGetVR_v5
 #define datGetVL datGetVL_v5
 #define datIndex datIndex_v5
+#define datInitProps datInitProps_v5
+#define datIterate datIterate_v5
 #define datLen datLen_v5
 #define datLock datLock_v5
 #define datLocked datLocked_v5
@@ -65,6 +68,7 @@
 #define datNcomp datNcomp_v5
 #define datNew datNew_v5
 #define datNewC datNewC_v5
+#define datNewP datNewP_v5
 #define datNew0 datNew0_v5
 #define datNew0D datNew0D_v5
 #define datNew0I datNew0I_v5
@@ -136,7 +140,10 @@
 #define datUnmap datUnmap_v5
 #define datValid datValid_v5
 #define datVec datVec_v5
+#define datWalk datWalk_v5
+#define hdsBegin hdsBegin_v5
 #define hdsCopy hdsCopy_v5
+#define hdsEnd hdsEnd_v5
 #define hdsErase hdsErase_v5
 #define hdsEwild hdsEwild_v5
 #define hdsFlush hdsFlush_v5
@@ -0,0 +1,135 @@
+/*
+*+
+*  Name:
+*     hdsdump
+
+*  Purpose:
+*     List the contents of an HDS container file
+
+*  Language:
+*     Starlink ANSI C
+
+*  Invocation:
+*     hdsdump [-s] [-n] file
+
+*  Description:
+*     This program lists every object in an HDS container file, one per
+*     line, giving its name, shape and type. Each object is indented to
+*     show its level in the hierarchy, and the components of each
+*     structure are listed in the same order as datIndex. The listing
+*     is produced using datCatalogue, so it is read from the catalogue
+*     stored in the file if there is one. Otherwise no locators are
+*     created for the objects within the file, but each object is opened.
+
+*  Options:
+*     -s
+*        Indicate which primitives do not have a defined value.
+*     -n
+*        Do not list the cells of structure arrays.
+
+*  Authors:
+*     AGENT: agent (agent@local)
+*     {enter_new_authors_here}
+
+*  History:
+*     2026-10-16 (AGENT):
+*        Original.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 agent (agent@local)
+*     All Rights Reserved.
+
+*  Licence:
+*     This program is free software; you can redistribute it and/or
+*     modify it under the terms of the GNU General Public License as
+*     published by the Free Software Foundation; either version 2 of
+*     the License, or (at your option) any later version.
+*
+*     This program is distributed in the hope that it will be
+*     useful, but WITHOUT ANY WARRANTY; without even the implied
+*     warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*     PURPOSE. See the GNU General Public License for more details.
+*
+*     You should have received a copy of the GNU General Public
+*     License along with this program; if not, write to the Free
+*     Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+*     MA 02110-1301, USA
+
+*  Bugs:
+*     {note_any_bugs_here}
+
+*-
+*/
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "ems.h"
+#include "sae_par.h"
+
+static int dumpNode( const HDSWalkNode *node, void *data, int *status );
+
+int main( int argc, char *argv[] ) {
+   HDSLoc *loc = NULL;
+   const char *file = NULL;
+   int flags = 0;
+   int i;
+   int status = SAI__OK;
+
+   for( i = 1; i < argc; i++ ) {
+      if( !strcmp( argv[ i ], "-s" ) ) {
+         flags |= HDS_WALK_STATE;
+      } else if( !strcmp( argv[ i ], "-n" ) ) {
+         flags |= HDS_WALK_NOCELLS;
+      } else if( argv[ i ][ 0 ] != '-' && !file ) {
+         file = argv[ i ];
+      } else {
+         file = NULL;
+         break;
+      }
+   }
+
+   if( !file ) {
+      fprintf( stderr, "Usage: %s [-s] [-n] file\n", argv[ 0 ] );
+      return EXIT_FAILURE;
+   }
+
+   emsBegin( &status );
+   hdsOpen( file, "READ", &loc, &status );
+   datCatalogue( loc, dumpNode, &flags, flags, &status );
+   datAnnul( &loc, &status );
+   emsEnd( &status );
+
+   return ( status == SAI__OK ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Print one line describing an object. */
+static int dumpNode( const HDSWalkNode *node, void *data, int *status ) {
+   int flags = *( (int *) data );
+   int i;
+
+   printf( "%*s%s", 3*node->level, "", node->name );
+   if( node->ndim > 0 ) {
+      printf( "(" );
+      for( i = 0; i < node->ndim; i++ ) {
+         printf( "%s%" HDS_DIM_FORMAT, i ? "," : "", node->dims[ i ] );
+      }
+      printf( ")" );
+   }
+   printf( "  <%s>", node->type );
+   if( ( flags & HDS_WALK_STATE ) && !node->isstruc && !node->state ) {
+      printf( "  {undefined}" );
+   }
+   printf( "\n" );
+
+   return 0;
+}
@@ -265,7 +265,7 @@ int hdsFlush( const char *group_str, int *status) {
 
 hdsbool_t hds1RemoveLocator( const HDSLoc * loc, int *status ) {
    hdsbool_t result = 1;
-   if ( (loc->grpname)[0] != '\0') {
+   if (loc->grpname) {
       LOCK_MUTEX;
       result = hds2RemoveLocator( loc, status );
       UNLOCK_MUTEX
@@ -326,7 +326,7 @@ static int hds2Link(HDSLoc *locator, const char *group_str, int *status) {
         function is already serialised by a mutex. */
      promoted = 0;
      locked = 0;
-     if ( (locator->grpname)[0] != '\0') {
+     if (locator->grpname) {
 
        /* The group name is stored inside the locator, so changing the group modifies
           the locator structure. Therefore, we need to ensure that the current
@@ -378,8 +378,18 @@ static int hds2Link(HDSLoc *locator, const char *group_str, int *status) {
        hds2RemoveLocator(locator, status);
      }
 
-     /* Now copy the group name to the locator */
-     one_strlcpy( locator->grpname, group_str, sizeof(locator->grpname), status );
+     /* Now copy the group name to the locator, allocating memory for it
+        if the locator was not previously in a group. */
+     if (!locator->grpname) {
+       locator->grpname = MEM_CALLOC( DAT__SZGRP+1, sizeof(char) );
+       if (!locator->grpname) {
+         *status = DAT__NOMEM;
+         emsRep( " ", "hdsLink: Unable to allocate memory for group name",
+                 status );
+         return *status;
+       }
+     }
+     one_strlcpy( locator->grpname, group_str, DAT__SZGRP+1, status );
 
      /* See if this entry already exists in the hash */
      HASH_FIND_STR( groups, group_str, entry );
@@ -451,7 +461,8 @@ static int hds2Flush( const char *group_str, int *status) {
     HDSLoc * loc = elt->locator;
     /* clear the group membership -- otherwise datAnnul will
        call back to the group code to try to remove the locator */
-    (loc->grpname)[0] = '\0';
+    if (loc->grpname) MEM_FREE( loc->grpname );
+    loc->grpname = NULL;
     datAnnul( &loc, status );
   }
 
@@ -479,7 +490,7 @@ static hdsbool_t hds2RemoveLocator( const HDSLoc * loc, int *status ) {
 
   /* Not associated with a group */
   grpname = loc->grpname;
-  if (grpname[0] == '\0') return removed;
+  if (!grpname) return removed;
 
   /* Look for the entry associated with this name */
   HASH_FIND_STR( groups, grpname, entry );
@@ -10,6 +10,7 @@
 #include <pthread.h>
 #include <errno.h>
 #include <libgen.h>
+#include <sys/stat.h>
 
 #include "hdf5.h"
 #include "ems.h"
@@ -23,22 +24,36 @@
 #include "uthash.h"
 #include "utarray.h"
 
-/* Declare the hash table, a set of HdsFile structures keyed by absolute
-   file path. Each such structure contains lists of the primary and
-   secondary locators associated with each container file. The HdsFile
-   structure is defined in dat1.h. */
+/* Declare the hash table, a set of HdsFile structures keyed by the
+   device and inode of the file (so that the same file reached via
+   different paths is recognised). Each such structure contains lists of
+   the primary and secondary locators associated with each container file.
+   The HdsFile structure is defined in dat1.h. */
 static HdsFile *hdsFiles = NULL;
 
 
-/* Mutexes used to serialise access to the above hash table, and the
-   structures stored within it. */
+/* The number of entries in the above hash table. Read and written
+   atomically so that it can be read without locking the mutex. */
+static int NumFiles = 0;
+
+/* Mutex used to serialise access to the above hash table. The lists of
+   locators in each HdsFile structure are protected by the mutex in the
+   structure. A locator created from an existing locator already knows
+   its HdsFile, so registering or unregistering it only needs the mutex
+   for the file. The global mutex is only needed when a file is opened
+   or closed. If both mutexes are needed, the global mutex is always
+   locked first. */
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX pthread_mutex_lock( &mutex );
 #define UNLOCK_MUTEX pthread_mutex_unlock( &mutex );
+#define LOCK_FILE(hdsFile) pthread_mutex_lock( &((hdsFile)->mutex) );
+#define UNLOCK_FILE(hdsFile) pthread_mutex_unlock( &((hdsFile)->mutex) );
 
 /* Local functions. */
 static int hds2CompareId( const void *a, const void *b );
 static char *hds2AbsPath( const char *path, int *status );
+static char *hds2FilePath( hid_t file_id, int *status );
+static void hds2FileKey( hid_t file_id, HdsFileKey *key, int *status );
 
 
 /* -----------------------------------------------------------------
@@ -53,16 +68,14 @@ int hds1RegLocator( HDSLoc *locator, int *status ){
    HDSLoc **head = NULL;
    HDSLoc *old = NULL;
    HdsFile *hdsFile;
+   HdsFileKey key;
    char *abspath = NULL;
-   char *path;
+   int global = 0;
    int result = 0;
 
 /* Check inherited status */
    if( *status != SAI__OK ) return result;
 
-/* Lock the mutex that serialises access to the hash table */
-   LOCK_MUTEX;
-
 /* If the supplied locator already contains a pointer to the HdsFile
    structure describing its container file (e.g. because the locator was
    created from an existing locator), then use it. Otherwise, we need to
@@ -70,40 +83,50 @@ int hds1RegLocator( HDSLoc *locator, int *status ){
    hdsFile = locator->hdsFile;
    if( !hdsFile ) {
 
-/* Get a dynamically allocated buffer holding the path to the file
-   associated with the supplied locator. */
-      path = dat1GetFullName( locator->file_id, 1, NULL, status );
+/* Get the device and inode of the file associated with the supplied
+   locator. This is done before locking the mutex. */
+      hds2FileKey( locator->file_id, &key, status );
 
-/* Convert the above path, which may be relative, into an absolute path.
-   The absolute path is returned in a dynamically allocated string. */
-      if( path ) {
-         abspath = hds2AbsPath( path, status );
-
-/* Free the momory holding the relative path. */
-         MEM_FREE( path );
-         path = NULL;
-      } else if( *status == SAI__OK ){
-         datMsg( "L", locator );
-         *status = DAT__FATAL;
-         emsRep( " ", "Supplied locator for ^L has no associated file path.",
-                 status );
-      }
+/* Lock the mutex that serialises access to the hash table */
+      LOCK_MUTEX;
+      global = 1;
 
-/* Search for an existing entry in the hash table for this path. */
+/* Search for an existing entry in the hash table for this file. */
       if( *status == SAI__OK ) {
-         HASH_FIND_STR( hdsFiles, abspath, hdsFile );
+         HASH_FIND( hh, hdsFiles, &key, sizeof( key ), hdsFile );
+
+/* If not found, get a dynamically allocated buffer holding the absolute
+   path to the file. This is only used for display and for erasing the
+   file. */
+         if( !hdsFile ) {
+            abspath = hds2FilePath( locator->file_id, status );
+            if( !abspath && *status == SAI__OK ){
+               datMsg( "L", locator );
+               *status = DAT__FATAL;
+               emsRep( " ", "Supplied locator for ^L has no associated file path.",
+                       status );
+            }
+         }
 
 /* If not found, create a new HdsFile structure to describe the file and add
-   it into the hash table using its absolute path as the key. The memory
-   allocated by hds2AbsPath ("abspath") is then owned by the HdsFile object
+   it into the hash table using its device and inode as the key. The memory
+   allocated by hds2FilePath ("abspath") is then owned by the HdsFile object
    and should be freed when the HdsFile object is freed. */
-         if( !hdsFile ){
+         if( !hdsFile && *status == SAI__OK ){
             hdsFile = MEM_CALLOC( 1, sizeof( HdsFile ) );
-            if( hdsFile ) {
+            if( hdsFile && pthread_mutex_init( &(hdsFile->mutex), NULL ) != 0 ) {
+               MEM_FREE( hdsFile );
+               hdsFile = NULL;
+               *status = DAT__MUTEX;
+               emsRep( " ", "Failed to initialise POSIX mutex for a new "
+                       "HdsFile.", status );
+
+            } else if( hdsFile ) {
+               hdsFile->key = key;
                hdsFile->path = abspath;
                abspath = NULL;
-               HASH_ADD_KEYPTR( hh, hdsFiles, hdsFile->path,
-                                strlen(hdsFile->path), hdsFile );
+               HASH_ADD( hh, hdsFiles, key, sizeof( HdsFileKey ), hdsFile );
+               __atomic_add_fetch( &NumFiles, 1, __ATOMIC_RELAXED );
 
             } else if( *status == SAI__OK ) {
                *status = DAT__FATAL;
@@ -120,6 +143,8 @@ int hds1RegLocator( HDSLoc *locator, int *status ){
    primary or secondary locators associated with the file. The "->prev"
    points away from the head, the "->next" link points towards the head. */
    if( hdsFile && *status == SAI__OK ) {
+      LOCK_FILE( hdsFile );
+
       if( locator->isprimary ) {
          head = &(hdsFile->primhead);
       } else {
@@ -133,6 +158,8 @@ int hds1RegLocator( HDSLoc *locator, int *status ){
       if( old ) old->next = locator;
 
       if( !(hdsFile->primhead) ) result = 1;
+
+      UNLOCK_FILE( hdsFile );
    }
 
 /* Release abspath (it will be NULL if it is now owned by an HdsFile). */
@@ -144,7 +171,7 @@ int hds1RegLocator( HDSLoc *locator, int *status ){
    }
 
 /* Unlock the mutex that serialises access to the hash table */
-   UNLOCK_MUTEX;
+   if( global ) UNLOCK_MUTEX;
 
    return result;
 }
@@ -165,8 +192,10 @@ int hds1UnregLocator( HDSLoc *locator, int *status ) {
 /* Check a locator was supplied. */
    if( !locator ) return result;
 
-/* Lock the mutex that serialises access to the hash table */
-   LOCK_MUTEX;
+/* Lock the mutex that serialises access to the lists of locators for the
+   container file. */
+   hdsFile = locator->hdsFile;
+   if( hdsFile ) LOCK_FILE( hdsFile );
 
 /* Begin a new error reporting environment */
    emsBegin( status );
@@ -179,7 +208,6 @@ int hds1UnregLocator( HDSLoc *locator, int *status ) {
 
 /* If the locator just removed was at the head of a chain, change the
    chain head to the following locator. */
-   hdsFile = locator->hdsFile;
    if( !hdsFile ) {  /* Sanity check */
       *status = DAT__FATAL;
       datMsg( "L", locator );
@@ -231,8 +259,8 @@ int hds1UnregLocator( HDSLoc *locator, int *status ) {
 /* End the current error reporting environment */
    emsEnd( status );
 
-/* Unlock the mutex that serialises access to the hash table */
-   UNLOCK_MUTEX;
+/* Unlock the mutex for the container file. */
+   if( hdsFile ) UNLOCK_FILE( hdsFile );
 
    return result;
 }
@@ -251,9 +279,6 @@ HDSLoc *hds1PopSecLocator( HDSLoc *locator, HdsFile **context, int *status ){
    HdsFile *hdsFile = context ? *context : NULL;
    int lstat = *status;
 
-/* Lock the mutex that serialises access to the hash table */
-   LOCK_MUTEX;
-
    if( !hdsFile && locator ) {
       hdsFile = locator->hdsFile;
       if( context ) *context = hdsFile;
@@ -267,6 +292,7 @@ HDSLoc *hds1PopSecLocator( HDSLoc *locator, HdsFile **context, int *status ){
    }
 
    if( hdsFile ){
+      LOCK_FILE( hdsFile );
       result = hdsFile->sechead;
       if( result ) {
          hdsFile->sechead = result->prev;
@@ -278,6 +304,7 @@ HDSLoc *hds1PopSecLocator( HDSLoc *locator, HdsFile **context, int *status ){
                      status, hdsFile->path );
          }
       }
+      UNLOCK_FILE( hdsFile );
    }
 
 /* Context error message */
@@ -286,9 +313,6 @@ HDSLoc *hds1PopSecLocator( HDSLoc *locator, HdsFile **context, int *status ){
               "list of secondary locators.", status );
    }
 
-/* Unlock the mutex that serialises access to the hash table */
-   UNLOCK_MUTEX;
-
    return result;
 }
 
@@ -301,8 +325,9 @@ HdsFile *hds1FreeHdsFile( HdsFile *hdsFile, int *status ){
 
    if( hdsFile ) {
       LOCK_MUTEX;
-
       HASH_DEL( hdsFiles, hdsFile );
+      __atomic_sub_fetch( &NumFiles, 1, __ATOMIC_RELAXED );
+      UNLOCK_MUTEX;
 
       if( hdsFile->sechead ) { /* Sanity check */
          if( *status == SAI__OK ) {
@@ -321,11 +346,10 @@ HdsFile *hds1FreeHdsFile( HdsFile *hdsFile, int *status ){
       }
 
       if( hdsFile->path ) MEM_FREE( hdsFile->path );
+      pthread_mutex_destroy( &(hdsFile->mutex) );
       memset( hdsFile, 0, sizeof(*hdsFile) );
       MEM_FREE( hdsFile );
       hdsFile = NULL;
-
-      UNLOCK_MUTEX;
    }
 
    return NULL;
@@ -340,23 +364,19 @@ size_t hds1PrimaryCount( const HDSLoc *locator, int *status ) {
    HdsFile *hdsFile;
    size_t result = 0;
 
-/* Lock the mutex that serialises access to the hash table */
-   LOCK_MUTEX;
-
    if( locator ){
       hdsFile = locator->hdsFile;
       if( hdsFile ) {
+         LOCK_FILE( hdsFile );
          loc = hdsFile->primhead;
          while( loc ) {
             result++;
             loc = loc->prev;
          }
+         UNLOCK_FILE( hdsFile );
       }
    }
 
-/* Unlock the mutex that serialises access to the hash table */
-   UNLOCK_MUTEX;
-
    return result;
 }
 
@@ -364,7 +384,7 @@ size_t hds1PrimaryCount( const HDSLoc *locator, int *status ) {
 
 /* -----------------------------------------------------------------
    Return a dynamically allocated array holding a list of any active
-   locators associated with a supplied HDF5 file path. Also return a
+   locators associated with a supplied HDF5 file. Also return a
    dynamically allocated array holding a list of file_ids for the same
    file that have associated locators. "*nloc" is returned holding the
    length of the *loclist array. The end of the *file_ids array is
@@ -376,9 +396,8 @@ void hds1GetLocators( hid_t file_id, int *nloc, HDSLoc ***loclist,
 /* Local Variables; */
    HDSLoc **ploc;
    HDSLoc *loc;
-   HdsFile *hdsFile;
-   char *abspath;
-   char *path;
+   HdsFile *hdsFile = NULL;
+   HdsFileKey key;
    hid_t *pr;
    hid_t *pw;
    hid_t *pid;
@@ -392,35 +411,21 @@ void hds1GetLocators( hid_t file_id, int *nloc, HDSLoc ***loclist,
 /* Check inherited status */
    if( *status != SAI__OK ) return;
 
+/* We need the device and inode of the file so that we can use them as a
+   key into the hash table. */
+   hds2FileKey( file_id, &key, status );
+
 /* Lock the mutex that serialises access to the hash table */
    LOCK_MUTEX;
 
-/* We need the path to the file so that we can use it as a key into the
-   hash table. Get a dynamically allocated buffer holding the path to the
-   file associated with the supplied file id. */
-   path = dat1GetFullName( file_id, 1, NULL, status );
-
-/* Convert the above path, which may be relative, into an absolute path.
-   The absolute path is returned in a dynamically allocated string. */
-   abspath = hds2AbsPath( path, status );
-
-/* Free the momory holding the relative path. */
-   if( path ) {
-      MEM_FREE( path );
-      path = NULL;
-   }
-
-/* Search for an existing entry in the hash table for this path. */
-   if( abspath ) {
-      HASH_FIND_STR( hdsFiles, abspath, hdsFile );
-
-/* Free the momory holding the absolute path. */
-      MEM_FREE( abspath );
-      abspath = NULL;
+/* Search for an existing entry in the hash table for this file. */
+   if( *status == SAI__OK ) {
+      HASH_FIND( hh, hdsFiles, &key, sizeof( key ), hdsFile );
    }
 
 /* If found... */
    if( hdsFile ){
+      LOCK_FILE( hdsFile );
 
 /* Count the number of primary locators. */
       loc = hdsFile->primhead;
@@ -478,6 +483,7 @@ void hds1GetLocators( hid_t file_id, int *nloc, HDSLoc ***loclist,
 /* Terminate the returned list of file ids with a zero value. */
          *pw = 0;
       }
+      UNLOCK_FILE( hdsFile );
    }
 
 /* Context error message */
@@ -496,11 +502,7 @@ void hds1GetLocators( hid_t file_id, int *nloc, HDSLoc ***loclist,
    Return the number of unique opened files. */
 
 int hds1CountFiles() {
-   int num_files;
-   LOCK_MUTEX;
-   num_files = HASH_COUNT( hdsFiles );
-   UNLOCK_MUTEX;
-   return num_files;
+   return __atomic_load_n( &NumFiles, __ATOMIC_RELAXED );
 }
 
 
@@ -539,6 +541,7 @@ int hds1CountLocators( size_t ncomp, char **comps, hdsbool_t skip_scratch_root,
 
 /* Loop round all primary locators associated with the current hdsFile,
    followed by all secondary locators. */
+      LOCK_FILE( hdsFile );
       prim = 1;
       loc = hdsFile->primhead;
       while( loc ) {
@@ -621,6 +624,7 @@ int hds1CountLocators( size_t ncomp, char **comps, hdsbool_t skip_scratch_root,
             prim = 0;
          }
       }
+      UNLOCK_FILE( hdsFile );
 
 /* Move on to the next HdsFile structure. */
       hdsFile = hdsFile->hh.next;
@@ -643,78 +647,46 @@ int hds1CountLocators( size_t ncomp, char **comps, hdsbool_t skip_scratch_root,
 
 /* -----------------------------------------------------------------
    Returns a pointer to the existing Handle that describes the top level
-   data object in the file specified by "file_id", or NULL if the file
-   has not previously been opened and so has no top-level Handle as yet.
-   Also returns NULL if an error occurs. */
+   data object in the supplied container file, or NULL if the file has no
+   top-level Handle as yet. Also returns NULL if an error occurs. */
 
-Handle *hds1FindHandle( hid_t file_id, int *status ){
+Handle *hds1FindHandle( HdsFile *hdsFile, int *status ){
 
 /* Local Variables; */
    HDSLoc *loc;
    Handle *result = NULL;
-   char *abspath;
-   char *path;
-   HdsFile *hdsFile;
 
 /* Check inherited status */
-   if( *status != SAI__OK ) return result;
+   if( *status != SAI__OK || !hdsFile ) return result;
 
-/* Lock the mutex that serialises access to the hash table */
-   LOCK_MUTEX;
-
-/* We need the path to the file so that we can use it as a key into the
-   hash table. Get a dynamically allocated buffer holding the path to the
-   file associated with the supplied file id. */
-   path = dat1GetFullName( file_id, 1, NULL, status );
-
-/* Convert the above path, which may be relative, into an absolute path.
-   The absolute path is returned in a dynamically allocated string. */
-   abspath = hds2AbsPath( path, status );
-
-/* Free the momory holding the relative path. */
-   if( path ) {
-      MEM_FREE( path );
-      path = NULL;
-   }
-
-/* Search for an existing entry in the hash table for this path. */
-   if( abspath ) {
-      HASH_FIND_STR( hdsFiles, abspath, hdsFile );
-
-/* Free the momory holding the absolute path. Must use plain free, not
-   MEM_FREE, since realpath uses plain malloc. */
-      MEM_FREE( abspath );
-      abspath = NULL;
-   }
-
-/* If found... */
-   if( hdsFile ){
+/* Lock the mutex that serialises access to the lists of locators for the
+   file. */
+   LOCK_FILE( hdsFile );
 
 /* Loop round all primary locators associated with this file until we
    find one that has a non_NULL handle. */
-      loc = hdsFile->primhead;
-      while( loc ) {
-         if( loc->handle ) {
+   loc = hdsFile->primhead;
+   while( loc ) {
+      if( loc->handle ) {
 
 /* Get the handle from the locator and navigate from there up the tree of
    handles to the top of the tree. Then break out of the loop. */
-            result = dat1TopHandle( loc->handle, status );
-            break;
-         }
+         result = dat1TopHandle( loc->handle, status );
+         break;
+      }
 
 /* Move on to the next primary handle in the linked list. */
-         loc = loc->prev;
-      }
+      loc = loc->prev;
    }
 
 /* Context error message */
    if( *status != SAI__OK ) {
       emsRep( " ", "hds1FindHandle: Failed to find a handle for a given "
-              "file id.", status );
+              "file.", status );
    }
 
-/* Unlock the mutex that serialises access to the hash table */
-   UNLOCK_MUTEX;
+/* Unlock the mutex. */
+   UNLOCK_FILE( hdsFile );
 
    return result;
 }
@@ -722,6 +694,68 @@ Handle *hds1FindHandle( hid_t file_id, int *status ){
 
 
 
+/* -----------------------------------------------------------------
+   Returns an HDF5 file identifier that is already in use by a primary
+   locator for the file with the supplied path, or zero if the file is not
+   currently open. The file is identified by device and inode, so the
+   supplied path need not be the path originally used to open the file.
+   Zero is also returned if "flags" is H5F_ACC_RDWR but the file is only
+   open for read-only access. The returned identifier is owned by the
+   existing locators and should not be closed by the caller. If an
+   identifier is returned, "*hdsFile" is returned holding a pointer to the
+   HdsFile structure for the file, which should be stored in any new
+   locator that uses the identifier before it is registered. */
+
+hid_t hds1FindFileId( const char *path, unsigned int flags, HdsFile **hdsFile,
+                      int *status ){
+
+/* Local Variables; */
+   HDSLoc *loc;
+   HdsFileKey key;
+   hid_t result = 0;
+   struct stat buf;
+   unsigned int intent;
+
+/* Initialise */
+   *hdsFile = NULL;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return result;
+
+/* Get the device and inode of the file. A file that cannot be found will
+   be reported by the caller. */
+   if( stat( path, &buf ) != 0 ) return result;
+   memset( &key, 0, sizeof( key ) );
+   key.dev = buf.st_dev;
+   key.ino = buf.st_ino;
+
+/* Lock the mutex that serialises access to the hash table, and search
+   for an entry for the file. */
+   LOCK_MUTEX;
+   HASH_FIND( hh, hdsFiles, &key, sizeof( key ), *hdsFile );
+
+/* If found, use the file identifier from the first primary locator that
+   gives the required access. */
+   if( *hdsFile ) {
+      LOCK_FILE( *hdsFile );
+      loc = (*hdsFile)->primhead;
+      while( loc && !result ) {
+         if( loc->file_id > 0 && H5Fget_intent( loc->file_id, &intent ) >= 0 &&
+             ( flags == H5F_ACC_RDONLY || ( intent & H5F_ACC_RDWR ) ) ) {
+            result = loc->file_id;
+         }
+         loc = loc->prev;
+      }
+      UNLOCK_FILE( *hdsFile );
+      if( !result ) *hdsFile = NULL;
+   }
+
+   UNLOCK_MUTEX;
+
+   return result;
+}
+
+
 /* -----------------------------------------------------------------
    Version of hdsShow that uses the internal list of locators rather than
    the HDF5 list of locators. This should duplicate the HDF5 list. */
@@ -751,6 +785,8 @@ void hds1ShowFiles( hdsbool_t listfiles, hdsbool_t listlocs, int * status  ){
    hdsFile = hdsFiles;
    while( hdsFile ) {
 
+      LOCK_FILE( hdsFile );
+
 /* If displaying info about each file... */
       if( listfiles ) {
 
@@ -790,7 +826,7 @@ void hds1ShowFiles( hdsbool_t listfiles, hdsbool_t listlocs, int * status  ){
 
             printf("   %p [%s] (%s) group=%s\n", loc, namestr,
                    (loc->isprimary ? "primary" : "secondary"),
-                   loc->grpname );
+                   ( loc->grpname ? loc->grpname : "" ) );
 
             loc = loc->prev;
          }
@@ -807,11 +843,12 @@ void hds1ShowFiles( hdsbool_t listfiles, hdsbool_t listlocs, int * status  ){
 
             printf("   %p [%s] (%s) group=%s\n", loc, namestr,
                    (loc->isprimary ? "primary" : "secondary"),
-                   loc->grpname );
+                   ( loc->grpname ? loc->grpname : "" ) );
 
             loc = loc->prev;
          }
       }
+      UNLOCK_FILE( hdsFile );
 
 /* Move on to the next HdsFile structure. */
       hdsFile = hdsFile->hh.next;
@@ -822,6 +859,64 @@ void hds1ShowFiles( hdsbool_t listfiles, hdsbool_t listlocs, int * status  ){
 }
 
 
+/* -----------------------------------------------------------------
+   Return a dynamically allocated array holding pointers to the full
+   paths of all registered container files. "*npath" is returned holding
+   the length of the array. The paths are stored in the same memory
+   block as the array, so the whole lot can be freed using a single call
+   to MEM_FREE. NULL is returned if no files are registered. */
+
+char **hds1GetPaths( int *npath, int *status ){
+
+/* Local Variables: */
+   HdsFile *hdsFile;
+   char **result = NULL;
+   char *p;
+   size_t nbyte;
+   int i;
+
+/* Initialise returned values. */
+   *npath = 0;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return result;
+
+/* Lock the mutex that serialises access to the registry */
+   LOCK_MUTEX;
+
+/* Find the total size needed for the array and the paths. */
+   nbyte = 0;
+   for( hdsFile = hdsFiles; hdsFile; hdsFile = hdsFile->hh.next ) {
+      nbyte += sizeof( *result ) + strlen( hdsFile->path ) + 1;
+      (*npath)++;
+   }
+
+/* Allocate it and copy the paths into it. */
+   if( *npath > 0 ) {
+      result = MEM_MALLOC( nbyte );
+      if( result ) {
+         p = (char *)( result + *npath );
+         i = 0;
+         for( hdsFile = hdsFiles; hdsFile; hdsFile = hdsFile->hh.next ) {
+            result[ i++ ] = p;
+            strcpy( p, hdsFile->path );
+            p += strlen( p ) + 1;
+         }
+      } else {
+         *npath = 0;
+         *status = DAT__NOMEM;
+         emsRep( " ", "Could not allocate memory for the paths of the "
+                 "open HDS container files.", status );
+      }
+   }
+
+/* Unlock the mutex that serialises access to the registry */
+   UNLOCK_MUTEX;
+
+   return result;
+}
+
+
 static int hds2CompareId( const void *a, const void *b ){
    hid_t *pa = (hid_t *) a;
    hid_t *pb = (hid_t *) b;
@@ -834,6 +929,72 @@ static int hds2CompareId( const void *a, const void *b ){
    }
 }
 
+/* Return the absolute path to the file associated with an HDF5 file
+   identifier, in a dynamically allocated string. NULL is returned if the
+   file has no path or an error occurs. */
+static char *hds2FilePath( hid_t file_id, int *status ){
+   char *abspath = NULL;
+   char *path;
+
+   if( *status != SAI__OK ) return abspath;
+
+/* Get a dynamically allocated buffer holding the path to the file. */
+   path = dat1GetFullName( file_id, 1, NULL, status );
+
+/* Convert the above path, which may be relative, into an absolute path,
+   then free the memory holding the relative path. */
+   if( path ) {
+      abspath = hds2AbsPath( path, status );
+      MEM_FREE( path );
+   }
+
+   return abspath;
+}
+
+/* Return the device and inode of the file associated with an HDF5 file
+   identifier. When the file uses the default (POSIX) driver these are
+   obtained directly from the open file descriptor. */
+static void hds2FileKey( hid_t file_id, HdsFileKey *key, int *status ){
+   char *path;
+   hid_t fapl;
+   int ok = 0;
+   struct stat buf;
+   void *vfd = NULL;
+
+   memset( key, 0, sizeof( *key ) );
+   if( *status != SAI__OK ) return;
+
+/* If the file uses the POSIX driver, the HDF5 file handle is a pointer to
+   the POSIX file descriptor. */
+   fapl = H5Fget_access_plist( file_id );
+   if( fapl > 0 ) {
+      if( H5Pget_driver( fapl ) == H5FD_SEC2 &&
+          H5Fget_vfd_handle( file_id, fapl, &vfd ) >= 0 && vfd ) {
+         ok = ( fstat( *( (int *) vfd ), &buf ) == 0 );
+      }
+      H5Pclose( fapl );
+   }
+
+/* Otherwise, use the file path. */
+   if( !ok ) {
+      path = dat1GetFullName( file_id, 1, NULL, status );
+      if( path ) {
+         ok = ( stat( path, &buf ) == 0 );
+         MEM_FREE( path );
+      }
+   }
+
+   if( ok ) {
+      key->dev = buf.st_dev;
+      key->ino = buf.st_ino;
+
+   } else if( *status == SAI__OK ) {
+      *status = DAT__FILNF;
+      emsRep( " ", "Cannot determine the device and inode of an HDF5 "
+              "container file.", status );
+   }
+}
+
 /* Return the absolute path to a file given the (possibly relative) supplied
    path. We can't just use the systems's realpath function since that
    requires the file to exist, which it may not. */
@@ -1,3 +1,4 @@
+#include <limits.h>
 #include <pthread.h>
 #include <string.h>
 
@@ -12,11 +13,13 @@
 
 /* Variable storing tuned state */
 
-/* Indicates that we have looked at the environment */
-static hdsbool_t HAVE_INITIALIZED_V5_TUNING = 0;
+/* Ensures that we look at the environment only once */
+static pthread_once_t TuneOnce = PTHREAD_ONCE_INIT;
 
 /* These are all the parameters that can be tuned along
-   with their defaults. */
+   with their defaults. They are read and written atomically so that
+   the getters, which are called by every public routine, do not need
+   to lock a mutex. */
 
 static hds_shell_t HDS_SHELL = HDS__SHSHELL; /* Default to doing expansion */
 
@@ -24,26 +27,90 @@ static hds_shell_t HDS_SHELL = HDS__SHSHELL; /* Default to doing expansion */
 
 static hdsbool_t HDS_MAP = HDS_TRUE; /* Do mmap by default when possible */
 
+/* Should files opened for writing also be mapped directly: 1 (yes), 0
+   (no). This needs the HDF5 sieve buffer to be disabled for such files. */
+
+static hdsbool_t HDS_MAPUPDATE = HDS_FALSE; /* Map copies by default */
+
 /* Should checks on HDS object locks be performed? 1 (yes), 0 (no) */
 
 static hdsbool_t HDS_LOCKCHECK = HDS_TRUE; /* Perform locking checks by default */
 
-/* A mutex used to serialise access to the getters and setters so that
-   multiple threads do not try to access the global data simultaneously. */
-static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
-#define LOCK_MUTEX pthread_mutex_lock( &mutex1 );
-#define UNLOCK_MUTEX pthread_mutex_unlock( &mutex1 );
+/* Should a catalogue of the hierarchy be written to each container file
+   that is modified? 1 (yes), 0 (no) */
+
+static hdsbool_t HDS_CATALOGUE = HDS_FALSE; /* No catalogue by default */
+
+/* Primitives with no more than this many bytes of data are stored in
+   the object header (compact layout) rather than in a separate block.
+   Off by default. */
+
+static int HDS_COMPACT = 0;
+
+/* Default storage filters for new primitives: the deflate compression
+   level (0 for none), whether bytes should be shuffled (1) or not (0),
+   whether a Fletcher32 checksum should be stored (1) or not (0), and the
+   scale-offset setting (0 for none). A new primitive that uses any
+   filter is chunked, with chunks of about HDS_CHUNKSIZE bytes unless the
+   chunk shape is given explicitly. */
+
+static int HDS_DEFLATE = 0;
+static hdsbool_t HDS_SHUFFLE = HDS_FALSE;
+static hdsbool_t HDS_FLETCHER32 = HDS_FALSE;
+static int HDS_SCALEOFFSET = 0;
+static int HDS_CHUNKSIZE = 262144;
+
+/* Number of threads used to compress or decompress the chunks of a
+   filtered primitive when it is written or read. One means HDF5 does it
+   itself. */
+
+static int HDS_NTHREADS = 1;
+
+/* File access properties: the number of bytes and hash table slots in
+   the cache of decompressed chunks kept for each open primitive, the
+   number of bytes in the buffer used to combine small reads and writes
+   of raw data (the "sieve buffer"), and the size of the blocks in which
+   space is allocated for metadata. The defaults are those used by HDF5.
+   The classic NBLOCKS parameter gives the cache size in 512-byte blocks,
+   and MAXW gives the number of slots. */
+
+static int HDS_RAWCACHE = 1048576;
+static int HDS_RAWSLOTS = 521;
+static int HDS_SIEVE = 65536;
+static int HDS_METABLOCK = 2048;
+
+/* File creation properties: the number of 512-byte blocks of disk space
+   allocated to a new container file when it is created (INAL), and the
+   number of components that each new structure is expected to hold
+   (NCOM). Zero means that HDF5 decides. */
+
+static int HDS_INAL = 0;
+static int HDS_NCOMP = 0;
 
 /* Parse tuning environment variables. Should only be called once the
    first time a tuning parameter is required */
 
 static void hds1SetShell( hds_shell_t shell);
 static void hds1SetUseMmap( hdsbool_t use_mmap );
+static void hds1SetMapUpdate( hdsbool_t map_update );
 static void hds1SetLockCheck( hdsbool_t lock_check );
+static void hds1SetCatalogue( hdsbool_t catalogue );
+static void hds1SetCompact( int compact );
+static void hds1SetDeflate( int deflate );
+static void hds1SetShuffle( hdsbool_t shuffle );
+static void hds1SetFletcher32( hdsbool_t fletcher32 );
+static void hds1SetScaleOffset( int scaleoffset );
+static void hds1SetChunkSize( int chunksize );
+static void hds1SetNThreads( int nthreads );
+static void hds1SetRawCache( int rawcache );
+static void hds1SetRawSlots( int rawslots );
+static void hds1SetSieve( int sieve );
+static void hds1SetMetaBlock( int metablock );
+static void hds1SetInal( int inal );
+static void hds1SetNcomp( int ncomp );
 
 static void hds1ReadTuneEnvironment () {
   int itemp = 0;
-  if (HAVE_INITIALIZED_V5_TUNING) return;
 
   /* dat1Getenv solely knows about environment variables
      with integers and not about range checking so we do the range check
@@ -57,11 +124,73 @@ static void hds1ReadTuneEnvironment () {
   dat1Getenv( "HDS_MAP", HDS_MAP, &itemp );
   hds1SetUseMmap( itemp ? HDS_TRUE : HDS_FALSE );
 
+  itemp = (HDS_MAPUPDATE ? 1 : 0);
+  dat1Getenv( "HDS_MAPUPDATE", HDS_MAPUPDATE, &itemp );
+  hds1SetMapUpdate( itemp ? HDS_TRUE : HDS_FALSE );
+
   itemp = (HDS_LOCKCHECK ? 1 : 0);
   dat1Getenv( "HDS_LOCKCHECK", HDS_LOCKCHECK, &itemp );
   hds1SetLockCheck( itemp ? HDS_TRUE : HDS_FALSE );
 
-  HAVE_INITIALIZED_V5_TUNING = 1;
+  itemp = (HDS_CATALOGUE ? 1 : 0);
+  dat1Getenv( "HDS_CATALOGUE", HDS_CATALOGUE, &itemp );
+  hds1SetCatalogue( itemp ? HDS_TRUE : HDS_FALSE );
+
+  itemp = HDS_COMPACT;
+  dat1Getenv( "HDS_COMPACT", HDS_COMPACT, &itemp );
+  hds1SetCompact( itemp );
+
+  itemp = HDS_DEFLATE;
+  dat1Getenv( "HDS_DEFLATE", HDS_DEFLATE, &itemp );
+  hds1SetDeflate( itemp );
+
+  itemp = (HDS_SHUFFLE ? 1 : 0);
+  dat1Getenv( "HDS_SHUFFLE", HDS_SHUFFLE, &itemp );
+  hds1SetShuffle( itemp ? HDS_TRUE : HDS_FALSE );
+
+  itemp = (HDS_FLETCHER32 ? 1 : 0);
+  dat1Getenv( "HDS_FLETCHER32", HDS_FLETCHER32, &itemp );
+  hds1SetFletcher32( itemp ? HDS_TRUE : HDS_FALSE );
+
+  itemp = HDS_SCALEOFFSET;
+  dat1Getenv( "HDS_SCALEOFFSET", HDS_SCALEOFFSET, &itemp );
+  hds1SetScaleOffset( itemp );
+
+  itemp = HDS_CHUNKSIZE;
+  dat1Getenv( "HDS_CHUNKSIZE", HDS_CHUNKSIZE, &itemp );
+  hds1SetChunkSize( itemp );
+
+  itemp = HDS_NTHREADS;
+  dat1Getenv( "HDS_NTHREADS", HDS_NTHREADS, &itemp );
+  hds1SetNThreads( itemp );
+
+  /* The classic HDS_NBLOCKS and HDS_MAXWPL variables are used if the
+     more specific ones are not set. */
+  itemp = HDS_RAWCACHE / HDS__BLOCKSIZE;
+  dat1Getenv( "HDS_NBLOCKS", itemp, &itemp );
+  dat1Getenv( "HDS_RAWCACHE", itemp * HDS__BLOCKSIZE, &itemp );
+  hds1SetRawCache( itemp );
+
+  itemp = HDS_RAWSLOTS;
+  dat1Getenv( "HDS_MAXWPL", HDS_RAWSLOTS, &itemp );
+  dat1Getenv( "HDS_RAWSLOTS", itemp, &itemp );
+  hds1SetRawSlots( itemp );
+
+  itemp = HDS_SIEVE;
+  dat1Getenv( "HDS_SIEVE", HDS_SIEVE, &itemp );
+  hds1SetSieve( itemp );
+
+  itemp = HDS_METABLOCK;
+  dat1Getenv( "HDS_METABLOCK", HDS_METABLOCK, &itemp );
+  hds1SetMetaBlock( itemp );
+
+  itemp = HDS_INAL;
+  dat1Getenv( "HDS_INALQ", HDS_INAL, &itemp );
+  hds1SetInal( itemp );
+
+  itemp = HDS_NCOMP;
+  dat1Getenv( "HDS_NCOMP", HDS_NCOMP, &itemp );
+  hds1SetNcomp( itemp );
 }
 
 
@@ -95,15 +224,130 @@ static void hds1ReadTuneEnvironment () {
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
+*     AGENT: agent (agent@local)
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Supports MAP and SHELL tuning parameters
+*     - Supports MAP, MAPUPDATE, LOCKCHECK, CATALOGUE, COMPACT, DEFLATE,
+*       SHUFFLE, FLETCHER32, SCALEOFFSET, CHUNKSIZE, NTHREADS, RAWCACHE,
+*       RAWSLOTS, SIEVE, METABLOCK, NBLOCKS, MAXW, INAL, NCOM and SHELL
+*       tuning parameters
+*     - MAPUPDATE: if non-zero (and MAP is non-zero), files that are
+*       opened for writing are also mapped directly by datMap, rather
+*       than through a copy of the data. HDF5 must then not keep its own
+*       copy of raw data, so the sieve buffer is disabled for such files
+*       and the SIEVE setting is ignored for them. If MAPUPDATE is zero,
+*       such files are only mapped directly if SIEVE is also zero.
+*       Defaults to 0 (or the value of the HDS_MAPUPDATE environment
+*       variable).
+*     - CATALOGUE: if non-zero, a catalogue of the hierarchy is written
+*       to each container file that is modified, when the file is closed
+*       (see datCatalogue). If zero, any catalogue already held in a file
+*       that is modified is left out of date, and so is no longer used.
+*       Defaults to 0 (or the value of the HDS_CATALOGUE environment
+*       variable).
+*     - COMPACT: the largest number of bytes of data in a new primitive
+*       for which compact storage is used. The data for a compact
+*       primitive is stored with its other metadata in the file, rather
+*       than in a separate block, so it can be read without any extra
+*       I/O. Zero disables compact storage. The value is limited to
+*       HDS__MXCOMPACT bytes. Defaults to 0 (or the value of the
+*       HDS_COMPACT environment variable).
+*     - DEFLATE, SHUFFLE, FLETCHER32, SCALEOFFSET: the storage filters
+*       used by default for new primitives (see datNewP, which can
+*       override them for individual primitives). DEFLATE is the deflate
+*       (gzip) compression level, 0 to 9, where 0 means no compression.
+*       SHUFFLE and FLETCHER32 are flags indicating if the bytes of each
+*       value should be shuffled before compression, and if a checksum
+*       should be stored with each chunk. A non-zero SCALEOFFSET value
+*       enables the scale-offset filter: integer values are stored
+*       losslessly using the minimum number of bits, and floating point
+*       values are rounded to SCALEOFFSET decimal places (so this is
+*       lossy). All default to 0 (or the value of the HDS_DEFLATE,
+*       HDS_SHUFFLE, HDS_FLETCHER32 and HDS_SCALEOFFSET environment
+*       variables).
+*     - CHUNKSIZE: the approximate number of bytes in each chunk of a
+*       primitive that uses any storage filter, if the chunk shape is not
+*       given explicitly. Defaults to 262144 (or the value of the
+*       HDS_CHUNKSIZE environment variable).
+*     - NTHREADS: the number of threads used to compress the chunks of a
+*       primitive that uses the deflate, shuffle or Fletcher32 filters
+*       when it is written by datPut (or datUnmap), and to decompress them
+*       when it is read by datGet (or datMap). One means the chunks are
+*       compressed and decompressed by HDF5 in the calling thread. The
+*       value is limited to HDS__MXTHREADS. Defaults to 1 (or the value of
+*       the HDS_NTHREADS environment variable).
+*     - RAWCACHE, RAWSLOTS: the number of bytes, and the number of hash
+*       table slots, in the cache of decompressed chunks that HDF5 keeps
+*       for each open chunked primitive. Chunks that are accessed again
+*       while they are in the cache are not read and decompressed again.
+*       A primitive for which one layer of chunks (i.e. all the chunks
+*       that hold a single plane of a cube) does not fit in the cache is
+*       given a larger cache of its own, up to HDS__MXRAWCACHE bytes.
+*       Default to 1048576 bytes and 521 slots (or the values of the
+*       HDS_RAWCACHE and HDS_RAWSLOTS environment variables).
+*     - NBLOCKS, MAXW: the HDS Classic names for RAWCACHE and RAWSLOTS.
+*       NBLOCKS gives the size of the cache in 512-byte blocks, and MAXW
+*       gives the number of slots. The HDS_NBLOCKS and HDS_MAXWPL
+*       environment variables are also used.
+*     - SIEVE: the number of bytes in the buffer that HDF5 uses to
+*       combine small reads and writes of contiguous primitives. Zero
+*       disables it. SIEVE is ignored, and the sieve buffer disabled,
+*       for files opened for writing while MAP and MAPUPDATE are both
+*       non-zero. Defaults to 65536 (or the value of the HDS_SIEVE
+*       environment variable).
+*     - METABLOCK: the size of the blocks in which file space is
+*       allocated for metadata, which keeps the metadata for nearby
+*       objects close together in the file. Zero allocates space for
+*       each item of metadata separately. Defaults to 2048 (or the value
+*       of the HDS_METABLOCK environment variable).
+*     - The above file access parameters are used when a file is opened
+*       or created, so changing them does not affect files that are
+*       already open.
+*     - INAL: the number of 512-byte blocks of disk space allocated to
+*       each new container file when it is created (see hdsNew). If
+*       non-zero, the space is reserved using posix_fallocate, so that a
+*       file that grows to a large size occupies few contiguous extents
+*       on the disk, and HDF5 allocates space within the file in pages
+*       and keeps track of free space between sessions. Space that has
+*       not been used is released when the file is closed. Files created
+*       in this way need HDF5 version 1.10.1 or later to read them.
+*       Defaults to zero (or the value of the HDS_INALQ environment
+*       variable), which leaves file space to HDF5.
+*     - NCOM: the number of components that each new structure is
+*       expected to hold. Space for this many components is reserved when
+*       the structure is created, and structures with up to this many
+*       components are stored in the compact form used by HDF5 for small
+*       groups. Defaults to zero (or the value of the HDS_NCOMP
+*       environment variable), which uses the HDF5 defaults (space for
+*       four components, and the compact form for up to eight).
 *     - Other HDS Classic tuning parameters are ignored.
 
 *  History:
 *     2014-09-10 (TIMJ):
 *        Initial version
+*     2026-10-16 (AGENT):
+*        Add CATALOGUE tuning parameter.
+*     2026-10-16 (AGENT):
+*        Add COMPACT tuning parameter.
+*     2026-10-16 (AGENT):
+*        Add DEFLATE, SHUFFLE, FLETCHER32, SCALEOFFSET and CHUNKSIZE
+*        tuning parameters.
+*     2026-10-16 (AGENT):
+*        Add NTHREADS tuning parameter.
+*     2026-10-16 (AGENT):
+*        NTHREADS also sets the number of threads used to decompress
+*        chunks.
+*     2026-10-16 (AGENT):
+*        Add RAWCACHE, RAWSLOTS, SIEVE and METABLOCK tuning parameters,
+*        and use NBLOCKS and MAXW to set the chunk cache.
+*     2026-10-16 (AGENT):
+*        INAL and NCOM control the space allocated to new files and
+*        structures.
+*     2026-10-16 (AGENT):
+*        Change the default for COMPACT to zero.
+*     2026-10-16 (AGENT):
+*        Add MAPUPDATE tuning parameter.
 *     {enter_further_changes_here}
 
 *  Copyright:
@@ -163,7 +407,9 @@ hdsTune(const char *param_str, int  value, int  *status) {
      - SYSL: System wide locking flag
      - WAIT: Wait for locked files
 
-     INAL, MAXW, NBLOCKS, NCOM, SYSL and WAIT are all irrelevant.
+     SYSL and WAIT are irrelevant. MAXW and NBLOCKS set the size of
+     the HDF5 chunk cache. INAL and NCOM set the HDF5 creation
+     properties for new files and structures.
 
      64BIT will have no effect as we are using whatever HDF5 gives us.
 
@@ -174,18 +420,48 @@ hdsTune(const char *param_str, int  value, int  *status) {
 
   */
 
-  if (strncmp( param_str, "INAL", 4 ) == 0 ||
-      strncmp( param_str, "64BIT", 5 ) == 0 ||
-      strncmp( param_str, "MAXW", 4 ) == 0 ||
-      strncmp( param_str, "NBLO", 4 ) == 0 ||
-      strncmp( param_str, "NCOM", 4 ) == 0 ||
+  if (strncmp( param_str, "64BIT", 5 ) == 0 ||
       strncmp( param_str, "SYSL", 4 ) == 0 ||
       strncmp( param_str, "WAIT", 4 ) == 0 ) {
     /* Irrelevant for HDF5 */
+  } else if (strncmp( param_str, "MAPU", 4) == 0 ) {
+    hds1SetMapUpdate( value ? HDS_TRUE : HDS_FALSE );
   } else if (strncmp( param_str, "MAP", 3) == 0 ) {
     hds1SetUseMmap( value ? HDS_TRUE : HDS_FALSE );
   } else if (strncmp( param_str, "LOCKCHECK", 9) == 0 ) {
     hds1SetLockCheck( value ? HDS_TRUE : HDS_FALSE );
+  } else if (strncmp( param_str, "CATA", 4) == 0 ) {
+    hds1SetCatalogue( value ? HDS_TRUE : HDS_FALSE );
+  } else if (strncmp( param_str, "COMP", 4) == 0 ) {
+    hds1SetCompact( value );
+  } else if (strncmp( param_str, "DEFL", 4) == 0 ) {
+    hds1SetDeflate( value );
+  } else if (strncmp( param_str, "SHUF", 4) == 0 ) {
+    hds1SetShuffle( value ? HDS_TRUE : HDS_FALSE );
+  } else if (strncmp( param_str, "FLET", 4) == 0 ) {
+    hds1SetFletcher32( value ? HDS_TRUE : HDS_FALSE );
+  } else if (strncmp( param_str, "SCAL", 4) == 0 ) {
+    hds1SetScaleOffset( value );
+  } else if (strncmp( param_str, "CHUN", 4) == 0 ) {
+    hds1SetChunkSize( value );
+  } else if (strncmp( param_str, "NTHR", 4) == 0 ) {
+    hds1SetNThreads( value );
+  } else if (strncmp( param_str, "RAWC", 4) == 0 ) {
+    hds1SetRawCache( value );
+  } else if (strncmp( param_str, "NBLO", 4) == 0 ) {
+    hds1SetRawCache( value > INT_MAX / HDS__BLOCKSIZE ? INT_MAX :
+                     value * HDS__BLOCKSIZE );
+  } else if (strncmp( param_str, "RAWS", 4) == 0 ||
+             strncmp( param_str, "MAXW", 4) == 0 ) {
+    hds1SetRawSlots( value );
+  } else if (strncmp( param_str, "SIEV", 4) == 0 ) {
+    hds1SetSieve( value );
+  } else if (strncmp( param_str, "META", 4) == 0 ) {
+    hds1SetMetaBlock( value );
+  } else if (strncmp( param_str, "INAL", 4) == 0 ) {
+    hds1SetInal( value );
+  } else if (strncmp( param_str, "NCOM", 4) == 0 ) {
+    hds1SetNcomp( value );
   } else if (strncmp( param_str, "SHEL", 4) == 0) {
     hds1SetShell( value );
   } else {
@@ -291,10 +567,43 @@ hdsGtune(const char *param_str, int *value, int *status) {
 
   if (strncasecmp(param_str, "SHEL", 4) == 0) {
     *value = hds1GetShell();
+  } else if (strncasecmp(param_str, "MAPU", 4) == 0) {
+    *value = hds1GetMapUpdate();
   } else if (strncasecmp(param_str, "MAP", 3) == 0) {
     *value = hds1GetUseMmap();
   } else if (strncasecmp(param_str, "LOCKCHECK", 9) == 0) {
     *value = hds1GetLockCheck();
+  } else if (strncasecmp(param_str, "CATA", 4) == 0) {
+    *value = hds1GetCatalogue();
+  } else if (strncasecmp(param_str, "COMP", 4) == 0) {
+    *value = hds1GetCompact();
+  } else if (strncasecmp(param_str, "DEFL", 4) == 0) {
+    *value = hds1GetDeflate();
+  } else if (strncasecmp(param_str, "SHUF", 4) == 0) {
+    *value = hds1GetShuffle();
+  } else if (strncasecmp(param_str, "FLET", 4) == 0) {
+    *value = hds1GetFletcher32();
+  } else if (strncasecmp(param_str, "SCAL", 4) == 0) {
+    *value = hds1GetScaleOffset();
+  } else if (strncasecmp(param_str, "CHUN", 4) == 0) {
+    *value = hds1GetChunkSize();
+  } else if (strncasecmp(param_str, "NTHR", 4) == 0) {
+    *value = hds1GetNThreads();
+  } else if (strncasecmp(param_str, "RAWC", 4) == 0) {
+    *value = hds1GetRawCache();
+  } else if (strncasecmp(param_str, "NBLO", 4) == 0) {
+    *value = hds1GetRawCache() / HDS__BLOCKSIZE;
+  } else if (strncasecmp(param_str, "RAWS", 4) == 0 ||
+             strncasecmp(param_str, "MAXW", 4) == 0) {
+    *value = hds1GetRawSlots();
+  } else if (strncasecmp(param_str, "SIEV", 4) == 0) {
+    *value = hds1GetSieve();
+  } else if (strncasecmp(param_str, "META", 4) == 0) {
+    *value = hds1GetMetaBlock();
+  } else if (strncasecmp(param_str, "INAL", 4) == 0) {
+    *value = hds1GetInal();
+  } else if (strncasecmp(param_str, "NCOM", 4) == 0) {
+    *value = hds1GetNcomp();
   } else {
     *status = DAT__NOTIM;
     emsRep("hdsGtune", "hdsGtune: Not yet implemented for HDF5",
@@ -306,57 +615,224 @@ hdsGtune(const char *param_str, int *value, int *status) {
 /* Getter and setter routines for internal use */
 
 hdsbool_t hds1GetUseMmap() {
-  hdsbool_t result;
   /* Ensure that defaults have been read */
-  hds1ReadTuneEnvironment();
-  LOCK_MUTEX;
-  result = HDS_MAP;
-  UNLOCK_MUTEX;
-  return result;
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_MAP, __ATOMIC_ACQUIRE );
 }
 
 static void hds1SetUseMmap( hdsbool_t use_mmap ) {
-  LOCK_MUTEX
-  HDS_MAP = use_mmap;
-  UNLOCK_MUTEX
+  __atomic_store_n( &HDS_MAP, use_mmap, __ATOMIC_RELEASE );
+  return;
+}
+
+hdsbool_t hds1GetMapUpdate() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_MAPUPDATE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetMapUpdate( hdsbool_t map_update ) {
+  __atomic_store_n( &HDS_MAPUPDATE, map_update, __ATOMIC_RELEASE );
   return;
 }
 
 hdsbool_t hds1GetLockCheck() {
-  hdsbool_t result;
   /* Ensure that defaults have been read */
-  hds1ReadTuneEnvironment();
-  LOCK_MUTEX;
-  result = HDS_LOCKCHECK;
-  UNLOCK_MUTEX;
-  return result;
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_LOCKCHECK, __ATOMIC_ACQUIRE );
 }
 
 static void hds1SetLockCheck( hdsbool_t lock_check ) {
-  LOCK_MUTEX
-  HDS_LOCKCHECK = lock_check;
-  UNLOCK_MUTEX
+  __atomic_store_n( &HDS_LOCKCHECK, lock_check, __ATOMIC_RELEASE );
+  return;
+}
+
+hdsbool_t hds1GetCatalogue() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_CATALOGUE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetCatalogue( hdsbool_t catalogue ) {
+  __atomic_store_n( &HDS_CATALOGUE, catalogue, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetCompact() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_COMPACT, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetCompact( int compact ) {
+  /* Range check -- clamp to the size that fits in an object header */
+  if (compact < 0) compact = 0;
+  if (compact > HDS__MXCOMPACT) compact = HDS__MXCOMPACT;
+  __atomic_store_n( &HDS_COMPACT, compact, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetDeflate() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_DEFLATE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetDeflate( int deflate ) {
+  /* Range check -- clamp to the levels supported by zlib */
+  if (deflate < 0) deflate = 0;
+  if (deflate > 9) deflate = 9;
+  __atomic_store_n( &HDS_DEFLATE, deflate, __ATOMIC_RELEASE );
+  return;
+}
+
+hdsbool_t hds1GetShuffle() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_SHUFFLE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetShuffle( hdsbool_t shuffle ) {
+  __atomic_store_n( &HDS_SHUFFLE, shuffle, __ATOMIC_RELEASE );
+  return;
+}
+
+hdsbool_t hds1GetFletcher32() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_FLETCHER32, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetFletcher32( hdsbool_t fletcher32 ) {
+  __atomic_store_n( &HDS_FLETCHER32, fletcher32, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetScaleOffset() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_SCALEOFFSET, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetScaleOffset( int scaleoffset ) {
+  if (scaleoffset < 0) scaleoffset = 0;
+  __atomic_store_n( &HDS_SCALEOFFSET, scaleoffset, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetChunkSize() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_CHUNKSIZE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetChunkSize( int chunksize ) {
+  /* Range check -- a chunk must hold at least one value */
+  if (chunksize < 1) chunksize = 1;
+  __atomic_store_n( &HDS_CHUNKSIZE, chunksize, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetNThreads() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_NTHREADS, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetNThreads( int nthreads ) {
+  /* Range check */
+  if (nthreads < 1) nthreads = 1;
+  if (nthreads > HDS__MXTHREADS) nthreads = HDS__MXTHREADS;
+  __atomic_store_n( &HDS_NTHREADS, nthreads, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetRawCache() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_RAWCACHE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetRawCache( int rawcache ) {
+  /* Range check -- zero disables the cache */
+  if (rawcache < 0) rawcache = 0;
+  __atomic_store_n( &HDS_RAWCACHE, rawcache, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetRawSlots() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_RAWSLOTS, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetRawSlots( int rawslots ) {
+  /* Range check -- the hash table needs at least one slot */
+  if (rawslots < 1) rawslots = 1;
+  __atomic_store_n( &HDS_RAWSLOTS, rawslots, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetSieve() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_SIEVE, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetSieve( int sieve ) {
+  /* Range check -- zero disables the sieve buffer */
+  if (sieve < 0) sieve = 0;
+  __atomic_store_n( &HDS_SIEVE, sieve, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetMetaBlock() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_METABLOCK, __ATOMIC_ACQUIRE );
+}
+
+static void hds1SetMetaBlock( int metablock ) {
+  /* Range check -- zero disables metadata blocks */
+  if (metablock < 0) metablock = 0;
+  __atomic_store_n( &HDS_METABLOCK, metablock, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetInal() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_INAL, __ATOMIC_ACQUIRE );
+}
+static void hds1SetInal( int inal ) {
+  /* Range check -- zero leaves file space to HDF5 */
+  if (inal < 0) inal = 0;
+  __atomic_store_n( &HDS_INAL, inal, __ATOMIC_RELEASE );
+  return;
+}
+
+int hds1GetNcomp() {
+  /* Ensure that defaults have been read */
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_NCOMP, __ATOMIC_ACQUIRE );
+}
+static void hds1SetNcomp( int ncomp ) {
+  /* Range check -- HDF5 can hold at most 65535 links in compact form */
+  if (ncomp < 0) ncomp = 0;
+  if (ncomp > 65535) ncomp = 65535;
+  __atomic_store_n( &HDS_NCOMP, ncomp, __ATOMIC_RELEASE );
   return;
 }
 
 hds_shell_t hds1GetShell() {
-  hds_shell_t result;
   /* Ensure that defaults have been read */
-  hds1ReadTuneEnvironment();
-  LOCK_MUTEX;
-  result = HDS_SHELL;
-  UNLOCK_MUTEX;
-  return result;
+  pthread_once( &TuneOnce, hds1ReadTuneEnvironment );
+  return __atomic_load_n( &HDS_SHELL, __ATOMIC_ACQUIRE );
 }
 
 static void hds1SetShell( hds_shell_t shell) {
   /* Range check -- revert to SHSHELL if out of range */
-  LOCK_MUTEX
-  if (shell >= HDS__NOSHELL && shell < HDS__MAXSHELL) {
-    HDS_SHELL = shell;
-  } else {
-    HDS_SHELL = HDS__SHSHELL;
-  }
-  UNLOCK_MUTEX
+  if (shell < HDS__NOSHELL || shell >= HDS__MAXSHELL) shell = HDS__SHSHELL;
+  __atomic_store_n( &HDS_SHELL, shell, __ATOMIC_RELEASE );
   return;
 }
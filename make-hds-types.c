@@ -382,6 +382,45 @@ int main (int argc, char ** argv ) {
 	   "#define HDS_BOOL_FORMAT \"%s\"\n\n",
 	   "int", "d");
 
+  /* Description of each object visited by datWalk. The strings and the
+     dimensions array are owned by datWalk. */
+  fprintf( OutputFile,
+           "/* Public type describing an object visited by datWalk or datCatalogue */\n"
+           "typedef struct HDSWalkNode {\n"
+           "   const char *name;    /* Object name, with subscripts for a cell */\n"
+           "   const char *path;    /* Path from the object supplied to datWalk */\n"
+           "   const char *type;    /* HDS type string */\n"
+           "   int level;           /* Depth below the object supplied to datWalk */\n"
+           "   int ndim;            /* Number of dimensions */\n"
+           "   const hdsdim *dims;  /* Dimensions */\n"
+           "   hdsbool_t isstruc;   /* Is the object a structure? */\n"
+           "   hdsbool_t iscell;    /* Is the object a cell of a structure array? */\n"
+           "   hdsbool_t state;     /* Does a primitive have a defined value? */\n"
+           "   size_t nbytes;       /* Number of bytes of data in a primitive */\n"
+           "} HDSWalkNode;\n"
+           "\n"
+           "/* Flags for datWalk and datCatalogue */\n"
+           "#define HDS_WALK_STATE 1     /* Determine the state of each primitive */\n"
+           "#define HDS_WALK_NOCELLS 2   /* Do not visit the cells of structure arrays */\n"
+           "\n");
+
+  /* Storage properties for a new primitive, used by datNewP. Negative
+     values (HDS_PROP_DEFAULT) mean use the corresponding tuning
+     parameter. */
+  fprintf( OutputFile,
+           "/* Public type describing how a new primitive is stored (see datNewP) */\n"
+           "typedef struct HDSCreateProps {\n"
+           "   const hdsdim *chunk; /* Chunk dimensions, or NULL for the default */\n"
+           "   int deflate;         /* Deflate compression level, 0 to 9 */\n"
+           "   int shuffle;         /* Shuffle bytes before compression? */\n"
+           "   int fletcher32;      /* Store a checksum for each chunk? */\n"
+           "   int scaleoffset;     /* Scale-offset setting, 0 for none */\n"
+           "} HDSCreateProps;\n"
+           "\n"
+           "/* Value of an HDSCreateProps field that takes the tuning default */\n"
+           "#define HDS_PROP_DEFAULT -1\n"
+           "\n");
+
   fprintf(OutputFile,
 	  "#endif /* _INCLUDED */\n\n");
   fprintf(POutputFile,